@@ -99,6 +99,7 @@ LOCAL_SRC_FILES += \
 	../../Src/Linderdaum/Core/ScriptCompiler.cpp \
 	../../Src/Linderdaum/Core/UUID.cpp \
 	../../Src/Linderdaum/Core/VFS/Archive.cpp \
+	../../Src/Linderdaum/Core/VFS/BinaryML.cpp \
 	../../Src/Linderdaum/Core/VFS/Files.cpp \
 	../../Src/Linderdaum/Core/VFS/FileSystem.cpp \
 	../../Src/Linderdaum/Core/VFS/libcompress.c \
@@ -117,6 +118,8 @@ LOCAL_SRC_FILES += \
 	../../Src/Linderdaum/Geometry/Surfaces.cpp \
 	../../Src/Linderdaum/Geometry/VAMender.cpp \
 	../../Src/Linderdaum/Geometry/VertexAttribs.cpp \
+	../../Src/Linderdaum/Geometry/Skinning.cpp \
+	../../Src/Linderdaum/Geometry/TriangleBVH.cpp \
 	../../Src/Linderdaum/GUI/ComCtl/I_BorderPanel.cpp \
 	../../Src/Linderdaum/GUI/ComCtl/I_Bubbles.cpp \
 	../../Src/Linderdaum/GUI/ComCtl/I_Button.cpp \
@@ -173,6 +176,7 @@ LOCAL_SRC_FILES += \
 	../../Src/Linderdaum/LString.cpp \
 	../../Src/Linderdaum/Math/Collision.cpp \
 	../../Src/Linderdaum/Math/LAABB.cpp \
+	../../Src/Linderdaum/Math/LAABBTree.cpp \
 	../../Src/Linderdaum/Math/LBox.cpp \
 	../../Src/Linderdaum/Math/LCurve.cpp \
 	../../Src/Linderdaum/Math/LFFT.cpp \
@@ -218,9 +222,11 @@ LOCAL_SRC_FILES += \
 	../../Src/Linderdaum/Renderer/RenderState.cpp \
 	../../Src/Linderdaum/Renderer/Soft/SoftFrameBuffer.cpp \
 	../../Src/Linderdaum/Renderer/Soft/SoftRenderContext.cpp \
+	../../Src/Linderdaum/Renderer/Soft/SoftRasterizer.cpp \
 	../../Src/Linderdaum/Renderer/VolumeRenderer.cpp \
 	../../Src/Linderdaum/Resources/iResource.cpp \
 	../../Src/Linderdaum/Resources/ResourcesManager.cpp \
+	../../Src/Linderdaum/Resources/ResourcesRegistry.cpp \
 	../../Src/Linderdaum/Resources/VFW.cpp \
 	../../Src/Linderdaum/Scene/CSM.cpp \
 	../../Src/Linderdaum/Scene/GameCamera.cpp \
@@ -250,6 +256,7 @@ LOCAL_SRC_FILES += \
 	../../Src/Linderdaum/Utils/Localizer.cpp \
 	../../Src/Linderdaum/Utils/Screen.cpp \
 	../../Src/Linderdaum/Utils/Thread.cpp \
+	../../Src/Linderdaum/Utils/JobSystem.cpp \
 	../../Src/Linderdaum/Utils/Utils.cpp \
 	../../Src/Linderdaum/Utils/Viewport.cpp \
 	../../Src/Linderdaum/VisualScene/CameraPositioner.cpp \
@@ -108,6 +108,7 @@ HEADERS += Src/Linderdaum/Core/Script.h
 HEADERS += Src/Linderdaum/Core/ScriptCompiler.h
 HEADERS += Src/Linderdaum/Core/UUID.h
 HEADERS += Src/Linderdaum/Core/VFS/Archive.h
+HEADERS += Src/Linderdaum/Core/VFS/BinaryML.h
 HEADERS += Src/Linderdaum/Core/VFS/Files.h
 HEADERS += Src/Linderdaum/Core/VFS/FileSystem.h
 HEADERS += Src/Linderdaum/Core/VFS/iIStream.h
@@ -131,6 +132,8 @@ HEADERS += Src/Linderdaum/Geometry/Mesh.h
 HEADERS += Src/Linderdaum/Geometry/Surfaces.h
 HEADERS += Src/Linderdaum/Geometry/VAMender.h
 HEADERS += Src/Linderdaum/Geometry/VertexAttribs.h
+HEADERS += Src/Linderdaum/Geometry/Skinning.h
+HEADERS += Src/Linderdaum/Geometry/TriangleBVH.h
 HEADERS += Src/Linderdaum/GUI/ComCtl/I_BorderPanel.h
 HEADERS += Src/Linderdaum/GUI/ComCtl/I_Bubbles.h
 HEADERS += Src/Linderdaum/GUI/ComCtl/I_Button.h
@@ -193,6 +196,8 @@ HEADERS += Src/Linderdaum/LKeys.h
 HEADERS += Src/Linderdaum/LString.h
 HEADERS += Src/Linderdaum/Math/Collision.h
 HEADERS += Src/Linderdaum/Math/LAABB.h
+HEADERS += Src/Linderdaum/Math/LAABBTree.h
+HEADERS += Src/Linderdaum/Math/LBoundsArray.h
 HEADERS += Src/Linderdaum/Math/LBlending.h
 HEADERS += Src/Linderdaum/Math/LBox.h
 HEADERS += Src/Linderdaum/Math/LCurve.h
@@ -259,6 +264,7 @@ HEADERS += Src/Linderdaum/Renderer/iVertexArray.h
 HEADERS += Src/Linderdaum/Renderer/RenderState.h
 HEADERS += Src/Linderdaum/Renderer/Soft/SoftFrameBuffer.h
 HEADERS += Src/Linderdaum/Renderer/Soft/SoftRenderContext.h
+HEADERS += Src/Linderdaum/Renderer/Soft/SoftRasterizer.h
 HEADERS += Src/Linderdaum/Renderer/Soft/SoftShaderProgram.h
 HEADERS += Src/Linderdaum/Renderer/Soft/SoftTexture.h
 HEADERS += Src/Linderdaum/Renderer/Soft/SoftVertexArray.h
@@ -267,6 +273,7 @@ HEADERS += Src/Linderdaum/Resources/iResource.h
 HEADERS += Src/Linderdaum/Resources/iVideoDecoder.h
 HEADERS += Src/Linderdaum/Resources/iVideoEncoder.h
 HEADERS += Src/Linderdaum/Resources/ResourcesManager.h
+HEADERS += Src/Linderdaum/Resources/ResourcesRegistry.h
 HEADERS += Src/Linderdaum/Resources/VFW.h
 HEADERS += Src/Linderdaum/Scene/CSM.h
 HEADERS += Src/Linderdaum/Scene/GameCamera.h
@@ -294,6 +301,17 @@ HEADERS += Src/Linderdaum/UnitTests/Tests/Test_1.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_10.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_11.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_12.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_13.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_14.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_15.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_16.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_17.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_18.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_19.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_20.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_21.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_22.h
+HEADERS += Src/Linderdaum/UnitTests/Tests/Test_23.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_2.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_3.h
 HEADERS += Src/Linderdaum/UnitTests/Tests/Test_4.h
@@ -320,6 +338,7 @@ HEADERS += Src/Linderdaum/Utils/PlatformGCC.h
 HEADERS += Src/Linderdaum/Utils/PlatformMSVC.h
 HEADERS += Src/Linderdaum/Utils/Screen.h
 HEADERS += Src/Linderdaum/Utils/Thread.h
+HEADERS += Src/Linderdaum/Utils/JobSystem.h
 HEADERS += Src/Linderdaum/Utils/TypeLists.h
 HEADERS += Src/Linderdaum/Utils/TypeTraits.h
 HEADERS += Src/Linderdaum/Utils/Utils.h
@@ -379,6 +398,7 @@ SOURCES += Src/Linderdaum/Core/Script.cpp
 SOURCES += Src/Linderdaum/Core/ScriptCompiler.cpp
 SOURCES += Src/Linderdaum/Core/UUID.cpp
 SOURCES += Src/Linderdaum/Core/VFS/Archive.cpp
+SOURCES += Src/Linderdaum/Core/VFS/BinaryML.cpp
 SOURCES += Src/Linderdaum/Core/VFS/Files.cpp
 SOURCES += Src/Linderdaum/Core/VFS/FileSystem.cpp
 SOURCES += Src/Linderdaum/Core/VFS/libcompress.c
@@ -397,6 +417,8 @@ SOURCES += Src/Linderdaum/Geometry/Mesh.cpp
 SOURCES += Src/Linderdaum/Geometry/Surfaces.cpp
 SOURCES += Src/Linderdaum/Geometry/VAMender.cpp
 SOURCES += Src/Linderdaum/Geometry/VertexAttribs.cpp
+SOURCES += Src/Linderdaum/Geometry/Skinning.cpp
+SOURCES += Src/Linderdaum/Geometry/TriangleBVH.cpp
 SOURCES += Src/Linderdaum/GUI/ComCtl/I_BorderPanel.cpp
 SOURCES += Src/Linderdaum/GUI/ComCtl/I_Bubbles.cpp
 SOURCES += Src/Linderdaum/GUI/ComCtl/I_Button.cpp
@@ -453,6 +475,7 @@ SOURCES += Src/Linderdaum/Input/ScreenJoystick.cpp
 SOURCES += Src/Linderdaum/LString.cpp
 SOURCES += Src/Linderdaum/Math/Collision.cpp
 SOURCES += Src/Linderdaum/Math/LAABB.cpp
+SOURCES += Src/Linderdaum/Math/LAABBTree.cpp
 SOURCES += Src/Linderdaum/Math/LBox.cpp
 SOURCES += Src/Linderdaum/Math/LCurve.cpp
 SOURCES += Src/Linderdaum/Math/LFFT.cpp
@@ -498,9 +521,11 @@ SOURCES += Src/Linderdaum/Renderer/iVertexArray.cpp
 SOURCES += Src/Linderdaum/Renderer/RenderState.cpp
 SOURCES += Src/Linderdaum/Renderer/Soft/SoftFrameBuffer.cpp
 SOURCES += Src/Linderdaum/Renderer/Soft/SoftRenderContext.cpp
+SOURCES += Src/Linderdaum/Renderer/Soft/SoftRasterizer.cpp
 SOURCES += Src/Linderdaum/Renderer/VolumeRenderer.cpp
 SOURCES += Src/Linderdaum/Resources/iResource.cpp
 SOURCES += Src/Linderdaum/Resources/ResourcesManager.cpp
+SOURCES += Src/Linderdaum/Resources/ResourcesRegistry.cpp
 SOURCES += Src/Linderdaum/Resources/VFW.cpp
 SOURCES += Src/Linderdaum/Scene/CSM.cpp
 SOURCES += Src/Linderdaum/Scene/GameCamera.cpp
@@ -530,6 +555,7 @@ SOURCES += Src/Linderdaum/Utils/Library.cpp
 SOURCES += Src/Linderdaum/Utils/Localizer.cpp
 SOURCES += Src/Linderdaum/Utils/Screen.cpp
 SOURCES += Src/Linderdaum/Utils/Thread.cpp
+SOURCES += Src/Linderdaum/Utils/JobSystem.cpp
 SOURCES += Src/Linderdaum/Utils/Utils.cpp
 SOURCES += Src/Linderdaum/Utils/Viewport.cpp
 SOURCES += Src/Linderdaum/VisualScene/CameraPositioner.cpp
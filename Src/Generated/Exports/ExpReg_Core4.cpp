@@ -531,6 +531,7 @@ void RegisterPackageLinderdaumCoreClass159(sEnvironment* Env)
    _RM__(SetLogLevel)
    _RM__(GetLogLevel)
    _RM__(EnableFileLogging)
+   _RM__(Flush)
    _RM__(GetCurrentProcsNesting)
    _RM__(GetCurrentProcsNestingSeparated)
    _RM__(PushProc)
@@ -36,8 +36,9 @@ iWaveform::iWaveform()
 
 iWaveform::~iWaveform()
 {
-	delete( FStream );
+	// the provider may still read from the stream
 	delete( FWaveDataProvider );
+	delete( FStream );
 
 	FWaveDataProvider = NULL;
 }
@@ -64,10 +65,15 @@ bool iWaveform::LoadFromFile( const LString& FileName )
 	*/
 	iWaveDataProvider* Provider = NULL;
 
+	// the old provider may still read from the old stream
+	AttachWaveDataProvider( NULL );
+
 	if ( FStream ) { delete( FStream ); }
 
-	// open stream
-	FStream = Env->FileSystem->CreateFileReader( GetFileName() );
+	// open stream, WAV and OGG are decoded sequentially and do not need the whole file mapped
+	bool Sequential = ( Ext == ".WAV" || Ext == ".OGG" );
+
+	FStream = Sequential ? Env->FileSystem->CreateStreamReader( GetFileName() ) : Env->FileSystem->CreateFileReader( GetFileName() );
 
 	// some error while opening file
 	if ( !FStream )
@@ -321,6 +327,9 @@ void iAudioSource::Update( float DeltaSeconds )
 }
 
 /*
+ * 17/10/2026
+     WAV and OGG files are opened via CreateStreamReader()
+     Wave data provider is deleted before its stream
  * 23/10/2010
      SetFadeVolume()
      GetFadeVolume()
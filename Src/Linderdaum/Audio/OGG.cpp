@@ -11,6 +11,7 @@
 #include "Environment.h"
 #include "Utils/Exceptions.h"
 #include "Core/VFS/iIStream.h"
+#include "Core/VFS/FileSystem.h"
 
 #if !OGG_DYNAMIC_LINK
 // static link
@@ -82,11 +83,11 @@ clWaveDataProvider_OGG::clWaveDataProvider_OGG( sEnvironment* E, iIStream* IStre
 #endif // L_AUDIO_USE_OGG
 
 	FWaveDataSize = static_cast<Lsizei>( IStream->GetFileSize() );
-	FOGGRawData = new Lubyte[ FWaveDataSize ];
-	FOGGRawPosition = 0;
-	FEndOfFile = FOGGRawPosition >= FWaveDataSize;
+	FStream = IStream;
+	FOwnsStream = false;
+	FEndOfFile = FWaveDataSize <= 0;
 
-	IStream->BlockRead( FOGGRawData, IStream->GetFileSize() );
+	FStream->Seek( 0 );
 
 #if L_AUDIO_USE_OGG
 	LoadOGG();
@@ -97,15 +98,77 @@ clWaveDataProvider_OGG::clWaveDataProvider_OGG( const clWaveDataProvider_OGG* Pr
 {
 	Env = Provider->Env;
 	FWaveDataSize = Provider->FWaveDataSize;
-	FOGGRawData = new Lubyte[ FWaveDataSize ];
-	FOGGRawPosition = 0;
+	FStream = Env->FileSystem->CreateStreamReader( Provider->FStream->GetVirtualFileName() );
+	FOwnsStream = true;
 	FEndOfFile = Provider->FEndOfFile;
 
-	memcpy( FOGGRawData, Provider->FOGGRawData, FWaveDataSize );
+	FATAL( !FStream, "Unable to reopen OGG stream: " + Provider->FStream->GetVirtualFileName() );
 
 	LoadOGG();
 }
 
+clWaveDataProvider_OGG::~clWaveDataProvider_OGG()
+{
+#if L_AUDIO_USE_OGG
+	OGG_ov_clear( &FVorbisFile );
+#endif
+
+	if ( FOwnsStream ) { delete( FStream ); }
+}
+
+#if L_AUDIO_USE_OGG
+size_t clWaveDataProvider_OGG::OGG_ReadFunc( void* Ptr, size_t Size, size_t NMemB, void* DataSource )
+{
+	iIStream* Stream = static_cast<clWaveDataProvider_OGG*>( DataSource )->FStream;
+
+	Luint64 BytesRead = Stream->GetBytesLeft();
+	Luint64 BytesSize = static_cast<Luint64>( Size * NMemB );
+
+	if ( BytesSize < BytesRead )
+	{
+		BytesRead = BytesSize;
+	}
+
+	Stream->BlockRead( Ptr, BytesRead );
+
+	return static_cast<size_t>( BytesRead );
+}
+
+int clWaveDataProvider_OGG::OGG_SeekFunc( void* DataSource, ogg_int64_t Offset, int Whence )
+{
+	clWaveDataProvider_OGG* OGG = static_cast<clWaveDataProvider_OGG*>( DataSource );
+
+	ogg_int64_t Position = Offset;
+
+	if ( Whence == SEEK_CUR )
+	{
+		Position += static_cast<ogg_int64_t>( OGG->FStream->GetFilePos() );
+	}
+	else if ( Whence == SEEK_END )
+	{
+		Position += OGG->FWaveDataSize;
+	}
+
+	if ( Position > OGG->FWaveDataSize ) { Position = OGG->FWaveDataSize; }
+
+	if ( Position < 0 ) { Position = 0; }
+
+	OGG->FStream->Seek( static_cast<Luint64>( Position ) );
+
+	return 0;
+}
+
+int clWaveDataProvider_OGG::OGG_CloseFunc( void* /*DataSource*/ )
+{
+	return 0;
+}
+
+long clWaveDataProvider_OGG::OGG_TellFunc( void* DataSource )
+{
+	return static_cast<long>( static_cast<clWaveDataProvider_OGG*>( DataSource )->FStream->GetFilePos() );
+}
+#endif // L_AUDIO_USE_OGG
+
 void clWaveDataProvider_OGG::LoadOGG()
 {
 #if L_AUDIO_USE_OGG
@@ -134,6 +197,8 @@ void clWaveDataProvider_OGG::LoadOGG()
 }
 
 /*
+ * 17/10/2026
+     libvorbis reads through iIStream, clones reopen the file
  * 21/01/2011
      It's here
 */
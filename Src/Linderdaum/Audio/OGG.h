@@ -72,17 +72,12 @@ class scriptfinal clWaveDataProvider_OGG: public iWaveDataProvider
 public:
 	static void ShutdownOGG();
 public:
+	/// decode the stream owned by the waveform, the stream is read sequentially
 	clWaveDataProvider_OGG( sEnvironment* E, iIStream* IStream );
+	/// reopen the file of Provider, each clone reads through its own stream
 	explicit clWaveDataProvider_OGG( const clWaveDataProvider_OGG* Provider );
 	void LoadOGG();
-	virtual ~clWaveDataProvider_OGG()
-	{
-#if L_AUDIO_USE_OGG
-		OGG_ov_clear( &FVorbisFile );
-#endif
-
-		delete[] FOGGRawData;
-	}
+	virtual ~clWaveDataProvider_OGG();
 	//
 	// iWaveDataProvider interface
 	//
@@ -167,61 +162,10 @@ public:
 	}
 private:
 #if L_AUDIO_USE_OGG
-	static size_t OGG_ReadFunc( void* Ptr, size_t Size, size_t NMemB, void* DataSource )
-	{
-		clWaveDataProvider_OGG* OGG = static_cast<clWaveDataProvider_OGG*>( DataSource );
-
-		Lsizei BytesRead = OGG->FWaveDataSize - OGG->FOGGRawPosition;
-		Lsizei BytesSize = static_cast<Lsizei>( Size * NMemB );
-
-		if ( BytesSize < BytesRead )
-		{
-			BytesRead = BytesSize;
-		}
-
-		memcpy( Ptr, OGG->FOGGRawData + OGG->FOGGRawPosition, BytesRead );
-
-		OGG->FOGGRawPosition += BytesRead;
-
-		return BytesRead;
-	}
-	static int OGG_SeekFunc( void* DataSource, ogg_int64_t Offset, int Whence )
-	{
-		clWaveDataProvider_OGG* OGG = static_cast<clWaveDataProvider_OGG*>( DataSource );
-
-		if ( Whence == SEEK_SET )
-		{
-			OGG->FOGGRawPosition = static_cast<Lsizei>( Offset );
-		}
-		else if ( Whence == SEEK_CUR )
-		{
-			OGG->FOGGRawPosition += static_cast<Lsizei>( Offset );
-		}
-		else if ( Whence == SEEK_END )
-		{
-			OGG->FOGGRawPosition = OGG->FWaveDataSize + static_cast<Lsizei>( Offset );
-		}
-
-		if ( OGG->FOGGRawPosition > OGG->FWaveDataSize )
-		{
-			OGG->FOGGRawPosition = OGG->FWaveDataSize;
-		}
-
-		if ( OGG->FOGGRawPosition < 0                  )
-		{
-			OGG->FOGGRawPosition = 0;
-		}
-
-		return OGG->FOGGRawPosition;
-	}
-	static int OGG_CloseFunc( void* DataSource )
-	{
-		return 0;
-	}
-	static long OGG_TellFunc( void* DataSource )
-	{
-		return static_cast<clWaveDataProvider_OGG*>( DataSource )->FOGGRawPosition;
-	}
+	static size_t OGG_ReadFunc( void* Ptr, size_t Size, size_t NMemB, void* DataSource );
+	static int    OGG_SeekFunc( void* DataSource, ogg_int64_t Offset, int Whence );
+	static int    OGG_CloseFunc( void* DataSource );
+	static long   OGG_TellFunc( void* DataSource );
 #endif // L_AUDIO_USE_OGG
 private:
 #if L_AUDIO_USE_OGG
@@ -229,8 +173,9 @@ private:
 #endif // L_AUDIO_USE_OGG
 	sWaveDataFormat        FWaveDataFormat;
 	Lsizei                 FWaveDataSize;
-	Lubyte*                FOGGRawData;
-	Lsizei                 FOGGRawPosition;
+	/// compressed data is pulled from here by libvorbis
+	iIStream*              FStream;
+	bool                   FOwnsStream;
 	int                    FOGGCurrentSection;
 	std::vector<char>      FDecodingBuffer;
 	int                    FDecodingBufferUsed;
@@ -242,6 +187,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     Compressed data is read through the stream instead of a copy in memory
  * 16/05/2009
      It's here
 */
@@ -12,13 +12,26 @@
 #define __WAV_inl__
 
 #include "Core/Logger.h"
+#include "Core/VFS/FileSystem.h"
 #include "Audio/Audio.h"
+#include "Environment.h"
+#include "Math/LMath.h"
 
 /// .WAV file data provider for audio streaming
 class scriptfinal clWaveDataProvider_WAV: public iWaveDataProvider
 {
+public:
+	/// longer samples are streamed from the file instead of being kept in memory
+	static const Lsizei STREAMING_THRESHOLD = 1024 * 1024;
 public:
 	clWaveDataProvider_WAV( sEnvironment* Env, iIStream* IStream )
+		: FSample( NULL ),
+		  FStream( IStream ),
+		  FOwnsStream( false ),
+		  FDataOffset( sizeof( sWAVHeader ) ),
+		  FDataPosition( 0 ),
+		  FDecodingBuffer(),
+		  FDecodingBufferUsed( 0 )
 	{
 		sWAVHeader Header;
 
@@ -39,30 +52,60 @@ public:
 		Env->Logger->Log( L_NOTICE, "Bits per sample: " + LStr::ToStr( Header.nBitsperSample ) );
 		Env->Logger->Log( L_NOTICE, "Sample rate    : " + LStr::ToStr( ( int )Header.SampleRate     ) );
 
-		FSample = ( Lubyte* )malloc( Header.DataSize );
-
 		FATAL( Header.DataSize > IStream->GetFileSize() - sizeof( Header ), "Invalid WAV file" );
 
-		IStream->BlockRead( FSample, Header.DataSize );
-
 		FWaveDataFormat.FChannels      = Header.Channels;
 		FWaveDataFormat.FSamplesPerSec = Header.SampleRate;
 		FWaveDataFormat.FBitsPerSample = Header.nBitsperSample;
 
 		FWaveDataSize = Header.DataSize;
+		FBlockAlign   = Header.nBlockAlign > 0 ? Header.nBlockAlign : 1;
+
+		if ( FWaveDataSize > STREAMING_THRESHOLD ) { return; }
+
+		// short sample: keep it in memory and forget the stream
+		FSample = ( Lubyte* )malloc( Header.DataSize );
+
+		IStream->BlockRead( FSample, Header.DataSize );
+
+		FStream = NULL;
 	}
 	explicit clWaveDataProvider_WAV( const clWaveDataProvider_WAV* Provider )
+		: FSample( NULL ),
+		  FStream( NULL ),
+		  FOwnsStream( false ),
+		  FDataOffset( Provider->FDataOffset ),
+		  FDataPosition( 0 ),
+		  FDecodingBuffer(),
+		  FDecodingBufferUsed( 0 )
 	{
-		FSample = ( Lubyte* )malloc( Provider->FWaveDataSize );
-
-		memcpy( FSample, Provider->FSample, Provider->FWaveDataSize );
-
 		FWaveDataFormat = Provider->FWaveDataFormat;
 		FWaveDataSize   = Provider->FWaveDataSize;
+		FBlockAlign     = Provider->FBlockAlign;
+
+		if ( Provider->FStream )
+		{
+			// each streaming clone reads through its own stream
+			FStream = Provider->Env->FileSystem->CreateStreamReader( Provider->FStream->GetVirtualFileName() );
+
+			FATAL( !FStream, "Unable to reopen WAV stream: " + Provider->FStream->GetVirtualFileName() );
+
+			FOwnsStream = true;
+
+			FStream->Seek( FDataOffset );
+		}
+		else
+		{
+			FSample = ( Lubyte* )malloc( Provider->FWaveDataSize );
+
+			memcpy( FSample, Provider->FSample, Provider->FWaveDataSize );
+		}
 	}
 	virtual ~clWaveDataProvider_WAV()
 	{
 		free( FSample );
+
+		if ( FOwnsStream ) { delete( FStream ); }
 	}
 	//
 	// iWaveDataProvider interface
@@ -78,11 +121,11 @@ public:
 	}
 	virtual bool                   IsStreaming() const
 	{
-		return false;
+		return FStream != NULL;
 	}
 	virtual bool                   IsEOF() const
 	{
-		return true;
+		return !FStream || FDataPosition >= FWaveDataSize;
 	}
 	virtual sWaveDataFormat        GetWaveDataFormat() const
 	{
@@ -90,24 +133,55 @@ public:
 	}
 	virtual Lubyte*                GetWaveData()
 	{
-		return FSample;
+		return FStream ? &FDecodingBuffer[0] : FSample;
 	}
 	virtual Lsizei                 GetWaveDataSize() const
 	{
-		return FWaveDataSize;
+		return FStream ? FDecodingBufferUsed : FWaveDataSize;
 	}
 	virtual int     StreamWaveData( int Size )
 	{
-		return 0;
+		if ( !FStream ) { return 0; }
+
+		// whole sample frames only
+		Size -= Size % FBlockAlign;
+
+		if ( Size > static_cast<int>( FDecodingBuffer.size() ) )
+		{
+			FDecodingBuffer.resize( Size );
+		}
+
+		FDecodingBufferUsed = std::min( static_cast<Lsizei>( Size ), FWaveDataSize - FDataPosition );
+
+		FStream->BlockRead( &FDecodingBuffer[0], FDecodingBufferUsed );
+
+		FDataPosition += FDecodingBufferUsed;
+
+		return FDecodingBufferUsed;
 	}
 	virtual void    Seek( float Time )
 	{
-		// nothing to do
+		if ( !FStream ) { return; }
+
+		Lsizei Position = static_cast<Lsizei>( Time * FWaveDataFormat.FSamplesPerSec ) * FBlockAlign;
+
+		FDataPosition = Math::Clamp( Position, 0, FWaveDataSize );
+
+		FStream->Seek( FDataOffset + FDataPosition );
 	}
 private:
-	Lubyte*            FSample;
-	sWaveDataFormat    FWaveDataFormat;
-	Lsizei             FWaveDataSize;
+	/// whole sample, if not streaming
+	Lubyte*                FSample;
+	/// the stream is owned by iWaveform, clones own theirs
+	iIStream*              FStream;
+	bool                   FOwnsStream;
+	Luint64                FDataOffset;
+	Lsizei                 FDataPosition;
+	std::vector<Lubyte>    FDecodingBuffer;
+	Lsizei                 FDecodingBufferUsed;
+	sWaveDataFormat        FWaveDataFormat;
+	Lsizei                 FWaveDataSize;
+	Lsizei                 FBlockAlign;
 private:
 #pragma pack(push, 1)
 	struct GCC_PACK( 1 ) sWAVHeader
@@ -132,6 +206,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     Samples longer than STREAMING_THRESHOLD are streamed from the file
  * 28/09/2010
      Added WAV header dumping
  * 16/05/2009
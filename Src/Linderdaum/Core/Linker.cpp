@@ -20,11 +20,28 @@
 #include "Environment.h"
 
 #include "Core/VFS/ML.h"
+#include "Core/VFS/BinaryML.h"
 
 #include "Core/RTTI/Method.h"
 #include "Core/RTTI/Symbol.h"
+#include "Core/RTTI/Property.h"
+#include "Math/LHash.h"
 
-clLinker::clLinker() : FStaticMethods()
+namespace
+{
+	/// a class with too many different property layouts falls back to the memoized per-property lookups
+	const size_t MAX_BINDING_PLANS_PER_CLASS = 16;
+
+	/// skip the nodes with empty IDs. This is a quirk of the parser, see LoadPropertyForObject()
+	inline mlNode* SkipWrapperNodes( mlNode* Node )
+	{
+		while ( Node->getIDRef().empty() && !Node->children.empty() ) { Node = Node->children[0]; }
+
+		return Node;
+	}
+}
+
+clLinker::clLinker() : FStaticMethods(), FPlansInUse( 0 ), FClassIndexValid( false ), FClassesGeneration( 0 )
 {
 }
 
@@ -51,6 +68,8 @@ void clLinker::RegisterStaticClass( iStaticClass* StaticClass )
 	StaticClass->Env = Env;
 
 	FClassesRepository[ LString( StaticClass->ClassName() ) ] = StaticClass;
+
+	ClearBindingPlans();
 }
 
 void clLinker::RebuildVirtualTables()
@@ -61,6 +80,8 @@ void clLinker::RebuildVirtualTables()
 	{
 		Iter->second->BuildVirtualTables();
 	}
+
+	ClearBindingPlans();
 }
 
 iObject* clLinker::InstantiateClassByName( const LString& ClassName ) const
@@ -87,9 +108,43 @@ iObject* clLinker::InstantiateClassByName( const LString& ClassName ) const
 
 iStaticClass* clLinker::FindStaticClass( const LString& ClassName ) const
 {
-	clClassesRepository::const_iterator Iter = FClassesRepository.find( ClassName );
+	LMutex Lock( &FClassIndexMutex );
+
+	if ( !FClassIndexValid ) { RebuildClassIndex_NoLock(); }
+
+	// one pass over the name and a single comparison instead of a string-keyed tree walk
+	sClassIndexEntry Key;
+	Key.FHash = Math::HashStringFNV1a( ClassName.c_str() );
+
+	std::vector<sClassIndexEntry>::const_iterator i = std::lower_bound( FClassIndex.begin(), FClassIndex.end(), Key );
+
+	for ( ; i != FClassIndex.end() && i->FHash == Key.FHash; ++i )
+	{
+		if ( *i->FName == ClassName ) { return i->FClass; }
+	}
+
+	return NULL;
+}
+
+void clLinker::RebuildClassIndex_NoLock() const
+{
+	FClassIndex.resize( 0 );
+	FClassIndex.reserve( FClassesRepository.size() );
 
-	return ( Iter == FClassesRepository.end() ) ? NULL : ( Iter->second );
+	for ( clClassesRepository::const_iterator i = FClassesRepository.begin(); i != FClassesRepository.end(); ++i )
+	{
+		sClassIndexEntry Entry;
+
+		Entry.FHash  = Math::HashStringFNV1a( i->first.c_str() );
+		Entry.FName  = &i->first;
+		Entry.FClass = i->second;
+
+		FClassIndex.push_back( Entry );
+	}
+
+	std::sort( FClassIndex.begin(), FClassIndex.end() );
+
+	FClassIndexValid = true;
 }
 
 void clLinker::LoadStaticMethod( const LString& FileName )
@@ -123,6 +178,9 @@ iStaticClass* clLinker::LoadStaticClass( const LString& FileName )
 
 		if ( LoadObjectFromFile( FileName, &Ptr ) ) { return NULL; }
 
+		// the properties of the reloaded class may have changed
+		ClearBindingPlans();
+
 		return OldClass;
 	}
 	else
@@ -137,6 +195,8 @@ iStaticClass* clLinker::LoadStaticClass( const LString& FileName )
 
 clLinker::~clLinker()
 {
+	ClearBindingPlans();
+
 	// 1. deallocate all classes
 	::Linderdaum::Utils::DeallocatePairs( FClassesRepository.begin(), FClassesRepository.end() );
 
@@ -505,7 +565,7 @@ bool clLinker::LoadPropertyForObject( iObject* Obj, mlNode* Node ) const
 	// skip comments
 //   if ( dynamic_cast<mlCommentNode*>( Node ) ) return true;
 
-	if ( Node->getID().empty() )
+	if ( Node->getIDRef().empty() )
 	{
 		// pass to the first child. this is a quirk of the parser
 		if ( Node->children.size() < 1 )
@@ -519,7 +579,7 @@ bool clLinker::LoadPropertyForObject( iObject* Obj, mlNode* Node ) const
 	}
 
 	// Continue result parametrization
-	iProperty* Prop = Obj->GetStaticClass()->FindProperty( Node->getID() );
+	iProperty* Prop = Obj->GetStaticClass()->FindProperty( Node->getIDRef() );
 
 	if ( !Prop )
 	{
@@ -536,6 +596,107 @@ bool clLinker::LoadPropertyForObject( iObject* Obj, mlNode* Node ) const
 	return Prop->Load( Obj, Node );
 }
 
+void clLinker::ClearBindingPlans()
+{
+	LMutex Lock( &FBindingsMutex );
+
+	// a class can be registered while some object is being loaded, so the plans in use are retired rather than deleted
+	for ( std::map<iStaticClass*, sClassBindings>::iterator i = FBindings.begin(); i != FBindings.end(); ++i )
+	{
+		FRetiredPlans.insert( FRetiredPlans.end(), i->second.FPlans.begin(), i->second.FPlans.end() );
+	}
+
+	FBindings.clear();
+
+	if ( !FPlansInUse ) { ::Linderdaum::Utils::DeallocateAll( FRetiredPlans ); }
+
+	FClassesGeneration++;
+
+	LMutex IndexLock( &FClassIndexMutex );
+
+	FClassIndexValid = false;
+}
+
+void clLinker::ReleaseBindingPlan() const
+{
+	LMutex Lock( &FBindingsMutex );
+
+	// the last load in progress is the safe point to free the retired plans
+	if ( --FPlansInUse == 0 && !FRetiredPlans.empty() ) { ::Linderdaum::Utils::DeallocateAll( FRetiredPlans ); }
+}
+
+iProperty* clLinker::ResolveProperty( iStaticClass* Class, const LString& Name ) const
+{
+	LMutex Lock( &FBindingsMutex );
+
+	return ResolveProperty_NoLock( &FBindings[ Class ], Class, Name );
+}
+
+iProperty* clLinker::ResolveProperty_NoLock( sClassBindings* Bindings, iStaticClass* Class, const LString& Name ) const
+{
+	std::map<LString, iProperty*>::const_iterator i = Bindings->FProperties.find( Name );
+
+	if ( i != Bindings->FProperties.end() ) { return i->second; }
+
+	// walks the whole chain of superclasses, so do it only once per name
+	iProperty* Prop = Class->FindProperty( Name );
+
+	Bindings->FProperties[ Name ] = Prop;
+
+	return Prop;
+}
+
+const clLinker::sBindingPlan* clLinker::GetBindingPlan( iStaticClass* Class, mlNode* Node ) const
+{
+	LMutex Lock( &FBindingsMutex );
+
+	sClassBindings& Bindings = FBindings[ Class ];
+
+	const size_t NumChildren = Node->children.size();
+
+	for ( std::vector<sBindingPlan*>::const_iterator i = Bindings.FPlans.begin(); i != Bindings.FPlans.end(); ++i )
+	{
+		const sBindingPlan* Plan = *i;
+
+		if ( Plan->FNames.size() != NumChildren ) { continue; }
+
+		bool Match = true;
+
+		for ( size_t j = 0; j != NumChildren && Match; j++ )
+		{
+			Match = SkipWrapperNodes( Node->children[j] )->getIDRef() == Plan->FNames[j];
+		}
+
+		if ( Match )
+		{
+			FPlansInUse++;
+
+			return Plan;
+		}
+	}
+
+	if ( Bindings.FPlans.size() >= MAX_BINDING_PLANS_PER_CLASS ) { return NULL; }
+
+	sBindingPlan* Plan = new sBindingPlan();
+
+	Plan->FNames.reserve( NumChildren );
+	Plan->FProperties.reserve( NumChildren );
+
+	for ( size_t j = 0; j != NumChildren; j++ )
+	{
+		const LString& Name = SkipWrapperNodes( Node->children[j] )->getIDRef();
+
+		Plan->FNames.push_back( Name );
+		Plan->FProperties.push_back( Name.empty() ? NULL : ResolveProperty_NoLock( &Bindings, Class, Name ) );
+	}
+
+	Bindings.FPlans.push_back( Plan );
+
+	FPlansInUse++;
+
+	return Plan;
+}
+
 bool clLinker::LoadObject( mlNode* Node, iObject** Result ) const
 {
 	if ( Result == NULL )
@@ -544,7 +705,7 @@ bool clLinker::LoadObject( mlNode* Node, iObject** Result ) const
 	}
 
 	// we skip nodes with empty IDs and pass to the first child
-	if ( Node->getID().empty() )
+	if ( Node->getIDRef().empty() )
 	{
 		TODO( "store last error" )
 
@@ -553,9 +714,9 @@ bool clLinker::LoadObject( mlNode* Node, iObject** Result ) const
 		return LoadObject( Node->children[0], Result );
 	}
 
-	if ( ( *Result == NULL ) || ( Node->getID() == "Object" ) )
+	if ( ( *Result == NULL ) || Node->hasID( "Object" ) )
 	{
-		if ( Node->getValue() == "NULL" )
+		if ( Node->getValueRef() == "NULL" )
 		{
 			*Result = NULL;
 
@@ -563,7 +724,7 @@ bool clLinker::LoadObject( mlNode* Node, iObject** Result ) const
 		}
 
 		/// if the object is null, then create it. otherwise - do the parametrization
-		if ( *Result == NULL ) { *Result = InstantiateClassByName( Node->getValue() ); }
+		if ( *Result == NULL ) { *Result = InstantiateClassByName( Node->getValueRef() ); }
 
 		if ( !IsFatalOnErrors() )
 		{
@@ -582,14 +743,38 @@ bool clLinker::LoadObject( mlNode* Node, iObject** Result ) const
 		/// now iterate each property
 //		mlSectionNode* Section = dynamic_cast<mlSectionNode*>( Node );
 
+		iStaticClass* Class = ( *Result )->GetStaticClass();
+
+		bool Loaded = true;
+
 		// Node->isSection is irrelevant here
-		for ( size_t i = 0 ; i < Node->children.size() ; i++ )
+		if ( const sBindingPlan* Plan = GetBindingPlan( Class, Node ) )
 		{
-			mlNode* Child = Node->children[i];
+			for ( size_t i = 0 ; i < Node->children.size() && Loaded ; i++ )
+			{
+				iProperty* Prop = Plan->FProperties[i];
+
+				// unknown properties go the slow way to report the error
+				Loaded = Prop ? Prop->Load( *Result, SkipWrapperNodes( Node->children[i] ) ) : LoadPropertyForObject( *Result, Node->children[i] );
+			}
+
+			ReleaseBindingPlan();
+		}
+		else
+		{
+			// too many layouts for a plan, the properties are still resolved only once per class
+			for ( size_t i = 0 ; i < Node->children.size() && Loaded ; i++ )
+			{
+				mlNode* Child = SkipWrapperNodes( Node->children[i] );
+
+				iProperty* Prop = Child->getIDRef().empty() ? NULL : ResolveProperty( Class, Child->getIDRef() );
 
-			if ( !LoadPropertyForObject( *Result, Child ) ) { return false; }
+				Loaded = Prop ? Prop->Load( *Result, Child ) : LoadPropertyForObject( *Result, Node->children[i] );
+			}
 		}
 
+		if ( !Loaded ) { return false; }
+
 		TODO( "save the error" )
 
 		if ( !( *Result )->EndLoad() ) { return false; }
@@ -630,6 +815,18 @@ bool clLinker::SaveObjectToFile( const LString& FileName, iObject* Obj ) const
 
 bool clLinker::LoadObjectsListFromStream( iIStream* Stream, std::vector<iObject*>* ObjectList ) const
 {
+	const void* Data = Stream->MapStream();
+	size_t      Size = static_cast<size_t>( Stream->GetFileSize() );
+
+	if ( clBinaryMLDocument::IsBinaryML( Data, Size ) )
+	{
+		clBinaryMLDocument Document;
+
+		if ( !Document.Open( Data, Size ) ) { return false; }
+
+		return LoadObjectsListBinary( Document.GetRoot(), ObjectList );
+	}
+
 	mlNode* XLMLTree = Env->FileSystem->LoadXLMLFromStream( Stream );
 
 	return LoadObjectsList( XLMLTree, ObjectList );
@@ -674,7 +871,47 @@ bool clLinker::LoadObjectsList( mlNode* XLMLTree, std::vector<iObject*>* ObjectL
 	return true;
 }
 
+bool clLinker::LoadObjectsListBinary( const clBinaryMLNodeRef& Root, std::vector<iObject*>* ObjectList ) const
+{
+	ObjectList->reserve( Root.GetNumChildren() );
+	ObjectList->resize( 0 );
+
+	for ( size_t i = 0; i != Root.GetNumChildren(); i++ )
+	{
+		// the rest of the document stays in the mapped file
+		mlNode* Node = Root.GetChild( i ).ToNode();
+
+		iObject* Object = NULL;
+
+		bool Res = LoadObject( Node, &Object );
+
+		delete( Node );
+
+		if ( !Res )
+		{
+			for ( size_t j = 0; j != ObjectList->size(); j++ )
+			{
+				if ( ( *ObjectList )[j] ) { ( *ObjectList )[j]->DisposeObject(); }
+			}
+
+			ObjectList->clear();
+
+			return false;
+		}
+
+		ObjectList->push_back( Object );
+	}
+
+	return true;
+}
+
 /*
+ * 17/10/2026
+     Retired binding plans are freed when no load is in progress
+     Binary XLML objects lists are walked in place
+     GetClassesGeneration()
+     Per-class property binding plans for LoadObject()
+     LoadObject() and LoadPropertyForObject() do not copy node IDs and values
  * 13/12/2010
      RebuildVirtualTables()
  * 05/04/2009
@@ -16,6 +16,7 @@
 #include "Core/iObject.h"
 
 #include "Utils/Utils.h"
+#include "Utils/Mutex.h"
 
 #define REGISTER_CLASS(linker, class)  { \
                                   iStaticClass* Class = (new clNativeStaticClass<class>); \
@@ -25,7 +26,9 @@
 class iSymbolDeclaration;
 class iMethod;
 class iIStream;
+class iProperty;
 class mlNode;
+class clBinaryMLNodeRef;
 
 /// Main factory for all classes derived from iObject
 class scriptfinal clLinker: public iObject
@@ -148,6 +151,47 @@ public:
 
 	/// Immediate execution
 	scriptmethod LString             ExecuteCode( const std::vector<LString>& Code );
+
+	/// Incremented every time classes are registered or rebuilt, the cached RTTI lookups are invalid after that
+	noexport     int                 GetClassesGeneration() const { return FClassesGeneration; }
+private:
+	/// Properties resolved for one particular sequence of node IDs
+	struct sBindingPlan
+	{
+		std::vector<LString>    FNames;
+		std::vector<iProperty*> FProperties;
+	};
+
+	/// Everything resolved for a single class while loading its instances
+	struct sClassBindings
+	{
+		/// memoized FindProperty() results, including the inherited properties and misses
+		std::map<LString, iProperty*> FProperties;
+		std::vector<sBindingPlan*>    FPlans;
+	};
+
+	/// Walk the top level of a binary XLML document in place, only one object is expanded to the mlNode tree at a time
+	bool                   LoadObjectsListBinary( const clBinaryMLNodeRef& Root, std::vector<iObject*>* ObjectList ) const;
+	/// Class name hash for the binary search in FClassIndex, the name is checked after the hash matches
+	struct sClassIndexEntry
+	{
+		Luint32         FHash;
+		const LString*  FName;
+		iStaticClass*   FClass;
+
+		bool operator < ( const sClassIndexEntry& Other ) const { return FHash < Other.FHash; }
+	};
+
+	/// Find or build the binding plan for the children of Node. Returns NULL if the class already has too many plans.
+	/// Every returned plan must be given back with ReleaseBindingPlan()
+	const sBindingPlan*    GetBindingPlan( iStaticClass* Class, mlNode* Node ) const;
+	void                   ReleaseBindingPlan() const;
+	/// Memoized FindProperty()
+	iProperty*             ResolveProperty( iStaticClass* Class, const LString& Name ) const;
+	iProperty*             ResolveProperty_NoLock( sClassBindings* Bindings, iStaticClass* Class, const LString& Name ) const;
+	/// Forget all the resolved properties, called when the set of classes changes
+	void                   ClearBindingPlans();
+	void                   RebuildClassIndex_NoLock() const;
 private:
 	typedef std::map<LString, iStaticClass*>                      clClassesRepository;
 	typedef std::vector<std::pair<LString, iMethod*> >            clMethodsRepository;
@@ -156,11 +200,28 @@ private:
 	clClassesRepository    FClassesRepository;
 	clMethodsRepository    FStaticMethods;
 	clSymbolsRepository    FGlobalSymbols;
+
+	mutable std::map<iStaticClass*, sClassBindings> FBindings;
+	/// plans invalidated while some object was being loaded, deleted once no plan is in use
+	mutable std::vector<sBindingPlan*>              FRetiredPlans;
+	mutable size_t                                  FPlansInUse;
+	/// FClassesRepository sorted by the hash of class names
+	mutable std::vector<sClassIndexEntry>           FClassIndex;
+	mutable bool                                    FClassIndexValid;
+	mutable clMutex                                 FBindingsMutex;
+	/// separate from FBindingsMutex: FindProperty() looks up the superclasses while the bindings are locked
+	mutable clMutex                                 FClassIndexMutex;
+
+	int                                             FClassesGeneration;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     Hashed classes index for FindStaticClass()
+     GetClassesGeneration()
+     Per-class property binding plans for LoadObject()
  * 18/01/2010
      Some 'noexport' defines to avoid errors with LSDC/Script compiler
  * 13/12/2010
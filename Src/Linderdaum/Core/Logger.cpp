@@ -63,6 +63,67 @@ LLogLevel StringToLogLevel(const LString& S)
 	return L_LOG;
 }
 
+namespace
+{
+	/// Binary log record, followed by the zero-terminated text: procs nesting and the message
+	struct sLogRecord
+	{
+		/// Total size of the record including the text, a multiple of 8. Zero marks the padding up to the end of the ring
+		Luint32 FSize;
+		Luint32 FLogLevel;
+		Luint32 FMilliseconds;
+		/// Offset of the message in the text, right after the procs nesting
+		Luint32 FMessageOffset;
+		Luint64 FTime;
+	};
+
+	/// Limit for a single record, so a few of them always fit into the ring
+	const Luint32 MAX_LOG_RECORD_SIZE = 16 * 1024;
+
+	/// Every logger gets a unique ID, so a stale cached context of a destroyed logger is never used
+	volatile long GLoggerInstances = 0;
+
+	L_THREAD_LOCAL long  GCachedLoggerID = 0;
+	L_THREAD_LOCAL void* GCachedLogContext = NULL;
+
+	/// Set while this thread holds FDrainMutex and writes the records out
+	L_THREAD_LOCAL bool  GDrainingLog = false;
+
+	inline void LogMemoryBarrier()
+	{
+#if defined( OS_WINDOWS )
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+}
+
+/// Drains the log rings in the background
+class clLogWriterThread: public iThread
+{
+public:
+	explicit clLogWriterThread( const clLogger* Logger ): FLogger( Logger ) {};
+
+	virtual void Run()
+	{
+		while ( !IsPendingExit() )
+		{
+			size_t Written = 0;
+
+			{
+				LMutex Lock( &FLogger->FDrainMutex );
+
+				Written = FLogger->DrainLogRecords_NoLock();
+			}
+
+			if ( !Written ) { FLogger->WaitForLogRecords( this ); }
+		}
+	}
+private:
+	const clLogger* FLogger;
+};
+
 int GetCurrentMilliseconds()
 {
 #if defined( OS_WINDOWS )
@@ -80,6 +141,31 @@ int GetCurrentMilliseconds()
 #endif
 }
 
+clLogger::clLogger()
+	: FLogFile( NULL ),
+	  FNumThreads( 0 ),
+	  FWriter( NULL ),
+	  FWriterSleeping( false ),
+	  FInstanceID( 0 ),
+	  FCurrentLogLevel( L_DEBUG ),
+	  FLastTimeStamp( 0.0 )
+{
+	for ( int i = 0; i != MAX_LOG_THREADS; i++ ) { FThreads[i] = NULL; }
+
+#if defined( OS_WINDOWS )
+	FInstanceID = InterlockedIncrement( &GLoggerInstances );
+#else
+	FInstanceID = __sync_add_and_fetch( &GLoggerInstances, 1 );
+#endif
+}
+
+clLogger::~clLogger()
+{
+	ShutdownLogger();
+
+	for ( long i = 0; i != FNumThreads; i++ ) { delete( FThreads[i] ); }
+}
+
 void clLogger::FatalException( const ::Linderdaum::clException* E )
 {
 	LString ExceptionName = LString( typeid( *E ).name() );
@@ -94,6 +180,8 @@ void clLogger::FatalException( const ::Linderdaum::clException* E )
 
 void clLogger::EnableFileLogging( const LString& LogFileName )
 {
+	StartWriter();
+
 	// if no log file was specified - leave the things as they are
 	if ( LogFileName.empty() ) { return; }
 
@@ -103,14 +191,24 @@ void clLogger::EnableFileLogging( const LString& LogFileName )
 
 	clFileSystem::CreateDirsPhys( Dir );
 
-	// close if there was an old log file
-	if ( FLogFile )
+	FILE* NewLogFile = fopen( LogFileName.c_str() , "w" );
+
+	// the writer thread uses FLogFile while it holds FDrainMutex
 	{
-		fflush( FLogFile );
-		fclose( FLogFile );
-	}
+		LMutex Lock( &FDrainMutex );
 
-	FLogFile = fopen( LogFileName.c_str() , "w" );
+		// write everything pending into the old log file
+		DrainLogRecords_NoLock();
+
+		// close if there was an old log file
+		if ( FLogFile )
+		{
+			fflush( FLogFile );
+			fclose( FLogFile );
+		}
+
+		FLogFile = NewLogFile;
+	}
 
 	// display a nice error message
 	if ( FLogFile == 0 )
@@ -143,11 +241,55 @@ void clLogger::ShutdownLogger()
 
 	Log( L_NOTICE, "clLogger::ShutdownLogger()->Closing log file..." );
 
+	StopWriter();
+
+	// other threads may still log and drain the rings in Flush()
+	LMutex Lock( &FDrainMutex );
+
+	DrainLogRecords_NoLock();
+
 	if ( FLogFile )
 	{
-		fflush( FLogFile );
 		fclose( FLogFile );
+
+		FLogFile = NULL;
+	}
+}
+
+void clLogger::StartWriter()
+{
+	if ( FWriter ) { return; }
+
+	FWriter = new clLogWriterThread( this );
+	FWriter->Start( Env, iThread::Priority_Normal );
+}
+
+void clLogger::StopWriter()
+{
+	if ( !FWriter ) { return; }
+
+	FWriter->Exit( false );
+
+	{
+		LMutex Lock( &FWakeMutex );
+
+		FWakeCondition.Signal();
 	}
+
+	FWriter->Exit( true );
+
+	delete( FWriter );
+
+	FWriter = NULL;
+}
+
+void clLogger::Flush() const
+{
+	LMutex Lock( &FDrainMutex );
+
+	DrainLogRecords_NoLock();
+
+	if ( FLogFile ) { fflush( FLogFile ); }
 }
 
 void clLogger::MarkTime( LLogLevel LogLevel, const char* Pattern ) const
@@ -181,32 +323,238 @@ void clLogger::LogP( LLogLevel LogLevel, const char* Pattern, ... ) const
 
 	va_end( p );
 
-	sThreadLogContext* Ctx = GetThreadLogContext();
+	::Linderdaum::clGuardian::MarkLogged();
+
+	PostLogRecord( GetThreadLogContext(), LogLevel, LogMessageBuffer );
 
-	if ( Ctx->FLogsOnThisLevel.size() > 0 )
+	// the console belongs to the engine threads, so it is updated here rather than in the writer thread
+	if ( Env->Console )
 	{
-		Ctx->FLogsOnThisLevel.back() = true;
+		if ( LogLevel == L_LOG )
+		{
+			Env->Console->Display( LogMessageBuffer );
+		}
+		else if ( LogLevel >= L_WARNING )
+		{
+			Env->Console->DisplayError( LogMessageBuffer );
+		}
 	}
+}
 
-	LString Str       = LString( LogMessageBuffer );
-	LString LogString = GetTimeStamp() + GetCurrentProcsNesting() + Str;
+void clLogger::PostLogRecord( sThreadLogContext* Ctx, LLogLevel LogLevel, const char* Message ) const
+{
+	const Luint32 MaxTextSize = MAX_LOG_RECORD_SIZE - sizeof( sLogRecord ) - 1;
 
-	SendAsync( L_EVENT_LOG, LEventArgs( &LogString, static_cast<float>( LogLevel ), ( iObject* )&Str, false ), false );
+	sLogRecord Record;
 
-	LMutex Lock( &FMutex );
+	time_t TempTime;
+	time( &TempTime );
 
-	if ( Env->Console )
+	Record.FLogLevel     = static_cast<Luint32>( LogLevel );
+	Record.FMilliseconds = static_cast<Luint32>( GetCurrentMilliseconds() );
+	Record.FTime         = static_cast<Luint64>( TempTime );
+
+	const bool Shared = ( Ctx == FThreads[ MAX_LOG_THREADS - 1 ] );
+
+	if ( Shared ) { FSharedContextMutex.Lock(); }
+
+	const int Depth = ::Linderdaum::clGuardian::GetDepth();
+
+	Luint32 NestingLength = 0;
+
+	for ( int i = 0; i != Depth; i++ )
 	{
-		if ( LogLevel == L_LOG )
+		NestingLength += static_cast<Luint32>( strlen( ::Linderdaum::clGuardian::GetFrameText( i ) ) );
+	}
+
+	if ( NestingLength > MaxTextSize ) { NestingLength = MaxTextSize; }
+
+	Luint32 MessageLength = static_cast<Luint32>( strlen( Message ) );
+
+	if ( NestingLength + MessageLength > MaxTextSize ) { MessageLength = MaxTextSize - NestingLength; }
+
+	Record.FMessageOffset = NestingLength;
+	Record.FSize          = ( sizeof( sLogRecord ) + NestingLength + MessageLength + 1 + 7 ) & ~7u;
+
+	// a record is never split: the tail of the ring is skipped if the record does not fit there
+	Luint32 Head      = Ctx->FRingHead;
+	Luint32 Offset    = Head & ( LOG_RING_SIZE - 1 );
+	Luint32 Remaining = LOG_RING_SIZE - Offset;
+	Luint32 Padding   = ( Remaining < Record.FSize ) ? Remaining : 0;
+
+	// bounded memory: when the ring is full, write out everything synchronously
+	if ( LOG_RING_SIZE - ( Head - Ctx->FRingTail ) < Padding + Record.FSize )
+	{
+		// FDrainMutex is not recursive: a record posted while this thread drains the rings is dropped
+		if ( GDrainingLog )
 		{
-			Env->Console->Display( Str );
+			if ( Shared ) { FSharedContextMutex.Unlock(); }
+
+			return;
 		}
-		else if ( LogLevel >= L_WARNING )
+
+		Flush();
+	}
+
+	if ( Padding >= sizeof( sLogRecord ) )
+	{
+		reinterpret_cast<sLogRecord*>( Ctx->FRing + Offset )->FSize = 0;
+	}
+
+	Head  += Padding;
+	Offset = Head & ( LOG_RING_SIZE - 1 );
+
+	Lubyte* Ptr  = Ctx->FRing + Offset;
+	char*   Text = reinterpret_cast<char*>( Ptr + sizeof( sLogRecord ) );
+
+	memcpy( Ptr, &Record, sizeof( sLogRecord ) );
+
+	for ( int i = 0; i != Depth && NestingLength > 0; i++ )
+	{
+		const char* Proc = ::Linderdaum::clGuardian::GetFrameText( i );
+
+		Luint32 Length = static_cast<Luint32>( strlen( Proc ) );
+
+		if ( Length > NestingLength ) { Length = NestingLength; }
+
+		memcpy( Text, Proc, Length );
+
+		Text          += Length;
+		NestingLength -= Length;
+	}
+
+	memcpy( Text, Message, MessageLength );
+
+	Text[ MessageLength ] = 0;
+
+	// publish the record only after it has been completely written
+	LogMemoryBarrier();
+
+	Ctx->FRingHead = Head + Record.FSize;
+
+	if ( Shared ) { FSharedContextMutex.Unlock(); }
+
+	// nobody drains the rings before the writer thread is started or after it is stopped
+	if ( !FWriter )
+	{
+		if ( !GDrainingLog ) { Flush(); }
+
+		return;
+	}
+
+	// the head must be visible before we check whether the writer is asleep
+	LogMemoryBarrier();
+
+	if ( FWriterSleeping )
+	{
+		LMutex Lock( &FWakeMutex );
+
+		FWakeCondition.Signal();
+	}
+}
+
+bool clLogger::HasLogRecords() const
+{
+	long NumThreads = FNumThreads;
+
+	LogMemoryBarrier();
+
+	for ( long i = 0; i != NumThreads; i++ )
+	{
+		if ( FThreads[i]->FRingHead != FThreads[i]->FRingTail ) { return true; }
+	}
+
+	return false;
+}
+
+void clLogger::WaitForLogRecords( const iThread* Writer ) const
+{
+	LMutex Lock( &FWakeMutex );
+
+	FWriterSleeping = true;
+
+	// the flag must be visible before we look at the heads, see PostLogRecord()
+	LogMemoryBarrier();
+
+	if ( !Writer->IsPendingExit() && !HasLogRecords() ) { FWakeCondition.Wait( &FWakeMutex ); }
+
+	FWriterSleeping = false;
+}
+
+size_t clLogger::DrainLogRecords_NoLock() const
+{
+	GDrainingLog = true;
+
+	size_t Written = 0;
+
+	long NumThreads = FNumThreads;
+
+	LogMemoryBarrier();
+
+	for ( long i = 0; i != NumThreads; i++ )
+	{
+		sThreadLogContext* Ctx = FThreads[i];
+
+		Luint32 Head = Ctx->FRingHead;
+		Luint32 Tail = Ctx->FRingTail;
+
+		// do not read the records before the head
+		LogMemoryBarrier();
+
+		while ( Tail != Head )
 		{
-			Env->Console->DisplayError( Str );
+			Luint32 Offset    = Tail & ( LOG_RING_SIZE - 1 );
+			Luint32 Remaining = LOG_RING_SIZE - Offset;
+
+			const sLogRecord* Record = reinterpret_cast<const sLogRecord*>( Ctx->FRing + Offset );
+
+			if ( Remaining < sizeof( sLogRecord ) || Record->FSize == 0 )
+			{
+				Tail += Remaining;
+				continue;
+			}
+
+			WriteLogRecord( Ctx, Record );
+
+			Tail += Record->FSize;
+
+			Written++;
 		}
+
+		// release the space only after the records have been read
+		LogMemoryBarrier();
+
+		Ctx->FRingTail = Tail;
 	}
 
+#if !defined( NDEBUG )
+
+	if ( Written && FLogFile ) { fflush( FLogFile ); }
+
+#endif // NDEBUG
+
+	GDrainingLog = false;
+
+	return Written;
+}
+
+void clLogger::WriteLogRecord( const sThreadLogContext* Ctx, const void* RecordPtr ) const
+{
+	const sLogRecord* Record = reinterpret_cast<const sLogRecord*>( RecordPtr );
+
+	const char* Text = reinterpret_cast<const char*>( Record ) + sizeof( sLogRecord );
+
+	LLogLevel LogLevel = static_cast<LLogLevel>( Record->FLogLevel );
+
+	time_t TempTime = static_cast<time_t>( Record->FTime );
+
+	::tm Time = *localtime( &TempTime );
+
+	LString Str       = LString( Text + Record->FMessageOffset );
+	LString LogString = LStr::GetFormatted( "%02d:%02d:%02d.%03d   ", Time.tm_hour, Time.tm_min, Time.tm_sec, static_cast<int>( Record->FMilliseconds ) ) + LString( Text );
+
+	SendAsync( L_EVENT_LOG, LEventArgs( &LogString, static_cast<float>( LogLevel ), ( iObject* )&Str, false ), false );
+
 	WriteLineToLog( LogString.c_str(), Ctx );
 
 	// NOTE: text console logging (slow)
@@ -225,11 +573,11 @@ void clLogger::LogP( LLogLevel LogLevel, const char* Pattern, ... ) const
 				break;
 			case L_LOG:
 				Attr = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-				fflush( FLogFile );
+				if ( FLogFile ) { fflush( FLogFile ); }
 				break;
 			case L_WARNING:
 				Attr = FOREGROUND_RED | FOREGROUND_INTENSITY;
-				fflush( FLogFile );
+				if ( FLogFile ) { fflush( FLogFile ); }
 				break;
 		}
 
@@ -242,8 +590,7 @@ void clLogger::LogP( LLogLevel LogLevel, const char* Pattern, ... ) const
 		}
 		else
 		{
-//			FIXME(%u pattern for size_t gives a reasonable warning on 64-bit posix systems)
-			printf( "(%u):%s\n", iThread::GetCurrentThread(), LogString.c_str() );
+			printf( "(%lu):%s\n", static_cast<unsigned long>( Ctx->FThreadID ), LogString.c_str() );
 		}
 
 #ifdef OS_WINDOWS
@@ -252,7 +599,7 @@ void clLogger::LogP( LLogLevel LogLevel, const char* Pattern, ... ) const
 	}
 }
 
-void clLogger::WriteLineToLog( const char* Line, sThreadLogContext* Ctx ) const
+void clLogger::WriteLineToLog( const char* Line, const sThreadLogContext* Ctx ) const
 {
 #if defined(OS_ANDROID)
 	__android_log_print( ANDROID_LOG_INFO, "LEngine", "(%s):%s", Ctx->FThreadName.c_str(), Line );
@@ -266,12 +613,8 @@ void clLogger::WriteLineToLog( const char* Line, sThreadLogContext* Ctx ) const
 	}
 	else
 	{
-		fprintf( FLogFile, "(%u):%s\n", iThread::GetCurrentThread(), Line );
+		fprintf( FLogFile, "(%lu):%s\n", static_cast<unsigned long>( Ctx->FThreadID ), Line );
 	}
-
-#if !defined( NDEBUG )
-	fflush( FLogFile );
-#endif // NDEBUG
 }
 
 void clLogger::SetCurrentThreadName( const LString& Name )
@@ -333,58 +676,30 @@ void clLogger::SetThreadName( size_t ThreadID, const LString& Name )
 
 void clLogger::PushProc( const char* Str )
 {
-	sThreadLogContext* Ctx = GetThreadLogContext();
-
-	new ( &( Ctx->FProcsNesting[ Ctx->FProcsNestingLevel ] ) ) LStringBuffer( Str );
-	Ctx->FProcsNestingLevel++;
-	Ctx->FLogsOnThisLevel.push_back( false );
+	::Linderdaum::clGuardian::PushText( Str );
 }
 
 void clLogger::PopProc()
 {
-	sThreadLogContext* Ctx = GetThreadLogContext();
-
-	if ( Ctx->FLogsOnThisLevel.back() )
-	{
-		Log( L_DEBUG, "<-" );
-	}
-
-	Ctx->FLogsOnThisLevel.pop_back();
-	Ctx->FProcsNestingLevel--;
-}
-
-LString clLogger::GetTimeStamp() const
-{
-	time_t TempTime;
-	time( &TempTime );
-
-	::tm Time = *localtime( &TempTime );
-
-	LString TimeStamp = LStr::GetFormatted( "%02d:%02d:%02d.%03d   ", Time.tm_hour, Time.tm_min, Time.tm_sec, GetCurrentMilliseconds() );
-
-	return TimeStamp;
+	::Linderdaum::clGuardian::PopFrame( this );
 }
 
 LString clLogger::GetCurrentProcsNesting() const
 {
-	sThreadLogContext* Ctx = GetThreadLogContext();
-
 	LString Str;
 
-	for ( int i = 0; i != Ctx->FProcsNestingLevel; i++ ) { Str += Ctx->FProcsNesting[i].ToString(); }
+	for ( int i = 0; i != ::Linderdaum::clGuardian::GetDepth(); i++ ) { Str += ::Linderdaum::clGuardian::GetFrameText( i ); }
 
 	return Str;
 }
 
 LString clLogger::GetCurrentProcsNestingSeparated() const
 {
-	sThreadLogContext* Ctx = GetThreadLogContext();
-
 	LString Nesting;
 
-	for ( int i = 0; i != Ctx->FProcsNestingLevel; i++ )
+	for ( int i = 0; i != ::Linderdaum::clGuardian::GetDepth(); i++ )
 	{
-		Nesting += LString( "    " ) + Ctx->FProcsNesting[i].ToString() + "\n";
+		Nesting += LString( "    " ) + ::Linderdaum::clGuardian::GetFrameText( i ) + "\n";
 	}
 
 	return Nesting;
@@ -436,6 +751,9 @@ void clLogger::Fatal( const LString& ErrorMessage,
 
 	SendSync( L_EVENT_FATAL, LEventArgs( &Error, 0, this, false ), false );
 
+	// the process is about to terminate, so write out everything while we still can
+	Flush();
+
 	clScreen::ShowMessageBox( "Linderdaum Engine. Fatal error:", Error, L_MB_OK, true );
 
 #ifdef _MSC_VER
@@ -453,22 +771,58 @@ void clLogger::Error( const LString& ErrorMessage, const LString& File, const LS
 }
 
 clLogger::sThreadLogContext* clLogger::GetThreadLogContext() const
+{
+	if ( GCachedLoggerID == FInstanceID ) { return static_cast<sThreadLogContext*>( GCachedLogContext ); }
+
+	sThreadLogContext* Ctx = FindThreadLogContext();
+
+	GCachedLoggerID   = FInstanceID;
+	GCachedLogContext = Ctx;
+
+	return Ctx;
+}
+
+clLogger::sThreadLogContext* clLogger::FindThreadLogContext() const
 {
 	size_t Thread = iThread::GetCurrentThread();
 
-	for ( size_t i = 0; i != FThreads.size(); i++ )
+	long NumThreads = FNumThreads;
+
+	LogMemoryBarrier();
+
+	for ( long i = 0; i != NumThreads; i++ )
 	{
-		if ( FThreads[i].FThreadID == Thread ) { return &FThreads[i]; }
+		if ( FThreads[i]->FThreadID == Thread ) { return FThreads[i]; }
 	}
 
 	LMutex Lock( &FMutex );
 
-	FThreads.push_back( sThreadLogContext( Thread ) );
+	// every thread registers only itself, so only the contexts added in the meantime need to be checked
+	for ( long i = NumThreads; i != FNumThreads; i++ )
+	{
+		if ( FThreads[i]->FThreadID == Thread ) { return FThreads[i]; }
+	}
+
+	// out of contexts: all the remaining threads share the last one
+	if ( FNumThreads == MAX_LOG_THREADS ) { return FThreads[ MAX_LOG_THREADS - 1 ]; }
+
+	FThreads[ FNumThreads ] = new sThreadLogContext( Thread );
+
+	// publish the context only after it has been constructed
+	LogMemoryBarrier();
+
+	FNumThreads++;
 
-	return &FThreads.back();
+	return FThreads[ FNumThreads - 1 ];
 }
 
 /*
+ * 17/10/2026
+     The writer thread sleeps on a condition instead of polling
+     Lock-free per-thread log rings drained by the writer thread
+     Flush()
+     Call stacks are tracked by clGuardian
+     Thread-local cache of the thread context
  * 18/02/2011
      LogP()
  * 16/02/2011
@@ -31,23 +31,24 @@ namespace Linderdaum
 };
 
 class clMutex;
+class clLogWriterThread;
+class iThread;
 
 /**
    \brief Global debug logging
 
    Provides multi-level logging with current execution context tracking.
    This class is implemented using FILE* to ensure maximum portability and simplicity.
+
+   Every thread writes binary log records into its own lock-free ring buffer,
+   the rings are drained by a dedicated writer thread which does all the actual output.
+   Call Flush() to write everything synchronously.
 **/
 class scriptfinal clLogger: public iObject
 {
-private:
-	static const size_t DefaultThreadsEstimate = 8;
 public:
-	clLogger(): FLogFile( NULL ), FThreads( DefaultThreadsEstimate ), FCurrentLogLevel( L_DEBUG ), FLastTimeStamp( 0.0 ) {};
-	virtual ~clLogger()
-	{
-		ShutdownLogger();
-	};
+	clLogger();
+	virtual ~clLogger();
 
 	NET_EXPORTABLE()
 
@@ -76,6 +77,11 @@ public:
 	   Called at statup
 	**/
 	scriptmethod void    EnableFileLogging( const LString& LogFileName );
+	/**
+	   Write all the pending log records and flush the log file.
+	   Called on shutdown and before terminating on a fatal error
+	**/
+	scriptmethod void    Flush() const;
 	/**
 	   Form a string with detailed call stack information
 	**/
@@ -85,13 +91,12 @@ public:
 	**/
 	scriptmethod LString GetCurrentProcsNestingSeparated() const;
 	/**
-	   Service function which pushes the routine name to internal stack.
-	   Called from guard() macro at the beginning of every routine being debugged.
+	   Service function which pushes the routine name to the call stack of the current thread.
+	   The guard() macro uses clGuardian directly.
 	**/
 	scriptmethod void    PushProc( const char* Str );
 	/**
-	   Service function which pops the routine name from internal stack.
-	   Called from unguard() macro at the end of every routine being debugged.
+	   Service function which pops the routine name from the call stack of the current thread.
 	**/
 	scriptmethod void    PopProc();
 	/**
@@ -108,33 +113,64 @@ public:
 	**/
 	scriptmethod void    Error( const LString& ErrorMessage, const LString& File, const LString& Line, const LString& Context );
 private:
-	static const int MAX_PROCS_NESTING = 32;
+	friend class clLogWriterThread;
+
+	/// Threads beyond this number share a single mutex-protected context
+	static const int MAX_LOG_THREADS   = 64;
+	/// Size of the per-thread ring buffer in bytes, a power of two
+	static const Luint32 LOG_RING_SIZE = 64 * 1024;
 private:
 	struct sThreadLogContext
 	{
-		sThreadLogContext(): FThreadID( 0 ), FProcsNestingLevel( 0 ), FLogsOnThisLevel(), FThreadName() {};
-		sThreadLogContext( size_t ThreadID ): FThreadID( ThreadID ), FProcsNestingLevel( 0 ), FLogsOnThisLevel(), FThreadName() {};
+		sThreadLogContext( size_t ThreadID ): FThreadID( ThreadID ), FThreadName(),
+			FRing( new Lubyte[ LOG_RING_SIZE ] ), FRingHead( 0 ), FRingTail( 0 ) {};
+		~sThreadLogContext() { delete[] FRing; };
 
 		size_t           FThreadID;
-		/// Current call stack
-		LStringBuffer    FProcsNesting[MAX_PROCS_NESTING];
-		int              FProcsNestingLevel;
-		/// Boolean flags indicating presence of any log messages on current execution level
-		LArray<bool>     FLogsOnThisLevel;
 		/// User-defined name of the thread
 		LString          FThreadName;
+		/// Single-producer single-consumer ring of log records. Only the owner thread moves the head,
+		/// only the holder of FDrainMutex moves the tail. Both are free-running byte counters
+		Lubyte*          FRing;
+		volatile Luint32 FRingHead;
+		volatile Luint32 FRingTail;
 	};
 	sThreadLogContext* GetThreadLogContext() const;
+	sThreadLogContext* FindThreadLogContext() const;
 	void      ShutdownLogger();
-	LString   GetTimeStamp() const;
+	void      StartWriter();
+	void      StopWriter();
 	LString   PrepareErrorMessage( const LString& ErrorMessage, const LString& File, const LString& Line, const LString& Context );
-	void      WriteLineToLog( const char* Line, sThreadLogContext* Ctx ) const;
+	void      PostLogRecord( sThreadLogContext* Ctx, LLogLevel LogLevel, const char* Message ) const;
+	/// Write all the published records, returns the number of written records. FDrainMutex should be locked
+	size_t    DrainLogRecords_NoLock() const;
+	bool      HasLogRecords() const;
+	/// Called by the writer thread to sleep until a new record is posted or the thread is asked to exit
+	void      WaitForLogRecords( const iThread* Writer ) const;
+	void      WriteLogRecord( const sThreadLogContext* Ctx, const void* Record ) const;
+	void      WriteLineToLog( const char* Line, const sThreadLogContext* Ctx ) const;
 private:
 	/// Actual handle for the file with debug log
 	FILE*                   FLogFile;
 
-	mutable std::vector<sThreadLogContext> FThreads;
-	mutable clMutex                        FMutex;
+	/// Published thread contexts, the pointers never change once published so the lookup is lock-free
+	mutable sThreadLogContext* FThreads[ MAX_LOG_THREADS ];
+	mutable volatile long      FNumThreads;
+	/// Guards the registration of new thread contexts
+	mutable clMutex            FMutex;
+	/// Serializes the producers sharing the last context
+	mutable clMutex            FSharedContextMutex;
+	/// Owned by whoever drains the rings: the writer thread or Flush()
+	mutable clMutex            FDrainMutex;
+
+	clLogWriterThread*         FWriter;
+	/// The writer thread sleeps on FWakeCondition while there is nothing to write
+	mutable clMutex            FWakeMutex;
+	mutable clCondition        FWakeCondition;
+	mutable volatile bool      FWriterSleeping;
+
+	/// Key for the thread-local cache of the thread context
+	long                       FInstanceID;
 
 	LLogLevel FCurrentLogLevel;
 
@@ -144,6 +180,10 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     Lock-free per-thread log rings drained by the writer thread
+     Flush()
+     Call stacks are tracked by clGuardian
  * 04/05/2011
      Added L_PARANOID
  * 18/02/2011
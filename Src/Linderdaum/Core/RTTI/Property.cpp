@@ -70,7 +70,7 @@ bool clArrayProperty::Load( iObject* TheObject, mlNode* Node ) const
 {
 	mlNode* RealNode = Node; //->children[i];
 
-	while ( RealNode->getID().empty() )
+	while ( RealNode->getIDRef().empty() )
 	{
 		// switch to subnode - avoid parser strange behaviour
 		if ( RealNode->children.size() == 0 )
@@ -81,8 +81,6 @@ bool clArrayProperty::Load( iObject* TheObject, mlNode* Node ) const
 		RealNode = RealNode->children[0];
 	}
 
-	LString ID = RealNode->getID();
-
 	int Size = static_cast<int>( RealNode->children.size() );
 
 	FResizeFunction( TheObject, Size );
@@ -133,6 +131,8 @@ bool clArrayProperty::IsDefaultValue( iObject* Obj ) const
 }
 
 /*
+ * 17/10/2026
+     clArrayProperty::Load() does not copy node IDs
  * 13/01/2011
      IsArray()
      IsDefaultValue()
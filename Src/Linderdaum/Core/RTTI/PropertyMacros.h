@@ -46,7 +46,7 @@ bool LoadObjectField_##TheClassName##_##ThePropName##_SETTER(mlNode* Node, iObje
 #define SCALAR_PROPERTY_LOAD__FIELD(ThePropName, TheFieldName, TheClassName, AccessFieldName, FromStringConverter) \
 bool LoadScalarField_##TheClassName##_##AccessFieldName##_FIELD(mlNode* Node, iObject* Obj) \
 {\
-   (dynamic_cast< TheClassName *>(Obj))-> TheFieldName = FromStringConverter( Node->getValue() );\
+   (dynamic_cast< TheClassName *>(Obj))-> TheFieldName = FromStringConverter( Node->getValueRef() );\
    return true; \
 }
 
@@ -54,7 +54,7 @@ bool LoadScalarField_##TheClassName##_##AccessFieldName##_FIELD(mlNode* Node, iO
 #define SCALAR_PROPERTY_LOAD__SETTER(ThePropName, TheFieldName, TheClassName, TheSetter, FromStringConverter) \
 bool LoadScalarField_##TheClassName##_##ThePropName##_SETTER(mlNode* Node, iObject* Obj) \
 {\
-   (dynamic_cast< TheClassName *>(Obj))-> TheSetter ( FromStringConverter( Node->getValue() ) );\
+   (dynamic_cast< TheClassName *>(Obj))-> TheSetter ( FromStringConverter( Node->getValueRef() ) );\
    return true; \
 }
 
@@ -106,7 +106,7 @@ bool SaveObjectField_##TheClassName##_##ThePropName##_GETTER(iObject* Obj, mlNod
 
 #define FIX_PARSER_DEFECT(DestNode, SrcNode) \
    mlNode* DestNode = SrcNode ; \
-   while( DestNode ->getID().empty()) \
+   while( DestNode ->getIDRef().empty()) \
    { \
       if ( DestNode ->children.size() < 1) \
       {\
@@ -260,6 +260,8 @@ void DeleteFunction_##TheClassName##_##TheArrayName##_FIELD(iObject* Obj, int Re
 #endif
 
 /*
+ * 17/10/2026
+     Scalar loaders do not copy node values
  * 07/10/2010
      Log section added
 */
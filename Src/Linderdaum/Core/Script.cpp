@@ -808,6 +808,8 @@ bool clCodePatch::Link( LString& ErrorCode )
 
 	FLabelLinks.resize( 0 );
 
+	Predecode();
+
 #ifdef CODE_PATCH__HEAVY_DEBUG
 	//
 	// DEBUG: dump all instructions into logfile
@@ -829,6 +831,24 @@ bool clCodePatch::Link( LString& ErrorCode )
 	return true;
 }
 
+void clCodePatch::Predecode()
+{
+	FExecutors.resize( FInstructions.size() );
+
+	// strings are numbered from 1, so every cache is reset on the first execution
+	sInlineCache EmptyCache;
+	memset( &EmptyCache, 0, sizeof( EmptyCache ) );
+
+	FInlineCaches.assign( FInstructions.size(), EmptyCache );
+
+	for ( size_t i = 0; i != FInstructions.size(); ++i )
+	{
+		LOpCodes OpCode = FInstructions[i].FOpCode;
+
+		FExecutors[i] = ( OpCode >= 0 && OpCode <= MAX_OPCODES ) ? executors[ OpCode ] : &clExecutionThread::Opcode_INVALID;
+	}
+}
+
 LString clCodePatch::FindLabelByIP( int IP ) const
 {
 	guard();
@@ -1281,21 +1301,15 @@ void clExecutionThread::Execute( clScriptMethod* Method, clCodePatch* CodePatch,
 		FParamSymbols.push_back( new clParamSymbolDeclaration( Method->GetParamName( static_cast<int>( i ) ), Params[i] ) );
 	}
 
+	sInstruction* Code = Instructions.empty() ? NULL : &Instructions[0];
+
+#if L_VM_PROFILING
+
 	while ( FInstructionPointer < FMaxInstructions )
 	{
-		FCurrentInstructionPtr = &Instructions[ FInstructionPointer ];
-		FCurrentInstruction = Instructions[ FInstructionPointer ];
+		FCurrentInstructionPtr = Code + FInstructionPointer;
 
-		LOpCodes OpCode = FCurrentInstruction.FOpCode;
-		/*
-		      printf("Opcode: %s   ", SymOpCodes[OpCode] );
-		      printf("ArgInt[0]: %i   ", FCurrentInstruction.FArgInt[0] );
-		      if ( FCurrentInstruction.FFlag & FLAG_LABEL )
-		      {
-		         printf("Label = %s   ", CodePatch->GetString( FCurrentInstruction.FArgInt[1] ).c_str() );
-		      }
-		      printf("Flag =  %i   \n", int(FCurrentInstruction.FFlag) );
-		*/
+		LOpCodes OpCode = FCurrentInstructionPtr->FOpCode;
 
 		RAISE_MSG_IF( OpCode > MAX_OPCODES, clExcept_InvalidOpCode, LStr::ToStr( OpCode ) );
 
@@ -1312,29 +1326,143 @@ void clExecutionThread::Execute( clScriptMethod* Method, clCodePatch* CodePatch,
 		FInstructionPointer++;
 	}
 
+#else
+
+	// fast path: the handlers were resolved by clCodePatch::Link(), opcodes were validated by the assembler
+	if ( const clOpCodeExecutor* Executors = CodePatch->GetExecutors() )
+	{
+		while ( FInstructionPointer < FMaxInstructions )
+		{
+			FCurrentInstructionPtr = Code + FInstructionPointer;
+
+			( this->*Executors[ FInstructionPointer ] )();
+
+			FInstructionPointer++;
+		}
+	}
+	else
+	{
+		while ( FInstructionPointer < FMaxInstructions )
+		{
+			FCurrentInstructionPtr = Code + FInstructionPointer;
+
+			LOpCodes OpCode = FCurrentInstructionPtr->FOpCode;
+
+			RAISE_MSG_IF( OpCode > MAX_OPCODES, clExcept_InvalidOpCode, LStr::ToStr( OpCode ) );
+
+			( this->*executors[OpCode] )();
+
+			FInstructionPointer++;
+		}
+	}
+
+#endif
+
 	// deallocate FParamSymbols on exit
 	Utils::Deallocate( FParamSymbols.begin(), FParamSymbols.end() );
 }
 
 LString clExecutionThread::ExtractString()
 {
-	if ( FCurrentInstruction.FArgInt[0] > 0 )
+	return FCurrentCodePatch->GetString( ExtractStringID() );
+}
+
+int clExecutionThread::ExtractStringID()
+{
+	if ( FCurrentInstructionPtr->FArgInt[0] > 0 )
 	{
-		return FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+		return FCurrentInstructionPtr->FArgInt[0];
 	}
-	else
+
+	return FStack.Pop<int>();
+}
+
+sInlineCache* clExecutionThread::GetInlineCache( int StringID )
+{
+	sInlineCache* Cache = FCurrentCodePatch->GetInlineCache( FInstructionPointer );
+
+	if ( !Cache ) { return NULL; }
+
+	int Generation = Env->Linker->GetClassesGeneration();
+
+	// the name can come from the stack, so the cache is valid only for a single string
+	if ( Cache->FGeneration != Generation || Cache->FStringID != StringID )
 	{
-		int StringID = FStack.Pop<int>();
+		memset( Cache, 0, sizeof( sInlineCache ) );
 
-		return FCurrentCodePatch->GetString( StringID );
+		Cache->FGeneration = Generation;
+		Cache->FStringID   = StringID;
 	}
+
+	return Cache;
+}
+
+iField* clExecutionThread::FindFieldCached( iStaticClass* Class, int StringID )
+{
+	sInlineCache* Cache = GetInlineCache( StringID );
+
+	if ( Cache )
+	{
+		for ( int i = 0; i != INLINE_CACHE_SIZE; i++ )
+		{
+			if ( Cache->FEntries[i].FClass == Class && Cache->FEntries[i].FField ) { return Cache->FEntries[i].FField; }
+		}
+	}
+
+	// miss: walk the superclasses
+	iField* Field = Class->FindField( *FCurrentCodePatch->GetStringPtr( StringID ) );
+
+	if ( Cache && Field )
+	{
+		sInlineCache::sEntry& Entry = Cache->FEntries[ Cache->FNextEntry ];
+
+		Entry.FClass  = Class;
+		Entry.FField  = Field;
+		Entry.FMethod = NULL;
+
+		Cache->FNextEntry = ( Cache->FNextEntry + 1 ) % INLINE_CACHE_SIZE;
+	}
+
+	return Field;
+}
+
+iMethod* clExecutionThread::FindMethodCached( iStaticClass* Class, int StringID, int Inherited )
+{
+	sInlineCache* Cache = GetInlineCache( StringID );
+
+	if ( Cache )
+	{
+		for ( int i = 0; i != INLINE_CACHE_SIZE; i++ )
+		{
+			const sInlineCache::sEntry& Entry = Cache->FEntries[i];
+
+			if ( Entry.FClass == Class && Entry.FInherited == Inherited && Entry.FMethod ) { return Entry.FMethod; }
+		}
+	}
+
+	// miss: search the methods list of every superclass
+	iMethod* Method = Class->FindMethod( *FCurrentCodePatch->GetStringPtr( StringID ), Inherited );
+
+	if ( Cache && Method )
+	{
+		sInlineCache::sEntry& Entry = Cache->FEntries[ Cache->FNextEntry ];
+
+		Entry.FClass     = Class;
+		Entry.FInherited = Inherited;
+		Entry.FField     = NULL;
+		Entry.FMethod    = Method;
+
+		Cache->FNextEntry = ( Cache->FNextEntry + 1 ) % INLINE_CACHE_SIZE;
+	}
+
+	return Method;
 }
 
 LString* clExecutionThread::ExtractStringPtr()
 {
-	if ( FCurrentInstruction.FArgInt[0] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[0] > 0 )
 	{
-		return FCurrentCodePatch->GetStringPtr( FCurrentInstruction.FArgInt[0] );
+		return FCurrentCodePatch->GetStringPtr( FCurrentInstructionPtr->FArgInt[0] );
 	}
 	else
 	{
@@ -1448,7 +1576,7 @@ void clExecutionThread::Opcode_LOAD_STRING_CONST()
 
 void clExecutionThread::Opcode_LOAD_BYTES()
 {
-	int NumBytes = FCurrentInstruction.FArgInt[0];
+	int NumBytes = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( NumBytes < 0 )
 	{
@@ -1481,7 +1609,7 @@ void clExecutionThread::Opcode_LOAD_BYTES()
 void clExecutionThread::Opcode_REPLICATE_STACK_TOP()
 {
 	// pop <N> bytes and push them twice
-	int _sz = FCurrentInstruction.FArgInt[0];
+	int _sz = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( _sz < 0 )
 	{
@@ -1495,7 +1623,7 @@ void clExecutionThread::Opcode_REPLICATE_STACK_TOP()
 void clExecutionThread::Opcode_PUSH_BYTES()
 {
 	// push <N> bytes from current address
-	int _n = FCurrentInstruction.FArgInt[0];
+	int _n = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( _n < 0 )
 	{
@@ -1510,7 +1638,7 @@ void clExecutionThread::Opcode_PUSH_BYTES()
 
 void clExecutionThread::Opcode_POP_BYTES()
 {
-	int _sz = FCurrentInstruction.FArgInt[0];
+	int _sz = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( _sz < 0 )
 	{
@@ -1551,9 +1679,9 @@ void clExecutionThread::Opcode_DISP_STRING()
 
 	LString String;
 
-	if ( FCurrentInstruction.FArgInt[0] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[0] > 0 )
 	{
-		String = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+		String = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[0] );
 	}
 	else
 	{
@@ -1640,7 +1768,7 @@ void clExecutionThread::CallMethod( iObject* NativeObject,
 
 void clExecutionThread::Opcode_INHERITED_CALL()
 {
-	LString MethodName = ExtractString();
+	int MethodNameID = ExtractStringID();
 
 	iObject* NativeObject = dynamic_cast<iObject*>( FStack.Pop<iObject*>() );
 
@@ -1652,9 +1780,9 @@ void clExecutionThread::Opcode_INHERITED_CALL()
 
 	FATAL( StaticClass == NULL, "Native object has no static class for method call: \"" + LString( NativeObject->ClassName() ) + "\"" );
 
-	iMethod* Method = StaticClass->FindMethod( MethodName, NativeObject->GetInheritedCall() );
+	iMethod* Method = FindMethodCached( StaticClass, MethodNameID, NativeObject->GetInheritedCall() );
 
-	FATAL( Method == NULL, "Native object \"" + LString( NativeObject->ClassName() ) + "\" has no method: \"" + MethodName + "\"" );
+	FATAL( Method == NULL, "Native object \"" + LString( NativeObject->ClassName() ) + "\" has no method: \"" + FCurrentCodePatch->GetString( MethodNameID ) + "\"" );
 
 	CallMethod( NativeObject, Method, NativeObject->GetInheritedCall() );
 
@@ -1665,7 +1793,7 @@ void clExecutionThread::Opcode_CALL_METHOD()
 {
 	guard();
 
-	LString MethodName = ExtractString();
+	int MethodNameID = ExtractStringID();
 
 	iObject* NativeObject = dynamic_cast<iObject*>( FStack.Pop<iObject*>() );
 
@@ -1677,10 +1805,10 @@ void clExecutionThread::Opcode_CALL_METHOD()
 
 	FATAL( StaticClass == NULL, "Native object has no static class for method call: \"" + LString( NativeObject->ClassName() ) + "\"" );
 
-	Method = StaticClass->FindMethod( MethodName, 0 );
+	Method = FindMethodCached( StaticClass, MethodNameID, 0 );
 
 	// check if we've got a method binder
-	FATAL( Method == NULL, "Native object \"" + LString( NativeObject->ClassName() ) + "\" has no method: \"" + MethodName + "\"" );
+	FATAL( Method == NULL, "Native object \"" + LString( NativeObject->ClassName() ) + "\" has no method: \"" + FCurrentCodePatch->GetString( MethodNameID ) + "\"" );
 
 	CallMethod( NativeObject, Method, 0 );
 
@@ -1689,11 +1817,11 @@ void clExecutionThread::Opcode_CALL_METHOD()
 
 void clExecutionThread::Opcode_CALL_STATIC_METHOD()
 {
-	int MethodIndex = FCurrentInstruction.FArgInt[1];
+	int MethodIndex = FCurrentInstructionPtr->FArgInt[1];
 
 	if ( MethodIndex == -1 )
 	{
-		LString MethodName = FCurrentCodePatch->GetString ( FCurrentInstruction.FArgInt[0] );
+		LString MethodName = FCurrentCodePatch->GetString ( FCurrentInstructionPtr->FArgInt[0] );
 
 		MethodIndex = Env->Linker->GetStaticMethodIndex( MethodName );
 
@@ -1764,7 +1892,7 @@ void clExecutionThread::Opcode_LATENT_RETURN()
 void clExecutionThread::UndeclareVars()
 {
 	// 1. get local number of vars
-	int SrcVarNum  = FCurrentInstruction.FDeclaredVars;
+	int SrcVarNum  = FCurrentInstructionPtr->FDeclaredVars;
 	// 2. get dest var num
 	int DestVarNum = FCurrentCodePatch->GetInstructions()[FInstructionPointer].FDeclaredVars;
 
@@ -1795,7 +1923,7 @@ void clExecutionThread::UndeclareVars()
 
 void clExecutionThread::Opcode_JMP()
 {
-	FInstructionPointer = FCurrentInstruction.FArgInt[0];
+	FInstructionPointer = FCurrentInstructionPtr->FArgInt[0];
 
 	UndeclareVars();
 }
@@ -1804,7 +1932,7 @@ void clExecutionThread::Opcode_JMP_IF()
 {
 	if ( FStack.Pop<bool>() )
 	{
-		FInstructionPointer = FCurrentInstruction.FArgInt[0];
+		FInstructionPointer = FCurrentInstructionPtr->FArgInt[0];
 
 		UndeclareVars();
 	}
@@ -1814,7 +1942,7 @@ void clExecutionThread::Opcode_JMP_IF_NOT()
 {
 	if ( FStack.Pop<bool>() == 0 )
 	{
-		FInstructionPointer = FCurrentInstruction.FArgInt[0];
+		FInstructionPointer = FCurrentInstructionPtr->FArgInt[0];
 
 		UndeclareVars();
 	}
@@ -1824,7 +1952,7 @@ void clExecutionThread::Opcode_DECLARE()
 {
 	int _Size = FStack.Pop<int>();
 //   LString _Name = FStack.Pop<LString>();
-	LString _Name = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+	LString _Name = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[0] );
 
 	TODO( "specify address for NEW manually for speedup" )
 
@@ -1858,18 +1986,18 @@ void clExecutionThread::Opcode_EQUAL_STRING_STRING()
 	LString String1;
 	LString String2;
 
-	if ( FCurrentInstruction.FArgInt[0] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[0] > 0 )
 	{
-		String1 = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+		String1 = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[0] );
 	}
 	else
 	{
 		String1 = FStack.Pop<LString>();
 	}
 
-	if ( FCurrentInstruction.FArgInt[1] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[1] > 0 )
 	{
-		String2 = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[1] );
+		String2 = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[1] );
 	}
 	else
 	{
@@ -1888,18 +2016,18 @@ void clExecutionThread::Opcode_ADD_STRING_STRING()
 	LString String1;
 	LString String2;
 
-	if ( FCurrentInstruction.FArgInt[0] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[0] > 0 )
 	{
-		String1 = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+		String1 = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[0] );
 	}
 	else
 	{
 		String1 = FStack.Pop<LString>();
 	}
 
-	if ( FCurrentInstruction.FArgInt[1] > 0 )
+	if ( FCurrentInstructionPtr->FArgInt[1] > 0 )
 	{
-		String2 = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[1] );
+		String2 = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[1] );
 	}
 	else
 	{
@@ -1912,7 +2040,7 @@ void clExecutionThread::Opcode_ADD_STRING_STRING()
 	unguard();
 }
 
-iSymbolDeclaration* clExecutionThread::FindSymbol( const LString& SymbolName )
+iSymbolDeclaration* clExecutionThread::FindSymbol( int StringID )
 {
 	/*
 	   // 1. search local vars
@@ -1939,7 +2067,7 @@ iSymbolDeclaration* clExecutionThread::FindSymbol( const LString& SymbolName )
 	if ( NativeObject != NULL )
 	{
 		// search local fields
-		iField* Field = NativeObject->GetStaticClass()->FindField( SymbolName );
+		iField* Field = FindFieldCached( NativeObject->GetStaticClass(), StringID );
 
 		if ( Field != NULL )
 		{
@@ -1956,12 +2084,14 @@ iSymbolDeclaration* clExecutionThread::FindSymbol( const LString& SymbolName )
 
 void clExecutionThread::Opcode_RESIZE()
 {
-	LString SymName = ExtractString();
+	int SymNameID = ExtractStringID();
 
-	iSymbolDeclaration* SymPtr = FindSymbol( SymName );
+	iSymbolDeclaration* SymPtr = FindSymbol( SymNameID );
 
 	if ( SymPtr == NULL )
 	{
+		const LString& SymName = *FCurrentCodePatch->GetStringPtr( SymNameID );
+
 		// Try local vars
 
 		for ( size_t i = 0 ; i < FLocalVars.size() ; i++ )
@@ -1985,12 +2115,12 @@ void clExecutionThread::Opcode_RESIZE()
 
 void clExecutionThread::Opcode_LOAD_GLOBAL_VAR_ADDRESS()
 {
-	int VarIdx = FCurrentInstruction.FArgInt[1];
+	int VarIdx = FCurrentInstructionPtr->FArgInt[1];
 
 	if ( VarIdx == -1 )
 	{
 		// try to find the symbol
-		LString VarName = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+		LString VarName = FCurrentCodePatch->GetString( FCurrentInstructionPtr->FArgInt[0] );
 		VarIdx = Env->Linker->GetGlobalVarIndex( VarName );
 
 		// update instruction in the codepatch
@@ -2012,9 +2142,9 @@ void clExecutionThread::Opcode_LOAD_LOCAL_VAR()
 {
 	// combined LOAD_LOCAL_VAR_ADDRESS + LOAD_VAL_FROM_CUR_ADDR
 
-	void* _ptr = FLocalVars[ FCurrentInstruction.FArgInt[0] ]->GetSymbolAddress();
+	void* _ptr = FLocalVars[ FCurrentInstructionPtr->FArgInt[0] ]->GetSymbolAddress();
 
-	int size = FCurrentInstruction.FArgInt[1];
+	int size = FCurrentInstructionPtr->FArgInt[1];
 
 	if ( size < 0 )
 	{
@@ -2028,21 +2158,21 @@ void clExecutionThread::Opcode_LOAD_LOCAL_VAR()
 
 void clExecutionThread::Opcode_LOAD_LOCAL_VAR_ADDRESS()
 {
-	int idx = FCurrentInstruction.FArgInt[0];
+	int idx = FCurrentInstructionPtr->FArgInt[0];
 	clVarSymbolDeclaration* Var = FLocalVars[idx];
 	FStack.Push<void*>( Var->GetSymbolAddress() );
 }
 
 void clExecutionThread::Opcode_LOAD_PARAM_ADDRESS()
 {
-	FStack.Push<void*>( FParamSymbols[FCurrentInstruction.FArgInt[0]]->GetSymbolAddress() );
+	FStack.Push<void*>( FParamSymbols[FCurrentInstructionPtr->FArgInt[0]]->GetSymbolAddress() );
 }
 
 void clExecutionThread::Opcode_LOAD_EFFECTIVE_ADDRESS()
 {
 	// find symbol
-	LString SymbolName         = ExtractString();
-	iSymbolDeclaration* Symbol = FindSymbol( SymbolName );
+	int SymbolNameID           = ExtractStringID();
+	iSymbolDeclaration* Symbol = FindSymbol( SymbolNameID );
 
 	if ( Symbol != NULL )
 	{
@@ -2052,13 +2182,13 @@ void clExecutionThread::Opcode_LOAD_EFFECTIVE_ADDRESS()
 		return;
 	}
 
-	FATAL_MSG( "Unable to find symbol : " + SymbolName );
+	FATAL_MSG( "Unable to find symbol : " + FCurrentCodePatch->GetString( SymbolNameID ) );
 }
 
 void clExecutionThread::Opcode_LOAD_CLASS_FIELD_ADDRESS()
 {
 	// extract class and field name
-	LString RefFieldName = FCurrentCodePatch->GetString( FCurrentInstruction.FArgInt[0] );
+	int RefFieldNameID = FCurrentInstructionPtr->FArgInt[0];
 
 	// load class reference using address on top of stack
 	//   REM : wonderful arithmetics ...
@@ -2067,7 +2197,7 @@ void clExecutionThread::Opcode_LOAD_CLASS_FIELD_ADDRESS()
 	// find "metafield"
 //   iStaticClass* mc = Env->Linker->FindStaticClass( LString(_obj->ClassName()) );
 	iStaticClass* mc = _obj->GetStaticClass();
-	iField* field    = mc->FindField( RefFieldName );
+	iField* field    = FindFieldCached( mc, RefFieldNameID );
 
 	// push the field address
 	FStack.Push<void*>( field->GetFieldPtr( _obj ) );
@@ -2076,7 +2206,7 @@ void clExecutionThread::Opcode_LOAD_CLASS_FIELD_ADDRESS()
 // WARNING : is this 64-bit safe ?
 void clExecutionThread::Opcode_ADD_OFFSET()
 {
-	int offset = FCurrentInstruction.FArgInt[0];
+	int offset = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( offset == -1 )
 	{
@@ -2093,7 +2223,7 @@ void clExecutionThread::Opcode_ADD_OFFSET()
 
 void clExecutionThread::Opcode_LOAD_VAL_FROM_CUR_ADDR()
 {
-	int size   = FCurrentInstruction.FArgInt[0];
+	int size   = FCurrentInstructionPtr->FArgInt[0];
 
 	if ( size < 0 )
 	{
@@ -2465,17 +2595,17 @@ void clExecutionThread::Opcode_INSPECT_TOP_STR()
 // load variable's value from instruction argument, removing this value from stack
 #define VM_CODE__DEFINE_SCALAR_VALUE_LOADER_NOSTACK_IMM(OpCode,type)          \
       VM_CODE__EXECUTOR_HEADER(OpCode)                \
-         type val = *reinterpret_cast<type*>(&FCurrentInstruction.FArgInt[0]); \
+         type val = *reinterpret_cast<type*>(&FCurrentInstructionPtr->FArgInt[0]); \
          VM_GET_VAL_FROM_STACK(void *,voidAddr)          \
          type *_ptr = reinterpret_cast<type *>(voidAddr);   \
          *_ptr = val;                     \
       }
 
-VM_CODE__DEFINE_VALUE_PUSHER( PUSH_INT, int, FCurrentInstruction.FArgInt[0] )
-VM_CODE__DEFINE_VALUE_PUSHER( PUSH_DOUBLE, double, FCurrentInstruction.FArgFloat[0] )
-VM_CODE__DEFINE_VALUE_PUSHER( PUSH_FLOAT, float, static_cast<float>( FCurrentInstruction.FArgFloat[0] ) )
-VM_CODE__DEFINE_VALUE_PUSHER( PUSH_BOOL, bool,/*static_cast<bool>(FCurrentInstruction.FArgByte[0])*/FCurrentInstruction.FArgInt[0] != 0 )
-VM_CODE__DEFINE_VALUE_PUSHER( PUSH_BYTE, Lubyte, static_cast<Lubyte>( FCurrentInstruction.FArgInt[0] ) )
+VM_CODE__DEFINE_VALUE_PUSHER( PUSH_INT, int, FCurrentInstructionPtr->FArgInt[0] )
+VM_CODE__DEFINE_VALUE_PUSHER( PUSH_DOUBLE, double, FCurrentInstructionPtr->FArgFloat[0] )
+VM_CODE__DEFINE_VALUE_PUSHER( PUSH_FLOAT, float, static_cast<float>( FCurrentInstructionPtr->FArgFloat[0] ) )
+VM_CODE__DEFINE_VALUE_PUSHER( PUSH_BOOL, bool,/*static_cast<bool>(FCurrentInstructionPtr->FArgByte[0])*/FCurrentInstructionPtr->FArgInt[0] != 0 )
+VM_CODE__DEFINE_VALUE_PUSHER( PUSH_BYTE, Lubyte, static_cast<Lubyte>( FCurrentInstructionPtr->FArgInt[0] ) )
 
 VM_CODE__DEFINE_SCALAR_VALUE_LOADER( LOAD_BOOL, bool )
 VM_CODE__DEFINE_SCALAR_VALUE_LOADER( LOAD_INT, int )
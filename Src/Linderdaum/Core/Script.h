@@ -32,6 +32,7 @@ class iOStream;
 class iIStream;
 
 class clScriptMethod;
+class clCodePatch;
 
 class iSymbolDeclaration;
 class clVarSymbolDeclaration;
@@ -107,6 +108,92 @@ struct sInstruction
 
 typedef std::vector<sInstruction> clInstructions;
 
+const int INLINE_CACHE_SIZE = 4;
+
+/**
+   Polymorphic inline cache of a single field access or method call instruction.
+
+   Receivers of these instructions are known only at run time, so the name is resolved
+   once per receiver class and the resolved iField/iMethod is reused while the classes stay the same.
+**/
+struct sInlineCache
+{
+	/// value of clLinker::GetClassesGeneration() the entries were resolved for
+	int             FGeneration;
+	/// symbol name in the code patch strings table
+	int             FStringID;
+	/// the next entry to replace
+	int             FNextEntry;
+	struct sEntry
+	{
+		iStaticClass* FClass;
+		int           FInherited;
+		iField*       FField;
+		iMethod*      FMethod;
+	} FEntries[ INLINE_CACHE_SIZE ];
+};
+
+/// LinderScript virtual machine execution thread
+class clExecutionThread
+{
+public:
+	EXCEPTIONABLE;
+	EXCEPTION( clExcept_InvalidOpCode, "Invalid opcode encountered while executing byte-code" );
+public:
+	clExecutionThread();
+	virtual ~clExecutionThread();
+	//
+	// iExecutionThread interface
+	//
+	scriptmethod iStack*  GetStack() { return &FStack; };
+	scriptmethod void     Execute( clScriptMethod* Method, clCodePatch* CodePatch, void* Self, clParametersList& Params );
+	/// opcodes statistics are collected only if L_VM_PROFILING is enabled
+	static  void          ClearExecutionStats();
+	static  void          LogExecutionStats( sEnvironment* Env );
+	/// opcodes executors (autogenerated stuff)
+#  include "Generated/VM/ExecThread_MtdList.h"
+private:
+	// symbol stuff
+	// field handler
+	clFieldSymbolDeclaration* FFieldSymbol;
+	iSymbolDeclaration*       FindSymbol( int StringID );
+	/// FindField()/FindMethod() through the inline cache of the current instruction
+	iField*                   FindFieldCached( iStaticClass* Class, int StringID );
+	iMethod*                  FindMethodCached( iStaticClass* Class, int StringID, int Inherited );
+	sInlineCache*             GetInlineCache( int StringID );
+private:
+	LString     ExtractString();
+	LString*    ExtractStringPtr();
+	int         ExtractStringID();
+	void        RecursiveEnter();
+	void        RecursiveLeave();
+	void        CallMethod( iObject* NativeObject, iMethod* Method, int Inherited );
+	void        UndeclareVars();
+private:
+	typedef std::vector<clParamSymbolDeclaration*> clParamSymbols;
+	typedef std::vector<clVarSymbolDeclaration*> clVarSymbols;
+public:
+	sEnvironment* Env;
+private:
+	iStack                  FStack;
+	iStack                  FRecursionStack;
+//   iStack                  FLocalVarsStack;
+	clVarSymbols            FLocalVars;
+	int                     FInstructionPointer;
+	/// instructions are executed in place, handlers may patch the operands of the current one
+	sInstruction*           FCurrentInstructionPtr;
+	void*                   FCurrentNativeObject;
+	iStaticClass*           FCurrentStaticClass;
+	clParametersList*       FCurrentParameters;
+	clCodePatch*            FCurrentCodePatch;
+	clScriptMethod*         FCurrentMethod;
+	int                     FMaxInstructions;
+	clParamSymbols          FParamSymbols;
+};
+
+/// Opcode handler, clCodePatch::Link() resolves one for every instruction
+typedef void ( clExecutionThread::*clOpCodeExecutor )();
+
 /// Code fragment within LinderScript virtual machine
 class scriptfinal clCodePatch: public iObject
 {
@@ -150,6 +237,10 @@ public:
 	noexport     LString*             GetStringPtr( int Index );
 	scriptmethod int                  GetStringsCount() const;
 	virtual      clInstructions&      GetInstructions() { return FInstructions; };
+	/// Handlers for each instruction or NULL if the code patch is not linked
+	noexport     const clOpCodeExecutor* GetExecutors() const { return ( !FExecutors.empty() && FExecutors.size() == FInstructions.size() ) ? &FExecutors[0] : NULL; }
+	/// Inline cache for the instruction or NULL if the code patch is not linked
+	noexport     sInlineCache*        GetInlineCache( int IP ) { return ( FInlineCaches.size() == FInstructions.size() ) ? &FInlineCaches[ IP ] : NULL; }
 	scriptmethod bool                 Link( LString& ErrorCode );
 
 	/// FIXME : the following two methods are 'virtual' to make them  exportable to .NET, but they are really only 'scriptmethod'.
@@ -179,67 +270,19 @@ private:
 	                                 sInstruction* OutInstruction );
 	/// remove Skip instructions starting from FromIP and update label tables
 	void    CollapseInstructions( int FromIP, int Skip );
+	/// resolve opcode handlers, so the VM does not index the executors table on every step, and reset inline caches
+	void    Predecode();
 private:
 	typedef std::map<LString, int> clLabelsTable;
 	clInstructions                 FInstructions;
+	std::vector<clOpCodeExecutor>  FExecutors;
+	std::vector<sInlineCache>      FInlineCaches;
 	LStr::clStringsVector          FStringTable;
 	LStr::clStringsVector          FLabelLinks;
 	/// map label names to IP jump offsets
 	clLabelsTable                  FLabelsTable;
 };
 
-/// LinderScript virtual machine execution thread
-class clExecutionThread
-{
-public:
-	EXCEPTIONABLE;
-	EXCEPTION( clExcept_InvalidOpCode, "Invalid opcode encountered while executing byte-code" );
-public:
-	clExecutionThread();
-	virtual ~clExecutionThread();
-	//
-	// iExecutionThread interface
-	//
-	scriptmethod iStack*  GetStack() { return &FStack; };
-	scriptmethod void     Execute( clScriptMethod* Method, clCodePatch* CodePatch, void* Self, clParametersList& Params );
-	static  void          ClearExecutionStats();
-	static  void          LogExecutionStats( sEnvironment* Env );
-	/// opcodes executors (autogenerated stuff)
-#  include "Generated/VM/ExecThread_MtdList.h"
-private:
-	// symbol stuff
-	// field handler
-	clFieldSymbolDeclaration* FFieldSymbol;
-	iSymbolDeclaration*       FindSymbol( const LString& SymbolName );
-private:
-	LString     ExtractString();
-	LString*    ExtractStringPtr();
-	void        RecursiveEnter();
-	void        RecursiveLeave();
-	void        CallMethod( iObject* NativeObject, iMethod* Method, int Inherited );
-	void        UndeclareVars();
-private:
-	typedef std::vector<clParamSymbolDeclaration*> clParamSymbols;
-	typedef std::vector<clVarSymbolDeclaration*> clVarSymbols;
-public:
-	sEnvironment* Env;
-private:
-	iStack                  FStack;
-	iStack                  FRecursionStack;
-//   iStack                  FLocalVarsStack;
-	clVarSymbols            FLocalVars;
-	int                     FInstructionPointer;
-	sInstruction            FCurrentInstruction;
-	sInstruction*           FCurrentInstructionPtr;
-	void*                   FCurrentNativeObject;
-	iStaticClass*           FCurrentStaticClass;
-	clParametersList*       FCurrentParameters;
-	clCodePatch*            FCurrentCodePatch;
-	clScriptMethod*         FCurrentMethod;
-	int                     FMaxInstructions;
-	clParamSymbols          FParamSymbols;
-};
-
 class scriptfinal clScriptField : public iField
 {
 public:
@@ -419,6 +462,9 @@ public:
 #endif
 
 /*
+ * 17/10/2026
+     Inline caches for field accesses and method calls
+     clExecutionThread executes instructions in place, predecoded opcode handlers
  * 15/12/2010
      vector<string> instead of string in Assemble()
  * 09/03/2010
@@ -16,6 +16,7 @@
 #include "Core/VFS/Archive.h"
 
 #include "Utils/LBlob.h"
+#include "Math/LHash.h"
 
 #include "SysEnv.h"
 
@@ -37,15 +38,15 @@ bool clArchiveReader::CloseArchive()
 
 	FAbortScanningFlag = 0;
 
+	/// Clear data cache
+	ClearExtracted();
+
 	/// Clear info containers
 	FFileInfos.clear();
 	FFileInfoIdx.clear();
 	FFileNames.clear();
 	FRealFileNames.clear();
 
-	/// Clear data cache
-	ClearExtracted();
-
 	/// Close the source stream
 	if ( FOwnsSourceFile ) { if ( FSourceFile ) { FSourceFile->DisposeObject(); } }
 
@@ -101,6 +102,8 @@ bool clArchiveReader::EnumerateFiles()
 	/// When all else fails
 	if ( !Res ) { Env->Logger->LogP( L_WARNING, "Unknown archive type in file %s", TheName.c_str() ); }
 
+	BuildFileIndex();
+
 	/// Inform our mount point that we are done
 	if ( FCompletionFlag ) { *FCompletionFlag = true; }
 
@@ -288,6 +291,9 @@ bool clArchiveReader::Enumerate_ZIP()
 
 		if ( err != UNZ_OK ) { /* printf("error %d with zipfile in unzGetCurrentFileInfo\n",err);*/ break; }
 
+		unz64_file_pos EntryPos;
+		unzGetFilePos64( uf, &EntryPos );
+
 		if ( ( i + 1 ) < gi.number_entry )
 		{
 			err = unzGoToNextFile( uf );
@@ -311,9 +317,10 @@ bool clArchiveReader::Enumerate_ZIP()
 		Info.FCompressedSize = file_info.compressed_size;
 		Info.FSize = file_info.uncompressed_size;
 		Info.FTimeStamp = ( _y << 25 ) | ( _m << 21 ) | ( _d << 16 ) | ( _H << 11 ) | ( _M << 5 );
+		Info.FEntryPos = EntryPos.pos_in_zip_directory;
+		Info.FEntryNumber = EntryPos.num_of_file;
 
 		FFileInfos.push_back( Info );
-		FFileInfoIdx[TheName] = ( int )FFileNames.size();
 		FFileNames.push_back( TheName );
 		FRealFileNames.push_back( LString( filename_inzip ) );
 	}
@@ -332,6 +339,257 @@ bool clArchiveReader::Enumerate_ZIP()
 	return true;
 }
 
+/**
+   Sequential reader of a single .zip entry.
+
+   The entry is inflated on demand into a window of STREAM_WINDOW_SIZE bytes. Forward seeks
+   decompress and drop the skipped data, backward seeks restart decompression from the beginning
+   of the entry, so streams should be consumed sequentially for the best performance.
+**/
+class scriptfinal clArchiveStream: public iIStream
+{
+public:
+	clArchiveStream( clArchiveReader* Reader, int Idx )
+		: FArchiveReader( Reader ),
+		  FIdx( Idx ),
+		  FSource( NULL ),
+		  FZipFile( NULL ),
+		  FSize( Reader->FFileInfos[Idx].FSize ),
+		  FPosition( 0 ),
+		  FWindowStart( 0 ),
+		  FWindowSize( 0 ),
+		  FDecodedSize( 0 ),
+		  FWindow( clArchiveReader::STREAM_WINDOW_SIZE )
+	{
+	}
+
+	virtual ~clArchiveStream()
+	{
+		CloseEntry();
+
+		if ( FSource ) { FSource->DisposeObject(); }
+	}
+
+	/// Open own reader of the archive and locate the entry
+	bool Open( const LString& FileName )
+	{
+		FFileName = FileName;
+
+		FSource = Env->FileSystem->CreateFileReader( FArchiveReader->GetSourceFile()->GetVirtualFileName() );
+
+		if ( !FSource ) { return false; }
+
+		zlib_filefunc64_def ffunc;
+		fill_fopen64_L_readfilefunc( FSource, &ffunc );
+
+		FZipFile = unzOpen2_64( "", &ffunc );
+
+		return FZipFile && RewindEntry();
+	}
+
+	//
+	// iIStream interface
+	//
+	virtual LString        GetVirtualFileName() const { return FFileName; }
+	virtual LString        GetFileName() const { return FFileName; }
+
+	virtual void           Seek( const Luint64 Position )     { FPosition  = Position; }
+	virtual void           SeekOffset( const Luint64 Offset ) { FPosition += Offset;   }
+
+	virtual void           BlockRead( void* Buf, const Luint64 Size )
+	{
+		RAISE_MSG_IF( Size + FPosition > FSize,
+		              clExcept_ReadingPastEndOfFile,
+		              LString( "\"" ) + FFileName + "\" (FSize = " + LStr::ToStr( FSize ) + ", ReadPos = " + LStr::ToStr( FPosition ) + ", ReadSize = " + LStr::ToStr( Size ) + ")" );
+
+		Lubyte* Out = static_cast<Lubyte*>( Buf );
+		Luint64 Left = Size;
+
+		while ( Left > 0 )
+		{
+			RAISE_MSG_IF( !FillWindow(), clExcept_ReadingPastEndOfFile, LString( "\"" ) + FFileName + "\" is corrupted" );
+
+			Luint64 Offset = FPosition - FWindowStart;
+			Luint64 Chunk  = FWindowSize - Offset;
+
+			if ( Chunk > Left ) { Chunk = Left; }
+
+			memcpy( Out, &FWindow[ static_cast<size_t>( Offset ) ], static_cast<size_t>( Chunk ) );
+
+			Out       += Chunk;
+			Left      -= Chunk;
+			FPosition += Chunk;
+		}
+	}
+
+	virtual LString        ReadLine()
+	{
+		return ReadLineInternal( false );
+	}
+
+	virtual LString        ReadLineLength()
+	{
+		Luint64 Length = ReadInt_Binary();
+
+		/// don't read anything beyond EOF
+		if ( FPosition + Length > FSize ) { Length = FSize - FPosition; }
+
+		LString Result( static_cast<size_t>( Length ), '\0' );
+
+		if ( Length > 0 ) { BlockRead( &Result[0], Length ); }
+
+		return Result;
+	}
+
+	virtual LString        ReadLineTrimLeadSpaces()
+	{
+		return ReadLineInternal( true );
+	}
+
+	virtual int            ReadInt_Binary()
+	{
+		int Int;
+
+		BlockRead( &Int, sizeof( Int ) );
+
+		return Int;
+	}
+
+	virtual bool           Eof() const { return ( FPosition >= FSize ); }
+
+	virtual Luint64        GetFileSize() const { return FSize; }
+	virtual Luint64        GetFilePos() const { return FPosition; }
+
+	/// The entry is never materialized in memory
+	virtual const Lubyte*  MapStream() const { return NULL; }
+	virtual const Lubyte*  MapStreamFromCurrentPos() const { return NULL; }
+
+private:
+	void CloseEntry()
+	{
+		if ( !FZipFile ) { return; }
+
+		unzCloseCurrentFile( FZipFile );
+		unzClose( FZipFile );
+
+		FZipFile = NULL;
+	}
+
+	/// Restart decompression from the beginning of the entry
+	bool RewindEntry()
+	{
+		unzCloseCurrentFile( FZipFile );
+
+		const clArchiveReader::sFileInfo& Info = FArchiveReader->FFileInfos[FIdx];
+
+		unz64_file_pos EntryPos;
+		EntryPos.pos_in_zip_directory = Info.FEntryPos;
+		EntryPos.num_of_file          = Info.FEntryNumber;
+
+		FWindowStart = 0;
+		FWindowSize  = 0;
+		FDecodedSize = 0;
+
+		if ( unzGoToFilePos64( FZipFile, &EntryPos ) != UNZ_OK ) { return false; }
+
+		return unzOpenCurrentFile( FZipFile ) == UNZ_OK;
+	}
+
+	/// Make sure the window contains the byte at FPosition
+	bool FillWindow()
+	{
+		if ( FPosition >= FWindowStart && FPosition < FWindowStart + FWindowSize ) { return true; }
+
+		if ( FPosition < FWindowStart && !RewindEntry() ) { return false; }
+
+		while ( FPosition >= FDecodedSize )
+		{
+			int Read = unzReadCurrentFile( FZipFile, &FWindow[0], static_cast<unsigned>( FWindow.size() ) );
+
+			if ( Read <= 0 )
+			{
+				Env->Logger->LogP( L_WARNING, "error %d while inflating %s", Read, FFileName.c_str() );
+				return false;
+			}
+
+			FWindowStart  = FDecodedSize;
+			FWindowSize   = static_cast<size_t>( Read );
+			FDecodedSize += Read;
+		}
+
+		return true;
+	}
+
+	LString ReadLineInternal( bool TrimLeadSpaces )
+	{
+		LString Line;
+
+		bool Leading = TrimLeadSpaces;
+
+		while ( FPosition < FSize && FillWindow() )
+		{
+			char Ch = static_cast<char>( FWindow[ static_cast<size_t>( FPosition - FWindowStart ) ] );
+
+			FPosition++;
+
+			if ( Leading && LStr::IsSeparator( Ch ) ) { continue; }
+
+			Leading = false;
+
+			if ( Ch == 13 ) { continue; }   // kill char
+
+			if ( Ch == 10 ) { break; }
+
+			Line.push_back( Ch );
+		}
+
+		return Line;
+	}
+
+private:
+	clArchiveReader*    FArchiveReader;
+	int                 FIdx;
+	LString             FFileName;
+
+	/// Own reader of the archive file
+	iIStream*           FSource;
+	unzFile             FZipFile;
+
+	Luint64             FSize;
+	Luint64             FPosition;
+
+	/// Offset of FWindow[0] in the entry
+	Luint64             FWindowStart;
+	size_t              FWindowSize;
+
+	/// Number of bytes inflated since the last rewind
+	Luint64             FDecodedSize;
+
+	std::vector<Lubyte> FWindow;
+};
+
+iIStream* clArchiveReader::CreateEntryStream( int Idx, const LString& StreamName )
+{
+	if ( FArchiveType != ARCH_ZIP ) { return NULL; }
+
+	if ( Idx < 0 || Idx >= static_cast<int>( FFileInfos.size() ) ) { return NULL; }
+
+	clArchiveStream* Stream = new clArchiveStream( this, Idx );
+	Stream->Env = Env;
+	Stream->AfterConstruction();
+
+	if ( !Stream->Open( StreamName.empty() ? FRealFileNames[Idx] : StreamName ) )
+	{
+		Env->Logger->LogP( L_WARNING, "Unable to open %s for streaming", FRealFileNames[Idx].c_str() );
+
+		Stream->DisposeObject();
+
+		return NULL;
+	}
+
+	return Stream;
+}
+
 /// end of .ZIP stuff
 
 bool clArchiveReader::ExtractSingleFile( const LString& FName, const LString& Password, int* AbortFlag, float* Progress, iOStream* FOut )
@@ -380,11 +638,198 @@ bool clArchiveReader::ExtractSingleFile( const LString& FName, const LString& Pa
 	return ( err == UNZ_OK );
 }
 
-const void* clArchiveReader::GetFileData_ZIP( size_t idx )
+void clArchiveReader::BuildFileIndex()
+{
+	/// keep the load factor at most 1/2
+	size_t NumSlots = 16;
+
+	while ( NumSlots < FFileNames.size() * 2 ) { NumSlots *= 2; }
+
+	FFileInfoIdx.assign( NumSlots, -1 );
+
+	for ( size_t i = 0; i != FFileNames.size(); i++ )
+	{
+		size_t Slot = Linderdaum::Math::HashStringFNV1a( FFileNames[i].c_str() ) & ( NumSlots - 1 );
+
+		/// duplicate names: the last entry wins
+		while ( FFileInfoIdx[Slot] > -1 && FFileNames[ FFileInfoIdx[Slot] ] != FFileNames[i] ) { Slot = ( Slot + 1 ) & ( NumSlots - 1 ); }
+
+		FFileInfoIdx[Slot] = static_cast<int>( i );
+	}
+
+	FExtracted.clear();
+	FExtracted.resize( FFileInfos.size() );
+
+	for ( size_t i = 0; i != FExtracted.size(); i++ )
+	{
+		FExtracted[i].FData     = NULL;
+		FExtracted[i].FSize     = 0;
+		FExtracted[i].FPinCount = 0;
+		FExtracted[i].FLRUPos   = FLRU.end();
+	}
+}
+
+int clArchiveReader::GetFileIdx( const LString& FileName ) const
+{
+	if ( FFileInfoIdx.empty() ) { return -1; }
+
+	size_t Mask = FFileInfoIdx.size() - 1;
+	size_t Slot = Linderdaum::Math::HashStringFNV1a( FileName.c_str() ) & Mask;
+
+	for ( int Idx = FFileInfoIdx[Slot]; Idx > -1; Idx = FFileInfoIdx[Slot] )
+	{
+		if ( FFileNames[Idx] == FileName ) { return Idx; }
+
+		Slot = ( Slot + 1 ) & Mask;
+	}
+
+	return -1;
+}
+
+const void* clArchiveReader::AcquireFileData( int Idx )
 {
-	/// sanity check
-	if ( FExtractedFromArchive.count( ( int )idx ) > 0 ) { return FExtractedFromArchive[( int )idx]; }
+	if ( Idx < 0 || Idx >= static_cast<int>( FFileInfos.size() ) ) { return NULL; }
+
+	/// .tar and .rar entries are stored uncompressed and mapped directly
+	if ( FArchiveType != ARCH_ZIP ) { return GetFileData_TAR_or_RAR( Idx ); }
+
+	{
+		LMutex Lock( &FCacheMutex );
+
+		sExtractedFile& Entry = FExtracted[Idx];
+
+		if ( Entry.FData )
+		{
+			FCacheStats.FHits++;
+
+			Entry.FPinCount++;
+
+			FLRU.splice( FLRU.begin(), FLRU, Entry.FLRUPos );
+
+			return Entry.FData;
+		}
+
+		FCacheStats.FMisses++;
+	}
+
+	/// decompress without holding the lock, so other threads can read cached entries meanwhile
+	const void* DataPtr = GetFileData_ZIP( Idx );
+
+	if ( !DataPtr ) { return NULL; }
+
+	LMutex Lock( &FCacheMutex );
+
+	sExtractedFile& Entry = FExtracted[Idx];
+
+	if ( Entry.FData )
+	{
+		/// another thread has decompressed the same entry concurrently
+		FreeData( const_cast<void*>( DataPtr ) );
+
+		Entry.FPinCount++;
+
+		FLRU.splice( FLRU.begin(), FLRU, Entry.FLRUPos );
 
+		return Entry.FData;
+	}
+
+	Entry.FData     = DataPtr;
+	Entry.FSize     = static_cast<size_t>( FFileInfos[Idx].FSize );
+	Entry.FPinCount = 1;
+	Entry.FLRUPos   = FLRU.insert( FLRU.begin(), Idx );
+
+	FCachedBytes += Entry.FSize;
+
+	if ( FCachedBytes > FCacheStats.FPeakBytes ) { FCacheStats.FPeakBytes = FCachedBytes; }
+
+	EvictExtracted_NoLock();
+
+	return DataPtr;
+}
+
+void clArchiveReader::ReleaseFileData( int Idx )
+{
+	if ( FArchiveType != ARCH_ZIP ) { return; }
+
+	if ( Idx < 0 || Idx >= static_cast<int>( FExtracted.size() ) ) { return; }
+
+	LMutex Lock( &FCacheMutex );
+
+	sExtractedFile& Entry = FExtracted[Idx];
+
+	if ( Entry.FPinCount > 0 ) { Entry.FPinCount--; }
+
+	if ( Entry.FPinCount == 0 ) { EvictExtracted_NoLock(); }
+}
+
+void clArchiveReader::SetCacheBudget( size_t Bytes )
+{
+	LMutex Lock( &FCacheMutex );
+
+	FCacheBudget = Bytes;
+
+	EvictExtracted_NoLock();
+}
+
+clArchiveReader::sCacheStats clArchiveReader::GetCacheStats() const
+{
+	LMutex Lock( &FCacheMutex );
+
+	return FCacheStats;
+}
+
+void clArchiveReader::EvictExtracted_NoLock()
+{
+	std::list<int>::iterator i = FLRU.end();
+
+	while ( FCachedBytes > FCacheBudget && i != FLRU.begin() )
+	{
+		--i;
+
+		sExtractedFile& Entry = FExtracted[*i];
+
+		if ( Entry.FPinCount > 0 ) { continue; }
+
+		FreeData( const_cast<void*>( Entry.FData ) );
+
+		FCachedBytes -= Entry.FSize;
+
+		Entry.FData   = NULL;
+		Entry.FSize   = 0;
+		Entry.FLRUPos = FLRU.end();
+
+		i = FLRU.erase( i );
+
+		FCacheStats.FEvictions++;
+	}
+}
+
+void clArchiveReader::ClearExtracted()
+{
+	LMutex Lock( &FCacheMutex );
+
+	if ( FCacheStats.FHits + FCacheStats.FMisses > 0 )
+	{
+		Env->Logger->LogP( L_DEBUG, "Archive cache: %i hits, %i misses, %i evictions, peak %i Kb",
+		                   static_cast<int>( FCacheStats.FHits ), static_cast<int>( FCacheStats.FMisses ),
+		                   static_cast<int>( FCacheStats.FEvictions ), static_cast<int>( FCacheStats.FPeakBytes / 1024 ) );
+	}
+
+	/// Other archive types do not decompress and allocate additional buffers
+	for ( std::vector<sExtractedFile>::iterator i = FExtracted.begin(); i != FExtracted.end(); ++i )
+	{
+		if ( i->FData ) { FreeData( const_cast<void*>( i->FData ) ); }
+	}
+
+	FExtracted.clear();
+	FLRU.clear();
+
+	FCachedBytes = 0;
+	FCacheStats  = sCacheStats();
+}
+
+const void* clArchiveReader::GetFileData_ZIP( size_t idx )
+{
 	clMemFileWriter* FOut = Env->FileSystem->CreateMemFileWriter( "mem_blob", FFileInfos[idx].FSize );
 
 	void* DataPtr = NULL;
@@ -546,7 +991,6 @@ bool clArchiveReader::Enumerate_RAR()
 
 				LString TheName = LStr::GetUpper( Name );
 				FFileInfos.push_back( Info );
-				FFileInfoIdx[TheName] = ( int )FFileNames.size();
 				FFileNames.push_back( TheName );
 
 				Env->Logger->Log( L_PARANOID, "File: " + Name );
@@ -739,8 +1183,6 @@ bool clArchiveReader::Enumerate_TAR()
 
 			TheName = LStr::GetUpper( TheName );
 			FFileInfos.push_back( Info );
-
-			FFileInfoIdx[TheName] = ( int )FFileNames.size();
 			FFileNames.push_back( TheName );
 
 			Ofs += RoundSize;
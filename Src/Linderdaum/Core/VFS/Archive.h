@@ -13,8 +13,9 @@
 #define __archive__h__included__
 
 #include "Core/iObject.h"
+#include "Utils/Mutex.h"
 
-#include <map>
+#include <list>
 
 class iIStream;
 class iOStream;
@@ -55,6 +56,12 @@ enum LArchiveType
 
    Since Open() can be a lenghty operation, we provide the information
    in FScanProgress variable and FAbortFlag can terminate the scanning before it is finished.
+
+   Entry names are looked up in an open-addressing hash index built after enumeration.
+   Decompressed .zip entries are kept in a byte-budgeted LRU cache. Every user of the data
+   pins the entry with AcquireFileData() and unpins it with ReleaseFileData(), only unpinned
+   entries are evicted. Lookups and data access are thread-safe once the archive is opened,
+   decompression itself is done outside of the cache lock.
 */
 class scriptfinal netexportable clArchiveReader: public iObject
 {
@@ -76,6 +83,12 @@ private:
 
 		/// Compressed data
 		void* FSourceData;
+
+		/// Position of the .zip central directory record, used to reopen the entry without a name lookup
+		Luint64 FEntryPos;
+
+		/// Index of the .zip central directory record
+		Luint64 FEntryNumber;
 	};
 
 	/// File information
@@ -87,8 +100,8 @@ private:
 	/// Real (in-archive) file names
 	std::vector<LString>   FRealFileNames;
 
-	/// File information indices (name to index map)
-	mutable std::map<LString, int> FFileInfoIdx;
+	/// Open-addressing (linear probing) hash index over FFileNames, -1 marks an empty slot
+	std::vector<int>       FFileInfoIdx;
 
 	/// Source file
 	iIStream* FSourceFile;
@@ -100,7 +113,8 @@ private:
 	LArchiveType FArchiveType;
 
 public:
-	clArchiveReader(): FCompletionFlag( NULL ), FSourceFile( NULL ), FOwnsSourceFile( false ), FArchiveType( ARCH_INVALID ) {}
+	clArchiveReader(): FCompletionFlag( NULL ), FSourceFile( NULL ), FOwnsSourceFile( false ), FArchiveType( ARCH_INVALID ),
+		FCacheBudget( DEFAULT_CACHE_BUDGET ), FCachedBytes( 0 ), FCacheStats() {}
 	virtual ~clArchiveReader() { CloseArchive(); }
 
 	/// Assign the source stream and set the internal ownership flag
@@ -140,35 +154,30 @@ public:
 		return ( idx > -1 ) ? FFileInfos[idx].FSize : 0;
 	}
 
-	/// Get the data for this file
+	/// Get the data for this file. The data is pinned in the cache until CloseArchive(), prefer AcquireFileData()
 	const void*   GetFileData( const LString& FileName )
 	{
-		int idx = GetFileIdx( FileName );
-		const void* DataPtr = NULL;
-
-		if ( idx > -1 )
-		{
-			/// Check if we already have this data in cache
-			if ( FExtractedFromArchive.count( idx ) > 0 ) { return FExtractedFromArchive[idx]; }
-
-			/// Decompress/extract the data
-			switch ( FArchiveType )
-			{
-				case ARCH_TAR:
-				case ARCH_RAR:
-					DataPtr = GetFileData_TAR_or_RAR( idx );
-					break;
-				case ARCH_ZIP:
-					DataPtr = GetFileData_ZIP( idx );
-					break;
-			}
-
-			if ( DataPtr ) { FExtractedFromArchive[idx] = DataPtr; }
-		}
-
-		return DataPtr;
+		return AcquireFileData( GetFileIdx( FileName ) );
 	}
 
+	/// Get the data for the file and pin it in the cache. Each successful call must be paired with ReleaseFileData()
+	const void*   AcquireFileData( int Idx );
+
+	/// Unpin the data returned by AcquireFileData(), it may be evicted afterwards
+	void          ReleaseFileData( int Idx );
+
+	/**
+	   Create a sequential reader which inflates a .zip entry in STREAM_WINDOW_SIZE windows.
+	   Memory usage does not depend on the entry size and nothing is put into the cache.
+	   The stream has its own source reader, so it can be used from any thread.
+	   MapStream() is not available for such streams. Returns NULL for other archive types,
+	   their entries are stored uncompressed and are mapped directly.
+	   StreamName is reported by GetFileName(), the in-archive name is used if it is empty.
+	**/
+	iIStream*     CreateEntryStream( int Idx, const LString& StreamName );
+
+	static const size_t STREAM_WINDOW_SIZE = 64 * 1024;
+
 	/// Get the extracted timestamp for this file
 	scriptmethod Luint64 GetFileTime( const LString& FileName ) const
 	{
@@ -177,7 +186,7 @@ public:
 	}
 
 	/// Convert file name to an internal linear index
-	scriptmethod int     GetFileIdx( const LString& FileName ) const { return ( FFileInfoIdx.count( FileName ) > 0 ) ? FFileInfoIdx[FileName] : -1; }
+	scriptmethod int     GetFileIdx( const LString& FileName ) const;
 
 	/// Get the number of files in archive
 	scriptmethod size_t  GetNumFiles() const { return FFileInfos.size(); }
@@ -185,6 +194,29 @@ public:
 	/// Get i-th file name in archive
 	scriptmethod LString GetFileName( Luint idx ) { return FFileNames[idx]; }
 
+#pragma region Decompression cache
+
+	/// Cache usage counters
+	struct sCacheStats
+	{
+		sCacheStats(): FHits( 0 ), FMisses( 0 ), FEvictions( 0 ), FPeakBytes( 0 ) {}
+
+		Luint64 FHits;
+		Luint64 FMisses;
+		Luint64 FEvictions;
+		size_t  FPeakBytes;
+	};
+
+	static const size_t DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024;
+
+	/// Set the maximal amount of decompressed data kept in memory (pinned entries may exceed it)
+	scriptmethod void    SetCacheBudget( size_t Bytes );
+	scriptmethod size_t  GetCacheBudget() const { return FCacheBudget; }
+	scriptmethod size_t  GetCachedBytes() const { return FCachedBytes; }
+	sCacheStats          GetCacheStats() const;
+
+#pragma endregion
+
 #pragma region Contents scanning
 
 	/**
@@ -214,30 +246,46 @@ private:
 	bool Enumerate_RAR();
 	bool Enumerate_ZIP();
 
+	/// Build FFileInfoIdx from FFileNames
+	void BuildFileIndex();
+
 	const void* GetFileData_TAR_or_RAR( size_t idx );
 	const void* GetFileData_ZIP( size_t idx );
 
-	/// Remove each extracted file from tmp container
-	void ClearExtracted()
-	{
-		/// Other archive types do not decompress and allocate additional buffers
-		if ( FArchiveType == ARCH_ZIP )
-		{
-			for ( std::map<int, const void*>::iterator i = FExtractedFromArchive.begin() ; i != FExtractedFromArchive.end() ; i++ )
-			{
-				this->FreeData( const_cast<void*>( i->second ) );
-			}
-		}
-
-		FExtractedFromArchive.clear();
-	}
+	/// Free all unpinned entries and reset the cache
+	void ClearExtracted();
+
+	/// Free least recently used unpinned entries until the cache fits the budget
+	void EvictExtracted_NoLock();
 
 	inline void* AllocData( size_t Sz ) { return ::malloc( Sz ); }
 
 	inline void FreeData( void* DataPtr ) { ::free( DataPtr ); }
 
-	/// Temporary cache for the extracted files. Removed on CloseArchive() call
-	std::map<int, const void*> FExtractedFromArchive;
+	/// Decompressed entry
+	struct sExtractedFile
+	{
+		const void* FData;
+		size_t      FSize;
+		/// number of AcquireFileData() calls without a matching ReleaseFileData()
+		int         FPinCount;
+		/// position in FLRU, most recently used entries are at the front
+		std::list<int>::iterator FLRUPos;
+	};
+
+	/// Cache of decompressed entries, indexed as FFileInfos. Only .zip entries are stored here
+	std::vector<sExtractedFile> FExtracted;
+
+	/// Indices of cached entries, most recently used first
+	std::list<int>              FLRU;
+
+	size_t                      FCacheBudget;
+	size_t                      FCachedBytes;
+	sCacheStats                 FCacheStats;
+
+	clMutex                     FCacheMutex;
+
+	friend class clArchiveStream;
 };
 
 #endif
@@ -0,0 +1,277 @@
+/**
+ * \file BinaryML.cpp
+ * \brief Binary XLML format: writer and zero-copy reader
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "BinaryML.h"
+#include "Core/VFS/iIStream.h"
+
+#include <map>
+#include <cstring>
+
+namespace
+{
+	const char ML_BINARY_MAGIC[4] = { 'L', 'B', 'M', 'L' };
+
+	/// Builds the string table, every distinct string is stored once
+	class clStringTableBuilder
+	{
+	public:
+		clStringTableBuilder(): FCharsSize( 0 ) {}
+
+		Luint32 Add( const LString& Str )
+		{
+			std::map<LString, Luint32>::const_iterator i = FIndices.find( Str );
+
+			if ( i != FIndices.end() ) { return i->second; }
+
+			sBinaryMLString Entry;
+			Entry.FOffset = FCharsSize;
+			Entry.FLength = static_cast<Luint32>( Str.length() );
+
+			Luint32 Idx = static_cast<Luint32>( FStrings.size() );
+
+			FStrings.push_back( Entry );
+			FOrder.push_back( Str );
+			FIndices[ Str ] = Idx;
+
+			FCharsSize += Entry.FLength + 1;
+
+			return Idx;
+		}
+
+		std::map<LString, Luint32>   FIndices;
+		std::vector<sBinaryMLString> FStrings;
+		std::vector<LString>         FOrder;
+		Luint32                      FCharsSize;
+	};
+
+	template <class T> inline void AppendData( std::vector<Lubyte>* Out, const T* Data, size_t Count )
+	{
+		if ( !Count ) { return; }
+
+		const Lubyte* Ptr = reinterpret_cast<const Lubyte*>( Data );
+
+		Out->insert( Out->end(), Ptr, Ptr + Count * sizeof( T ) );
+	}
+}
+
+#pragma region clBinaryMLNodeRef
+
+const char* clBinaryMLNodeRef::GetID() const
+{
+	return FDocument->FChars + FDocument->FStrings[ FNode->FID ].FOffset;
+}
+
+size_t clBinaryMLNodeRef::GetIDLength() const
+{
+	return FDocument->FStrings[ FNode->FID ].FLength;
+}
+
+const char* clBinaryMLNodeRef::GetValue() const
+{
+	return FDocument->FChars + FDocument->FStrings[ FNode->FValue ].FOffset;
+}
+
+size_t clBinaryMLNodeRef::GetValueLength() const
+{
+	return FDocument->FStrings[ FNode->FValue ].FLength;
+}
+
+bool clBinaryMLNodeRef::IsID( const char* ID ) const
+{
+	const sBinaryMLString& Str = FDocument->FStrings[ FNode->FID ];
+
+	return ::strncmp( FDocument->FChars + Str.FOffset, ID, Str.FLength ) == 0 && ID[ Str.FLength ] == 0;
+}
+
+clBinaryMLNodeRef clBinaryMLNodeRef::GetChild( size_t i ) const
+{
+	return clBinaryMLNodeRef( FDocument, FDocument->FNodes + FNode->FFirstChild + i );
+}
+
+clBinaryMLNodeRef clBinaryMLNodeRef::FindChild( const char* ID ) const
+{
+	for ( size_t i = 0; i != FNode->FNumChildren; i++ )
+	{
+		clBinaryMLNodeRef Child = GetChild( i );
+
+		if ( Child.IsID( ID ) ) { return Child; }
+	}
+
+	return clBinaryMLNodeRef();
+}
+
+mlNode* clBinaryMLNodeRef::ToNode() const
+{
+	mlNode* Node = new mlNode( LString( GetID(), GetIDLength() ), LString( GetValue(), GetValueLength() ) );
+
+	Node->isSection     = IsSection();
+	Node->isQuotedParam = IsQuotedParam();
+
+	Node->children.reserve( FNode->FNumChildren );
+
+	for ( size_t i = 0; i != FNode->FNumChildren; i++ )
+	{
+		Node->children.push_back( GetChild( i ).ToNode() );
+	}
+
+	return Node;
+}
+
+#pragma endregion
+
+#pragma region clBinaryMLDocument
+
+clBinaryMLDocument::clBinaryMLDocument()
+	: FNodes( NULL ),
+	  FStrings( NULL ),
+	  FChars( NULL ),
+	  FNumNodes( 0 ),
+	  FStream( NULL )
+{
+}
+
+clBinaryMLDocument::~clBinaryMLDocument()
+{
+	Close();
+}
+
+void clBinaryMLDocument::Close()
+{
+	if ( FStream ) { FStream->DisposeObject(); }
+
+	FNodes    = NULL;
+	FStrings  = NULL;
+	FChars    = NULL;
+	FNumNodes = 0;
+	FStream   = NULL;
+}
+
+bool clBinaryMLDocument::IsBinaryML( const void* Data, size_t Size )
+{
+	return Data && Size >= sizeof( sBinaryMLHeader ) && ::memcmp( Data, ML_BINARY_MAGIC, sizeof( ML_BINARY_MAGIC ) ) == 0;
+}
+
+bool clBinaryMLDocument::Open( const void* Data, size_t Size )
+{
+	Close();
+
+	if ( !IsBinaryML( Data, Size ) ) { return false; }
+
+	const Lubyte* Bytes = static_cast<const Lubyte*>( Data );
+
+	const sBinaryMLHeader* Header = reinterpret_cast<const sBinaryMLHeader*>( Bytes );
+
+	if ( Header->FVersion != ML_BINARY_VERSION || Header->FNumNodes == 0 ) { return false; }
+
+	/// validate everything once, so the node references do not need any checks
+	Luint64 NodesEnd   = static_cast<Luint64>( Header->FNodesOffset ) + static_cast<Luint64>( Header->FNumNodes ) * sizeof( sBinaryMLNode );
+	Luint64 StringsEnd = static_cast<Luint64>( Header->FStringsOffset ) + static_cast<Luint64>( Header->FNumStrings ) * sizeof( sBinaryMLString );
+	Luint64 CharsEnd   = static_cast<Luint64>( Header->FCharsOffset ) + Header->FCharsSize;
+
+	if ( NodesEnd > Size || StringsEnd > Size || CharsEnd > Size ) { return false; }
+
+	const sBinaryMLNode*   Nodes   = reinterpret_cast<const sBinaryMLNode*>( Bytes + Header->FNodesOffset );
+	const sBinaryMLString* Strings = reinterpret_cast<const sBinaryMLString*>( Bytes + Header->FStringsOffset );
+	const char*            Chars   = reinterpret_cast<const char*>( Bytes + Header->FCharsOffset );
+
+	for ( Luint32 i = 0; i != Header->FNumStrings; i++ )
+	{
+		Luint64 End = static_cast<Luint64>( Strings[i].FOffset ) + Strings[i].FLength;
+
+		if ( End >= Header->FCharsSize || Chars[ End ] != 0 ) { return false; }
+	}
+
+	for ( Luint32 i = 0; i != Header->FNumNodes; i++ )
+	{
+		const sBinaryMLNode& Node = Nodes[i];
+
+		if ( Node.FID >= Header->FNumStrings || Node.FValue >= Header->FNumStrings ) { return false; }
+
+		/// children always follow the parent, this also rules out cycles
+		if ( Node.FNumChildren > 0 &&
+		     ( Node.FFirstChild <= i || static_cast<Luint64>( Node.FFirstChild ) + Node.FNumChildren > Header->FNumNodes ) ) { return false; }
+	}
+
+	FNodes    = Nodes;
+	FStrings  = Strings;
+	FChars    = Chars;
+	FNumNodes = Header->FNumNodes;
+
+	return true;
+}
+
+bool clBinaryMLDocument::OpenStream( iIStream* Stream )
+{
+	Close();
+
+	if ( !Stream ) { return false; }
+
+	if ( !Open( Stream->MapStream(), static_cast<size_t>( Stream->GetFileSize() ) ) )
+	{
+		Stream->DisposeObject();
+
+		return false;
+	}
+
+	FStream = Stream;
+
+	return true;
+}
+
+void clBinaryMLDocument::Write( mlNode* Root, std::vector<Lubyte>* Out )
+{
+	/// lay out the nodes breadth-first, so the children of every node are contiguous
+	std::vector<mlNode*>       Order( 1, Root );
+	std::vector<sBinaryMLNode> Nodes;
+	clStringTableBuilder       Strings;
+
+	for ( size_t i = 0; i != Order.size(); i++ )
+	{
+		mlNode* N = Order[i];
+
+		sBinaryMLNode Node;
+		Node.FID          = Strings.Add( N->getID() );
+		Node.FValue       = Strings.Add( N->getValue() );
+		Node.FFirstChild  = static_cast<Luint32>( Order.size() );
+		Node.FNumChildren = static_cast<Luint32>( N->children.size() );
+		Node.FFlags       = ( N->isSection ? ML_BINARY_SECTION : 0 ) | ( N->isQuotedParam ? ML_BINARY_QUOTED : 0 );
+
+		Nodes.push_back( Node );
+
+		Order.insert( Order.end(), N->children.begin(), N->children.end() );
+	}
+
+	sBinaryMLHeader Header;
+	::memcpy( Header.FMagic, ML_BINARY_MAGIC, sizeof( ML_BINARY_MAGIC ) );
+	Header.FVersion       = ML_BINARY_VERSION;
+	Header.FNumNodes      = static_cast<Luint32>( Nodes.size() );
+	Header.FNumStrings    = static_cast<Luint32>( Strings.FStrings.size() );
+	Header.FNodesOffset   = sizeof( sBinaryMLHeader );
+	Header.FStringsOffset = Header.FNodesOffset + Header.FNumNodes * sizeof( sBinaryMLNode );
+	Header.FCharsOffset   = Header.FStringsOffset + Header.FNumStrings * sizeof( sBinaryMLString );
+	Header.FCharsSize     = Strings.FCharsSize;
+
+	Out->clear();
+	Out->reserve( Header.FCharsOffset + Header.FCharsSize );
+
+	AppendData( Out, &Header, 1 );
+	AppendData( Out, &Nodes[0], Nodes.size() );
+	AppendData( Out, &Strings.FStrings[0], Strings.FStrings.size() );
+
+	for ( std::vector<LString>::const_iterator i = Strings.FOrder.begin(); i != Strings.FOrder.end(); ++i )
+	{
+		AppendData( Out, i->c_str(), i->length() + 1 );
+	}
+}
+
+#pragma endregion
+
+/*
+ * 17/10/2026
+     It's here
+*/
@@ -0,0 +1,147 @@
+/**
+ * \file BinaryML.h
+ * \brief Binary XLML format: writer and zero-copy reader
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _BinaryML_
+#define _BinaryML_
+
+#include "Platform.h"
+#include "ML.h"
+
+#include <vector>
+
+class iIStream;
+class clBinaryMLDocument;
+
+/**
+   Binary XLML file layout (little-endian, all offsets are from the beginning of the file):
+
+      sBinaryMLHeader
+      sBinaryMLNode   [FNumNodes]    - node 0 is the root, children of every node are stored contiguously
+      sBinaryMLString [FNumStrings]  - string table, every distinct ID or value is stored once
+      char            [FCharsSize]   - zero-terminated string contents
+
+   All the fields are 32-bit, so the structures have no padding.
+**/
+struct sBinaryMLHeader
+{
+	char    FMagic[4];
+	Luint32 FVersion;
+	Luint32 FNumNodes;
+	Luint32 FNumStrings;
+	Luint32 FNodesOffset;
+	Luint32 FStringsOffset;
+	Luint32 FCharsOffset;
+	Luint32 FCharsSize;
+};
+
+struct sBinaryMLString
+{
+	Luint32 FOffset;
+	Luint32 FLength;
+};
+
+struct sBinaryMLNode
+{
+	/// string table indices
+	Luint32 FID;
+	Luint32 FValue;
+	/// index of the first child node
+	Luint32 FFirstChild;
+	Luint32 FNumChildren;
+	/// combination of ML_BINARY_SECTION and ML_BINARY_QUOTED
+	Luint32 FFlags;
+};
+
+const Luint32 ML_BINARY_VERSION = 1;
+
+const Luint32 ML_BINARY_SECTION = 1;
+const Luint32 ML_BINARY_QUOTED  = 2;
+
+/**
+   \brief Lightweight reference to a node inside of the clBinaryMLDocument
+
+   IDs and values point directly into the document data and stay valid while the document is alive.
+**/
+class clBinaryMLNodeRef
+{
+public:
+	clBinaryMLNodeRef(): FDocument( NULL ), FNode( NULL ) {}
+	clBinaryMLNodeRef( const clBinaryMLDocument* Document, const sBinaryMLNode* Node ): FDocument( Document ), FNode( Node ) {}
+
+	inline bool        IsValid() const { return FNode != NULL; }
+
+	const char*        GetID() const;
+	size_t             GetIDLength() const;
+	const char*        GetValue() const;
+	size_t             GetValueLength() const;
+
+	/// compare ID without constructing any strings
+	bool               IsID( const char* ID ) const;
+
+	inline bool        IsSection() const { return ( FNode->FFlags & ML_BINARY_SECTION ) != 0; }
+	inline bool        IsQuotedParam() const { return ( FNode->FFlags & ML_BINARY_QUOTED ) != 0; }
+
+	inline size_t      GetNumChildren() const { return FNode->FNumChildren; }
+	clBinaryMLNodeRef  GetChild( size_t i ) const;
+
+	/// return the first child with the given ID or an invalid reference
+	clBinaryMLNodeRef  FindChild( const char* ID ) const;
+
+	/// build the heap mlNode tree for this node and all of its children
+	mlNode*            ToNode() const;
+private:
+	const clBinaryMLDocument* FDocument;
+	const sBinaryMLNode*      FNode;
+};
+
+/**
+   \brief Binary XLML document
+
+   Walks the binary data in place: nothing is parsed or copied when the document is opened,
+   the data is only validated once so the node references can skip the bounds checks.
+   The data is usually mapped from a file via iIStream::MapStream(), the document may own that stream.
+**/
+class clBinaryMLDocument
+{
+public:
+	clBinaryMLDocument();
+	~clBinaryMLDocument();
+
+	/// Attach to the memory block, the data must stay valid while the document is used
+	bool    Open( const void* Data, size_t Size );
+
+	/// Attach to the mapped stream. The stream is disposed by the document
+	bool    OpenStream( iIStream* Stream );
+
+	void    Close();
+
+	inline clBinaryMLNodeRef GetRoot() const { return FNodes ? clBinaryMLNodeRef( this, FNodes ) : clBinaryMLNodeRef(); }
+
+	inline size_t            GetNumNodes() const { return FNumNodes; }
+
+	/// Check if the memory block starts with the binary XLML signature
+	static bool   IsBinaryML( const void* Data, size_t Size );
+
+	/// Serialize the mlNode tree into Out
+	static void   Write( mlNode* Root, std::vector<Lubyte>* Out );
+private:
+	friend class clBinaryMLNodeRef;
+
+	const sBinaryMLNode*   FNodes;
+	const sBinaryMLString* FStrings;
+	const char*            FChars;
+	size_t                 FNumNodes;
+	iIStream*              FStream;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
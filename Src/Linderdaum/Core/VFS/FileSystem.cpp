@@ -56,6 +56,7 @@
 #endif
 
 #include "ML.h"
+#include "BinaryML.h"
 
 inline LString Arch_FixFileName( const LString& VirtualName )
 {
@@ -68,7 +69,21 @@ inline LString Arch_FixFileName( const LString& VirtualName )
 	return Name;
 }
 
-/// Implementation of a mount point for the uncompressed .RAR/.TAR files
+/// Archive entry data, pinned in the archive cache while the file is alive
+class scriptfinal clArchiveRAWFile: public clMemRAWFile
+{
+public:
+	clArchiveRAWFile( clArchiveReader* Reader, int Idx ): FArchiveReader( Reader ), FIdx( Idx ) {}
+	virtual ~clArchiveRAWFile()
+	{
+		if ( GetFileData() ) { FArchiveReader->ReleaseFileData( FIdx ); }
+	}
+private:
+	clArchiveReader* FArchiveReader;
+	int              FIdx;
+};
+
+/// Implementation of a mount point for the .RAR/.TAR/.ZIP files
 class scriptfinal clArchiveMP: public iMountPoint
 {
 public:
@@ -89,15 +104,17 @@ public:
 
 		LString FName = Arch_FixFileName( VirtualName );
 
-		clMemRAWFile* File = new clMemRAWFile();
+		int Idx = FArchiveReader->GetFileIdx( FName );
+
+		clArchiveRAWFile* File = new clArchiveRAWFile( FArchiveReader, Idx );
 		File->Env = Env;
 		File->AfterConstruction();
 
 		File->SetFileName( VirtualName );
 		File->SetVirtualFileName( VirtualName );
 
-		const void* DataPtr = FArchiveReader->GetFileData( FName );
-		Luint64 FileSize = FArchiveReader->GetFileSize( FName );
+		const void* DataPtr = FArchiveReader->AcquireFileData( Idx );
+		Luint64 FileSize = DataPtr ? FArchiveReader->GetFileSize( FName ) : 0;
 
 		File->CreateFromManagedBuffer( DataPtr, FileSize );
 
@@ -106,6 +123,18 @@ public:
 		return File;
 	}
 
+	virtual iIStream*    CreateStreamReader( const LString& VirtualName ) const
+	{
+		int Idx = FArchiveReader->GetFileIdx( Arch_FixFileName( VirtualName ) );
+
+		/// small entries are cheaper to decompress at once and keep in the archive cache
+		if ( Idx < 0 || FArchiveReader->GetFileSize( Arch_FixFileName( VirtualName ) ) < clArchiveReader::STREAM_WINDOW_SIZE ) { return NULL; }
+
+		Env->Logger->Log( L_PARANOID, "Streaming " + VirtualName + " from " + FArchiveReader->GetSourceFile()->GetFileName() );
+
+		return FArchiveReader->CreateEntryStream( Idx, VirtualName );
+	}
+
 	virtual bool         FileExistsAtThisPoint( const LString& VirtualName ) const
 	{
 //		WaitLoad();
@@ -1049,6 +1078,30 @@ iIStream* clFileSystem::CreateFileReader( const LString& FileName ) const
 	unguard();
 }
 
+iIStream* clFileSystem::CreateStreamReader( const LString& FileName ) const
+{
+	guard( "%s", FileName.c_str() );
+
+	if ( FileName.find( "RESOURCE:" ) != 0 )
+	{
+		LString Name = FileName;
+
+		LStr::ReplaceAll( &Name, '/', PATH_SEPARATOR );
+		LStr::ReplaceAll( &Name, '\\', PATH_SEPARATOR );
+		LString ReplFileName = clFileSystem::ReplaceEnvVars( Name );
+
+		iMountPoint* MountPoint = FindMountPoint( ReplFileName );
+
+		iIStream* Stream = MountPoint ? MountPoint->CreateStreamReader( ReplFileName ) : NULL;
+
+		if ( Stream ) { return Stream; }
+	}
+
+	return CreateFileReader( FileName );
+
+	unguard();
+}
+
 iIStream* clFileSystem::CreateFileReaderFromString( const LString& FileName, const LString& VirtualFileName, const LString& Str ) const
 {
 	clMemRAWFile* RAWFile = new clMemRAWFile();
@@ -1626,6 +1679,46 @@ bool clFileSystem::SaveXLMLToStream( mlNode* Node, iOStream* OStream ) const
 	return true;
 }
 
+bool clFileSystem::SaveBinaryML( mlNode* Node, const LString& FileName ) const
+{
+	iOStream* Stream = Env->FileSystem->CreateFileWriter ( FileName );
+
+	bool Res = SaveBinaryMLToStream( Node, Stream );
+
+	delete Stream;
+
+	return Res;
+}
+
+bool clFileSystem::SaveBinaryMLToStream( mlNode* Node, iOStream* OStream ) const
+{
+	if ( !Node || !OStream ) { return false; }
+
+	std::vector<Lubyte> Data;
+
+	clBinaryMLDocument::Write( Node, &Data );
+
+	OStream->BlockWrite( &Data[0], Data.size() );
+
+	return true;
+}
+
+clBinaryMLDocument* clFileSystem::LoadBinaryML( const LString& FileName ) const
+{
+	clBinaryMLDocument* Document = new clBinaryMLDocument();
+
+	if ( !Document->OpenStream( CreateFileReader( FileName ) ) )
+	{
+		Env->Logger->LogP( L_WARNING, "Invalid binary XLML file: %s", FileName.c_str() );
+
+		delete( Document );
+
+		return NULL;
+	}
+
+	return Document;
+}
+
 bool clFileSystem::SaveXLMLToLog( mlNode* Node ) const
 {
 	clLogStream Log;
@@ -1677,11 +1770,23 @@ mlNode* clFileSystem::LoadXLMLFromStream_Internal( iIStream* IStream, bool NonSt
 	const char* Ptr = reinterpret_cast<const char*>( IStream->MapStream() );
 	Luint64 Size    = IStream->GetFileSize();
 
-	mlTreeBuilder Builder;
+	mlNode* Node = NULL;
 
-	Builder.ASEMode = NonStrictASEMode;
+	if ( clBinaryMLDocument::IsBinaryML( Ptr, static_cast<size_t>( Size ) ) )
+	{
+		// binary XLML does not need any parsing
+		clBinaryMLDocument Document;
 
-	mlNode* Node = Builder.build( Ptr, static_cast<size_t>( Size ) );
+		if ( Document.Open( Ptr, static_cast<size_t>( Size ) ) ) { Node = Document.GetRoot().ToNode(); }
+	}
+	else
+	{
+		mlTreeBuilder Builder;
+
+		Builder.ASEMode = NonStrictASEMode;
+
+		Node = Builder.build( Ptr, static_cast<size_t>( Size ) );
+	}
 
 	// check if parsing was successfull
 	if ( this->IsFatalOnErrors() )
@@ -2200,115 +2305,10 @@ void WriteXML( iOStream* OS, mlNode* N, int depth )
 	OS->WriteLine( Prefix + LString( "<" ) + N->getID() + LString( "/>" ) );
 }
 
-#if 0
-
-////// Experimental "semi-binary"serialization (not enough Write..() methods in FileWriter to perform this)
-
-// "True" binary serialization must be autogenerated in LSDC
-
-/**
-   Binary serialization of the mlNode
-*/
-bool clFileSystem::NodeToBinary( mlNode* Node, iOStream* OutStream )
-{
-	if ( !Node )
-	{
-		// FLastError = "Invalid node pointer";
-		return false;
-	}
-
-	/// TODO : handle write errors
-
-	/// 1. Write node type
-	if ( !OutStream->WriteInt32( Node->GetTypeCode() ) ) { return false; }
-
-	/// 2. Write node name
-	if ( !OutStream->WriteBinaryString( Node->getID() ) ) { return false; }
-
-	/// 3. Write node value
-	if ( !OutStream->WriteBinaryString( Node->getValue() ) ) { return false; }
-
-	/// 4. Write number of children
-	Lint32 NumCh = static_cast<Luint32>( Node->children.size() );
-
-	if ( !OutStream->WriteInt32( NumCh ) ) { return false; }
-
-	/// 5. Write children
-	for ( int i = 0 ; i < NumCh ; i++ )
-	{
-		if ( !NodeToBinary( Node->children[i], OutStream ) )
-		{
-			// FLastError = "Error saving child(" + _int2str(i) + ") : " + FLastError;
-			return false;
-		}
-	}
-
-	return true;
-}
-
-/**
-   Loads "binary-textual" representation of mlNode
-
-   Binary format eliminates the need for any parsing
-*/
-mlNode* clFileSystem::NodeFromBinary( iIStream* InStream )
-{
-	/// 1. Create node
-	mlNode* Result = new mlNode();
-
-	if ( !Result )
-	{
-		// FLastError = "Invalid node type";
-
-		return NULL;
-	}
-
-	/// 2. Read node name
-	LString NodeName;
-
-	if ( !InStream->ReadBinaryString( NodeName ) ) { return false; }
-
-	/// 3. Read node value
-	LString NodeValue;
-
-	if ( !InStream->ReadBinaryString( NodeValue ) ) { return false; }
-
-	/// 4. Read number of child nodes
-	Lint32 NumCh;
-
-	if ( !InStream->ReadInt32( NumCh ) ) { return false; }
-
-	if ( NumCh < 0 /*  || NumCh > MAX_NUMBER_OF_CH */ )
-	{
-		// FLastError = "Invalid number of children: " + _int2str( NumCh );
-		return false;
-	}
-
-	/// 5. Read children
-	for ( int i = 0 ; i < NumCh ; i++ )
-	{
-		mlNode* Node = NodeFromBinary( InStream );
-
-		if ( !Node )
-		{
-			// store error
-			// FLastError = ""...
-
-			// clean already loaded nodes
-			delete Node; // Node->DisposeObject();
-
-			return NULL;
-		}
-
-		Result->children.push_back( Node );
-	}
-
-	return Result;
-}
-
-#endif
-
 /*
+ * 17/10/2026
+     Binary XLML: SaveBinaryML(), LoadBinaryML(), binary files are detected in LoadXLML()
+     CreateStreamReader()
  * 04/12/2012
      NULL checks for mount points
  * 20/12/2011
@@ -20,6 +20,7 @@ class iIStream;
 class iOStream;
 class mlNode;
 class mlTreeBuilder;
+class clBinaryMLDocument;
 class clMemRAWFile;
 class clMemFileWriter;
 class iRAWFile;
@@ -111,6 +112,16 @@ public:
 	**/
 	scriptmethod iIStream*       CreateFileReader( const LString& FileName ) const;
 
+	/**
+	   Create a reader for sequential consumers (audio decoders, video streams, etc.)
+
+	      - Large compressed archive entries are inflated on demand in fixed-size windows,
+	        so the memory usage does not depend on the file size
+	      - MapStream() returns NULL for such streams, backward seeks are slow
+	      - Falls back to CreateFileReader() for everything else
+	**/
+	scriptmethod iIStream*       CreateStreamReader( const LString& FileName ) const;
+
 	/**
 	   Create FileWriter for the specified file name
 
@@ -322,8 +333,14 @@ public:
 	/// Save XML  representation of the mlNode tree to the output stream
 	scriptmethod bool    SaveXMLToStream( mlNode* Node, iOStream* OStream ) const;
 
-// virtu_al mlNode* LoadBinaryTree(const LString& FileName) const;
-// vi_rtual bool    SaveBinaryTree(mlNode* Node) const;
+	/// Save binary XLML representation of the mlNode tree. LoadXLML() detects binary files automatically
+	scriptmethod bool    SaveBinaryML( mlNode* Node, const LString& FileName ) const;
+
+	/// Save binary XLML representation of the mlNode tree to the output stream
+	scriptmethod bool    SaveBinaryMLToStream( mlNode* Node, iOStream* OStream ) const;
+
+	/// Map binary XLML file and walk it in place without building the mlNode tree. Returns NULL if the file is not a valid binary XLML
+	clBinaryMLDocument*  LoadBinaryML( const LString& FileName ) const;
 
 #pragma endregion
 
@@ -489,6 +506,9 @@ public:
 #endif
 
 /*
+ * 17/10/2026
+     SaveBinaryML(), LoadBinaryML()
+     CreateStreamReader()
  * 03/07/2010
      FileExistsInResource()
  * 18/05/2010
@@ -15,6 +15,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <new>
 
 #ifdef ML_HEAVY_DEBUG
 #include <iostream>
@@ -137,6 +138,7 @@ void strParser::nextToken()
 
 	if ( isDelimiter( buffer[pos] ) )
 	{
+		tokenStart = pos;
 		token = buffer[pos];
 		tokenType = T_DELIMITER;
 		pos++;
@@ -145,6 +147,7 @@ void strParser::nextToken()
 		// check for quoted string
 		if ( token == "\"" )
 		{
+			tokenStart = pos;
 			getString();
 			tokenType = T_QUOTED_STRING;
 			return;
@@ -161,6 +164,8 @@ void strParser::nextToken()
 			pos++; // advance and skip #
 			curPos++;
 
+			tokenStart = pos;
+
 			// skip until double #
 			if ( skipUntil( "##" ) )
 			{
@@ -239,6 +244,8 @@ void strParser::nextToken()
 		return;
 	}
 
+	tokenStart = pos;
+
 	while ( normalChar( buffer[pos] ) )
 	{
 		token += buffer[pos];
@@ -351,11 +358,137 @@ LString strParser::getSubString( size_t start, size_t len )
 
 
 
+/// Heap-allocated mlNode tree
+struct mlHeapTree
+{
+	typedef mlNode  Node;
+	typedef LString String;
+
+	explicit mlHeapTree( strParser* _parser ) : parser( _parser ) {}
+
+	inline Node*   newNode() { return new mlNode(); }
+
+	inline Node*   newParam( const String& name, const String& value, bool quoted )
+	{
+		mlNode* node = new mlNode( name, value );
+		node->isQuotedParam = quoted;
+		return node;
+	}
+
+	inline void    addChild( Node* node, Node* child ) { node->children.push_back( child ); }
+
+	inline size_t  numChildren( Node* node ) const { return node->children.size(); }
+
+	inline Node*   firstChild( Node* node ) const { return node->children[0]; }
+
+	inline void    setIDValue( Node* node, const String& name, const String& value ) { node->setID( name ); node->setValue( value ); }
+
+	inline bool    isIDEmpty( Node* node ) const { return node->getIDRef().empty(); }
+
+	inline void    release( Node* node ) { delete node; }
+
+	/// Delete the node, but not its children
+	inline void    releaseWrapper( Node* node ) { node->children.clear(); delete node; }
+
+	inline void    tokenString( String& str ) const { str = parser->token; }
+
+	inline void    appendToken( String& str ) const
+	{
+		if ( !str.empty() ) { str += " "; }
+
+		str += parser->token;
+	}
+
+	inline void    assign( String& str, const LString& val ) const { str = val; }
+
+	strParser* parser;
+};
+
+/// Arena-allocated mlViewNode tree
+struct mlArenaTree
+{
+	typedef mlViewNode   Node;
+	typedef mlStringView String;
+
+	mlArenaTree( strParser* _parser, mlArena* _arena ) : parser( _parser ), arena( _arena ) {}
+
+	inline Node*   newNode() { return new( arena->alloc( sizeof( mlViewNode ) ) ) mlViewNode(); }
+
+	inline Node*   newParam( const String& name, const String& value, bool quoted )
+	{
+		mlViewNode* node = newNode();
+		node->setID( name );
+		node->setValue( value );
+		node->isQuotedParam = quoted;
+		return node;
+	}
+
+	inline void    addChild( Node* node, Node* child ) { node->addChild( child ); }
+
+	inline size_t  numChildren( Node* node ) const { return node->numChildren; }
+
+	inline Node*   firstChild( Node* node ) const { return node->firstChild; }
+
+	inline void    setIDValue( Node* node, const String& name, const String& value ) { node->setID( name ); node->setValue( value ); }
+
+	inline bool    isIDEmpty( Node* node ) const { return node->getID().empty(); }
+
+	/// everything is freed with the arena
+	inline void    release( Node* /*node*/ ) {}
+
+	inline void    releaseWrapper( Node* /*node*/ ) {}
+
+	inline void    tokenString( String& str ) const
+	{
+		if ( !parser->getTokenView( &str ) ) { str = arena->copyString( parser->token.data(), parser->token.length() ); }
+	}
+
+	inline void    appendToken( String& str ) const
+	{
+		String tok;
+		tokenString( tok );
+
+		if ( str.empty() ) { str = tok; return; }
+
+		// tokens separated by a single space are extended in place
+		if ( tok.ptr == str.ptr + str.len + 1 && str.ptr[str.len] == ' ' )
+		{
+			str.len += tok.len + 1;
+			return;
+		}
+
+		char* buf = static_cast<char*>( arena->alloc( str.len + tok.len + 2 ) );
+
+		memcpy( buf, str.ptr, str.len );
+		buf[str.len] = ' ';
+		memcpy( buf + str.len + 1, tok.ptr, tok.len );
+		buf[str.len + tok.len + 1] = 0;
+
+		str = String( buf, str.len + tok.len + 1 );
+	}
+
+	inline void    assign( String& str, const LString& val ) const { str = arena->copyString( val.data(), val.length() ); }
+
+	strParser* parser;
+	mlArena*   arena;
+};
+
 mlNode* mlTreeBuilder::build( const char* buffer, size_t bufLen )
 {
 	parser.setBuffer( buffer, bufLen );
 
-	return readSection();
+	mlHeapTree Tree( &parser );
+
+	return readSection( Tree );
+}
+
+mlViewNode* mlTreeBuilder::buildView( const char* buffer, size_t bufLen, mlArena* arena )
+{
+	parser.setBuffer( buffer, bufLen );
+
+	mlArenaTree Tree( &parser, arena );
+
+	return readSection( Tree );
 }
 
 bool mlTreeBuilder::canReadUntilOpeningBracket( LString& val )
@@ -364,6 +497,7 @@ bool mlTreeBuilder::canReadUntilOpeningBracket( LString& val )
 
 	LString oldToken = parser.token;
 	int oldTokenType = parser.tokenType;
+	size_t oldTokenStart = parser.tokenStart;
 	parser.pushPosition();
 
 	while ( parser.tokenType != T_EOF && parser.tokenType != T_EOLN && !parser.isComment() )
@@ -386,22 +520,22 @@ bool mlTreeBuilder::canReadUntilOpeningBracket( LString& val )
 	parser.restorePosition();
 	parser.token = oldToken;
 	parser.tokenType = oldTokenType;
+	parser.tokenStart = oldTokenStart;
 	return false;
 }
 
-mlNode* mlTreeBuilder::removeRedundant( mlNode* res )
+template <class Tree> typename Tree::Node* mlTreeBuilder::removeRedundant( Tree& T, typename Tree::Node* res )
 {
 	if ( !ASEMode ) { return res; }
 
 	// remove redundant nodes
-	if ( ( res->children.size() == 1 ) && res->getID().empty() )
+	if ( ( T.numChildren( res ) == 1 ) && T.isIDEmpty( res ) )
 	{
 		ML_TRACE( "Removing redundant node" );
 
-		mlNode* tmp = res->children[0];
+		typename Tree::Node* tmp = T.firstChild( res );
 
-		res->children.clear();
-		delete res;
+		T.releaseWrapper( res );
 
 		return tmp;
 	}
@@ -410,9 +544,12 @@ mlNode* mlTreeBuilder::removeRedundant( mlNode* res )
 }
 
 // actual entry point
-mlNode* mlTreeBuilder::readSection()
+template <class Tree> typename Tree::Node* mlTreeBuilder::readSection( Tree& T )
 {
-	mlNode* result = new mlNode();
+	typedef typename Tree::Node   Node;
+	typedef typename Tree::String String;
+
+	Node* result = T.newNode();
 	result->isSection = true;
 
 	parser.nextToken();
@@ -420,8 +557,8 @@ mlNode* mlTreeBuilder::readSection()
 	// read until the end
 	while ( parser.tokenType != T_EOF )
 	{
-		LString nodeName  = "";
-		LString nodeValue = "";
+		String nodeName;
+		String nodeValue;
 		bool isQuotedParam = false;
 
 		//    parser.nextToken();
@@ -460,10 +597,10 @@ mlNode* mlTreeBuilder::readSection()
 			// new parameter node or section node
 			ML_TRACE( "Reading parameter or section with name " << parser.token )
 
-			nodeName = parser.token;
-			nodeValue = "";
+			T.tokenString( nodeName );
+			nodeValue = String();
 
-			mlNode* node = new mlNode();
+			Node* node = T.newNode();
 
 			// gather everything that is related to this node
 
@@ -536,7 +673,7 @@ mlNode* mlTreeBuilder::readSection()
 					ML_TRACE( "got quoted string for parameter : " << parser.token )
 
 					// read the string
-					nodeValue = parser.token;
+					T.tokenString( nodeValue );
 
 					parser.nextToken();
 
@@ -559,7 +696,7 @@ mlNode* mlTreeBuilder::readSection()
 							SET_ERROR( ML_ERR_NO_CLOSING_BRACKET );
 						}
 
-						delete result;
+						T.release( result );
 						return 0;
 					}
 
@@ -571,7 +708,7 @@ mlNode* mlTreeBuilder::readSection()
 					{
 						// error - embedded comments are not allowed here
 						SET_ERROR( ML_ERR_NO_EMBEDDED_COMMENTS )
-						delete result;
+						T.release( result );
 						return 0;
 					}
 				}
@@ -589,7 +726,13 @@ mlNode* mlTreeBuilder::readSection()
 				{
 					ML_TRACE( "Checking ase-style section" )
 
-					if ( canReadUntilOpeningBracket( nodeValue ) )
+					LString aseValue;
+
+					bool canRead = canReadUntilOpeningBracket( aseValue );
+
+					T.assign( nodeValue, aseValue );
+
+					if ( canRead )
 					{
 						ML_TRACE( "OK, got node value [" << nodeValue << "]" )
 						// yes, it is a paramertized section
@@ -617,11 +760,11 @@ mlNode* mlTreeBuilder::readSection()
 
 			if ( parser.token == "}" )
 			{
-				ML_TRACE( "Finishing subsection, name = " << nodeName )
+				ML_TRACE( "Finishing subsection" )
 
 				// finish section, but also add the node
-				node->children.push_back( new mlNode/*mlParamNode*/( nodeName, "" ) );
-				result->children.push_back( node );
+				T.addChild( node, T.newParam( nodeName, String(), false ) );
+				T.addChild( result, node );
 				break;
 			}
 
@@ -631,11 +774,11 @@ mlNode* mlTreeBuilder::readSection()
 				ML_TRACE( "read { , switching to subsection " )
 
 				// read subsection
-				mlNode* subSection = readSection();
+				Node* subSection = readSection( T );
 
 				if ( !subSection )
 				{
-					delete result;
+					T.release( result );
 					return 0;
 				}
 
@@ -643,33 +786,31 @@ mlNode* mlTreeBuilder::readSection()
 				{
 					// no ending bracket ?
 					SET_ERROR( ML_ERR_NO_CLOSING_BRACKET )
-					delete result;
+					T.release( result );
 					return 0;
 				}
 
-				subSection->setValue( nodeValue );
+				T.setIDValue( subSection, nodeName, nodeValue );
 				subSection->isQuotedParam = isQuotedParam;
-				subSection->setID( nodeName );
 
-				ML_TRACE( "Created subsection: " << nodeName << ", " << nodeValue )
+				ML_TRACE( "Created subsection" )
 
-				node->children.push_back( removeRedundant( subSection ) /*subSection*/ );
+				T.addChild( node, removeRedundant( T, subSection ) /*subSection*/ );
 			}
 			else
 			{
 				if ( shouldBeSubsection )
 				{
 					ML_TRACE( "expected subsection " )
-					ML_TRACE( "InNode : " << node->getID() )
 
 					// no subsection error
 					SET_ERROR( ML_ERR_EXPECTED_SUBSECTION )
-					delete result;
+					T.release( result );
 					return 0;
 				}
 				else
 				{
-					nodeValue = "";
+					nodeValue = String();
 					bool isQuotedParam = false;
 
 					if ( !isNonValuedNode )
@@ -689,10 +830,8 @@ mlNode* mlTreeBuilder::readSection()
 									// nodeValue += " "+parser.token;
 								}
 
-								if ( !nodeValue.empty() ) { nodeValue += " "; }
-
 								// if IsQuotedParam then add "-" brackets around token
-								nodeValue += parser.token;
+								T.appendToken( nodeValue );
 							}
 							else
 							{
@@ -702,10 +841,9 @@ mlNode* mlTreeBuilder::readSection()
 								if ( !parser.isComment() )
 								{
 									ML_TRACE( "strange token : " << parser.token )
-									ML_TRACE( "InNode : " << node->getID() )
 
 									SET_ERROR( ML_ERR_SINGLE_STRING_EXPECTED )
-									delete result;
+									T.release( result );
 									return 0;
 								}
 							}
@@ -714,21 +852,19 @@ mlNode* mlTreeBuilder::readSection()
 						}
 					}
 
-					mlNode* paramNode = new mlNode/*mlParamNode*/( nodeName, nodeValue );
-					paramNode->isQuotedParam = isQuotedParam;
-					node->children.push_back( paramNode );
+					T.addChild( node, T.newParam( nodeName, nodeValue, isQuotedParam ) );
 
 					if ( isNonValuedNode )
 					{
-						result->children.push_back( node );
+						T.addChild( result, node );
 						continue;
 					}
 				}
 			}
 
-			ML_TRACE( "Finished section, node name  = " << node->getID() << ", value = " << node->getValue() )
+			ML_TRACE( "Finished section" )
 
-			result->children.push_back( removeRedundant( node ) );
+			T.addChild( result, removeRedundant( T, node ) );
 		}
 		else if ( parser.isComment() || ( parser.tokenType == T_EOLN ) )
 		{
@@ -741,15 +877,131 @@ mlNode* mlTreeBuilder::readSection()
 
 			// report error ?
 			SET_ERROR( ML_ERR_SINGLE_STRING_EXPECTED )
-			delete result;
+			T.release( result );
 			return 0;
 		}
 
 		parser.nextToken();
 	}
 
-	ML_TRACE( "Finished node: Name = " << result->getID() << ", Value = " << result->getValue() )
-	ML_TRACE( "Children count = " << result->children.size() );
+	ML_TRACE( "Finished node" )
+	ML_TRACE( "Children count = " << T.numChildren( result ) );
+
+	return removeRedundant( T, result );
+}
+
+void* mlArena::alloc( size_t size )
+{
+	size = ( size + 7 ) & ~static_cast<size_t>( 7 );
+
+	if ( size > left )
+	{
+		// large allocations get a dedicated block, the current block stays in use
+		if ( size > blockSize / 4 )
+		{
+			char* big = static_cast<char*>( malloc( size ) );
+			blocks.push_back( big );
+			return big;
+		}
+
+		cur  = static_cast<char*>( malloc( blockSize ) );
+		left = blockSize;
+
+		blocks.push_back( cur );
+	}
+
+	void* res = cur;
+
+	cur  += size;
+	left -= size;
+
+	return res;
+}
+
+mlStringView mlArena::copyString( const char* str, size_t len )
+{
+	char* buf = static_cast<char*>( alloc( len + 1 ) );
+
+	memcpy( buf, str, len );
+	buf[len] = 0;
+
+	return mlStringView( buf, len );
+}
+
+void mlArena::clear()
+{
+	for ( std::vector<char*>::iterator i = blocks.begin() ; i != blocks.end() ; ++i )
+	{
+		free( *i );
+	}
+
+	blocks.clear();
+
+	cur  = NULL;
+	left = 0;
+}
+
+mlViewNode* mlViewNode::getChild( size_t i ) const
+{
+	mlViewNode* child = firstChild;
+
+	for ( ; child && i ; i-- ) { child = child->nextSibling; }
+
+	return child;
+}
+
+mlViewNode* mlViewNode::findChild( const char* _ID ) const
+{
+	for ( mlViewNode* child = firstChild ; child ; child = child->nextSibling )
+	{
+		if ( child->FID.equals( _ID ) ) { return child; }
+	}
+
+	return NULL;
+}
+
+mlNode* mlViewNode::toNode() const
+{
+	mlNode* node = new mlNode( FID.str(), FValue.str() );
+
+	node->isSection     = isSection;
+	node->isQuotedParam = isQuotedParam;
+
+	node->children.reserve( numChildren );
+
+	for ( mlViewNode* child = firstChild ; child ; child = child->nextSibling )
+	{
+		node->children.push_back( child->toNode() );
+	}
+
+	return node;
+}
+
+bool mlDocument::build( const char* buffer, size_t bufLen, bool copyBuffer, bool ASEMode )
+{
+	clear();
+
+	if ( copyBuffer )
+	{
+		char* copy = static_cast<char*>( arena.alloc( bufLen + 1 ) );
+
+		memcpy( copy, buffer, bufLen );
+		copy[bufLen] = 0;
+
+		buffer = copy;
+	}
+
+	mlTreeBuilder builder;
+
+	builder.ASEMode = ASEMode;
+
+	root = builder.buildView( buffer, bufLen, &arena );
+
+	lastError = builder.lastError;
+	lastPos   = builder.lastPos;
+	lastLine  = builder.lastLine;
+
+	if ( !root ) { clear(); }
 
-	return removeRedundant( result );
+	return root != NULL;
 }
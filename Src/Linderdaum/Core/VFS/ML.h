@@ -13,11 +13,14 @@
 #define __ml__nodes__h__included__
 
 #include <stddef.h>
+#include <string.h>
 
 /// Define for compilation without LString (use without the rest of the Engine)
 #undef __NO_L_STRING
 
 class mlNode;
+class mlViewNode;
+class mlArena;
 class strParser;
 
 #include <vector>
@@ -151,6 +154,13 @@ public:
 
 	inline LString getValue() const { return FValue; }
 
+	/// Access ID and value without copying
+	inline const LString& getIDRef() const { return FID; }
+
+	inline const LString& getValueRef() const { return FValue; }
+
+	inline bool    hasID( const char* _ID ) const { return FID == _ID; }
+
 #pragma endregion
 
 #pragma region Actual node content
@@ -181,7 +191,7 @@ inline void FindAllNodesWithName( mlNode* Root, const LString& Name, std::vector
 {
 	for ( size_t i = 0 ; i < Root->children.size() ; i++ )
 	{
-		if ( Root->children[i]->getID() == Name )
+		if ( Root->children[i]->getIDRef() == Name )
 		{
 			SubNodes.push_back( Root->children[i] );
 		}
@@ -191,7 +201,7 @@ inline void FindAllNodesWithName( mlNode* Root, const LString& Name, std::vector
 inline mlNode* FindSubNode( mlNode* N, const LString& SubName )
 {
 	for ( size_t i = 0 ; i < N->children.size() ; i++ )
-		if ( N->children[i]->getID() == SubName )
+		if ( N->children[i]->getIDRef() == SubName )
 		{
 			return N->children[i];
 		}
@@ -205,7 +215,7 @@ inline void FindAllNodesWithNameStartingFrom( const std::vector<LString>& Prefix
 {
 	for ( size_t i = 0 ; i < Root->children.size() ; i++ )
 		for ( size_t j = 0 ; j < Prefixes.size() ; j++ )
-			if ( LStr::StartsWith( Root->children[i]->getID(), Prefixes[j] ) )
+			if ( LStr::StartsWith( Root->children[i]->getIDRef(), Prefixes[j] ) )
 			{
 				SubNodes.push_back( Root->children[i] );
 				break;
@@ -215,6 +225,119 @@ inline void FindAllNodesWithNameStartingFrom( const std::vector<LString>& Prefix
 #endif
 
 
+/**
+   \brief Non-owning reference to a range of characters
+
+   Views produced by mlDocument point either into the parsed text or into the document arena.
+   They are not zero-terminated.
+*/
+struct mlStringView
+{
+	mlStringView() : ptr( NULL ), len( 0 ) {}
+	mlStringView( const char* _ptr, size_t _len ) : ptr( _ptr ), len( _len ) {}
+
+	inline bool    empty() const { return len == 0; }
+
+	inline bool    equals( const char* str ) const { return ( len == 0 || strncmp( ptr, str, len ) == 0 ) && str[len] == 0; }
+
+	inline bool    equals( const LString& str ) const { return str.length() == len && ( len == 0 || memcmp( ptr, str.data(), len ) == 0 ); }
+
+	inline bool    operator == ( const char* str ) const { return equals( str ); }
+
+	inline LString str() const { return LString( ptr, len ); }
+
+	const char* ptr;
+	size_t      len;
+};
+
+/**
+   \brief Linear allocator for document nodes and strings
+
+   Memory is taken from large blocks and released all at once
+*/
+class mlArena
+{
+public:
+	explicit mlArena( size_t _blockSize = 64 * 1024 ) : blockSize( _blockSize ), cur( NULL ), left( 0 ) {}
+	~mlArena() { clear(); }
+
+	/// Allocate 8-byte aligned memory
+	void* alloc( size_t size );
+
+	/// Store a zero-terminated copy of the string in the arena
+	mlStringView copyString( const char* str, size_t len );
+
+	/// Free all blocks
+	void clear();
+
+	inline size_t getNumBlocks() const { return blocks.size(); }
+private:
+	mlArena( const mlArena& );
+	mlArena& operator = ( const mlArena& );
+
+	std::vector<char*> blocks;
+
+	size_t blockSize;
+
+	/// Free space in the last block
+	char*  cur;
+	size_t left;
+};
+
+/**
+   \brief Node of the arena-allocated ML tree
+
+   The tree has the same shape as the mlNode tree built from the same text.
+   Nodes are never deleted one by one, they live as long as the owning mlDocument.
+*/
+class mlViewNode
+{
+public:
+	mlViewNode() : isSection( false ), isQuotedParam( false ), numChildren( 0 ), firstChild( NULL ), lastChild( NULL ), nextSibling( NULL ) {}
+
+	inline const mlStringView& getID() const { return FID; }
+
+	inline const mlStringView& getValue() const { return FValue; }
+
+	inline void    setID( const mlStringView& _ID ) { FID = _ID; }
+
+	inline void    setValue( const mlStringView& val ) { FValue = val; }
+
+	inline void    addChild( mlViewNode* child )
+	{
+		if ( lastChild ) { lastChild->nextSibling = child; }
+		else { firstChild = child; }
+
+		lastChild = child;
+		numChildren++;
+	}
+
+	/// i-th child, O(i)
+	mlViewNode*    getChild( size_t i ) const;
+
+	/// First child with the given ID or NULL
+	mlViewNode*    findChild( const char* _ID ) const;
+
+	/// Build an equivalent heap-allocated mlNode tree
+	mlNode*        toNode() const;
+
+public:
+	bool isSection;
+
+	bool isQuotedParam;
+
+	size_t      numChildren;
+
+	/// Children are iterated as: for ( mlViewNode* C = N->firstChild; C; C = C->nextSibling )
+	mlViewNode* firstChild;
+	mlViewNode* lastChild;
+	mlViewNode* nextSibling;
+
+private:
+	mlStringView FID;
+	mlStringView FValue;
+};
+
 inline bool isDelimiter( char c )
 {
 	// unused ones are "-", "+", "*", ",", ":"
@@ -244,8 +367,10 @@ class strParser
 public:
 	int tokenType;
 	LString token;
+	/// Offset of the token contents in the buffer
+	size_t tokenStart;
 public:
-	strParser() : bufLen( 0 ), buffer( 0 ), tokenType( 0 ), token( "" ) { reset(); }
+	strParser() : bufLen( 0 ), buffer( 0 ), tokenType( 0 ), token( "" ), tokenStart( 0 ) { reset(); }
 	~strParser() {}
 
 	/// Reset parsing state
@@ -263,6 +388,18 @@ public:
 		reset();
 	}
 
+	/// Point the view to the token contents in the buffer, fails if the token was transformed (escape sequences, line breaks)
+	inline bool getTokenView( mlStringView* view ) const
+	{
+		size_t len = token.length();
+
+		if ( tokenStart + len > bufLen || memcmp( buffer + tokenStart, token.data(), len ) != 0 ) { return false; }
+
+		*view = mlStringView( buffer + tokenStart, len );
+
+		return true;
+	}
+
 	inline size_t getLine() const { return curLine; }
 	inline size_t getPos()  const { return curPos;  }
 
@@ -366,6 +503,9 @@ public:
 	mlTreeBuilder() : ASEMode( false ), lastError( 0 ), lastPos( 0 ), lastLine( 0 ) {}
 
 	mlNode* build( const char* buffer, size_t bufLen );
+
+	/// Build arena-allocated tree, IDs and values point into the buffer where possible
+	mlViewNode* buildView( const char* buffer, size_t bufLen, mlArena* arena );
 public:
 	/// Last error code
 	size_t lastError;
@@ -384,17 +524,50 @@ public:
 private:
 	bool canReadUntilOpeningBracket( LString& val );
 
-	mlNode* removeRedundant( mlNode* res );
+	/// Grammar is shared by the heap and the arena trees, see mlHeapTree and mlArenaTree in ML.cpp
+	template <class Tree> typename Tree::Node* removeRedundant( Tree& T, typename Tree::Node* res );
 
 	// internal state
-	mlNode* readSection();
+	template <class Tree> typename Tree::Node* readSection( Tree& T );
 
 	strParser parser;
 };
 
+/**
+   \brief ML document with all the nodes and strings in a single arena
+
+   Parsing costs a few block allocations and freeing the document costs the same.
+   Unless the text is copied by build(), the buffer must outlive the document.
+*/
+class mlDocument
+{
+public:
+	mlDocument() : lastError( 0 ), lastPos( 0 ), lastLine( 0 ), root( NULL ) {}
+
+	/// Parse the text, returns false and sets lastError on failure
+	bool build( const char* buffer, size_t bufLen, bool copyBuffer = false, bool ASEMode = false );
+
+	/// Release all nodes
+	void clear() { root = NULL; arena.clear(); }
+
+	inline mlViewNode* getRoot() const { return root; }
+
+	inline const mlArena& getArena() const { return arena; }
+public:
+	size_t lastError;
+
+	size_t lastPos, lastLine;
+private:
+	mlArena     arena;
+	mlViewNode* root;
+};
+
 #endif
 
 /*
+ * 17/10/2026
+     mlArena, mlViewNode, mlDocument
+     Non-copying accessors for mlNode
  * 04/09/2010
      Fixes for x64 target
 */
@@ -41,6 +41,9 @@ public:
 	/// Create appropriate file reader for the specified VirtualName
 	virtual iRAWFile*    CreateRAWFile( const LString& VirtualName ) const = 0;
 
+	/// Create a sequential reader which does not map the whole file into memory, NULL if CreateRAWFile() should be used instead
+	virtual iIStream*    CreateStreamReader( const LString& /*VirtualName*/ ) const { return NULL; }
+
 	/// Retrieve file time
 	virtual Lint64       GetFileTime( const LString& VirtualName ) const = 0;
 
@@ -207,6 +210,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     CreateStreamReader()
  * 07/01/2012
      clAliasMountPoint
  * 25/10/2011
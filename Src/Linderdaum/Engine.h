@@ -26,8 +26,8 @@
 #  define guard(...) {
 #  define unguard() }
 #else
-#  define guardEnv(Env, Pattern, ...) { ::Linderdaum::clGuardian Guardian( Env->Logger, FUNC_NAME, Pattern, __VA_ARGS__ );
-#  define guard(...) { ::Linderdaum::clGuardian Guardian( Env->Logger, FUNC_NAME, ## __VA_ARGS__ );
+#  define guardEnv(Env, Pattern, ...) { static const ::Linderdaum::sGuardSite GuardSite = { FUNC_NAME }; ::Linderdaum::clGuardian Guardian( Env->Logger, &GuardSite, Pattern, __VA_ARGS__ );
+#  define guard(...) { static const ::Linderdaum::sGuardSite GuardSite = { FUNC_NAME }; ::Linderdaum::clGuardian Guardian( Env->Logger, &GuardSite, ## __VA_ARGS__ );
 #  define unguard() }
 #endif
 
@@ -113,6 +113,8 @@ using namespace ::Linderdaum;
 #endif
 
 /*
+ * 17/10/2026
+     Static call site descriptors in guard()
  * 26/02/2012
      0.6.08
  * 28/01/2012
@@ -52,6 +52,8 @@ int getch( );
 #include "Core/Console.h"
 #include "Utils/Screen.h"
 #include "Utils/Library.h"
+#include "Utils/JobSystem.h"
+#include "Utils/Thread.h"
 #include "Renderer/iRenderContext.h"
 #include "World/World.h"
 #include "Audio/Audio.h"
@@ -197,6 +199,7 @@ sEnvironment::sEnvironment(): sSysEnv(),
 	Input( NULL ),
 	Viewport( NULL ),
 	Resources( NULL ),
+	Jobs( NULL ),
 	//
 	FTimeQuantum( 0.04f ), // in seconds
 	//
@@ -371,6 +374,12 @@ void sEnvironment::DeployEnvironment( const std::vector<LString>* CommandLine,
 	Console = Linker->Instantiate( "clConsole" );
 	Console->SendCommand( "exec " + ConfigFile );
 
+	// one core is left for the main thread
+	Jobs = new clJobSystem();
+	Jobs->Start( this, Console->GetVarValueInt( "Jobs.NumWorkers", iThread::GetNumberOfCores() - 1 ) );
+
+	Logger->LogP( L_LOG, "Job system started with %i worker(s)", Jobs->GetNumWorkers() );
+
 	Resources = Linker->Instantiate( "clResourcesManager" );
 
 	Screen   = Linker->Instantiate( "clScreen" );
@@ -430,6 +439,13 @@ void sEnvironment::ShutdownEnvironment()
 {
 	Resources->StopLoaderThread();
 
+	// the jobs can reference any subsystem, finish them first
+	Env->Logger->Log( L_DEBUG, "Stopping job system" );
+
+	delete( Jobs );
+
+	Jobs = NULL;
+
 	Console->SendCommand( "ResetGUI" );
 
 	Console->SendCommand( "StopWebServers" );
@@ -727,6 +743,8 @@ void sEnvironment::GenerateTicks()
 
 	FUpdatesPerFrame->SetInt( FNumUpdatesPerFrame );
 
+	Jobs->RunMainThreadJobs();
+
 	if ( !IsSuspended() )
 	{
 		RenderFrame( DeltaSeconds, FNumUpdatesPerFrame );
@@ -907,6 +925,8 @@ void sEnvironment::RemoveFromObjectsGraph( iObject* Obj )
 }
 
 /*
+ * 17/10/2026
+     Job system startup and shutdown, main thread jobs are executed in GenerateTicks()
  * 25/04/2011
      Localizer initialization and shutdown
  * 07/11/2010
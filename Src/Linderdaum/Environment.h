@@ -31,6 +31,7 @@ class iVideoEncoder;
 class clViewport;
 class clResourcesManager;
 class clLocalizer;
+class clJobSystem;
 
 /*! \mainpage Linderdaum Engine Documentation
  *
@@ -292,6 +293,9 @@ public:
 	/// localization information
 	nativefield    clLocalizer*         Localizer;
 
+	/// work-stealing job scheduler
+	nativefield    clJobSystem*         Jobs;
+
 	/// defenes how often L_EVENT_TIMER is sent - the global update speed of all subsystems, in seconds
 	float FTimeQuantum;
 
@@ -333,6 +337,8 @@ template <typename T> inline T* Construct( sEnvironment* Env )
 #endif
 
 /*
+ * 17/10/2026
+     Jobs
  * 25/04/2011
      Localizer added
  * 24/06/2010
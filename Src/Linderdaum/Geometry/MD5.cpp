@@ -15,6 +15,7 @@
 #include "Core/Logger.h"
 #include "Renderer/iRenderContext.h"
 #include "Geometry/VertexAttribs.h"
+#include "Geometry/Skinning.h"
 #include "Resources/ResourcesManager.h"
 
 #include "Math/LVector.h"
@@ -50,21 +51,30 @@ const LString MD5_Frame       = "FRAME";
 
 void sMD5Mesh::CalcPoints( clJointsSet* Joints )
 {
-	FPoints.resize( FVertices.size() );
+	size_t NumVertices = FVertices.size();
 
-	for ( size_t i = 0; i != FVertices.size(); ++i )
+	FPoints.resize( NumVertices );
+
+	if ( !NumVertices ) { return; }
+
+	std::vector<sSkinInfluences> Influences( NumVertices );
+	std::vector<sSkinMatrix>     Matrices;
+
+	const sWeight* Weights = FWeights.empty() ? NULL : &FWeights[0];
+
+	for ( size_t i = 0; i != NumVertices; ++i )
 	{
-		sMD5Vertex& V = FVertices[i];
+		const sMD5Vertex& V = FVertices[i];
 
-		LVector3 Pos( 0, 0, 0 );
+		clSkinning::PackInfluences( Weights + V.FWeightIndex, V.FWeightCount, &Influences[i] );
+	}
 
-		for ( int k = 0; k != V.FWeightCount; ++k )
-		{
-			sWeight& Weight = FWeights[ V.FWeightIndex + k ];
-			sJoint&  Joint  = Joints->GetJoint( Weight.FJointIndex );
+	clSkinning::CalcJointMatrices( *Joints, *Joints, 0.0f, &Matrices );
+	clSkinning::SkinVertices( &Influences[0], &Matrices[0], 0, NumVertices, &FPoints[0] );
 
-			Pos += Joint.Transform( Weight.FPosWeight.ToVector3() ) * Weight.FPosWeight.W;
-		}
+	for ( size_t i = 0; i != NumVertices; ++i )
+	{
+		const LVector3& Pos = FPoints[i];
 
 		FPoints[i] = LVector3( Pos.Y, Pos.X, Pos.Z );
 	}
@@ -663,6 +673,8 @@ void clMD5Loader::MD5_ReadAnimations( const LString& BaseFileName )
 }
 
 /*
+ * 17/10/2026
+     sMD5Mesh::CalcPoints() uses clSkinning
  * 27/03/2010
      (In)Correct normals smoothing (using VAMender)
  * 28/11/2007
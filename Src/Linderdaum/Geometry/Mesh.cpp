@@ -24,9 +24,9 @@
 
 // to make difference between 32/64 bit platforms and MSVC/GCC builds
 #ifdef PLATFORM_GCC
-const float MeshVersion = 0.926f + sizeof( size_t ) + 0.0001f;
+const float MeshVersion = 0.927f + sizeof( size_t ) + 0.0001f;
 #else
-const float MeshVersion = 0.926f + sizeof( size_t );
+const float MeshVersion = 0.927f + sizeof( size_t );
 #endif
 
 const int CACHED_MESH_MARKER = 0xDEADBEEF;
@@ -578,6 +578,8 @@ void clMesh::LoadAnimStates( const LString& FileName )
 }
 
 /*
+ * 17/10/2026
+     MeshVersion bumped, the cached vertex attribs contain the triangle BVH
  * 11/09/2010
      CACHED_MESH_MARKER added for correct caching on 32/64-bit platforms
  * 09/02/2010
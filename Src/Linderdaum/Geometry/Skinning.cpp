@@ -0,0 +1,210 @@
+/**
+ * \file Skinning.cpp
+ * \brief CPU skinning with per-joint matrices
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "Skinning.h"
+
+#include "Geometry/Joints.h"
+#include "Utils/JobSystem.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#  define L_SKINNING_SSE
+#  include <xmmintrin.h>
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#  define L_SKINNING_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+	/// Vertices per job, smaller ranges do not pay for the scheduling
+	const size_t SKINNING_GRAIN = 512;
+
+	struct sSkinningJob
+	{
+		const sSkinInfluences* FInfluences;
+		const sSkinMatrix*     FMatrices;
+		LVector3*              FVertices;
+	};
+
+	void SkinningRangeProc( void* Param, size_t Begin, size_t End )
+	{
+		sSkinningJob* Job = reinterpret_cast<sSkinningJob*>( Param );
+
+		clSkinning::SkinVertices( Job->FInfluences, Job->FMatrices, Begin, End, Job->FVertices );
+	}
+}
+
+void clSkinning::PackInfluences( const sWeight* Weights, int WeightCount, sSkinInfluences* Out )
+{
+	int   Used[ L_MAX_SKIN_INFLUENCES ];
+	int   NumUsed = 0;
+	float Sum     = 0.0f;
+	float Kept    = 0.0f;
+
+	// select the heaviest weights
+	for ( int k = 0; k != WeightCount; k++ )
+	{
+		float W = Weights[k].FPosWeight.W;
+
+		Sum += W;
+
+		if ( NumUsed < L_MAX_SKIN_INFLUENCES )
+		{
+			Used[ NumUsed++ ] = k;
+			continue;
+		}
+
+		int Lightest = 0;
+
+		for ( int j = 1; j != NumUsed; j++ )
+		{
+			if ( Weights[ Used[j] ].FPosWeight.W < Weights[ Used[ Lightest ] ].FPosWeight.W ) { Lightest = j; }
+		}
+
+		if ( W > Weights[ Used[ Lightest ] ].FPosWeight.W ) { Used[ Lightest ] = k; }
+	}
+
+	for ( int j = 0; j != NumUsed; j++ ) { Kept += Weights[ Used[j] ].FPosWeight.W; }
+
+	// keep the total weight when some influences were dropped
+	float Scale = ( NumUsed < WeightCount && Kept > 0.0f ) ? Sum / Kept : 1.0f;
+
+	for ( int j = 0; j != L_MAX_SKIN_INFLUENCES; j++ )
+	{
+		if ( j < NumUsed )
+		{
+			const sWeight& Weight = Weights[ Used[j] ];
+
+			float W = Weight.FPosWeight.W * Scale;
+
+			Out->FPosWeights[j] = LVector4( Weight.FPosWeight.ToVector3() * W, W );
+			Out->FJoints[j]     = Weight.FJointIndex;
+		}
+		else
+		{
+			Out->FPosWeights[j] = LVector4( 0.0f );
+			Out->FJoints[j]     = 0;
+		}
+	}
+}
+
+void clSkinning::CalcJointMatrices( const clJointsSet& Joints1, const clJointsSet& Joints2, float Blend, std::vector<sSkinMatrix>* Matrices )
+{
+	int NumJoints = Joints1.GetJointsCount();
+
+	Matrices->resize( NumJoints );
+
+	bool SingleFrame = ( &Joints1 == &Joints2 ) || ( Blend == 0.0f );
+
+	for ( int i = 0; i != NumJoints; i++ )
+	{
+		const sJoint& Joint1 = Joints1.GetJoint( i );
+
+		LQuaternion Orientation = Joint1.FOrientation;
+		LVector3    Position    = Joint1.FPosition;
+
+		if ( !SingleFrame )
+		{
+			const sJoint& Joint2 = Joints2.GetJoint( i );
+
+			Orientation.SLERP( Joint1.FOrientation, Joint2.FOrientation, Blend );
+			Position.Lerp( Joint1.FPosition, Joint2.FPosition, Blend );
+		}
+
+		sSkinMatrix& M = ( *Matrices )[i];
+
+		M.FColumns[0] = LVector4( Orientation.RotateVector( LVector3( 1.0f, 0.0f, 0.0f ) ), 0.0f );
+		M.FColumns[1] = LVector4( Orientation.RotateVector( LVector3( 0.0f, 1.0f, 0.0f ) ), 0.0f );
+		M.FColumns[2] = LVector4( Orientation.RotateVector( LVector3( 0.0f, 0.0f, 1.0f ) ), 0.0f );
+		M.FColumns[3] = LVector4( Position, 0.0f );
+	}
+}
+
+void clSkinning::SkinVertices( const sSkinInfluences* Influences, const sSkinMatrix* Matrices, size_t Begin, size_t End, LVector3* Vertices )
+{
+	for ( size_t i = Begin; i != End; i++ )
+	{
+		const sSkinInfluences& Inf = Influences[i];
+
+#if defined( L_SKINNING_SSE )
+		__m128 Pos = _mm_setzero_ps();
+
+		for ( int k = 0; k != L_MAX_SKIN_INFLUENCES; k++ )
+		{
+			const LVector4& PW = Inf.FPosWeights[k];
+			const LVector4* C  = Matrices[ Inf.FJoints[k] ].FColumns;
+
+			__m128 V = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &C[0].X ), _mm_set1_ps( PW.X ) ),
+			                       _mm_mul_ps( _mm_loadu_ps( &C[1].X ), _mm_set1_ps( PW.Y ) ) );
+
+			V = _mm_add_ps( V, _mm_mul_ps( _mm_loadu_ps( &C[2].X ), _mm_set1_ps( PW.Z ) ) );
+			V = _mm_add_ps( V, _mm_mul_ps( _mm_loadu_ps( &C[3].X ), _mm_set1_ps( PW.W ) ) );
+
+			Pos = _mm_add_ps( Pos, V );
+		}
+
+		float Out[4];
+		_mm_storeu_ps( Out, Pos );
+
+		Vertices[i] = LVector3( Out[0], Out[1], Out[2] );
+#elif defined( L_SKINNING_NEON )
+		float32x4_t Pos = vdupq_n_f32( 0.0f );
+
+		for ( int k = 0; k != L_MAX_SKIN_INFLUENCES; k++ )
+		{
+			const LVector4& PW = Inf.FPosWeights[k];
+			const LVector4* C  = Matrices[ Inf.FJoints[k] ].FColumns;
+
+			float32x4_t V = vmulq_n_f32( vld1q_f32( &C[0].X ), PW.X );
+
+			V = vmlaq_n_f32( V, vld1q_f32( &C[1].X ), PW.Y );
+			V = vmlaq_n_f32( V, vld1q_f32( &C[2].X ), PW.Z );
+			V = vmlaq_n_f32( V, vld1q_f32( &C[3].X ), PW.W );
+
+			Pos = vaddq_f32( Pos, V );
+		}
+
+		Vertices[i] = LVector3( vgetq_lane_f32( Pos, 0 ), vgetq_lane_f32( Pos, 1 ), vgetq_lane_f32( Pos, 2 ) );
+#else
+		LVector3 Pos( 0.0f );
+
+		for ( int k = 0; k != L_MAX_SKIN_INFLUENCES; k++ )
+		{
+			const LVector4& PW = Inf.FPosWeights[k];
+			const LVector4* C  = Matrices[ Inf.FJoints[k] ].FColumns;
+
+			Pos += C[0].ToVector3() * PW.X + C[1].ToVector3() * PW.Y + C[2].ToVector3() * PW.Z + C[3].ToVector3() * PW.W;
+		}
+
+		Vertices[i] = Pos;
+#endif
+	}
+}
+
+void clSkinning::SkinVerticesParallel( clJobSystem* Jobs, const sSkinInfluences* Influences, const sSkinMatrix* Matrices, size_t Count, LVector3* Vertices )
+{
+	if ( !Jobs )
+	{
+		SkinVertices( Influences, Matrices, 0, Count, Vertices );
+		return;
+	}
+
+	sSkinningJob Job;
+
+	Job.FInfluences = Influences;
+	Job.FMatrices   = Matrices;
+	Job.FVertices   = Vertices;
+
+	Jobs->ParallelFor( &SkinningRangeProc, &Job, 0, Count, SKINNING_GRAIN );
+}
+
+/*
+ * 17/10/2026
+     SkinVerticesParallel()
+     It's here
+*/
@@ -0,0 +1,67 @@
+/**
+ * \file Skinning.h
+ * \brief CPU skinning with per-joint matrices
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _clSkinning_
+#define _clSkinning_
+
+#include "Platform.h"
+#include "Math/LVector.h"
+
+#include <vector>
+
+class clJointsSet;
+class clJobSystem;
+struct sWeight;
+
+/// Max number of joints influencing a single vertex
+const int L_MAX_SKIN_INFLUENCES = 4;
+
+/// Fixed-size joint influences of a vertex
+struct sSkinInfluences
+{
+	/// X,Y,Z - position in the joint space multiplied by the weight, W - weight. Unused slots are zero
+	LVector4    FPosWeights[ L_MAX_SKIN_INFLUENCES ];
+	int         FJoints[ L_MAX_SKIN_INFLUENCES ];
+};
+
+/// Joint transform, three rotated axes and the translation. The 4th components are zero
+struct sSkinMatrix
+{
+	LVector4    FColumns[4];
+};
+
+/**
+   \brief Software skinning
+
+   Joints are blended and converted to matrices once per frame, the vertices are then transformed
+   by at most L_MAX_SKIN_INFLUENCES matrices each. Vertex ranges are independent and can be skinned
+   in parallel.
+**/
+class clSkinning
+{
+public:
+	/// Pack the weights of a single vertex. Only the heaviest L_MAX_SKIN_INFLUENCES weights are kept and renormalized
+	static void    PackInfluences( const sWeight* Weights, int WeightCount, sSkinInfluences* Out );
+
+	/// Blend two skeleton frames and build a matrix for every joint
+	static void    CalcJointMatrices( const clJointsSet& Joints1, const clJointsSet& Joints2, float Blend, std::vector<sSkinMatrix>* Matrices );
+
+	/// Transform the vertices [Begin..End)
+	static void    SkinVertices( const sSkinInfluences* Influences, const sSkinMatrix* Matrices, size_t Begin, size_t End, LVector3* Vertices );
+
+	/// Transform the vertices [0..Count) in parallel, Jobs can be NULL
+	static void    SkinVerticesParallel( clJobSystem* Jobs, const sSkinInfluences* Influences, const sSkinMatrix* Matrices, size_t Count, LVector3* Vertices );
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     SkinVerticesParallel()
+     It's here
+*/
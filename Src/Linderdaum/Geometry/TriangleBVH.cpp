@@ -0,0 +1,630 @@
+/**
+ * \file TriangleBVH.cpp
+ * \brief Bounding volume hierarchy over the triangles of clVertexAttribs
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "TriangleBVH.h"
+
+#include "Geometry/VertexAttribs.h"
+#include "Math/LMath.h"
+
+#include <algorithm>
+
+/// Max triangles in a leaf
+const Luint32 TRIANGLE_BVH_LEAF_SIZE = 4;
+
+/// Number of bins for the SAH evaluation
+const int     TRIANGLE_BVH_NUM_BINS  = 16;
+
+/// Depth limit of the tree, the traversal stack should fit two entries per level
+const int     TRIANGLE_BVH_MAX_DEPTH = 48;
+const int     TRIANGLE_BVH_STACK_SIZE = 2 * TRIANGLE_BVH_MAX_DEPTH + 2;
+
+namespace
+{
+	inline float BoxArea( const LVector3& Min, const LVector3& Max )
+	{
+		LVector3 D = Max - Min;
+
+		return D.X * D.Y + D.Y * D.Z + D.Z * D.X;
+	}
+
+	inline void ExtendBox( LVector3& Min, LVector3& Max, const LVector3& PMin, const LVector3& PMax )
+	{
+		Min = LVector3( Math::LMin( Min.X, PMin.X ), Math::LMin( Min.Y, PMin.Y ), Math::LMin( Min.Z, PMin.Z ) );
+		Max = LVector3( Math::LMax( Max.X, PMax.X ), Math::LMax( Max.Y, PMax.Y ), Math::LMax( Max.Z, PMax.Z ) );
+	}
+
+	inline void EmptyBox( LVector3& Min, LVector3& Max )
+	{
+		Min = LVector3(  Linderdaum::Math::INFINITY );
+		Max = LVector3( -Linderdaum::Math::INFINITY );
+	}
+
+	/// Slab test, InvA is the reciprocal of the ray direction
+	inline bool RayHitsBox( const sTriangleBVHNode& Node, const LVector3& P, const LVector3& InvA, float MaxT, float* TEnter )
+	{
+		float T1 = ( Node.FMin.X - P.X ) * InvA.X;
+		float T2 = ( Node.FMax.X - P.X ) * InvA.X;
+
+		float TMin = Math::LMin( T1, T2 );
+		float TMax = Math::LMax( T1, T2 );
+
+		T1 = ( Node.FMin.Y - P.Y ) * InvA.Y;
+		T2 = ( Node.FMax.Y - P.Y ) * InvA.Y;
+
+		TMin = Math::LMax( TMin, Math::LMin( T1, T2 ) );
+		TMax = Math::LMin( TMax, Math::LMax( T1, T2 ) );
+
+		T1 = ( Node.FMin.Z - P.Z ) * InvA.Z;
+		T2 = ( Node.FMax.Z - P.Z ) * InvA.Z;
+
+		TMin = Math::LMax( TMin, Math::LMin( T1, T2 ) );
+		TMax = Math::LMin( TMax, Math::LMax( T1, T2 ) );
+
+		*TEnter = TMin;
+
+		return TMax >= Math::LMax( TMin, 0.0f ) && TMin <= MaxT;
+	}
+
+	inline LVector3 SafeInverse( const LVector3& A )
+	{
+		// large finite values keep the slab test free of NaNs for the axis-parallel rays
+		const float Big = 1e30f;
+
+		return LVector3( ( A.X != 0.0f ) ? 1.0f / A.X : Big,
+		                 ( A.Y != 0.0f ) ? 1.0f / A.Y : Big,
+		                 ( A.Z != 0.0f ) ? 1.0f / A.Z : Big );
+	}
+
+	inline float BoxSqrDistance( const sTriangleBVHNode& Node, const LVector3& Point )
+	{
+		float DX = Math::LMax( Math::LMax( Node.FMin.X - Point.X, 0.0f ), Point.X - Node.FMax.X );
+		float DY = Math::LMax( Math::LMax( Node.FMin.Y - Point.Y, 0.0f ), Point.Y - Node.FMax.Y );
+		float DZ = Math::LMax( Math::LMax( Node.FMin.Z - Point.Z, 0.0f ), Point.Z - Node.FMax.Z );
+
+		return DX * DX + DY * DY + DZ * DZ;
+	}
+
+	struct sTriangleBVHBin
+	{
+		LVector3 FMin;
+		LVector3 FMax;
+		Luint32  FCount;
+	};
+
+	/// Partition predicate for the chosen split plane
+	struct sTriangleBVHSplit
+	{
+		const std::vector<LVector3>* FCentroids;
+		int                          FAxis;
+		float                        FSplit;
+
+		bool operator()( Luint32 Tri ) const { return ( *FCentroids )[Tri][FAxis] < FSplit; }
+	};
+}
+
+void clTriangleBVH::Clear()
+{
+	FNodes.FStream.clear();
+	FTriangles.FStream.clear();
+}
+
+void clTriangleBVH::Build( const clVertexAttribs* VA )
+{
+	Clear();
+
+	Luint32 NumTris = static_cast<Luint32>( VA->GetNumTriangles() );
+
+	if ( NumTris == 0 ) { return; }
+
+	std::vector<LVector3> Mins( NumTris );
+	std::vector<LVector3> Maxs( NumTris );
+	std::vector<LVector3> Centroids( NumTris );
+
+	FTriangles.resize( NumTris );
+
+	for ( Luint32 i = 0; i != NumTris; i++ )
+	{
+		LVector3 V1, V2, V3;
+
+		VA->GetTriangle( static_cast<int>( i ), V1, V2, V3 );
+
+		EmptyBox( Mins[i], Maxs[i] );
+		ExtendBox( Mins[i], Maxs[i], V1, V1 );
+		ExtendBox( Mins[i], Maxs[i], V2, V2 );
+		ExtendBox( Mins[i], Maxs[i], V3, V3 );
+
+		Centroids[i] = ( Mins[i] + Maxs[i] ) * 0.5f;
+
+		FTriangles.GetPtr()[i] = i;
+	}
+
+	FNodes.FStream.reserve( 2 * NumTris / TRIANGLE_BVH_LEAF_SIZE + 1 );
+
+	BuildNode( 0, NumTris, 0, Mins, Maxs, Centroids );
+}
+
+Luint32 clTriangleBVH::BuildNode( Luint32 Begin, Luint32 End, int Depth, const std::vector<LVector3>& Mins, const std::vector<LVector3>& Maxs, const std::vector<LVector3>& Centroids )
+{
+	Luint32 NodeIdx = static_cast<Luint32>( FNodes.size() );
+
+	sTriangleBVHNode Node;
+
+	EmptyBox( Node.FMin, Node.FMax );
+
+	LVector3 CMin, CMax;
+
+	EmptyBox( CMin, CMax );
+
+	Luint32* Tris = FTriangles.GetPtr();
+
+	for ( Luint32 i = Begin; i != End; i++ )
+	{
+		ExtendBox( Node.FMin, Node.FMax, Mins[ Tris[i] ], Maxs[ Tris[i] ] );
+		ExtendBox( CMin, CMax, Centroids[ Tris[i] ], Centroids[ Tris[i] ] );
+	}
+
+	Node.FOffset = Begin;
+	Node.FCount  = End - Begin;
+
+	FNodes.push_back( Node );
+
+	if ( Node.FCount <= TRIANGLE_BVH_LEAF_SIZE || Depth >= TRIANGLE_BVH_MAX_DEPTH ) { return NodeIdx; }
+
+	// find the best split among the bin boundaries of all three axes
+	float BestCost  = Linderdaum::Math::INFINITY;
+	int   BestAxis  = -1;
+	float BestSplit = 0.0f;
+
+	for ( int Axis = 0; Axis != 3; Axis++ )
+	{
+		float Extent = CMax[Axis] - CMin[Axis];
+
+		if ( Extent <= 0.0f ) { continue; }
+
+		sTriangleBVHBin Bins[ TRIANGLE_BVH_NUM_BINS ];
+
+		for ( int b = 0; b != TRIANGLE_BVH_NUM_BINS; b++ )
+		{
+			EmptyBox( Bins[b].FMin, Bins[b].FMax );
+			Bins[b].FCount = 0;
+		}
+
+		float Scale = TRIANGLE_BVH_NUM_BINS / Extent;
+
+		for ( Luint32 i = Begin; i != End; i++ )
+		{
+			int b = static_cast<int>( ( Centroids[ Tris[i] ][Axis] - CMin[Axis] ) * Scale );
+
+			b = Math::Clamp( b, 0, TRIANGLE_BVH_NUM_BINS - 1 );
+
+			ExtendBox( Bins[b].FMin, Bins[b].FMax, Mins[ Tris[i] ], Maxs[ Tris[i] ] );
+			Bins[b].FCount++;
+		}
+
+		// sweep from the right to accumulate the right-side areas
+		float   RightArea[ TRIANGLE_BVH_NUM_BINS ];
+		Luint32 RightCount[ TRIANGLE_BVH_NUM_BINS ];
+
+		LVector3 RMin, RMax;
+		EmptyBox( RMin, RMax );
+		Luint32 RCount = 0;
+
+		for ( int b = TRIANGLE_BVH_NUM_BINS - 1; b > 0; b-- )
+		{
+			ExtendBox( RMin, RMax, Bins[b].FMin, Bins[b].FMax );
+			RCount += Bins[b].FCount;
+
+			RightArea[b]  = ( RCount > 0 ) ? BoxArea( RMin, RMax ) : 0.0f;
+			RightCount[b] = RCount;
+		}
+
+		LVector3 LMin, LMax;
+		EmptyBox( LMin, LMax );
+		Luint32 LCount = 0;
+
+		for ( int b = 0; b < TRIANGLE_BVH_NUM_BINS - 1; b++ )
+		{
+			ExtendBox( LMin, LMax, Bins[b].FMin, Bins[b].FMax );
+			LCount += Bins[b].FCount;
+
+			if ( LCount == 0 || RightCount[b + 1] == 0 ) { continue; }
+
+			float Cost = LCount * BoxArea( LMin, LMax ) + RightCount[b + 1] * RightArea[b + 1];
+
+			if ( Cost < BestCost )
+			{
+				BestCost  = Cost;
+				BestAxis  = Axis;
+				BestSplit = CMin[Axis] + ( b + 1 ) / Scale;
+			}
+		}
+	}
+
+	Luint32 Mid = Begin;
+
+	if ( BestAxis >= 0 )
+	{
+		// do not split if a leaf is cheaper, unit cost for both traversal and intersection
+		float LeafCost = Node.FCount * BoxArea( Node.FMin, Node.FMax );
+
+		if ( BestCost + BoxArea( Node.FMin, Node.FMax ) >= LeafCost && Node.FCount <= 4 * TRIANGLE_BVH_LEAF_SIZE ) { return NodeIdx; }
+
+		sTriangleBVHSplit Pred;
+		Pred.FCentroids = &Centroids;
+		Pred.FAxis      = BestAxis;
+		Pred.FSplit     = BestSplit;
+
+		Mid = static_cast<Luint32>( std::partition( Tris + Begin, Tris + End, Pred ) - Tris );
+	}
+
+	if ( Mid == Begin || Mid == End )
+	{
+		// degenerate centroids, split in the middle
+		Mid = Begin + ( End - Begin ) / 2;
+	}
+
+	BuildNode( Begin, Mid, Depth + 1, Mins, Maxs, Centroids );
+
+	Luint32 Second = BuildNode( Mid, End, Depth + 1, Mins, Maxs, Centroids );
+
+	FNodes.GetPtr()[ NodeIdx ].FOffset = Second;
+	FNodes.GetPtr()[ NodeIdx ].FCount  = 0;
+
+	return NodeIdx;
+}
+
+bool clTriangleBVH::IntersectTriangle( const LVector3& P, const LVector3& A, const LVector3& V1, const LVector3& V2, const LVector3& V3, float MaxT, float* T )
+{
+	LVector3 E1 = V2 - V1;
+	LVector3 E2 = V3 - V1;
+
+	LVector3 PVec = A.Cross( E2 );
+
+	float Det = E1.Dot( PVec );
+
+	if ( fabs( Det ) < Linderdaum::Math::EPSILON ) { return false; }
+
+	float InvDet = 1.0f / Det;
+
+	LVector3 TVec = P - V1;
+
+	float U = TVec.Dot( PVec ) * InvDet;
+
+	if ( U < 0.0f || U > 1.0f ) { return false; }
+
+	LVector3 QVec = TVec.Cross( E1 );
+
+	float V = A.Dot( QVec ) * InvDet;
+
+	if ( V < 0.0f || U + V > 1.0f ) { return false; }
+
+	float Dist = E2.Dot( QVec ) * InvDet;
+
+	if ( Dist < 0.0f || Dist > MaxT ) { return false; }
+
+	*T = Dist;
+
+	return true;
+}
+
+LVector3 clTriangleBVH::ClosestPointOnTriangle( const LVector3& Point, const LVector3& V1, const LVector3& V2, const LVector3& V3 )
+{
+	// Voronoi regions of the triangle, see "Real-Time Collision Detection" 5.1.5
+	LVector3 AB = V2 - V1;
+	LVector3 AC = V3 - V1;
+	LVector3 AP = Point - V1;
+
+	float D1 = AB.Dot( AP );
+	float D2 = AC.Dot( AP );
+
+	if ( D1 <= 0.0f && D2 <= 0.0f ) { return V1; }
+
+	LVector3 BP = Point - V2;
+
+	float D3 = AB.Dot( BP );
+	float D4 = AC.Dot( BP );
+
+	if ( D3 >= 0.0f && D4 <= D3 ) { return V2; }
+
+	float VC = D1 * D4 - D3 * D2;
+
+	if ( VC <= 0.0f && D1 >= 0.0f && D3 <= 0.0f ) { return V1 + AB * ( D1 / ( D1 - D3 ) ); }
+
+	LVector3 CP = Point - V3;
+
+	float D5 = AB.Dot( CP );
+	float D6 = AC.Dot( CP );
+
+	if ( D6 >= 0.0f && D5 <= D6 ) { return V3; }
+
+	float VB = D5 * D2 - D1 * D6;
+
+	if ( VB <= 0.0f && D2 >= 0.0f && D6 <= 0.0f ) { return V1 + AC * ( D2 / ( D2 - D6 ) ); }
+
+	float VA = D3 * D6 - D5 * D4;
+
+	if ( VA <= 0.0f && ( D4 - D3 ) >= 0.0f && ( D5 - D6 ) >= 0.0f ) { return V2 + ( V3 - V2 ) * ( ( D4 - D3 ) / ( ( D4 - D3 ) + ( D5 - D6 ) ) ); }
+
+	float Denom = 1.0f / ( VA + VB + VC );
+
+	return V1 + AB * ( VB * Denom ) + AC * ( VC * Denom );
+}
+
+bool clTriangleBVH::RayCastClosest( const clVertexAttribs* VA, const LVector3& P, const LVector3& A, float MaxT, sTriangleBVHHit* Hit ) const
+{
+	if ( IsEmpty() ) { return false; }
+
+	const sTriangleBVHNode* Nodes = FNodes.GetPtr();
+	const Luint32*          Tris  = FTriangles.GetPtr();
+
+	LVector3 InvA = SafeInverse( A );
+
+	Luint32 Stack[ TRIANGLE_BVH_STACK_SIZE ];
+	int     StackSize = 0;
+
+	float TEnter = 0.0f;
+
+	if ( !RayHitsBox( Nodes[0], P, InvA, MaxT, &TEnter ) ) { return false; }
+
+	Stack[ StackSize++ ] = 0;
+
+	bool Found = false;
+
+	while ( StackSize > 0 )
+	{
+		const sTriangleBVHNode& Node = Nodes[ Stack[ --StackSize ] ];
+
+		if ( Node.IsLeaf() )
+		{
+			for ( Luint32 i = Node.FOffset; i != Node.FOffset + Node.FCount; i++ )
+			{
+				LVector3 V1, V2, V3;
+
+				VA->GetTriangle( static_cast<int>( Tris[i] ), V1, V2, V3 );
+
+				float T;
+
+				if ( IntersectTriangle( P, A, V1, V2, V3, MaxT, &T ) )
+				{
+					// shrink the ray to cull the farther nodes
+					MaxT = T;
+
+					Hit->FT        = T;
+					Hit->FTriangle = static_cast<int>( Tris[i] );
+
+					Found = true;
+				}
+			}
+
+			continue;
+		}
+
+		Luint32 Child1 = static_cast<Luint32>( &Node - Nodes ) + 1;
+		Luint32 Child2 = Node.FOffset;
+
+		float T1 = 0.0f;
+		float T2 = 0.0f;
+
+		bool Hit1 = RayHitsBox( Nodes[ Child1 ], P, InvA, MaxT, &T1 );
+		bool Hit2 = RayHitsBox( Nodes[ Child2 ], P, InvA, MaxT, &T2 );
+
+		// push the farther child first, so the nearer one is visited first
+		if ( Hit1 && Hit2 && T1 < T2 ) { std::swap( Child1, Child2 ); }
+
+		if ( Hit1 && Hit2 )
+		{
+			Stack[ StackSize++ ] = Child1;
+			Stack[ StackSize++ ] = Child2;
+		}
+		else if ( Hit1 )
+		{
+			Stack[ StackSize++ ] = Child1;
+		}
+		else if ( Hit2 )
+		{
+			Stack[ StackSize++ ] = Child2;
+		}
+	}
+
+	if ( Found ) { Hit->FPoint = P + A * Hit->FT; }
+
+	return Found;
+}
+
+bool clTriangleBVH::RayCastAny( const clVertexAttribs* VA, const LVector3& P, const LVector3& A, float MaxT ) const
+{
+	if ( IsEmpty() ) { return false; }
+
+	const sTriangleBVHNode* Nodes = FNodes.GetPtr();
+	const Luint32*          Tris  = FTriangles.GetPtr();
+
+	LVector3 InvA = SafeInverse( A );
+
+	Luint32 Stack[ TRIANGLE_BVH_STACK_SIZE ];
+	int     StackSize = 0;
+
+	Stack[ StackSize++ ] = 0;
+
+	while ( StackSize > 0 )
+	{
+		Luint32 NodeIdx = Stack[ --StackSize ];
+
+		const sTriangleBVHNode& Node = Nodes[ NodeIdx ];
+
+		float TEnter;
+
+		if ( !RayHitsBox( Node, P, InvA, MaxT, &TEnter ) ) { continue; }
+
+		if ( Node.IsLeaf() )
+		{
+			for ( Luint32 i = Node.FOffset; i != Node.FOffset + Node.FCount; i++ )
+			{
+				LVector3 V1, V2, V3;
+
+				VA->GetTriangle( static_cast<int>( Tris[i] ), V1, V2, V3 );
+
+				float T;
+
+				if ( IntersectTriangle( P, A, V1, V2, V3, MaxT, &T ) ) { return true; }
+			}
+
+			continue;
+		}
+
+		Stack[ StackSize++ ] = Node.FOffset;
+		Stack[ StackSize++ ] = NodeIdx + 1;
+	}
+
+	return false;
+}
+
+bool clTriangleBVH::FindClosestPoint( const clVertexAttribs* VA, const LVector3& Point, float MaxDistance, sTriangleBVHHit* Hit ) const
+{
+	if ( IsEmpty() ) { return false; }
+
+	const sTriangleBVHNode* Nodes = FNodes.GetPtr();
+	const Luint32*          Tris  = FTriangles.GetPtr();
+
+	float BestSqrDist = MaxDistance * MaxDistance;
+
+	Luint32 Stack[ TRIANGLE_BVH_STACK_SIZE ];
+	float   StackDist[ TRIANGLE_BVH_STACK_SIZE ];
+	int     StackSize = 0;
+
+	Stack[ StackSize ] = 0;
+	StackDist[ StackSize++ ] = BoxSqrDistance( Nodes[0], Point );
+
+	bool Found = false;
+
+	while ( StackSize > 0 )
+	{
+		--StackSize;
+
+		// the box could have become too far since it was pushed
+		if ( StackDist[ StackSize ] > BestSqrDist ) { continue; }
+
+		Luint32 NodeIdx = Stack[ StackSize ];
+
+		const sTriangleBVHNode& Node = Nodes[ NodeIdx ];
+
+		if ( Node.IsLeaf() )
+		{
+			for ( Luint32 i = Node.FOffset; i != Node.FOffset + Node.FCount; i++ )
+			{
+				LVector3 V1, V2, V3;
+
+				VA->GetTriangle( static_cast<int>( Tris[i] ), V1, V2, V3 );
+
+				LVector3 Closest = ClosestPointOnTriangle( Point, V1, V2, V3 );
+
+				float SqrDist = ( Closest - Point ).SqrLength();
+
+				if ( SqrDist <= BestSqrDist )
+				{
+					BestSqrDist = SqrDist;
+
+					Hit->FT        = SqrDist;
+					Hit->FTriangle = static_cast<int>( Tris[i] );
+					Hit->FPoint    = Closest;
+
+					Found = true;
+				}
+			}
+
+			continue;
+		}
+
+		Luint32 Child1 = NodeIdx + 1;
+		Luint32 Child2 = Node.FOffset;
+
+		float D1 = BoxSqrDistance( Nodes[ Child1 ], Point );
+		float D2 = BoxSqrDistance( Nodes[ Child2 ], Point );
+
+		// visit the nearer child first
+		if ( D1 < D2 )
+		{
+			std::swap( Child1, Child2 );
+			std::swap( D1, D2 );
+		}
+
+		if ( D1 <= BestSqrDist )
+		{
+			Stack[ StackSize ] = Child1;
+			StackDist[ StackSize++ ] = D1;
+		}
+
+		if ( D2 <= BestSqrDist )
+		{
+			Stack[ StackSize ] = Child2;
+			StackDist[ StackSize++ ] = D2;
+		}
+	}
+
+	return Found;
+}
+
+void clTriangleBVH::QuerySphere( const clVertexAttribs* VA, const LVector3& Center, float Radius, std::vector<int>* Triangles ) const
+{
+	if ( IsEmpty() ) { return; }
+
+	const sTriangleBVHNode* Nodes = FNodes.GetPtr();
+	const Luint32*          Tris  = FTriangles.GetPtr();
+
+	float SqrRadius = Radius * Radius;
+
+	Luint32 Stack[ TRIANGLE_BVH_STACK_SIZE ];
+	int     StackSize = 0;
+
+	Stack[ StackSize++ ] = 0;
+
+	while ( StackSize > 0 )
+	{
+		Luint32 NodeIdx = Stack[ --StackSize ];
+
+		const sTriangleBVHNode& Node = Nodes[ NodeIdx ];
+
+		if ( BoxSqrDistance( Node, Center ) > SqrRadius ) { continue; }
+
+		if ( Node.IsLeaf() )
+		{
+			for ( Luint32 i = Node.FOffset; i != Node.FOffset + Node.FCount; i++ )
+			{
+				LVector3 V1, V2, V3;
+
+				VA->GetTriangle( static_cast<int>( Tris[i] ), V1, V2, V3 );
+
+				if ( ( ClosestPointOnTriangle( Center, V1, V2, V3 ) - Center ).SqrLength() <= SqrRadius )
+				{
+					Triangles->push_back( static_cast<int>( Tris[i] ) );
+				}
+			}
+
+			continue;
+		}
+
+		Stack[ StackSize++ ] = Node.FOffset;
+		Stack[ StackSize++ ] = NodeIdx + 1;
+	}
+}
+
+void clTriangleBVH::LoadFromStream( iIStream* Stream )
+{
+	FNodes.LoadFromStream( Stream );
+	FTriangles.LoadFromStream( Stream );
+}
+
+void clTriangleBVH::SaveToStream( iOStream* Stream ) const
+{
+	FNodes.SaveToStream( Stream );
+	FTriangles.SaveToStream( Stream );
+}
+
+/*
+ * 17/10/2026
+     It's here
+*/
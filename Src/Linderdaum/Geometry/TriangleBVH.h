@@ -0,0 +1,94 @@
+/**
+ * \file TriangleBVH.h
+ * \brief Bounding volume hierarchy over the triangles of clVertexAttribs
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _clTriangleBVH_
+#define _clTriangleBVH_
+
+#include "Platform.h"
+#include "Math/LVector.h"
+#include "Utils/LArray.h"
+#include "Geometry/AttribStream.h"
+
+#include <vector>
+
+class clVertexAttribs;
+
+/// Flattened BVH node, the nodes are stored in the depth-first order
+struct sTriangleBVHNode
+{
+	LVector3 FMin;
+	/// first entry in the triangles list for leaves, index of the second child for internal nodes (the first child follows the node)
+	Luint32  FOffset;
+	LVector3 FMax;
+	/// number of triangles in a leaf, 0 for internal nodes
+	Luint32  FCount;
+
+	inline bool IsLeaf() const { return FCount > 0; }
+};
+
+/// Result of the triangle queries
+struct sTriangleBVHHit
+{
+	/// ray parameter for the ray queries, squared distance for the closest point query
+	float    FT;
+	int      FTriangle;
+	LVector3 FPoint;
+};
+
+/**
+   \brief Triangle BVH for the ray and proximity queries
+
+   Built top-down with the binned surface area heuristic. Triangles are referenced by their indices
+   in clVertexAttribs::GetTriangle(), the vertices are not copied, so the vertex attribs passed to the
+   queries should be the same which were used to build the tree.
+**/
+class clTriangleBVH
+{
+public:
+	clTriangleBVH() {};
+
+	void    Build( const clVertexAttribs* VA );
+	void    Clear();
+
+	inline bool   IsEmpty() const { return FNodes.size() == 0; }
+	inline size_t GetNumNodes() const { return FNodes.size(); }
+
+	/// Closest hit of the ray P + T * A, 0 <= T <= MaxT
+	bool    RayCastClosest( const clVertexAttribs* VA, const LVector3& P, const LVector3& A, float MaxT, sTriangleBVHHit* Hit ) const;
+
+	/// Any hit of the ray P + T * A, 0 <= T <= MaxT. Faster for the occlusion tests
+	bool    RayCastAny( const clVertexAttribs* VA, const LVector3& P, const LVector3& A, float MaxT ) const;
+
+	/// Closest point on the surface within MaxDistance
+	bool    FindClosestPoint( const clVertexAttribs* VA, const LVector3& Point, float MaxDistance, sTriangleBVHHit* Hit ) const;
+
+	/// Collect all the triangles touching the sphere
+	void    QuerySphere( const clVertexAttribs* VA, const LVector3& Center, float Radius, std::vector<int>* Triangles ) const;
+
+	void    LoadFromStream( iIStream* Stream );
+	void    SaveToStream( iOStream* Stream ) const;
+
+	/// Moller-Trumbore ray/triangle test, T is in [0..MaxT]
+	static bool IntersectTriangle( const LVector3& P, const LVector3& A, const LVector3& V1, const LVector3& V2, const LVector3& V3, float MaxT, float* T );
+
+	/// Closest point on the triangle
+	static LVector3 ClosestPointOnTriangle( const LVector3& Point, const LVector3& V1, const LVector3& V2, const LVector3& V3 );
+private:
+	Luint32 BuildNode( Luint32 Begin, Luint32 End, int Depth, const std::vector<LVector3>& Mins, const std::vector<LVector3>& Maxs, const std::vector<LVector3>& Centroids );
+private:
+	sAttribStream<sTriangleBVHNode> FNodes;
+	/// triangle indices referenced by the leaves
+	sAttribStream<Luint32>          FTriangles;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
@@ -13,6 +13,7 @@
 #include "Math/LGeomUtils.h"
 
 #include "Images/Bitmap.h"
+#include "Environment.h"
 #include "Geometry/VAMender.h"
 
 clVertexAttribs::clVertexAttribs()
@@ -40,7 +41,9 @@ clVertexAttribs::clVertexAttribs()
      FCurrentColor( LC_White ),
 	  FVTBits( 0 ),
 	  FStreams( L_VS_TOTAL_ATTRIBS ),
-	  FMorphTargetsBitmap( NULL )
+	  FMorphTargetsBitmap( NULL ),
+	  FTriangleBVH(),
+	  FTriangleBVHValid( false )
 {
 }
 
@@ -65,7 +68,10 @@ clVertexAttribs::clVertexAttribs( size_t Vertices,
 	  FCurrentNormal(),
      FCurrentColor( LC_White ),
 	  FVTBits( VertexTypeBits ),
-	  FStreams( L_VS_TOTAL_ATTRIBS )
+	  FStreams( L_VS_TOTAL_ATTRIBS ),
+	  FMorphTargetsBitmap( NULL ),
+	  FTriangleBVH(),
+	  FTriangleBVHValid( false )
 {
 	int VTB = VertexTypeBits;
 
@@ -132,6 +138,19 @@ void clVertexAttribs::LoadFromStream( iIStream* Stream )
 	Stream->BlockRead( &FCurrentNormal,    sizeof( FCurrentNormal ) );
 	Stream->BlockRead( &FCurrentColor,     sizeof( FCurrentColor ) );
 	Stream->BlockRead( &FVTBits,           sizeof( FVTBits ) );
+
+	FSkinInfluences.clear();
+
+	Stream->BlockRead( &FTriangleBVHValid, sizeof( FTriangleBVHValid ) );
+
+	if ( FTriangleBVHValid )
+	{
+		FTriangleBVH.LoadFromStream( Stream );
+	}
+	else
+	{
+		FTriangleBVH.Clear();
+	}
 }
 
 void clVertexAttribs::SaveToStream( iOStream* Stream ) const
@@ -160,6 +179,15 @@ void clVertexAttribs::SaveToStream( iOStream* Stream ) const
 	Stream->BlockWrite( &FCurrentNormal,    sizeof( FCurrentNormal ) );
 	Stream->BlockWrite( &FCurrentColor,     sizeof( FCurrentColor ) );
 	Stream->BlockWrite( &FVTBits,           sizeof( FVTBits ) );
+
+	// the cached BVH should not depend on whether anything was ray cast before caching
+	bool SaveTriangleBVH = IsTriangleBVHWorthBuilding();
+
+	if ( SaveTriangleBVH && !FTriangleBVHValid ) { BuildTriangleBVH(); }
+
+	Stream->BlockWrite( &SaveTriangleBVH, sizeof( SaveTriangleBVH ) );
+
+	if ( SaveTriangleBVH ) { FTriangleBVH.SaveToStream( Stream ); }
 }
 
 const std::vector<const void*>& clVertexAttribs::EnumerateVertexStreams() const
@@ -308,6 +336,8 @@ bool clVertexAttribs::MergeWith( const clVertexAttribs* Other )
 		this->FVTBits = Other->FVTBits;
 	}
 
+	InvalidateTriangleBVH();
+
 	/// Copy each attribute stream
 	FVertices.MergeWith( Other->FVertices );
 
@@ -349,6 +379,8 @@ void clVertexAttribs::Translate( const LVector3& Vec )
 
 void clVertexAttribs::Transform( const LMatrix4& Mtx )
 {
+	InvalidateTriangleBVH();
+
 	LVector3* Vertices = FVertices.GetPtr();
 
 	size_t VertexCount = FVertices.size();
@@ -374,6 +406,8 @@ void clVertexAttribs::TransformTexCoords( const LMatrix4& Mtx )
 
 void clVertexAttribs::NormalizeVertices()
 {
+	InvalidateTriangleBVH();
+
 	LVector3* Vertices = FVertices.GetPtr();
 	size_t VertexCount = FVertices.size();
 
@@ -435,7 +469,7 @@ void clVertexAttribs::SetKeyframe( sEnvironment* Env, int KeyframeNum, int NextK
 
 		if ( NextKeyframeNum > Last ) { NextKeyframeNum = Last; }
 
-		CalcPointsFromBitmap( Env, KeyframeNum, NextKeyframeNum, LerpCoef );
+		CalcPoints( &FSkeletonFrames[ KeyframeNum ], &FSkeletonFrames[ NextKeyframeNum ], LerpCoef, Env ? Env->Jobs : NULL );
 	}
 }
 
@@ -547,33 +581,34 @@ LAABoundingBox clVertexAttribs::GetBoundingBoxInterpolated( size_t Keyframe1, si
 	return Box;
 }
 
-void clVertexAttribs::CalcPoints( clJointsSet* Joints1, clJointsSet* Joints2, float Blend )
+void clVertexAttribs::UpdateSkinInfluences()
 {
-	LVector3* Vertices      = &FVertices.FStream[0];
-	LVector2* BlendingCoefs = &FBlendingCoefs.FStream[0];
+	size_t NumVertices = FBlendingCoefs.size();
 
-	for ( size_t i = 0; i != FBlendingCoefs.size(); i++ )
+	FSkinInfluences.resize( NumVertices );
+
+	const LVector2* BlendingCoefs = FBlendingCoefs.GetPtr();
+
+	for ( size_t i = 0; i != NumVertices; i++ )
 	{
 		int WeightIndex = ( int )BlendingCoefs[ i ].X;
 		int WeightCount = ( int )BlendingCoefs[ i ].Y;
 
-		LVector3 Pos( 0, 0, 0 );
+		clSkinning::PackInfluences( FWeights.GetPtr() + WeightIndex, WeightCount, &FSkinInfluences[i] );
+	}
+}
+
+void clVertexAttribs::CalcPoints( clJointsSet* Joints1, clJointsSet* Joints2, float Blend, clJobSystem* Jobs )
+{
+	InvalidateTriangleBVH();
 
-		for ( int k = 0; k != WeightCount; ++k )
-		{
-			sWeight& Weight = FWeights.FStream[ WeightIndex + k ];
-			sJoint&  Joint1  = Joints1->GetJoint( Weight.FJointIndex );
-			sJoint&  Joint2  = Joints2->GetJoint( Weight.FJointIndex );
+	if ( FSkinInfluences.size() != FBlendingCoefs.size() ) { UpdateSkinInfluences(); }
 
-			sJoint Joint = Joint1;
-			Joint.FOrientation.SLERP( Joint1.FOrientation, Joint2.FOrientation, Blend );
-			Joint.FPosition.Lerp( Joint1.FPosition, Joint2.FPosition, Blend );
+	if ( FSkinInfluences.empty() ) { return; }
 
-			Pos += Joint.Transform( Weight.FPosWeight.ToVector3() ) * Weight.FPosWeight.W;
-		}
+	clSkinning::CalcJointMatrices( *Joints1, *Joints2, Blend, &FSkinMatrices );
 
-		Vertices[i] = Pos;
-	}
+	clSkinning::SkinVerticesParallel( Jobs, &FSkinInfluences[0], &FSkinMatrices[0], FSkinInfluences.size(), FVertices.GetPtr() );
 }
 
 clBitmap* clVertexAttribs::GetMorphTargetsBitmap( sEnvironment* Env ) const
@@ -586,51 +621,6 @@ clBitmap* clVertexAttribs::GetMorphTargetsBitmap( sEnvironment* Env ) const
 	return FMorphTargetsBitmap;
 }
 
-void clVertexAttribs::CalcPointsFromBitmap( sEnvironment* Env, int Frame1, int Frame2, float Blend )
-{
-	if ( !FMorphTargetsBitmap )
-	{
-		FMorphTargetsBitmap = PackSkeletonsToBitmap( Env );
-	}
-
-	LVector3* Vertices      = &FVertices.FStream[0];
-	LVector2* BlendingCoefs = &FBlendingCoefs.FStream[0];
-
-	int VStart1 = Frame1 * 4;
-	int VStart2 = Frame2 * 4;
-
-	sJoint Joint;
-	sJoint Joint1;
-	sJoint Joint2;
-
-	for ( size_t i = 0; i != FBlendingCoefs.size(); i++ )
-	{
-		int WeightIndex = ( int )BlendingCoefs[ i ].X;
-		int WeightCount = ( int )BlendingCoefs[ i ].Y;
-
-		LVector3 Pos( 0, 0, 0 );
-
-		for ( int k = 0; k != WeightCount; ++k )
-		{
-			LVector4 PosWeight  = FMorphTargetsBitmap->GetPixel( WeightIndex + k, VStart1 + 0, 0 );
-			LVector4 JointIndex = FMorphTargetsBitmap->GetPixel( WeightIndex + k, VStart1 + 1, 0 );
-
-			Joint1.FOrientation = LQuaternion( FMorphTargetsBitmap->GetPixel( ( int )JointIndex.X, VStart1 + 2, 0 ) );
-			Joint1.FPosition    =              FMorphTargetsBitmap->GetPixel( ( int )JointIndex.X, VStart1 + 3, 0 ).ToVector3();
-
-			Joint2.FOrientation = LQuaternion( FMorphTargetsBitmap->GetPixel( ( int )JointIndex.X, VStart2 + 2, 0 ) );
-			Joint2.FPosition    = FMorphTargetsBitmap->GetPixel( ( int )JointIndex.X, VStart2 + 3, 0 ).ToVector3();
-
-			Joint.FOrientation.SLERP( Joint1.FOrientation, Joint2.FOrientation, Blend );
-			Joint.FPosition.Lerp( Joint1.FPosition, Joint2.FPosition, Blend );
-
-			Pos += Joint.Transform( PosWeight.ToVector3() ) * PosWeight.W;
-		}
-
-		Vertices[i] = Pos;
-	}
-}
-
 clVertexAttribs* clVertexAttribs::CreateEmpty()
 {
 	return new clVertexAttribs();
@@ -729,6 +719,10 @@ void clVertexAttribs::SetColorV( const LVector4& Vec )
 
 void clVertexAttribs::Restart( LPrimitiveType Primitive, size_t ReserveVertices, int VertexTypeBits )
 {
+	InvalidateTriangleBVH();
+
+	FSkinInfluences.clear();
+
 	FCurrentColor     = LC_White;
 	FCurrentNormal    = LVector3( 0, 0, 0 );
 	FCurrentTexCoords = LVector4( 0, 0, 0, 0 );
@@ -798,6 +792,8 @@ void clVertexAttribs::EmitVertex( float X, float Y, float Z, int WeightStart, in
 
 void clVertexAttribs::EmitVertexV( LVector3 Vec, int WeightStart, int WeightCount )
 {
+	if ( FTriangleBVHValid ) { InvalidateTriangleBVH(); }
+
 	FVertices.FStream[ FActiveVertexCount ] = Vec;
 
 	using Linderdaum::Math::IsMaskSet;
@@ -925,10 +921,13 @@ bool clVertexAttribs::IntersectWithRayAndFindTriangle( const LVector3& P, const
 {
 	int NumTris = GetNumTriangles();
 
+	if ( FTriangleBVHValid || IsTriangleBVHWorthBuilding() )
+	{
+		return RayCastClosest( P, A, isect, TriangleIdx );
+	}
+
 	float Dist = Linderdaum::Math::INFINITY;
-	bool Intersection = false;
 
-	LVector3 result;
 	LVector3 V1, V2, V3;
 
 	TriangleIdx = -1;
@@ -937,23 +936,87 @@ bool clVertexAttribs::IntersectWithRayAndFindTriangle( const LVector3& P, const
 	{
 		GetTriangle( i, V1, V2, V3 );
 
-		if ( IntersectRayToTriangle( P, A, V1, V2, V3, result ) )
-		{
-			Intersection = true;
-
-			float NewDist = ( result - P ).Length();
+		float T;
 
-			if ( NewDist < Dist )
-			{
-				Dist = NewDist;
-				isect = result;
+		if ( clTriangleBVH::IntersectTriangle( P, A, V1, V2, V3, Dist, &T ) )
+		{
+			Dist = T;
 
-				TriangleIdx = i;
-			}
+			TriangleIdx = i;
 		}
 	}
 
-	return Intersection;
+	if ( TriangleIdx < 0 ) { return false; }
+
+	isect = P + A * Dist;
+
+	return true;
+}
+
+bool clVertexAttribs::IsTriangleBVHWorthBuilding() const
+{
+	// the tree is not worth building for tiny or animated meshes
+	return GetNumTriangles() >= 64 && !FDynamic && GetSkeletonFramesCount() == 0;
+}
+
+void clVertexAttribs::BuildTriangleBVH() const
+{
+	FTriangleBVH.Build( this );
+
+	FTriangleBVHValid = true;
+}
+
+void clVertexAttribs::InvalidateTriangleBVH()
+{
+	FTriangleBVH.Clear();
+
+	FTriangleBVHValid = false;
+}
+
+bool clVertexAttribs::RayCastClosest( const LVector3& P, const LVector3& A, LVector3& isect, int& TriangleIdx ) const
+{
+	if ( !FTriangleBVHValid ) { BuildTriangleBVH(); }
+
+	sTriangleBVHHit Hit;
+
+	TriangleIdx = -1;
+
+	if ( !FTriangleBVH.RayCastClosest( this, P, A, Linderdaum::Math::INFINITY, &Hit ) ) { return false; }
+
+	isect       = Hit.FPoint;
+	TriangleIdx = Hit.FTriangle;
+
+	return true;
+}
+
+bool clVertexAttribs::RayCastAny( const LVector3& P, const LVector3& A, float MaxT ) const
+{
+	if ( !FTriangleBVHValid ) { BuildTriangleBVH(); }
+
+	return FTriangleBVH.RayCastAny( this, P, A, MaxT );
+}
+
+bool clVertexAttribs::FindClosestPoint( const LVector3& Point, LVector3& Closest, int& TriangleIdx ) const
+{
+	if ( !FTriangleBVHValid ) { BuildTriangleBVH(); }
+
+	sTriangleBVHHit Hit;
+
+	TriangleIdx = -1;
+
+	if ( !FTriangleBVH.FindClosestPoint( this, Point, Linderdaum::Math::INFINITY, &Hit ) ) { return false; }
+
+	Closest     = Hit.FPoint;
+	TriangleIdx = Hit.FTriangle;
+
+	return true;
+}
+
+void clVertexAttribs::QuerySphere( const LVector3& Center, float Radius, std::vector<int>* Triangles ) const
+{
+	if ( !FTriangleBVHValid ) { BuildTriangleBVH(); }
+
+	FTriangleBVH.QuerySphere( this, Center, Radius, Triangles );
 }
 
 void clVertexAttribs::MapPlanar( const LVector3& Start, const LVector3& V1, const LVector3& V2 )
@@ -1001,6 +1064,11 @@ void clVertexAttribs::MapCylindrical( const LVector3& Base, float Radius, float
 }
 
 /*
+ * 17/10/2026
+     The triangle BVH of the static meshes is always built before saving
+     CalcPoints() skins in parallel using clJobSystem
+     CalcPoints() blends the joints once per frame and skins with the packed influences, SetKeyframe() no longer reads the morph targets bitmap
+     IntersectWithRayAndFindTriangle() uses the triangle BVH for static meshes, hits behind the ray origin are ignored
  * 11/01/2011
      SplitTriangles()
      CreateFromTriangles()
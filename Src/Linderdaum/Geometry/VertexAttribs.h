@@ -22,11 +22,14 @@
 
 #include "Geometry/Joints.h"
 #include "Geometry/AttribStream.h"
+#include "Geometry/TriangleBVH.h"
+#include "Geometry/Skinning.h"
 
 #include "Core/VFS/iIStream.h"
 #include "Core/VFS/iOStream.h"
 
 class clBitmap;
+class clJobSystem;
 
 const int L_TEXCOORDS_BIT   = 1;
 const int L_NORMALS_BIT     = 2;
@@ -256,14 +259,42 @@ public:
 
 #pragma endregion
 
+#pragma region Triangle BVH
+	/**
+	   The BVH is built on the first query and dropped by the modifying routines of this class.
+	   Call InvalidateTriangleBVH() after writing to FVertices directly.
+	   SaveToStream() writes the BVH only for the meshes where IsTriangleBVHWorthBuilding() is true, building it if needed
+	**/
+	noexport void    BuildTriangleBVH() const;
+	noexport void    InvalidateTriangleBVH();
+	noexport bool    HasTriangleBVH() const { return FTriangleBVHValid; }
+
+	/// Static meshes with enough triangles use the BVH for ray casts, their BVH is always built before saving
+	noexport bool    IsTriangleBVHWorthBuilding() const;
+
+	/// Closest hit of the ray P + T * A, T >= 0
+	noexport bool    RayCastClosest( const LVector3& P, const LVector3& A, LVector3& isect, int& TriangleIdx ) const;
+
+	/// True if any triangle is hit by the ray P + T * A, 0 <= T <= MaxT
+	noexport bool    RayCastAny( const LVector3& P, const LVector3& A, float MaxT ) const;
+
+	/// Closest point on the surface, returns false for an empty mesh
+	noexport bool    FindClosestPoint( const LVector3& Point, LVector3& Closest, int& TriangleIdx ) const;
+
+	/// Indices of the triangles touching the sphere
+	noexport void    QuerySphere( const LVector3& Center, float Radius, std::vector<int>* Triangles ) const;
+#pragma endregion
+
 	static clVertexAttribs*    CreateEmpty();
 	static clVertexAttribs*    Create( size_t Vertices, int VertexTypeBits );
 	static clVertexAttribs*    CreateFromTriangles( const std::vector<int>& Indices, const std::vector<LVector3>& Vertices, int VertexTypeBits );
 
-	/// recalculate vertices positions according to skeleton joints
-	void        CalcPoints( clJointsSet* Joints1, clJointsSet* Joints2, float Blend );
+	/// recalculate vertices positions according to skeleton joints, the vertices are skinned in parallel if Jobs is not NULL
+	void        CalcPoints( clJointsSet* Joints1, clJointsSet* Joints2, float Blend, clJobSystem* Jobs = NULL );
+
+	/// pack FWeights into fixed-size influences, called by CalcPoints() when the weights count changes
+	void        UpdateSkinInfluences();
 private:
-	void        CalcPointsFromBitmap( sEnvironment* Env, int Frame1, int Frame2, float Blend );
 	clBitmap*   PackSkeletonsToBitmap( sEnvironment* Env ) const;
 public:
 	/// type of geometry primitive to iterate indices/vertices
@@ -324,11 +355,21 @@ private:
 	mutable std::vector<const void*> FStreams;
 	/// packed skeleton
 	mutable clBitmap*   FMorphTargetsBitmap;
+	/// lazily built triangle BVH
+	mutable clTriangleBVH FTriangleBVH;
+	mutable bool          FTriangleBVHValid;
+	/// software skinning data
+	std::vector<sSkinInfluences> FSkinInfluences;
+	std::vector<sSkinMatrix>     FSkinMatrices;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     CalcPoints() skins in parallel using clJobSystem
+     Software skinning through clSkinning, CalcPointsFromBitmap() removed
+     Lazily built triangle BVH, RayCastClosest(), RayCastAny(), FindClosestPoint(), QuerySphere()
  * 11/01/2011
      SplitTriangles()
      CreateFromTriangles()
@@ -2324,7 +2324,7 @@ void clBitmap::Untangle2D( LFFT* fft )
 	int n2 = fft->n2;
 
 	/// 0 < k1 < n1, 0 < k2 < n2/2,
-	for ( int k1 = 1 ; k1 < n1 / 2 ; k1++ )
+	for ( int k1 = 1 ; k1 < n1 ; k1++ )
 	{
 		for ( int k2 = 1 ; k2 < n2 / 2 ; k2++ )
 		{
@@ -2413,6 +2413,33 @@ void clBitmap::Untangle2D( LFFT* fft )
 	*/
 }
 
+clBitmap* clBitmap::FFT2DAlloc() const
+{
+	int W = FBitmapParams.FWidth;
+	int H = FBitmapParams.FHeight;
+
+	LFFT FFT( W, H );
+
+	FFT.SetJobSystem( Env->Jobs );
+	FFT.AllocArray( false );
+
+	for ( int x = 0 ; x < W ; x++ )
+	{
+		for ( int y = 0 ; y < H ; y++ )
+		{
+			FFT.a2D[x][y] = GetPixel( x, y, 0 ).X;
+		}
+	}
+
+	FFT.TransformReal( false );
+
+	clBitmap* Res = clBitmap::CreateBitmap( Env, W, H, 1, L_BITMAP_FLOAT32_RGBA, L_TEXTURE_2D );
+
+	Res->Untangle2D( &FFT );
+
+	return Res;
+}
+
 void clBitmap::ScalePixelComponents( const LVector4& Factor )
 {
 	int W = FBitmapParams.FWidth;
@@ -2673,6 +2700,8 @@ void clBitmap::CombineImages_Dense( const std::vector<clBitmap*>& Images, std::v
 }
 
 /*
+ * 17/10/2026
+     FFT2DAlloc(), Untangle2D() fills the k1 > n1/2 quadrant
  * 02/02/2012
      Rotate90CW(), Rotate90CCW(), Rotate180()
  * 09/12/2010
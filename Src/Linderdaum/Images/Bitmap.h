@@ -355,6 +355,9 @@ public:
 	*/
 	scriptmethod void  Untangle2D( LFFT* fft );
 
+	/// Real 2D DFT of the R channel untangled to a new FLOAT32_RGBA bitmap, the sizes must be powers of two. Runs on the engine's job system
+	scriptmethod clBitmap* FFT2DAlloc() const;
+
 	/// Store sqrt(r * r + g * g) to B channel
 	scriptmethod void  CalculateComplexMagnitude();
 
@@ -533,6 +536,8 @@ template <typename T> void clBitmap::BlendBitmap( clBitmap* Overlay, T BlendingO
 #endif
 
 /*
+ * 17/10/2026
+     FFT2DAlloc()
  * 02/02/2012
      Rotate90CW(), Rotate90CCW(), Rotate180()
  * 29/01/2011
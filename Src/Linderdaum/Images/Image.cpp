@@ -103,7 +103,7 @@ clImage::~clImage()
 bool clImage::LoadFromFile( const LString& FileName )
 {
 	SetAsyncLoadComplete( false );
-	Env->Resources->EnqueueLoading( new clLoaderThread::clLoadOp_Image( this ) );
+	Env->Resources->EnqueueLoading( new clLoaderPool::clLoadOp_Image( this ) );
 
 //	TODO( "refactor LoadTexture*() using this" )
 
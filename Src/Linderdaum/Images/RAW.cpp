@@ -21,6 +21,7 @@
 #include "Core/Console.h"
 #include "Core/CVars.h"
 #include "GUI/GUIManager.h"
+#include "Utils/JobSystem.h"
 
 #if defined(OS_WINDOWS)
 #include <windows.h>
@@ -69,8 +70,23 @@ clRAWLoader::~clRAWLoader()
 {
 }
 
+/// Bricks of the VolumeLib filters and histograms are processed by the engine's job system
+static void VL_ParallelForCallback_Impl( void* Context, VL_RangeProc Proc, void* Param, size_t Count )
+{
+	clJobSystem* Jobs = reinterpret_cast<sEnvironment*>( Context )->Jobs;
+
+	if ( Jobs ) { Jobs->ParallelFor( Proc, Param, 0, Count, 1 ); }
+	else { Proc( Param, 0, Count ); }
+}
+
+void clRAWLoader::InstallParallelFor( sEnvironment* Env )
+{
+	VL_SetParallelForCallback( &VL_ParallelForCallback_Impl, Env );
+}
+
 void clRAWLoader::AfterConstruction()
 {
+	InstallParallelFor( Env );
 }
 
 /////////////
@@ -587,6 +603,8 @@ bool clRAWLoader::Load( iIStream* IStream, clBitmap* Resource, bool IsAutoGradie
 }
 
 /*
+ * 17/10/2026
+     VolumeLib parallel callbacks are routed to the job system
  * 02/03/2009
      Automatic rescaling
  * 14/11/2008
@@ -27,6 +27,9 @@ public:
 	// clLoader<iTexture> interface
 	//
 	virtual bool Load( iIStream* IStream, clBitmap* Resource, bool IsAutoGradient, bool IsAutoESL );
+
+	/// Route the VolumeLib parallel loops (bricked filters and histograms) to the job system of Env
+	static void InstallParallelFor( sEnvironment* Env );
 private:
 	inline LString GetRescaledFileName( const LString& CachingDir, const LString& FileName )
 	{
@@ -76,6 +79,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     InstallParallelFor()
  * 13/05/2009
      Finally, dynamic linking with volume_proc.dll
  * 02/10/2007
@@ -294,7 +294,7 @@ void VoxelNeighbourhoodIterator::FetchNeighbourhood()
 					for ( p = 0 ; p < BPP ; p++ )
 					{
 						// TODO : use increments instead of direct calculation
-						VoxelAddr = &reinterpret_cast<unsigned char*>( SelLinePtr )[CurX + ( i )*BPP + p];
+						VoxelAddr = &reinterpret_cast<unsigned char*>( SelLinePtr )[( CurX + i ) * BPP + p];
 
 						// TODO : remove this from the inner loop, do the recalculation of i_start and i_end !
 						if ( CurX + i < 0 || CurX + i > Width - 1 )
@@ -338,7 +338,8 @@ bool VoxelNeighbourhoodIterator::MoveToNextXVoxel()
 		CurX = MinX;
 		CurY++;
 
-		if ( CurY >= MaxY )
+		// MaxY is the last row, as MaxX is the last voxel in the row
+		if ( CurY > MaxY )
 		{
 			CurY = MinY;
 			CurZ++;
@@ -437,6 +438,155 @@ bool VoxelNeighbourhoodIterator::IsLastVoxel() const
 	return false;
 }
 
+// Parallel execution
+
+static VL_ParallelForCallback g_ParallelFor = 0;
+static void* g_ParallelForContext = 0;
+
+void VL_ParallelFor( VL_RangeProc Proc, void* Param, size_t Count )
+{
+	if ( Count == 0 ) { return; }
+
+	if ( g_ParallelFor != 0 && Count > 1 )
+	{
+		g_ParallelFor( g_ParallelForContext, Proc, Param, Count );
+	}
+	else
+	{
+		Proc( Param, 0, Count );
+	}
+}
+
+// Bricked volume
+
+BrickedVolume::BrickedVolume( int W, int H, int D, int bpp, int brickSize )
+	: Width( W ), Height( H ), Depth( D ), BPP( bpp )
+{
+	// round the brick size to the power of two
+	BrickShift = 0;
+
+	while ( ( 2 << BrickShift ) <= brickSize ) { BrickShift++; }
+
+	BrickSize = 1 << BrickShift;
+	BrickMask = BrickSize - 1;
+
+	NumBricksX = ( W + BrickMask ) >> BrickShift;
+	NumBricksY = ( H + BrickMask ) >> BrickShift;
+	NumBricksZ = ( D + BrickMask ) >> BrickShift;
+
+	size_t Size = static_cast<size_t>( GetNumBricks() ) * BrickSize * BrickSize * BrickSize * BPP;
+
+	TheData = new unsigned char[Size];
+
+	FillWithZeroes();
+}
+
+BrickedVolume::~BrickedVolume()
+{
+	delete [] TheData;
+}
+
+void BrickedVolume::FillWithZeroes()
+{
+	memset( TheData, 0, static_cast<size_t>( GetNumBricks() ) * BrickSize * BrickSize * BrickSize * BPP );
+}
+
+bool BrickedVolume::IsInteriorBrick( int Idx, int Radius ) const
+{
+	int X0, Y0, Z0;
+	GetBrickOrigin( Idx, X0, Y0, Z0 );
+
+	return ( X0 - Radius >= 0 ) && ( Y0 - Radius >= 0 ) && ( Z0 - Radius >= 0 ) &&
+	       ( X0 + BrickSize + Radius <= Width ) && ( Y0 + BrickSize + Radius <= Height ) && ( Z0 + BrickSize + Radius <= Depth );
+}
+
+void BrickedVolume::PutRow( int Y, int Z, const unsigned char* Src )
+{
+	// the row is split into BrickSize-long contiguous pieces
+	for ( int X = 0 ; X < Width ; X += BrickSize )
+	{
+		int Count = ( X + BrickSize < Width ) ? BrickSize : Width - X;
+
+		memcpy( GetVoxelPtr( X, Y, Z ), Src + X * BPP, Count * BPP );
+	}
+}
+
+void BrickedVolume::GetRow( int Y, int Z, unsigned char* Dst ) const
+{
+	for ( int X = 0 ; X < Width ; X += BrickSize )
+	{
+		int Count = ( X + BrickSize < Width ) ? BrickSize : Width - X;
+
+		memcpy( Dst + X * BPP, GetVoxelPtr( X, Y, Z ), Count * BPP );
+	}
+}
+
+void BrickedVolume::LoadFromSlicer( VolumeSlicer* Slicer, int StartZ, int FinishZ, int* CurrentSlice )
+{
+	*CurrentSlice = 0;
+
+	for ( int Z = StartZ ; Z < FinishZ ; Z++ )
+	{
+		VolumeSlice* Slice = Slicer->GetZSlicePtr( Z );
+
+		for ( int Y = 0 ; Y < Height ; Y++ )
+		{
+			PutRow( Y, Z, reinterpret_cast<unsigned char*>( Slice->GetRowPtr( Y ) ) );
+		}
+
+		( *CurrentSlice )++;
+	}
+}
+
+void BrickedVolume::WriteToWriter( VolumeWriter* Writer, int StartZ, int FinishZ, int* CurrentSlice ) const
+{
+	VolumeSlice NewZSlice( Width, Height, BPP, true, 0 );
+
+	*CurrentSlice = 0;
+
+	for ( int Z = StartZ ; Z < FinishZ ; Z++ )
+	{
+		for ( int Y = 0 ; Y < Height ; Y++ )
+		{
+			GetRow( Y, Z, reinterpret_cast<unsigned char*>( NewZSlice.GetRowPtr( Y ) ) );
+		}
+
+		Writer->WriteSliceZ( Z, &NewZSlice );
+
+		( *CurrentSlice )++;
+	}
+}
+
+void BrickedVolume::LoadFromLinear( VOLUME_PTR Data )
+{
+	const unsigned char* Src = reinterpret_cast<const unsigned char*>( Data );
+
+	size_t RowSize = static_cast<size_t>( Width ) * BPP;
+
+	for ( int Z = 0 ; Z < Depth ; Z++ )
+	{
+		for ( int Y = 0 ; Y < Height ; Y++ )
+		{
+			PutRow( Y, Z, Src + ( static_cast<size_t>( Z ) * Height + Y ) * RowSize );
+		}
+	}
+}
+
+void BrickedVolume::StoreToLinear( VOLUME_PTR Data ) const
+{
+	unsigned char* Dst = reinterpret_cast<unsigned char*>( Data );
+
+	size_t RowSize = static_cast<size_t>( Width ) * BPP;
+
+	for ( int Z = 0 ; Z < Depth ; Z++ )
+	{
+		for ( int Y = 0 ; Y < Height ; Y++ )
+		{
+			GetRow( Y, Z, Dst + ( static_cast<size_t>( Z ) * Height + Y ) * RowSize );
+		}
+	}
+}
+
 void SeriesVolumeWriter::WriteSliceZ( int Z, VolumeSlice* Slice )
 {
 	char buf[1024];
@@ -1088,7 +1238,7 @@ void* VL_CreateVolumeSlicer( int W, int H, int D, int BPP )
 extern "C"
 void  VL_DeleteVolumeSlicer( void* Slicer )
 {
-	delete [] reinterpret_cast<VolumeSlicer*>( Slicer );
+	delete reinterpret_cast<VolumeSlicer*>( Slicer );
 }
 
 extern "C"
@@ -1242,6 +1392,107 @@ extern "C" void VL_CalculateESLMap16( void* Slicer, int W, int H, int D, int BPP
 }
 
 
+// parallel execution and bricked volumes
+
+extern "C"
+void VL_SetParallelForCallback( VL_ParallelForCallback Callback, void* Context )
+{
+	g_ParallelFor = Callback;
+	g_ParallelForContext = Context;
+}
+
+extern "C"
+void* VL_CreateBrickedVolume( int W, int H, int D, int BPP, int BrickSize )
+{
+	return new BrickedVolume( W, H, D, BPP, BrickSize );
+}
+
+extern "C"
+void  VL_DeleteBrickedVolume( void* Bricked )
+{
+	delete reinterpret_cast<BrickedVolume*>( Bricked );
+}
+
+extern "C"
+void  VL_LoadBrickedVolume( void* Bricked, void* Slicer, int* CurrentSlice )
+{
+	BrickedVolume* Vol = reinterpret_cast<BrickedVolume*>( Bricked );
+
+	Vol->LoadFromSlicer( reinterpret_cast<VolumeSlicer*>( Slicer ), 0, Vol->GetDepth(), CurrentSlice );
+}
+
+extern "C"
+void  VL_WriteBrickedVolume( void* Bricked, void* writer, int StartZ, int FinishZ, int* CurrentSlice )
+{
+	reinterpret_cast<BrickedVolume*>( Bricked )->WriteToWriter( reinterpret_cast<VolumeWriter*>( writer ), StartZ, FinishZ, CurrentSlice );
+}
+
+// separable gaussian smoothing of the bricked volume, the kernel is exp(-r^2/sigma^2)
+#define MAKE_SEPARABLE_GAUSSIAN_IMPL(FuncName, SampleType) \
+extern "C"\
+void FuncName(void* In, void* Out, int size, float sigma) \
+{\
+std::vector<float> filter( size );\
+PrepareGaussianFilter1D<float>( size, sigma * sigma, &filter[0] );\
+MakeSeparableBrickedConvolution<SampleType,float>(reinterpret_cast<BrickedVolume*>(In),reinterpret_cast<BrickedVolume*>(Out),size,&filter[0],&filter[0],&filter[0]);\
+}
+
+MAKE_SEPARABLE_GAUSSIAN_IMPL( VL_MakeSeparableGaussian8_Single, unsigned char )
+MAKE_SEPARABLE_GAUSSIAN_IMPL( VL_MakeSeparableGaussian16_Single, unsigned short )
+
+// density histogram of the bricked volume, Bins[] is not cleared
+extern "C"
+void VL_CollectBrickedHistogram8( void* Bricked, int NumBins, unsigned int* Bins )
+{
+	VolumeHistogram1D Hist( NumBins, sizeof( unsigned int ), Bins, false );
+	Hist.CollectSamples<unsigned int, unsigned char>( reinterpret_cast<BrickedVolume*>( Bricked ) );
+}
+
+extern "C"
+void VL_CollectBrickedHistogram16( void* Bricked, int NumBins, unsigned int* Bins )
+{
+	VolumeHistogram1D Hist( NumBins, sizeof( unsigned int ), Bins, false );
+	Hist.CollectSamples<unsigned int, unsigned short>( reinterpret_cast<BrickedVolume*>( Bricked ) );
+}
+
+extern "C"
+void VL_LoadBrickedVolumeFromLinear( void* Bricked, VOLUME_PTR Data )
+{
+	reinterpret_cast<BrickedVolume*>( Bricked )->LoadFromLinear( Data );
+}
+
+extern "C"
+void VL_StoreBrickedVolumeToLinear( void* Bricked, VOLUME_PTR Data )
+{
+	reinterpret_cast<BrickedVolume*>( Bricked )->StoreToLinear( Data );
+}
+
+// full Size^3 kernel convolution of the bricked volume, the kernel layout is the same as in VL_MakeConvolution*
+#define MAKE_BRICKED_CONV_FILTER_IMPL(FuncName, SampleType) \
+extern "C"\
+void FuncName(void* In, void* Out, int size, float* filter) \
+{\
+MakeScalarBrickedConvolution<SampleType,float>(reinterpret_cast<BrickedVolume*>(In),reinterpret_cast<BrickedVolume*>(Out),size,filter);\
+}
+
+MAKE_BRICKED_CONV_FILTER_IMPL( VL_MakeBrickedConvolution8_Single, unsigned char )
+MAKE_BRICKED_CONV_FILTER_IMPL( VL_MakeBrickedConvolution16_Single, unsigned short )
+
+// (density, gradient magnitude) histogram of the bricked volume, W*H bins, Bins[] is not cleared
+extern "C"
+void VL_CollectBrickedHistogram2D8( void* Bricked, int W, int H, double MaxValue, double MaxGradient, unsigned int* Bins )
+{
+	VolumeHistogram2D Hist( W, H, sizeof( unsigned int ), Bins, false );
+	Hist.CollectSamples<unsigned int, unsigned char>( reinterpret_cast<BrickedVolume*>( Bricked ), MaxValue, MaxGradient );
+}
+
+extern "C"
+void VL_CollectBrickedHistogram2D16( void* Bricked, int W, int H, double MaxValue, double MaxGradient, unsigned int* Bins )
+{
+	VolumeHistogram2D Hist( W, H, sizeof( unsigned int ), Bins, false );
+	Hist.CollectSamples<unsigned int, unsigned short>( reinterpret_cast<BrickedVolume*>( Bricked ), MaxValue, MaxGradient );
+}
+
 extern "C"
 int VL_GetLastErrorCode()
 {
@@ -39,6 +39,10 @@ typedef size_t ( *VL_ReadCallback )( void* DataSource, VOLUME_PTR block, size_t
 typedef int ( *VL_WriteSeekCallback )( void* DataSource, size_t Offset );
 typedef size_t ( *VL_WriteCallback )( void* DataSource, VOLUME_PTR block, size_t Offset );
 
+// parallel execution callback : must call Proc for each subrange of [0..Count) and return when all of them are finished
+typedef void ( *VL_RangeProc )( void* Param, size_t Begin, size_t End );
+typedef void ( *VL_ParallelForCallback )( void* Context, VL_RangeProc Proc, void* Param, size_t Count );
+
 class InStream;
 class OutStream;
 
@@ -520,6 +524,163 @@ private:
 	VolumeSlice* GetSliceByCoord( int Z );
 };
 
+/**
+   Runs Proc( Param, Begin, End ) over the [0..Count) range
+
+   The work is dispatched through the callback installed with VL_SetParallelForCallback(),
+   or executed on the calling thread if there is none. Proc must be ready to be called
+   concurrently for disjoint subranges
+**/
+void VL_ParallelFor( VL_RangeProc Proc, void* Param, size_t Count );
+
+class VolumeWriter;
+
+// default edge of the cubic brick (must be a power of two)
+#define DEFAULT_BRICK_SIZE 32
+
+/**
+   In-memory volume stored as a grid of cubic bricks (BrickSize^3 voxels each)
+
+   The linear slice-by-slice layout puts z-neighbours Width*Height*BPP bytes apart,
+   so every filter tap in the z direction is a cache miss for large volumes.
+   Here the voxel (x,y,z) lives in the brick (x/BrickSize, y/BrickSize, z/BrickSize)
+   and the whole neighbourhood of a voxel usually fits in a few cache-resident bricks.
+
+   Bricks are independent units of work : the filters and histograms below
+   process them in parallel with VL_ParallelFor()
+
+   The edge bricks are padded up to BrickSize, padding voxels are never read
+**/
+class BrickedVolume
+{
+public:
+	/**
+	   Allocates zero-filled storage for the W x H x D volume with bpp bytes per voxel
+	**/
+	BrickedVolume( int W, int H, int D, int bpp, int brickSize = DEFAULT_BRICK_SIZE );
+
+	virtual ~BrickedVolume();
+
+	inline int GetBPP()    const { return BPP;    }
+	inline int GetWidth()  const { return Width;  }
+	inline int GetHeight() const { return Height; }
+	inline int GetDepth()  const { return Depth;  }
+
+	inline int GetBrickSize() const { return BrickSize; }
+	inline int GetNumBricks() const { return NumBricksX * NumBricksY * NumBricksZ; }
+
+	/**
+	   Number of bricks along the axis (0 - X, 1 - Y, 2 - Z)
+	**/
+	inline int GetNumBricksAlong( int Axis ) const { return ( Axis == 0 ) ? NumBricksX : ( ( Axis == 1 ) ? NumBricksY : NumBricksZ ); }
+
+	/**
+	   Coordinates of the first voxel in the brick
+	**/
+	inline void GetBrickOrigin( int Idx, int& X, int& Y, int& Z ) const
+	{
+		X = ( Idx % NumBricksX ) << BrickShift;
+		Y = ( ( Idx / NumBricksX ) % NumBricksY ) << BrickShift;
+		Z = ( Idx / ( NumBricksX * NumBricksY ) ) << BrickShift;
+	}
+
+	/**
+	   Is the neighbourhood of given radius around each voxel of the brick entirely inside the volume ?
+	   For such bricks the boundary checks can be skipped
+	**/
+	bool IsInteriorBrick( int Idx, int Radius ) const;
+
+	/**
+	   Direct access to the voxel, coordinates must be inside the volume
+	**/
+	inline VOLUME_PTR GetVoxelPtr( int X, int Y, int Z ) const
+	{
+		size_t Brick = ( static_cast<size_t>( Z >> BrickShift ) * NumBricksY + ( Y >> BrickShift ) ) * NumBricksX + ( X >> BrickShift );
+		size_t Local = ( ( ( Z & BrickMask ) << BrickShift | ( Y & BrickMask ) ) << BrickShift ) | ( X & BrickMask );
+
+		return &TheData[( ( Brick << ( 3 * BrickShift ) ) + Local ) * BPP];
+	}
+
+	template <class VoxelT> inline VoxelT GetVoxel( int X, int Y, int Z ) const
+	{
+		return *reinterpret_cast<VoxelT*>( GetVoxelPtr( X, Y, Z ) );
+	}
+
+	/**
+	   Same as GetVoxel(), but returns zero outside the volume (as the zero 'proxy' slice of VolumeSlicer does)
+	**/
+	template <class VoxelT> inline VoxelT GetSafeVoxel( int X, int Y, int Z ) const
+	{
+		if ( X < 0 || Y < 0 || Z < 0 || X >= Width || Y >= Height || Z >= Depth ) { return static_cast<VoxelT>( 0 ); }
+
+		return GetVoxel<VoxelT>( X, Y, Z );
+	}
+
+	template <class VoxelT> inline void PutVoxel( int X, int Y, int Z, VoxelT Value )
+	{
+		*reinterpret_cast<VoxelT*>( GetVoxelPtr( X, Y, Z ) ) = Value;
+	}
+
+	/**
+	   Fetches the Size^3 neighbourhood of (X,Y,Z) into Values[]
+
+	   The layout is the same as in VoxelNeighbourhoodIterator (x runs fastest),
+	   so the filter kernels prepared for it can be used as is
+	**/
+	template <class VoxelT> void FetchNeighbourhood( int X, int Y, int Z, int Size, VoxelT* Values ) const
+	{
+		int Size2 = Size / 2;
+
+		for ( int k = -Size2 ; k <= Size2 ; k++ )
+		{
+			for ( int j = -Size2 ; j <= Size2 ; j++ )
+			{
+				for ( int i = -Size2 ; i <= Size2 ; i++ )
+				{
+					*Values++ = GetSafeVoxel<VoxelT>( X + i, Y + j, Z + k );
+				}
+			}
+		}
+	}
+
+	void FillWithZeroes();
+
+	/**
+	   Reads [StartZ..FinishZ) slices from the slicer. The slicer sizes and BPP must match
+	**/
+	void LoadFromSlicer( VolumeSlicer* Slicer, int StartZ, int FinishZ, int* CurrentSlice );
+
+	/**
+	   Writes [StartZ..FinishZ) slices using the linear slice layout
+	**/
+	void WriteToWriter( VolumeWriter* Writer, int StartZ, int FinishZ, int* CurrentSlice ) const;
+
+	/**
+	   Conversion from/to the flat W*H*D*BPP array
+	**/
+	void LoadFromLinear( VOLUME_PTR Data );
+	void StoreToLinear( VOLUME_PTR Data ) const;
+
+private:
+	/// copy one x-row of voxels from/to the linear buffer
+	void PutRow( int Y, int Z, const unsigned char* Src );
+	void GetRow( int Y, int Z, unsigned char* Dst ) const;
+
+private:
+	int Width, Height, Depth, BPP;
+
+	int BrickSize, BrickShift, BrickMask;
+	int NumBricksX, NumBricksY, NumBricksZ;
+
+	/// all the bricks, one after another
+	unsigned char* TheData;
+
+private:
+	/// the volume owns TheData, copies are not allowed
+	BrickedVolume( const BrickedVolume& );
+	BrickedVolume& operator = ( const BrickedVolume& );
+};
+
 
 /**
    Used in filtering processes
@@ -771,6 +932,159 @@ private:
 	void FetchNeighbourhood();
 };
 
+// number of independent bin sets used by the parallel histogram collection
+#define HISTOGRAM_CHUNKS 16
+
+/**
+   Parallel histogram collection over a bricked volume
+
+   The bricks are split into HISTOGRAM_CHUNKS contiguous groups and each group
+   accumulates into its own (thread-local) bin set. The bin sets are added to the output at the end,
+   so no locking is needed and the result does not depend on the number of threads
+
+   Collector::operator()( Vol, X, Y, Z, Bins ) increments the bins for a single voxel
+**/
+template <class SampleType, class Collector>
+class BrickedHistogramTask
+{
+public:
+	BrickedHistogramTask( const BrickedVolume* vol, size_t binCount, const Collector& collector )
+		: Vol( vol ), BinCount( binCount ), TheCollector( collector )
+	{
+		NumChunks = static_cast<size_t>( Vol->GetNumBricks() );
+
+		if ( NumChunks > HISTOGRAM_CHUNKS ) { NumChunks = HISTOGRAM_CHUNKS; }
+	}
+
+	/**
+	   Collects the samples and adds them to Output[0..BinCount)
+	**/
+	void Run( SampleType* Output )
+	{
+		ChunkBins.assign( NumChunks * BinCount, static_cast<SampleType>( 0 ) );
+
+		VL_ParallelFor( &CollectChunks, this, NumChunks );
+
+		for ( size_t c = 0 ; c < NumChunks ; c++ )
+		{
+			const SampleType* Bins = &ChunkBins[c * BinCount];
+
+			for ( size_t i = 0 ; i < BinCount ; i++ ) { Output[i] += Bins[i]; }
+		}
+	}
+
+private:
+	static void CollectChunks( void* Param, size_t Begin, size_t End )
+	{
+		BrickedHistogramTask* Task = reinterpret_cast<BrickedHistogramTask*>( Param );
+
+		const BrickedVolume* Vol = Task->Vol;
+
+		size_t NumBricks = static_cast<size_t>( Vol->GetNumBricks() );
+		int BS = Vol->GetBrickSize();
+
+		for ( size_t c = Begin ; c < End ; c++ )
+		{
+			SampleType* Bins = &Task->ChunkBins[c * Task->BinCount];
+
+			size_t FirstBrick = c * NumBricks / Task->NumChunks;
+			size_t LastBrick  = ( c + 1 ) * NumBricks / Task->NumChunks;
+
+			for ( size_t b = FirstBrick ; b < LastBrick ; b++ )
+			{
+				int X0, Y0, Z0;
+				Vol->GetBrickOrigin( static_cast<int>( b ), X0, Y0, Z0 );
+
+				int X1 = ( X0 + BS < Vol->GetWidth()  ) ? X0 + BS : Vol->GetWidth();
+				int Y1 = ( Y0 + BS < Vol->GetHeight() ) ? Y0 + BS : Vol->GetHeight();
+				int Z1 = ( Z0 + BS < Vol->GetDepth()  ) ? Z0 + BS : Vol->GetDepth();
+
+				for ( int Z = Z0 ; Z < Z1 ; Z++ )
+				{
+					for ( int Y = Y0 ; Y < Y1 ; Y++ )
+					{
+						for ( int X = X0 ; X < X1 ; X++ )
+						{
+							Task->TheCollector( Vol, X, Y, Z, Bins );
+						}
+					}
+				}
+			}
+		}
+	}
+
+private:
+	const BrickedVolume* Vol;
+	size_t BinCount;
+	size_t NumChunks;
+	Collector TheCollector;
+
+	/// NumChunks consecutive bin sets
+	vector<SampleType> ChunkBins;
+};
+
+/**
+   Density histogram : the voxel value is the bin index
+**/
+template <class SampleType, class VoxelT>
+struct DensityCollector
+{
+	explicit DensityCollector( size_t len ) : Len( len ) {}
+
+	inline void operator()( const BrickedVolume* Vol, int X, int Y, int Z, SampleType* Bins ) const
+	{
+		size_t Idx = static_cast<size_t>( Vol->GetVoxel<VoxelT>( X, Y, Z ) );
+
+		if ( Idx < Len ) { Bins[Idx]++; }
+	}
+
+	size_t Len;
+};
+
+/**
+   (density, gradient magnitude) histogram used for 2D transfer functions
+
+   The gradient is estimated with central differences, values are mapped
+   linearly from [0..MaxValue] and [0..MaxGradient] to the bin ranges.
+   Non-positive MaxValue or MaxGradient puts everything into the first bin along that axis
+**/
+template <class SampleType, class VoxelT>
+struct DensityGradientCollector
+{
+	DensityGradientCollector( int w, int h, double maxValue, double maxGradient )
+		: W( w ), H( h ),
+		  ValueScale( ( maxValue > 0.0 ) ? static_cast<double>( w - 1 ) / maxValue : 0.0 ),
+		  GradientScale( ( maxGradient > 0.0 ) ? static_cast<double>( h - 1 ) / maxGradient : 0.0 ) {}
+
+	inline void operator()( const BrickedVolume* Vol, int X, int Y, int Z, SampleType* Bins ) const
+	{
+		double V  = static_cast<double>( Vol->GetVoxel<VoxelT>( X, Y, Z ) );
+		double Gx = static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X + 1, Y, Z ) ) - static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X - 1, Y, Z ) );
+		double Gy = static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X, Y + 1, Z ) ) - static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X, Y - 1, Z ) );
+		double Gz = static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X, Y, Z + 1 ) ) - static_cast<double>( Vol->GetSafeVoxel<VoxelT>( X, Y, Z - 1 ) );
+
+		double G = 0.5 * sqrt( Gx * Gx + Gy * Gy + Gz * Gz );
+
+		int i = static_cast<int>( V * ValueScale );
+		int j = static_cast<int>( G * GradientScale );
+
+		if ( i < 0 ) { i = 0; }
+
+		if ( i > W - 1 ) { i = W - 1; }
+
+		if ( j < 0 ) { j = 0; }
+
+		if ( j > H - 1 ) { j = H - 1; }
+
+		Bins[j * W + i]++;
+	}
+
+	int W, H;
+
+	/// bins per unit of density and gradient magnitude
+	double ValueScale, GradientScale;
+};
+
 class VolumeHistogram
 {
 public:
@@ -910,6 +1224,17 @@ public:
 		}
 	}
 
+	/**
+	   Collect density values from the bricked volume, the bricks are processed in parallel
+	**/
+	template<class SampleType, class VoxelT>
+	void CollectSamples( const BrickedVolume* Vol )
+	{
+		BrickedHistogramTask< SampleType, DensityCollector<SampleType, VoxelT> > Task( Vol, DataLength, DensityCollector<SampleType, VoxelT>( DataLength ) );
+
+		Task.Run( reinterpret_cast<SampleType*>( TheData ) );
+	}
+
 	virtual ~VolumeHistogram1D()
 	{
 	}
@@ -936,6 +1261,22 @@ public:
 	         int H = Slicer->GetHeight();
 	      }
 	*/
+
+	/**
+	   Collect (density, gradient magnitude) pairs from the bricked volume, the bricks are processed in parallel
+
+	   Density goes along the X axis of the histogram, gradient magnitude along the Y axis.
+	   MaxValue and MaxGradient are mapped to the last bin
+	**/
+	template<class SampleType, class VoxelT>
+	void CollectSamples( const BrickedVolume* Vol, double MaxValue, double MaxGradient )
+	{
+		BrickedHistogramTask< SampleType, DensityGradientCollector<SampleType, VoxelT> > Task( Vol, DataLength,
+		      DensityGradientCollector<SampleType, VoxelT>( Width, Height, MaxValue, MaxGradient ) );
+
+		Task.Run( reinterpret_cast<SampleType*>( TheData ) );
+	}
+
 	template<class SampleType>
 	void RenderRGBABitmap( unsigned char* BMP )
 	{
@@ -2047,7 +2388,237 @@ void PrepareGaussianFilter( int Size, FilterCoeffT SigmaSqr, FilterCoeffT* filte
 	// 2. normalize the kernel
 	int N = Size * Size * Size;
 
-	for ( ofs = 0 ; ofs < N; ofs++ ) { filter[ofs++] /= sum; }
+	for ( ofs = 0 ; ofs < N; ofs++ ) { filter[ofs] /= sum; }
+}
+
+// 1-d gaussian kernel. The product of three such kernels is the PrepareGaussianFilter() kernel
+template <class FilterCoeffT>
+void PrepareGaussianFilter1D( int Size, FilterCoeffT SigmaSqr, FilterCoeffT* filter )
+{
+	int Size2 = Size / 2;
+
+	FilterCoeffT sum = 0.0;
+
+	for ( int i = -Size2 ; i <= Size2 ; i++ )
+	{
+		filter[i + Size2] = exp( -( static_cast<FilterCoeffT>( i * i ) ) / SigmaSqr );
+		sum += filter[i + Size2];
+	}
+
+	for ( int i = 0 ; i < Size ; i++ ) { filter[i] /= sum; }
+}
+
+/**
+   Full Size^3 kernel convolution of a bricked volume, each brick is a separate parallel work item
+**/
+template <class VoxelT, class VoxelOutT, class FilterCoeffsT>
+class BrickedConvolutionTask
+{
+public:
+	BrickedConvolutionTask( const BrickedVolume* in, BrickedVolume* out, int size, const FilterCoeffsT* filter )
+		: In( in ), Out( out ), Size( size ), Filter( filter ) {}
+
+	void Run()
+	{
+		VL_ParallelFor( &ConvolveBricks, this, static_cast<size_t>( In->GetNumBricks() ) );
+	}
+
+private:
+	static void ConvolveBricks( void* Param, size_t Begin, size_t End )
+	{
+		BrickedConvolutionTask* Task = reinterpret_cast<BrickedConvolutionTask*>( Param );
+
+		const BrickedVolume* In = Task->In;
+
+		int BS = In->GetBrickSize();
+		int Size = Task->Size;
+		int Size2 = Size / 2;
+
+		// the brick with its apron is copied to a linear block, so the kernel taps have constant offsets
+		int BlockSize = BS + 2 * Size2;
+		int SliceSize = BlockSize * BlockSize;
+
+		vector<FilterCoeffsT> Block( BlockSize * SliceSize );
+		vector<int> TapOfs( Size * Size * Size );
+
+		int t = 0;
+
+		for ( int k = 0 ; k < Size ; k++ )
+		{
+			for ( int j = 0 ; j < Size ; j++ )
+			{
+				for ( int i = 0 ; i < Size ; i++ ) { TapOfs[t++] = k * SliceSize + j * BlockSize + i; }
+			}
+		}
+
+		for ( size_t b = Begin ; b < End ; b++ )
+		{
+			int X0, Y0, Z0;
+			In->GetBrickOrigin( static_cast<int>( b ), X0, Y0, Z0 );
+
+			int X1 = ( X0 + BS < In->GetWidth()  ) ? X0 + BS : In->GetWidth();
+			int Y1 = ( Y0 + BS < In->GetHeight() ) ? Y0 + BS : In->GetHeight();
+			int Z1 = ( Z0 + BS < In->GetDepth()  ) ? Z0 + BS : In->GetDepth();
+
+			// no boundary checks for the bricks far from the volume border
+			bool Interior = In->IsInteriorBrick( static_cast<int>( b ), Size2 );
+
+			FilterCoeffsT* Dst = &Block[0];
+
+			for ( int Z = Z0 - Size2 ; Z < Z0 + BS + Size2 ; Z++ )
+			{
+				for ( int Y = Y0 - Size2 ; Y < Y0 + BS + Size2 ; Y++ )
+				{
+					for ( int X = X0 - Size2 ; X < X0 + BS + Size2 ; X++ )
+					{
+						*Dst++ = static_cast<FilterCoeffsT>( Interior ? In->GetVoxel<VoxelT>( X, Y, Z ) : In->GetSafeVoxel<VoxelT>( X, Y, Z ) );
+					}
+				}
+			}
+
+			for ( int Z = Z0 ; Z < Z1 ; Z++ )
+			{
+				for ( int Y = Y0 ; Y < Y1 ; Y++ )
+				{
+					const FilterCoeffsT* Src = &Block[( Z - Z0 ) * SliceSize + ( Y - Y0 ) * BlockSize];
+
+					for ( int X = X0 ; X < X1 ; X++, Src++ )
+					{
+						FilterCoeffsT sum = 0;
+
+						for ( t = 0 ; t < static_cast<int>( TapOfs.size() ) ; t++ ) { sum += Task->Filter[t] * Src[TapOfs[t]]; }
+
+						Task->Out->PutVoxel<VoxelOutT>( X, Y, Z, static_cast<VoxelOutT>( sum ) );
+					}
+				}
+			}
+		}
+	}
+
+private:
+	const BrickedVolume* In;
+	BrickedVolume* Out;
+	int Size;
+	const FilterCoeffsT* Filter;
+};
+
+/**
+   One pass of the separable convolution : Size-tap 1-d kernel along the Axis (0 - X, 1 - Y, 2 - Z)
+
+   The work item is a column of bricks along the Axis. Each line of voxels is copied to a local buffer
+   before filtering, so In and Out can be the same volume
+**/
+template <class VoxelT, class VoxelOutT, class FilterCoeffsT>
+class BrickedLineConvolutionTask
+{
+public:
+	BrickedLineConvolutionTask( const BrickedVolume* in, BrickedVolume* out, int axis, int size, const FilterCoeffsT* filter )
+		: In( in ), Out( out ), Axis( axis ), Size( size ), Filter( filter ) {}
+
+	void Run()
+	{
+		size_t NumColumns = static_cast<size_t>( In->GetNumBricks() ) / static_cast<size_t>( In->GetNumBricksAlong( Axis ) );
+
+		VL_ParallelFor( &ConvolveColumns, this, NumColumns );
+	}
+
+private:
+	static void ConvolveColumns( void* Param, size_t Begin, size_t End )
+	{
+		BrickedLineConvolutionTask* Task = reinterpret_cast<BrickedLineConvolutionTask*>( Param );
+
+		const BrickedVolume* In = Task->In;
+
+		int Dims[3] = { In->GetWidth(), In->GetHeight(), In->GetDepth() };
+
+		// U and V are the axes orthogonal to the filtering direction
+		int A = Task->Axis;
+		int U = ( A == 0 ) ? 1 : 0;
+		int V = ( A == 2 ) ? 1 : 2;
+
+		int BS = In->GetBrickSize();
+		int Len = Dims[A];
+		int Size2 = Task->Size / 2;
+		int NumBricksU = In->GetNumBricksAlong( U );
+
+		// zero-padded line : the same border handling as in VolumeSlicer
+		vector<FilterCoeffsT> Line( Len + 2 * Size2, static_cast<FilterCoeffsT>( 0 ) );
+
+		int Coords[3];
+
+		for ( size_t c = Begin ; c < End ; c++ )
+		{
+			int U0 = static_cast<int>( c % NumBricksU ) * BS;
+			int V0 = static_cast<int>( c / NumBricksU ) * BS;
+
+			int U1 = ( U0 + BS < Dims[U] ) ? U0 + BS : Dims[U];
+			int V1 = ( V0 + BS < Dims[V] ) ? V0 + BS : Dims[V];
+
+			for ( Coords[V] = V0 ; Coords[V] < V1 ; Coords[V]++ )
+			{
+				for ( Coords[U] = U0 ; Coords[U] < U1 ; Coords[U]++ )
+				{
+					for ( Coords[A] = 0 ; Coords[A] < Len ; Coords[A]++ )
+					{
+						Line[Coords[A] + Size2] = static_cast<FilterCoeffsT>( In->GetVoxel<VoxelT>( Coords[0], Coords[1], Coords[2] ) );
+					}
+
+					for ( Coords[A] = 0 ; Coords[A] < Len ; Coords[A]++ )
+					{
+						const FilterCoeffsT* Src = &Line[Coords[A]];
+
+						FilterCoeffsT sum = 0;
+
+						for ( int k = 0 ; k < Task->Size ; k++ ) { sum += Task->Filter[k] * Src[k]; }
+
+						Task->Out->PutVoxel<VoxelOutT>( Coords[0], Coords[1], Coords[2], static_cast<VoxelOutT>( sum ) );
+					}
+				}
+			}
+		}
+	}
+
+private:
+	const BrickedVolume* In;
+	BrickedVolume* Out;
+	int Axis;
+	int Size;
+	const FilterCoeffsT* Filter;
+};
+
+/**
+   Scalar convolution of the bricked volume with the Size^3 kernel (same kernel layout as in MakeScalarVolumeConvolution)
+   Bricks are processed in parallel
+**/
+template <class VoxelT, class FilterCoeffsT>
+void MakeScalarBrickedConvolution( const BrickedVolume* In, BrickedVolume* Out, int Size, const FilterCoeffsT* filter )
+{
+	BrickedConvolutionTask<VoxelT, VoxelT, FilterCoeffsT> Task( In, Out, Size, filter );
+
+	Task.Run();
+}
+
+/**
+   Separable scalar convolution : the kernel is filterX[i]*filterY[j]*filterZ[k], each of the filters has Size taps
+
+   Costs 3*Size operations per voxel instead of Size^3. The intermediate results are stored with FilterCoeffsT precision,
+   so the output matches MakeScalarBrickedConvolution() with the equivalent 3-d kernel up to rounding
+**/
+template <class VoxelT, class FilterCoeffsT>
+void MakeSeparableBrickedConvolution( const BrickedVolume* In, BrickedVolume* Out, int Size,
+                                      const FilterCoeffsT* filterX, const FilterCoeffsT* filterY, const FilterCoeffsT* filterZ )
+{
+	BrickedVolume Tmp( In->GetWidth(), In->GetHeight(), In->GetDepth(), sizeof( FilterCoeffsT ), In->GetBrickSize() );
+
+	BrickedLineConvolutionTask<VoxelT, FilterCoeffsT, FilterCoeffsT> PassX( In, &Tmp, 0, Size, filterX );
+	PassX.Run();
+
+	// in-place
+	BrickedLineConvolutionTask<FilterCoeffsT, FilterCoeffsT, FilterCoeffsT> PassY( &Tmp, &Tmp, 1, Size, filterY );
+	PassY.Run();
+
+	BrickedLineConvolutionTask<FilterCoeffsT, VoxelT, FilterCoeffsT> PassZ( &Tmp, Out, 2, Size, filterZ );
+	PassZ.Run();
 }
 
 /**
@@ -2295,6 +2866,21 @@ extern "C" {
 	DLLIMPORT void VL_MakeVec4SingleVolumeConvolution_Quantize8( void* Slicer, int W, int H, int D, int BPP, void* writer, int StartZ, int FinishZ, int size, float* filter, int* CurrentSlice );
 	DLLIMPORT void VL_CalculateESLMap8( void* Slicer, int W, int H, int D, int BPP, int Factor, void* output, int StartZ, int FinishZ, int* CurrentSlice );
 	DLLIMPORT void VL_CalculateESLMap16( void* Slicer, int W, int H, int D, int BPP, int Factor, void* output, int StartZ, int FinishZ, int* CurrentSlice );
+	DLLIMPORT void VL_SetParallelForCallback( VL_ParallelForCallback Callback, void* Context );
+	DLLIMPORT void* VL_CreateBrickedVolume( int W, int H, int D, int BPP, int BrickSize );
+	DLLIMPORT void VL_DeleteBrickedVolume( void* Bricked );
+	DLLIMPORT void VL_LoadBrickedVolume( void* Bricked, void* Slicer, int* CurrentSlice );
+	DLLIMPORT void VL_WriteBrickedVolume( void* Bricked, void* writer, int StartZ, int FinishZ, int* CurrentSlice );
+	DLLIMPORT void VL_MakeSeparableGaussian8_Single( void* In, void* Out, int size, float sigma );
+	DLLIMPORT void VL_MakeSeparableGaussian16_Single( void* In, void* Out, int size, float sigma );
+	DLLIMPORT void VL_CollectBrickedHistogram8( void* Bricked, int NumBins, unsigned int* Bins );
+	DLLIMPORT void VL_CollectBrickedHistogram16( void* Bricked, int NumBins, unsigned int* Bins );
+	DLLIMPORT void VL_LoadBrickedVolumeFromLinear( void* Bricked, VOLUME_PTR Data );
+	DLLIMPORT void VL_StoreBrickedVolumeToLinear( void* Bricked, VOLUME_PTR Data );
+	DLLIMPORT void VL_MakeBrickedConvolution8_Single( void* In, void* Out, int size, float* filter );
+	DLLIMPORT void VL_MakeBrickedConvolution16_Single( void* In, void* Out, int size, float* filter );
+	DLLIMPORT void VL_CollectBrickedHistogram2D8( void* Bricked, int W, int H, double MaxValue, double MaxGradient, unsigned int* Bins );
+	DLLIMPORT void VL_CollectBrickedHistogram2D16( void* Bricked, int W, int H, double MaxValue, double MaxGradient, unsigned int* Bins );
 	DLLIMPORT int VL_GetLastErrorCode();
 
 #ifdef __cplusplus
@@ -0,0 +1,662 @@
+/**
+ * \file LAABBTree.cpp
+ * \brief Dynamic bounding volume hierarchy of axis-aligned boxes
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "Math/LAABBTree.h"
+#include "Math/LFrustum.h"
+#include "Math/LBoundsArray.h"
+
+#include <algorithm>
+
+using namespace Linderdaum;
+
+namespace
+{
+	const float DEFAULT_MARGIN = 0.1f;
+
+	/// Subtrees of this height and lower (up to 16 leaves) are culled leaf by leaf in one batch
+	const int FRUSTUM_BATCH_HEIGHT = 4;
+
+	inline LAABoundingBox Union( const LAABoundingBox& A, const LAABoundingBox& B )
+	{
+		LAABoundingBox Result;
+
+		Result.FMin = LVector3( Math::LMin( A.FMin.X, B.FMin.X ), Math::LMin( A.FMin.Y, B.FMin.Y ), Math::LMin( A.FMin.Z, B.FMin.Z ) );
+		Result.FMax = LVector3( Math::LMax( A.FMax.X, B.FMax.X ), Math::LMax( A.FMax.Y, B.FMax.Y ), Math::LMax( A.FMax.Z, B.FMax.Z ) );
+
+		return Result;
+	}
+
+	inline bool Contains( const LAABoundingBox& Outer, const LAABoundingBox& Inner )
+	{
+		return Outer.FMin.X <= Inner.FMin.X && Outer.FMin.Y <= Inner.FMin.Y && Outer.FMin.Z <= Inner.FMin.Z &&
+		       Outer.FMax.X >= Inner.FMax.X && Outer.FMax.Y >= Inner.FMax.Y && Outer.FMax.Z >= Inner.FMax.Z;
+	}
+
+	inline bool Overlaps( const LAABoundingBox& A, const LAABoundingBox& B )
+	{
+		return A.FMin.X <= B.FMax.X && A.FMin.Y <= B.FMax.Y && A.FMin.Z <= B.FMax.Z &&
+		       A.FMax.X >= B.FMin.X && A.FMax.Y >= B.FMin.Y && A.FMax.Z >= B.FMin.Z;
+	}
+
+	/// half of the surface area, enough for the comparisons
+	inline float Area( const LAABoundingBox& Box )
+	{
+		LVector3 Size = Box.FMax - Box.FMin;
+
+		return Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X;
+	}
+
+	/// slab test, InvDir components are 1/Dir or 0 for the axes parallel to the ray
+	inline bool RayEntry( const LAABoundingBox& Box, const LVector3& Origin, const LVector3& Dir, const LVector3& InvDir, float MaxT, float* TEntry )
+	{
+		float TMin = 0.0f;
+		float TMax = MaxT;
+
+		for ( int i = 0; i != 3; i++ )
+		{
+			if ( fabsf( Dir[i] ) < Math::EPSILON )
+			{
+				if ( Origin[i] < Box.FMin[i] || Origin[i] > Box.FMax[i] ) { return false; }
+
+				continue;
+			}
+
+			float T1 = ( Box.FMin[i] - Origin[i] ) * InvDir[i];
+			float T2 = ( Box.FMax[i] - Origin[i] ) * InvDir[i];
+
+			if ( T1 > T2 ) { std::swap( T1, T2 ); }
+
+			TMin = Math::LMax( TMin, T1 );
+			TMax = Math::LMin( TMax, T2 );
+
+			if ( TMin > TMax ) { return false; }
+		}
+
+		*TEntry = TMin;
+
+		return true;
+	}
+
+	/// orders leaves by the box center along the axis
+	class clCenterLess
+	{
+	public:
+		clCenterLess( const std::vector<sAABBTreeNode>& Nodes, int Axis ): FNodes( Nodes ), FAxis( Axis ) {}
+
+		bool operator()( int A, int B ) const
+		{
+			const LAABoundingBox& BoxA = FNodes[A].FBox;
+			const LAABoundingBox& BoxB = FNodes[B].FBox;
+
+			return BoxA.FMin[ FAxis ] + BoxA.FMax[ FAxis ] < BoxB.FMin[ FAxis ] + BoxB.FMax[ FAxis ];
+		}
+	private:
+		const std::vector<sAABBTreeNode>& FNodes;
+		int                               FAxis;
+	};
+}
+
+LAABBTree::LAABBTree()
+	: FNodes(),
+	  FRoot( L_AABB_TREE_NULL ),
+	  FFreeList( L_AABB_TREE_NULL ),
+	  FNumProxies( 0 ),
+	  FMargin( DEFAULT_MARGIN )
+{
+}
+
+LAABBTree::LAABBTree( float Margin )
+	: FNodes(),
+	  FRoot( L_AABB_TREE_NULL ),
+	  FFreeList( L_AABB_TREE_NULL ),
+	  FNumProxies( 0 ),
+	  FMargin( Margin )
+{
+}
+
+int LAABBTree::AllocateNode()
+{
+	int Node = FFreeList;
+
+	if ( Node == L_AABB_TREE_NULL )
+	{
+		Node = static_cast<int>( FNodes.size() );
+
+		FNodes.push_back( sAABBTreeNode() );
+	}
+	else
+	{
+		FFreeList = FNodes[ Node ].FParent;
+	}
+
+	sAABBTreeNode& N = FNodes[ Node ];
+
+	N.FParent   = L_AABB_TREE_NULL;
+	N.FChild1   = L_AABB_TREE_NULL;
+	N.FChild2   = L_AABB_TREE_NULL;
+	N.FHeight   = 0;
+	N.FUserData = -1;
+
+	return Node;
+}
+
+void LAABBTree::FreeNode( int Node )
+{
+	FNodes[ Node ].FParent = FFreeList;
+	FNodes[ Node ].FHeight = -1;
+
+	FFreeList = Node;
+}
+
+void LAABBTree::Clear()
+{
+	FNodes.clear();
+
+	FRoot       = L_AABB_TREE_NULL;
+	FFreeList   = L_AABB_TREE_NULL;
+	FNumProxies = 0;
+}
+
+int LAABBTree::CreateProxy( const LAABoundingBox& Box, int UserData )
+{
+	int Proxy = AllocateNode();
+
+	FNodes[ Proxy ].FBox      = Box;
+	FNodes[ Proxy ].FUserData = UserData;
+	FNodes[ Proxy ].FBox.Grow( FMargin );
+
+	InsertLeaf( Proxy );
+
+	FNumProxies++;
+
+	return Proxy;
+}
+
+void LAABBTree::DestroyProxy( int Proxy )
+{
+	RemoveLeaf( Proxy );
+
+	FreeNode( Proxy );
+
+	FNumProxies--;
+}
+
+bool LAABBTree::MoveProxy( int Proxy, const LAABoundingBox& Box )
+{
+	// refit: the fat box still covers the new one
+	if ( Contains( FNodes[ Proxy ].FBox, Box ) ) { return false; }
+
+	RemoveLeaf( Proxy );
+
+	FNodes[ Proxy ].FBox = Box;
+	FNodes[ Proxy ].FBox.Grow( FMargin );
+
+	InsertLeaf( Proxy );
+
+	return true;
+}
+
+void LAABBTree::UpdateNode( int Node )
+{
+	sAABBTreeNode& N = FNodes[ Node ];
+
+	const sAABBTreeNode& Child1 = FNodes[ N.FChild1 ];
+	const sAABBTreeNode& Child2 = FNodes[ N.FChild2 ];
+
+	N.FBox    = Union( Child1.FBox, Child2.FBox );
+	N.FHeight = 1 + Math::LMax( Child1.FHeight, Child2.FHeight );
+}
+
+void LAABBTree::InsertLeaf( int Leaf )
+{
+	if ( FRoot == L_AABB_TREE_NULL )
+	{
+		FRoot = Leaf;
+		FNodes[ Leaf ].FParent = L_AABB_TREE_NULL;
+
+		return;
+	}
+
+	LAABoundingBox LeafBox = FNodes[ Leaf ].FBox;
+
+	// find the best sibling using the surface area heuristic
+	int Index = FRoot;
+
+	while ( !FNodes[ Index ].IsLeaf() )
+	{
+		const sAABBTreeNode& N = FNodes[ Index ];
+
+		float CombinedArea = Area( Union( N.FBox, LeafBox ) );
+
+		// cost of creating a new parent for this node and the leaf
+		float Cost = 2.0f * CombinedArea;
+
+		// minimum cost of pushing the leaf further down the tree
+		float InheritanceCost = 2.0f * ( CombinedArea - Area( N.FBox ) );
+
+		const sAABBTreeNode& Child1 = FNodes[ N.FChild1 ];
+		const sAABBTreeNode& Child2 = FNodes[ N.FChild2 ];
+
+		float Cost1 = Area( Union( Child1.FBox, LeafBox ) ) + InheritanceCost;
+		float Cost2 = Area( Union( Child2.FBox, LeafBox ) ) + InheritanceCost;
+
+		if ( !Child1.IsLeaf() ) { Cost1 -= Area( Child1.FBox ); }
+
+		if ( !Child2.IsLeaf() ) { Cost2 -= Area( Child2.FBox ); }
+
+		if ( Cost < Cost1 && Cost < Cost2 ) { break; }
+
+		Index = ( Cost1 < Cost2 ) ? N.FChild1 : N.FChild2;
+	}
+
+	int Sibling   = Index;
+	int OldParent = FNodes[ Sibling ].FParent;
+	int NewParent = AllocateNode();
+
+	FNodes[ NewParent ].FParent = OldParent;
+	FNodes[ NewParent ].FChild1 = Sibling;
+	FNodes[ NewParent ].FChild2 = Leaf;
+
+	FNodes[ Sibling ].FParent = NewParent;
+	FNodes[ Leaf    ].FParent = NewParent;
+
+	if ( OldParent == L_AABB_TREE_NULL )
+	{
+		FRoot = NewParent;
+	}
+	else if ( FNodes[ OldParent ].FChild1 == Sibling )
+	{
+		FNodes[ OldParent ].FChild1 = NewParent;
+	}
+	else
+	{
+		FNodes[ OldParent ].FChild2 = NewParent;
+	}
+
+	// refit and balance the ancestors
+	for ( Index = NewParent; Index != L_AABB_TREE_NULL; Index = FNodes[ Index ].FParent )
+	{
+		Index = Balance( Index );
+
+		UpdateNode( Index );
+	}
+}
+
+void LAABBTree::RemoveLeaf( int Leaf )
+{
+	if ( Leaf == FRoot )
+	{
+		FRoot = L_AABB_TREE_NULL;
+
+		return;
+	}
+
+	int Parent      = FNodes[ Leaf ].FParent;
+	int GrandParent = FNodes[ Parent ].FParent;
+	int Sibling     = ( FNodes[ Parent ].FChild1 == Leaf ) ? FNodes[ Parent ].FChild2 : FNodes[ Parent ].FChild1;
+
+	FreeNode( Parent );
+
+	FNodes[ Sibling ].FParent = GrandParent;
+
+	if ( GrandParent == L_AABB_TREE_NULL )
+	{
+		FRoot = Sibling;
+
+		return;
+	}
+
+	if ( FNodes[ GrandParent ].FChild1 == Parent )
+	{
+		FNodes[ GrandParent ].FChild1 = Sibling;
+	}
+	else
+	{
+		FNodes[ GrandParent ].FChild2 = Sibling;
+	}
+
+	for ( int Index = GrandParent; Index != L_AABB_TREE_NULL; Index = FNodes[ Index ].FParent )
+	{
+		Index = Balance( Index );
+
+		UpdateNode( Index );
+	}
+}
+
+/// Rotate the subtree if it is imbalanced, returns the new root of the subtree
+int LAABBTree::Balance( int IdxA )
+{
+	sAABBTreeNode* A = &FNodes[ IdxA ];
+
+	if ( A->IsLeaf() || A->FHeight < 2 ) { return IdxA; }
+
+	int IdxB = A->FChild1;
+	int IdxC = A->FChild2;
+
+	sAABBTreeNode* B = &FNodes[ IdxB ];
+	sAABBTreeNode* C = &FNodes[ IdxC ];
+
+	int Imbalance = C->FHeight - B->FHeight;
+
+	if ( Imbalance > 1 )
+	{
+		// rotate C up
+		int IdxF = C->FChild1;
+		int IdxG = C->FChild2;
+
+		sAABBTreeNode* F = &FNodes[ IdxF ];
+		sAABBTreeNode* G = &FNodes[ IdxG ];
+
+		C->FChild1 = IdxA;
+		C->FParent = A->FParent;
+		A->FParent = IdxC;
+
+		if ( C->FParent == L_AABB_TREE_NULL )             { FRoot = IdxC; }
+		else if ( FNodes[ C->FParent ].FChild1 == IdxA ) { FNodes[ C->FParent ].FChild1 = IdxC; }
+		else                                               { FNodes[ C->FParent ].FChild2 = IdxC; }
+
+		// the higher grandchild stays under C
+		if ( F->FHeight > G->FHeight )
+		{
+			C->FChild2 = IdxF;
+			A->FChild2 = IdxG;
+			G->FParent = IdxA;
+		}
+		else
+		{
+			C->FChild2 = IdxG;
+			A->FChild2 = IdxF;
+			F->FParent = IdxA;
+		}
+
+		UpdateNode( IdxA );
+		UpdateNode( IdxC );
+
+		return IdxC;
+	}
+
+	if ( Imbalance < -1 )
+	{
+		// rotate B up
+		int IdxD = B->FChild1;
+		int IdxE = B->FChild2;
+
+		sAABBTreeNode* D = &FNodes[ IdxD ];
+		sAABBTreeNode* E = &FNodes[ IdxE ];
+
+		B->FChild1 = IdxA;
+		B->FParent = A->FParent;
+		A->FParent = IdxB;
+
+		if ( B->FParent == L_AABB_TREE_NULL )             { FRoot = IdxB; }
+		else if ( FNodes[ B->FParent ].FChild1 == IdxA ) { FNodes[ B->FParent ].FChild1 = IdxB; }
+		else                                               { FNodes[ B->FParent ].FChild2 = IdxB; }
+
+		if ( D->FHeight > E->FHeight )
+		{
+			B->FChild2 = IdxD;
+			A->FChild1 = IdxE;
+			E->FParent = IdxA;
+		}
+		else
+		{
+			B->FChild2 = IdxE;
+			A->FChild1 = IdxD;
+			D->FParent = IdxA;
+		}
+
+		UpdateNode( IdxA );
+		UpdateNode( IdxB );
+
+		return IdxB;
+	}
+
+	return IdxA;
+}
+
+void LAABBTree::Rebuild()
+{
+	std::vector<int> Leaves;
+	Leaves.reserve( FNumProxies );
+
+	for ( int i = 0; i != static_cast<int>( FNodes.size() ); i++ )
+	{
+		if ( FNodes[i].FHeight < 0 ) { continue; }
+
+		if ( FNodes[i].IsLeaf() )
+		{
+			Leaves.push_back( i );
+		}
+		else
+		{
+			FreeNode( i );
+		}
+	}
+
+	FRoot = Leaves.empty() ? L_AABB_TREE_NULL : BuildTopDown( &Leaves[0], static_cast<int>( Leaves.size() ) );
+
+	if ( FRoot != L_AABB_TREE_NULL ) { FNodes[ FRoot ].FParent = L_AABB_TREE_NULL; }
+}
+
+/// Median split along the longest axis of the box centers
+int LAABBTree::BuildTopDown( int* Leaves, int Count )
+{
+	if ( Count == 1 ) { return Leaves[0]; }
+
+	LAABoundingBox Centers( FNodes[ Leaves[0] ].FBox.GetCenter(), FNodes[ Leaves[0] ].FBox.GetCenter() );
+
+	for ( int i = 1; i != Count; i++ )
+	{
+		Centers.CombinePoint( FNodes[ Leaves[i] ].FBox.GetCenter() );
+	}
+
+	LVector3 Size = Centers.GetSize();
+
+	int Axis = ( Size.X > Size.Y ) ? ( ( Size.X > Size.Z ) ? 0 : 2 ) : ( ( Size.Y > Size.Z ) ? 1 : 2 );
+
+	int Half = Count / 2;
+
+	std::nth_element( Leaves, Leaves + Half, Leaves + Count, clCenterLess( FNodes, Axis ) );
+
+	int Child1 = BuildTopDown( Leaves, Half );
+	int Child2 = BuildTopDown( Leaves + Half, Count - Half );
+
+	int Node = AllocateNode();
+
+	FNodes[ Node ].FChild1 = Child1;
+	FNodes[ Node ].FChild2 = Child2;
+
+	FNodes[ Child1 ].FParent = Node;
+	FNodes[ Child2 ].FParent = Node;
+
+	UpdateNode( Node );
+
+	return Node;
+}
+
+float LAABBTree::GetAreaRatio() const
+{
+	if ( FRoot == L_AABB_TREE_NULL ) { return 0.0f; }
+
+	float RootArea = Area( FNodes[ FRoot ].FBox );
+
+	if ( RootArea <= 0.0f ) { return 0.0f; }
+
+	float TotalArea = 0.0f;
+
+	for ( size_t i = 0; i != FNodes.size(); i++ )
+	{
+		if ( FNodes[i].FHeight > 0 ) { TotalArea += Area( FNodes[i].FBox ); }
+	}
+
+	return TotalArea / RootArea;
+}
+
+void LAABBTree::CollectLeaves( int Node, std::vector<int>* Proxies ) const
+{
+	const sAABBTreeNode& N = FNodes[ Node ];
+
+	if ( N.IsLeaf() )
+	{
+		Proxies->push_back( Node );
+
+		return;
+	}
+
+	CollectLeaves( N.FChild1, Proxies );
+	CollectLeaves( N.FChild2, Proxies );
+}
+
+void LAABBTree::QueryAABB( const LAABoundingBox& Box, std::vector<int>* Proxies ) const
+{
+	Proxies->clear();
+
+	if ( FRoot == L_AABB_TREE_NULL ) { return; }
+
+	std::vector<int> Stack( 1, FRoot );
+
+	while ( !Stack.empty() )
+	{
+		int Node = Stack.back();
+		Stack.pop_back();
+
+		const sAABBTreeNode& N = FNodes[ Node ];
+
+		if ( !Overlaps( N.FBox, Box ) ) { continue; }
+
+		if ( N.IsLeaf() )
+		{
+			Proxies->push_back( Node );
+		}
+		else
+		{
+			Stack.push_back( N.FChild1 );
+			Stack.push_back( N.FChild2 );
+		}
+	}
+}
+
+/// Scratch buffers for the batched culling, reused by the whole query
+struct sAABBTreeFrustumBatch
+{
+	std::vector<int>    FLeaves;
+	LAABBArray          FBoxes;
+	std::vector<Lubyte> FVisible;
+};
+
+void LAABBTree::QueryFrustum( const LFrustum& Frustum, std::vector<int>* Proxies ) const
+{
+	Proxies->clear();
+
+	if ( FRoot == L_AABB_TREE_NULL ) { return; }
+
+	sAABBTreeFrustumBatch Batch;
+
+	QueryFrustum_Node( Frustum, FRoot, L_FRUSTUM_ALL_PLANES, &Batch, Proxies );
+}
+
+void LAABBTree::QueryFrustum_Node( const LFrustum& Frustum, int Node, int PlaneMask, sAABBTreeFrustumBatch* Batch, std::vector<int>* Proxies ) const
+{
+	const sAABBTreeNode& N = FNodes[ Node ];
+
+	if ( !Frustum.IsAABBInFrustumMasked( N.FBox, &PlaneMask ) ) { return; }
+
+	// completely inside, take everything without tests
+	if ( !PlaneMask )
+	{
+		CollectLeaves( Node, Proxies );
+
+		return;
+	}
+
+	if ( N.IsLeaf() )
+	{
+		Proxies->push_back( Node );
+
+		return;
+	}
+
+	// the leaves of a small subtree are tested in one batch against the planes the subtree still intersects
+	if ( N.FHeight <= FRUSTUM_BATCH_HEIGHT )
+	{
+		Batch->FLeaves.clear();
+
+		CollectLeaves( Node, &Batch->FLeaves );
+
+		size_t Count = Batch->FLeaves.size();
+
+		Batch->FBoxes.Clear();
+
+		for ( size_t i = 0; i != Count; i++ ) { Batch->FBoxes.Add( FNodes[ Batch->FLeaves[i] ].FBox ); }
+
+		Batch->FVisible.resize( Count );
+
+		Frustum.CullAABBs( Batch->FBoxes, &Batch->FVisible[0], PlaneMask );
+
+		for ( size_t i = 0; i != Count; i++ )
+		{
+			if ( Batch->FVisible[i] ) { Proxies->push_back( Batch->FLeaves[i] ); }
+		}
+
+		return;
+	}
+
+	QueryFrustum_Node( Frustum, N.FChild1, PlaneMask, Batch, Proxies );
+	QueryFrustum_Node( Frustum, N.FChild2, PlaneMask, Batch, Proxies );
+}
+
+void LAABBTree::RayCast( const LVector3& Origin, const LVector3& Dir, float MaxT, std::vector<sAABBTreeRayHit>* Hits ) const
+{
+	Hits->clear();
+
+	if ( FRoot == L_AABB_TREE_NULL ) { return; }
+
+	LVector3 InvDir;
+
+	for ( int i = 0; i != 3; i++ )
+	{
+		InvDir[i] = ( fabsf( Dir[i] ) < Math::EPSILON ) ? 0.0f : 1.0f / Dir[i];
+	}
+
+	std::vector<int> Stack( 1, FRoot );
+
+	while ( !Stack.empty() )
+	{
+		int Node = Stack.back();
+		Stack.pop_back();
+
+		const sAABBTreeNode& N = FNodes[ Node ];
+
+		float T;
+
+		if ( !RayEntry( N.FBox, Origin, Dir, InvDir, MaxT, &T ) ) { continue; }
+
+		if ( N.IsLeaf() )
+		{
+			sAABBTreeRayHit Hit;
+			Hit.FT     = T;
+			Hit.FProxy = Node;
+
+			Hits->push_back( Hit );
+		}
+		else
+		{
+			Stack.push_back( N.FChild1 );
+			Stack.push_back( N.FChild2 );
+		}
+	}
+
+	std::sort( Hits->begin(), Hits->end() );
+}
+
+/*
+ * 17/10/2026
+     Leaves of the small subtrees are culled in one batch with the planes mask
+     Batched frustum test of the small subtrees
+     It's here
+*/
@@ -0,0 +1,116 @@
+/**
+ * \file LAABBTree.h
+ * \brief Dynamic bounding volume hierarchy of axis-aligned boxes
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _LAABBTree_
+#define _LAABBTree_
+
+#include "Platform.h"
+#include "Math/LAABB.h"
+
+#include <vector>
+
+class LFrustum;
+struct sAABBTreeFrustumBatch;
+
+const int L_AABB_TREE_NULL = -1;
+
+/// Node of the LAABBTree
+struct sAABBTreeNode
+{
+	/// enlarged box for leaves, union of the children boxes for internal nodes
+	LAABoundingBox FBox;
+	/// parent node for the nodes in the tree, next free node for the nodes in the free list
+	int            FParent;
+	int            FChild1;
+	int            FChild2;
+	/// 0 for leaves, -1 for free nodes
+	int            FHeight;
+	int            FUserData;
+
+	inline bool IsLeaf() const { return FChild1 == L_AABB_TREE_NULL; }
+};
+
+/// Result of the LAABBTree::RayCast()
+struct sAABBTreeRayHit
+{
+	/// ray parameter where the ray enters the proxy box
+	float FT;
+	int   FProxy;
+
+	inline bool operator < ( const sAABBTreeRayHit& Other ) const { return FT < Other.FT; }
+};
+
+/**
+   \brief Dynamic bounding volume hierarchy
+
+   Every proxy is a leaf holding an enlarged ("fat") copy of the user box, so small movements only refit
+   the leaf and do not touch the tree structure. Leaves that leave their fat box are reinserted using the
+   surface area heuristic, the tree is kept balanced with rotations. Rebuild() does a full top-down
+   rebuild after the large changes.
+**/
+class LAABBTree
+{
+public:
+	LAABBTree();
+	explicit LAABBTree( float Margin );
+
+	/// Insert new proxy, returns the proxy handle
+	int     CreateProxy( const LAABoundingBox& Box, int UserData );
+
+	void    DestroyProxy( int Proxy );
+
+	/// Update the proxy box, returns true if the proxy was reinserted
+	bool    MoveProxy( int Proxy, const LAABoundingBox& Box );
+
+	/// Remove all proxies
+	void    Clear();
+
+	/// Rebuild the whole tree top-down, proxy handles stay valid
+	void    Rebuild();
+
+	inline int                   GetUserData( int Proxy ) const { return FNodes[ Proxy ].FUserData; }
+	inline const LAABoundingBox& GetFatAABB( int Proxy ) const { return FNodes[ Proxy ].FBox; }
+	inline size_t                GetNumProxies() const { return FNumProxies; }
+	inline int                   GetHeight() const { return ( FRoot == L_AABB_TREE_NULL ) ? 0 : FNodes[ FRoot ].FHeight; }
+
+	/// Sum of the surface areas of all nodes divided by the root area, lower is better
+	float   GetAreaRatio() const;
+
+	/// Collect the proxies overlapping the box
+	void    QueryAABB( const LAABoundingBox& Box, std::vector<int>* Proxies ) const;
+
+	/// Collect the proxies inside or intersecting the frustum. The subtrees completely inside are not tested any more
+	void    QueryFrustum( const LFrustum& Frustum, std::vector<int>* Proxies ) const;
+
+	/// Collect the proxies hit by the ray Origin + T * Dir, 0 <= T <= MaxT, sorted by the entry distance
+	void    RayCast( const LVector3& Origin, const LVector3& Dir, float MaxT, std::vector<sAABBTreeRayHit>* Hits ) const;
+private:
+	int     AllocateNode();
+	void    FreeNode( int Node );
+	void    InsertLeaf( int Leaf );
+	void    RemoveLeaf( int Leaf );
+	int     Balance( int Node );
+	void    UpdateNode( int Node );
+	int     BuildTopDown( int* Leaves, int Count );
+	void    CollectLeaves( int Node, std::vector<int>* Proxies ) const;
+	void    QueryFrustum_Node( const LFrustum& Frustum, int Node, int PlaneMask, sAABBTreeFrustumBatch* Batch, std::vector<int>* Proxies ) const;
+private:
+	std::vector<sAABBTreeNode> FNodes;
+	int                        FRoot;
+	int                        FFreeList;
+	size_t                     FNumProxies;
+	/// enlargement of the leaf boxes
+	float                      FMargin;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
@@ -0,0 +1,66 @@
+/**
+ * \file LBoundsArray.h
+ * \brief Bounding boxes in the structure-of-arrays layout for the batched culling
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _LBoundsArray_
+#define _LBoundsArray_
+
+#include "Platform.h"
+#include "Math/LAABB.h"
+
+#include <vector>
+
+/// Axis-aligned boxes, every coordinate is stored in its own array
+class LAABBArray
+{
+public:
+	inline size_t size() const { return FMinX.size(); }
+
+	void Clear()
+	{
+		FMinX.clear(); FMinY.clear(); FMinZ.clear();
+		FMaxX.clear(); FMaxY.clear(); FMaxZ.clear();
+	}
+
+	void Reserve( size_t Count )
+	{
+		FMinX.reserve( Count ); FMinY.reserve( Count ); FMinZ.reserve( Count );
+		FMaxX.reserve( Count ); FMaxY.reserve( Count ); FMaxZ.reserve( Count );
+	}
+
+	void Add( const LAABoundingBox& Box )
+	{
+		FMinX.push_back( Box.FMin.X ); FMinY.push_back( Box.FMin.Y ); FMinZ.push_back( Box.FMin.Z );
+		FMaxX.push_back( Box.FMax.X ); FMaxY.push_back( Box.FMax.Y ); FMaxZ.push_back( Box.FMax.Z );
+	}
+
+	void Set( size_t i, const LAABoundingBox& Box )
+	{
+		FMinX[i] = Box.FMin.X; FMinY[i] = Box.FMin.Y; FMinZ[i] = Box.FMin.Z;
+		FMaxX[i] = Box.FMax.X; FMaxY[i] = Box.FMax.Y; FMaxZ[i] = Box.FMax.Z;
+	}
+
+	LAABoundingBox Get( size_t i ) const
+	{
+		LAABoundingBox Box;
+
+		Box.FMin = LVector3( FMinX[i], FMinY[i], FMinZ[i] );
+		Box.FMax = LVector3( FMaxX[i], FMaxY[i], FMaxZ[i] );
+
+		return Box;
+	}
+public:
+	std::vector<float> FMinX, FMinY, FMinZ;
+	std::vector<float> FMaxX, FMaxY, FMaxZ;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
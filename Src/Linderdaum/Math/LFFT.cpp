@@ -1,7 +1,13 @@
 #include "LFFT.h"
 
+#include "Utils/JobSystem.h"
+#include "Utils/Mutex.h"
+
 #include <math.h>
 
+#include <map>
+#include <vector>
+
 /**
 Copyright
     Copyright(C) 1997,2001 Takuya OOURA (email: ooura@kurims.kyoto-u.ac.jp, web: http://www.kurims.kyoto-u.ac.jp/~ooura/fft.html).
@@ -11,6 +17,7 @@ Copyright
 Modifications (LV):
 
    - removed explicit memory management for temporary archives ('t' can be allocated outside for 2d/3d transforms)
+   - cached cos/sin tables, row/column passes on clJobSystem instead of pthreads
 */
 
 /// Low-level functions
@@ -49,6 +56,16 @@ void rdft3d( int n1, int n2, int n3, int isgn, float** *a, float* t, int* ip, fl
 /// Value rearrangement for 3D transform
 void rdft3dsort( int n1, int n2, int n3, int isgn, float** *a );
 
+/// Fill the cos/sin tables for the transforms up to 4*nw long. The tables are read-only afterwards
+void makewt( int nw, int* ip, float* w );
+void makect( int nc, int* ip, float* c );
+
+/// Multithreaded versions of the 2D/3D DFTs, the tables should be filled in advance
+void cdft2d_mt( clJobSystem* Jobs, int n1, int n2, int isgn, float** a, int* ip, float* w );
+void rdft2d_mt( clJobSystem* Jobs, int n1, int n2, int isgn, float** a, int* ip, float* w );
+void cdft3d_mt( clJobSystem* Jobs, int n1, int n2, int n3, int isgn, float** *a, int* ip, float* w );
+void rdft3d_mt( clJobSystem* Jobs, int n1, int n2, int n3, int isgn, float** *a, int* ip, float* w );
+
 #ifdef __cplusplus
 // }
 #endif
@@ -57,16 +74,114 @@ void rdft3dsort( int n1, int n2, int n3, int isgn, float** *a );
 template <class T> T MAX( T a, T b ) { return ( a > b ) ? a : b; }
 template <class T> T MAX3( T a, T b, T c ) { return MAX( a, MAX( b, c ) ); }
 
+/// Transforms smaller than this (in floats) are not split between the threads
+const int FFT_THREADS_BEGIN_N = 8192;
+
+namespace
+{
+	/// Tables for all the transforms with the same nw and nc
+	struct sFFTPlan
+	{
+		int*     ip;
+		float*   w;
+	};
+
+	/// Tables are never released before exit, there are only a few distinct sizes in practice
+	class clFFTPlanCache
+	{
+	public:
+		~clFFTPlanCache()
+		{
+			for ( std::map< std::pair<int, int>, sFFTPlan >::iterator i = FPlans.begin(); i != FPlans.end(); ++i )
+			{
+				delete[] i->second.ip;
+				delete[] i->second.w;
+			}
+		}
+
+		/// Tables for the complex transforms of length up to 4*nw and the real transforms of length up to 4*nc
+		const sFFTPlan& GetPlan( int nw, int nc )
+		{
+			LMutex Lock( &FMutex );
+
+			std::pair<int, int> Key( nw, nc );
+
+			std::map< std::pair<int, int>, sFFTPlan >::iterator i = FPlans.find( Key );
+
+			if ( i != FPlans.end() ) { return i->second; }
+
+			sFFTPlan Plan;
+
+			Plan.ip = new int[2 + ( int ) sqrt( 4 * nw + 0.5 )];
+			Plan.w  = new float[nw + nc];
+
+			makewt( nw, Plan.ip, Plan.w );
+			makect( nc, Plan.ip, Plan.w + nw );
+
+			return FPlans[ Key ] = Plan;
+		}
+	private:
+		clMutex                                     FMutex;
+		std::map< std::pair<int, int>, sFFTPlan >   FPlans;
+	};
+
+	clFFTPlanCache FFTPlans;
+
+	/// Get the cached tables suitable for both real and complex transforms. N is the largest dimension, NLast is the last one
+	void GetPlan( int N, int NLast, int** ip, float** w )
+	{
+		// cdft() of the longest complex row takes 2*N floats
+		const sFFTPlan& Plan = FFTPlans.GetPlan( MAX( N >> 1, 1 ), MAX( NLast >> 2, 1 ) );
+
+		*ip = Plan.ip;
+		*w  = Plan.w;
+	}
+
+	struct sScaleParams
+	{
+		float**    a2;
+		float***   a3;
+		int        n2;
+		int        RowSize;
+		float      D;
+	};
+
+	/// Multiply the rows [Begin..End), the rows of a 3D array are numbered as i * n2 + j
+	void ScaleRowsProc( void* Param, size_t Begin, size_t End )
+	{
+		sScaleParams* P = reinterpret_cast<sScaleParams*>( Param );
+
+		for ( size_t r = Begin; r != End; r++ )
+		{
+			float* Row = P->a3 ? P->a3[ r / P->n2 ][ r % P->n2 ] : P->a2[ r ];
+
+			for ( int j = 0; j < P->RowSize; j++ )
+			{
+				Row[j] *= P->D;
+			}
+		}
+	}
+
+	void ScaleRows( clJobSystem* Jobs, sScaleParams* P, size_t NumRows )
+	{
+		if ( Jobs )
+		{
+			Jobs->ParallelFor( &ScaleRowsProc, P, 0, NumRows, MAX( FFT_THREADS_BEGIN_N / P->RowSize, 1 ) );
+		}
+		else
+		{
+			ScaleRowsProc( P, 0, NumRows );
+		}
+	}
+}
+
 void LFFT::Prepare1D( int an1 )
 {
 	Dim = 1;
 
 	n1 = an1;
 
-	ip = new int[2 + ( int ) sqrt( n1 + 0.5 )];
-	w  = new float[3 * n1 / 2];
-
-	ip[0] = 0;
+	GetPlan( n1, n1, &ip, &w );
 }
 
 void LFFT::AssignPointersFromBitmap( void* Bmp, int W, int H, int D )
@@ -92,18 +207,12 @@ void LFFT::Prepare2D( int an1, int an2 )
 	n1 = an1;
 	n2 = an2;
 
-	t = new float[ gettsize2( n1, n2 ) ];
+	// complex transforms have 2*n2 floats in a row
+	t = new float[ gettsize2( n1, 2 * n2 ) ];
 
 ///   a = alloc_2d_float(n1, n2);
 
-	int n = MAX( n1, n2 / 2 );
-	ip = new int[2 + ( int ) sqrt( n + 0.5 )];
-
-	n = MAX( n1, n2 ) * 3 / 2;
-	w = new float[n];
-
-	/// Trigger the ip table recalculation in the first call of dft2d()
-	ip[0] = 0;
+	GetPlan( MAX( n1, n2 ), n2, &ip, &w );
 }
 
 void LFFT::Prepare3D( int an1, int an2, int an3 )
@@ -114,18 +223,11 @@ void LFFT::Prepare3D( int an1, int an2, int an3 )
 	n2 = an2;
 	n3 = an3;
 
-	t = new float[gettsize3( n1, n2, n3 )];
+	t = new float[gettsize3( n1, n2, 2 * n3 )];
 
 ///   a = alloc_3d_float(n1, n2, n3);
 
-	int n = MAX3( n1, n2, n3 / 2 );
-	ip = new int[2 + ( int ) sqrt( n + 0.5 )];
-
-	n = MAX3( n1, n2, n3 ) * 3 / 2;
-	w = new float[n];
-
-	/// Trigger the ip table recalculation in the first call of dft2d()
-	ip[0] = 0;
+	GetPlan( MAX3( n1, n2, n3 ), n3, &ip, &w );
 }
 
 void LFFT::FreeArray()
@@ -199,9 +301,7 @@ void LFFT::AllocArray( bool Complex )
 
 void LFFT::Free()
 {
-	delete[] w;
-	delete[] ip;
-
+	// ip and w belong to the cache
 	if ( Dim == 3 || Dim == 2 )
 	{
 		delete[] t;
@@ -217,6 +317,11 @@ void LFFT::Free()
 	ip = 0;
 }
 
+bool LFFT::UseJobs( int Size ) const
+{
+	return Jobs && Jobs->GetNumWorkers() > 0 && Size >= FFT_THREADS_BEGIN_N;
+}
+
 void LFFT::Transform( bool Inverse, bool Complex )
 {
 	int Sgn = Inverse ? -1 : 1;
@@ -240,45 +345,80 @@ void LFFT::Transform( bool Inverse, bool Complex )
 	if ( Dim == 2 )
 	{
 		int maxN2 = Complex ? 2 * n2 : n2;
-		Complex ? cdft2d( n1, 2 * n2, Sgn, a2D, t, ip, w ) :    rdft2d( n1, n2, Sgn, a2D, t, ip, w );
+
+		// the small transforms are not worth the scheduling
+		clJobSystem* Threads = UseJobs( n1 * n2 ) ? Jobs : NULL;
+
+		if ( Threads )
+		{
+			Complex ? cdft2d_mt( Threads, n1, 2 * n2, Sgn, a2D, ip, w ) : rdft2d_mt( Threads, n1, n2, Sgn, a2D, ip, w );
+		}
+		else
+		{
+			Complex ? cdft2d( n1, 2 * n2, Sgn, a2D, t, ip, w ) :    rdft2d( n1, n2, Sgn, a2D, t, ip, w );
+		}
 
 		if ( Inverse )
 		{
-			float D = ( ( Complex ? 1.0f : 2.0f ) / ( float )n1 ) / ( float )n2;
+			sScaleParams P = { a2D, NULL, n2, maxN2, ( ( Complex ? 1.0f : 2.0f ) / ( float )n1 ) / ( float )n2 };
 
-			for ( int j1 = 0; j1 < n1 ; j1++ )
-			{
-				for ( int j2 = 0; j2 < maxN2 ; j2++ )
-				{
-					a2D[j1][j2] *= D;
-				}
-			}
+			ScaleRows( Threads, &P, n1 );
 		}
 	}
 
 	if ( Dim == 3 )
 	{
 		int maxN3 = Complex ? 2 * n3 : n3;
-		Complex ? cdft3d( n1, n2, 2 * n3, Sgn, a3D, t, ip, w ) : rdft3d( n1, n2, n3, Sgn, a3D, t, ip, w );
+
+		clJobSystem* Threads = UseJobs( n1 * n2 * n3 ) ? Jobs : NULL;
+
+		if ( Threads )
+		{
+			Complex ? cdft3d_mt( Threads, n1, n2, 2 * n3, Sgn, a3D, ip, w ) : rdft3d_mt( Threads, n1, n2, n3, Sgn, a3D, ip, w );
+		}
+		else
+		{
+			Complex ? cdft3d( n1, n2, 2 * n3, Sgn, a3D, t, ip, w ) : rdft3d( n1, n2, n3, Sgn, a3D, t, ip, w );
+		}
 
 		if ( Inverse )
 		{
-			float D = ( ( ( Complex ? 1.0f : 2.0f ) / ( float )n1 ) / ( float )n2 ) / ( float )n3;
+			sScaleParams P = { NULL, a3D, n2, maxN3, ( ( ( Complex ? 1.0f : 2.0f ) / ( float )n1 ) / ( float )n2 ) / ( float )n3 };
 
-			for ( int j1 = 0; j1 < n1 ; j1++ )
-			{
-				for ( int j2 = 0; j2 < n2 ; j2++ )
-				{
-					for ( int j3 = 0; j3 < maxN3 ; j3++ )
-					{
-						a3D[j1][j2][j3] *= D;
-					}
-				}
-			}
+			ScaleRows( Threads, &P, n1 * n2 );
 		}
 	}
 }
 
+void LFFT::TransformRealToComplex( bool Inverse )
+{
+	// pack the Nyquist frequency back to where rdft() keeps it
+	if ( Inverse )
+	{
+		if ( Dim == 1 ) { a1D[1] = a1D[n1]; }
+
+		if ( Dim == 2 ) { rdft2dsort( n1, n2, -1, a2D ); }
+
+		if ( Dim == 3 ) { rdft3dsort( n1, n2, n3, -1, a3D ); }
+	}
+
+	Transform( Inverse, false );
+
+	if ( !Inverse )
+	{
+		if ( Dim == 1 )
+		{
+			a1D[n1]     = a1D[1];
+			a1D[n1 + 1] = 0.0f;
+			a1D[1]      = 0.0f;
+		}
+
+		if ( Dim == 2 ) { rdft2dsort( n1, n2, 1, a2D ); }
+
+		if ( Dim == 3 ) { rdft3dsort( n1, n2, n3, 1, a3D ); }
+	}
+}
+
 
 /**
 With some modifications, this code is
@@ -3303,6 +3443,7 @@ void makect( int nc, int* ip, float* c );
 void cdft( int n, int isgn, float* a, int* ip, float* w );
 void rdft( int n, int isgn, float* a, int* ip, float* w );
 void cdft2d_sub( int n1, int n2, int isgn, float** a, float* t, int* ip, float* w );
+void cdft2d_cols( int n1, int j0, int j1, int isgn, float** a, float* t, int* ip, float* w );
 void rdft2d_sub( int n1, int n2, int isgn, float** a );
 
 void cdft2d( int n1, int n2, int isgn, float** a, float* t, int* ip, float* w )
@@ -3422,41 +3563,11 @@ void rdft2dsort( int n1, int n2, int isgn, float** a )
 void cdft2d_sub( int n1, int n2, int isgn, float** a, float* t,
                  int* ip, float* w )
 {
-	int i, j;
+	int i;
 
 	if ( n2 > 4 )
 	{
-		for ( j = 0; j < n2; j += 8 )
-		{
-			for ( i = 0; i < n1; i++ )
-			{
-				t[2 * i] = a[i][j];
-				t[2 * i + 1] = a[i][j + 1];
-				t[2 * n1 + 2 * i] = a[i][j + 2];
-				t[2 * n1 + 2 * i + 1] = a[i][j + 3];
-				t[4 * n1 + 2 * i] = a[i][j + 4];
-				t[4 * n1 + 2 * i + 1] = a[i][j + 5];
-				t[6 * n1 + 2 * i] = a[i][j + 6];
-				t[6 * n1 + 2 * i + 1] = a[i][j + 7];
-			}
-
-			cdft( 2 * n1, isgn, t, ip, w );
-			cdft( 2 * n1, isgn, &t[2 * n1], ip, w );
-			cdft( 2 * n1, isgn, &t[4 * n1], ip, w );
-			cdft( 2 * n1, isgn, &t[6 * n1], ip, w );
-
-			for ( i = 0; i < n1; i++ )
-			{
-				a[i][j] = t[2 * i];
-				a[i][j + 1] = t[2 * i + 1];
-				a[i][j + 2] = t[2 * n1 + 2 * i];
-				a[i][j + 3] = t[2 * n1 + 2 * i + 1];
-				a[i][j + 4] = t[4 * n1 + 2 * i];
-				a[i][j + 5] = t[4 * n1 + 2 * i + 1];
-				a[i][j + 6] = t[6 * n1 + 2 * i];
-				a[i][j + 7] = t[6 * n1 + 2 * i + 1];
-			}
-		}
+		cdft2d_cols( n1, 0, n2, isgn, a, t, ip, w );
 	}
 	else if ( n2 == 4 )
 	{
@@ -3498,37 +3609,78 @@ void cdft2d_sub( int n1, int n2, int isgn, float** a, float* t,
 }
 
 
+/// 2D column pass over the columns [j0..j1), both multiples of 8
+void cdft2d_cols( int n1, int j0, int j1, int isgn, float** a, float* t, int* ip, float* w )
+{
+	int i, j;
+
+	for ( j = j0; j < j1; j += 8 )
+	{
+		for ( i = 0; i < n1; i++ )
+		{
+			t[2 * i] = a[i][j];
+			t[2 * i + 1] = a[i][j + 1];
+			t[2 * n1 + 2 * i] = a[i][j + 2];
+			t[2 * n1 + 2 * i + 1] = a[i][j + 3];
+			t[4 * n1 + 2 * i] = a[i][j + 4];
+			t[4 * n1 + 2 * i + 1] = a[i][j + 5];
+			t[6 * n1 + 2 * i] = a[i][j + 6];
+			t[6 * n1 + 2 * i + 1] = a[i][j + 7];
+		}
+
+		cdft( 2 * n1, isgn, t, ip, w );
+		cdft( 2 * n1, isgn, &t[2 * n1], ip, w );
+		cdft( 2 * n1, isgn, &t[4 * n1], ip, w );
+		cdft( 2 * n1, isgn, &t[6 * n1], ip, w );
+
+		for ( i = 0; i < n1; i++ )
+		{
+			a[i][j] = t[2 * i];
+			a[i][j + 1] = t[2 * i + 1];
+			a[i][j + 2] = t[2 * n1 + 2 * i];
+			a[i][j + 3] = t[2 * n1 + 2 * i + 1];
+			a[i][j + 4] = t[4 * n1 + 2 * i];
+			a[i][j + 5] = t[4 * n1 + 2 * i + 1];
+			a[i][j + 6] = t[6 * n1 + 2 * i];
+			a[i][j + 7] = t[6 * n1 + 2 * i + 1];
+		}
+	}
+}
+
+
 void rdft2d_sub( int n1, int n2, int isgn, float** a )
 {
-	int n1h, i, j;
+	int n1h, i;
 	float xi;
 
 	( void )n2;
 
 	n1h = n1 >> 1;
 
+	// walking the rows from both ends, indexing a[n1 - i] is miscompiled by GCC 12 -O2 (the call is removed as pure)
+	float** ai = a + 1;
+	float** aj = a + n1 - 1;
+
 	if ( isgn < 0 )
 	{
-		for ( i = 1; i < n1h; i++ )
+		for ( i = 1; i < n1h; i++, ai++, aj-- )
 		{
-			j = n1 - i;
-			xi = a[i][0] - a[j][0];
-			a[i][0] += a[j][0];
-			a[j][0] = xi;
-			xi = a[j][1] - a[i][1];
-			a[i][1] += a[j][1];
-			a[j][1] = xi;
+			xi = ( *ai )[0] - ( *aj )[0];
+			( *ai )[0] += ( *aj )[0];
+			( *aj )[0] = xi;
+			xi = ( *aj )[1] - ( *ai )[1];
+			( *ai )[1] += ( *aj )[1];
+			( *aj )[1] = xi;
 		}
 	}
 	else
 	{
-		for ( i = 1; i < n1h; i++ )
+		for ( i = 1; i < n1h; i++, ai++, aj-- )
 		{
-			j = n1 - i;
-			a[j][0] = 0.5f * ( a[i][0] - a[j][0] );
-			a[i][0] -= a[j][0];
-			a[j][1] = 0.5f * ( a[i][1] + a[j][1] );
-			a[i][1] -= a[j][1];
+			( *aj )[0] = 0.5f * ( ( *ai )[0] - ( *aj )[0] );
+			( *ai )[0] -= ( *aj )[0];
+			( *aj )[1] = 0.5f * ( ( *ai )[1] + ( *aj )[1] );
+			( *ai )[1] -= ( *aj )[1];
 		}
 	}
 }
@@ -3807,7 +3959,9 @@ void makect( int nc, int* ip, float* c );
 void cdft( int n, int isgn, float* a, int* ip, float* w );
 void rdft( int n, int isgn, float* a, int* ip, float* w );
 void xdft3da_sub( int n1, int n2, int n3, int icr, int isgn, float** *a, float* t, int* ip, float* w );
+void xdft3da_planes( int i0, int i1, int n2, int n3, int icr, int isgn, float** *a, float* t, int* ip, float* w );
 void cdft3db_sub( int n1, int n2, int n3, int isgn, float** *a, float* t, int* ip, float* w );
+void cdft3db_cols( int n1, int j0, int j1, int n3, int isgn, float** *a, float* t, int* ip, float* w );
 void rdft3d_sub( int n1, int n2, int n3, int isgn, float** *a );
 
 int gettsize3( int n1, int n2, int n3 )
@@ -3995,10 +4149,16 @@ void rdft3dsort( int n1, int n2, int n3, int isgn, float** *a )
 
 
 void xdft3da_sub( int n1, int n2, int n3, int icr, int isgn, float** *a, float* t, int* ip, float* w )
+{
+	xdft3da_planes( 0, n1, n2, n3, icr, isgn, a, t, ip, w );
+}
+
+/// Row passes of the planes [i0..i1)
+void xdft3da_planes( int i0, int i1, int n2, int n3, int icr, int isgn, float** *a, float* t, int* ip, float* w )
 {
 	int i, j, k;
 
-	for ( i = 0; i < n1; i++ )
+	for ( i = i0; i < i1; i++ )
 	{
 		if ( icr == 0 )
 		{
@@ -4099,12 +4259,18 @@ void xdft3da_sub( int n1, int n2, int n3, int icr, int isgn, float** *a, float*
 
 
 void cdft3db_sub( int n1, int n2, int n3, int isgn, float** *a, float* t, int* ip, float* w )
+{
+	cdft3db_cols( n1, 0, n2, n3, isgn, a, t, ip, w );
+}
+
+/// Column passes of the rows [j0..j1) of all the planes
+void cdft3db_cols( int n1, int j0, int j1, int n3, int isgn, float** *a, float* t, int* ip, float* w )
 {
 	int i, j, k;
 
 	if ( n3 > 4 )
 	{
-		for ( j = 0; j < n2; j++ )
+		for ( j = j0; j < j1; j++ )
 		{
 			for ( k = 0; k < n3; k += 8 )
 			{
@@ -4141,7 +4307,7 @@ void cdft3db_sub( int n1, int n2, int n3, int isgn, float** *a, float* t, int* i
 	}
 	else if ( n3 == 4 )
 	{
-		for ( j = 0; j < n2; j++ )
+		for ( j = j0; j < j1; j++ )
 		{
 			for ( i = 0; i < n1; i++ )
 			{
@@ -4165,7 +4331,7 @@ void cdft3db_sub( int n1, int n2, int n3, int isgn, float** *a, float* t, int* i
 	}
 	else if ( n3 == 2 )
 	{
-		for ( j = 0; j < n2; j++ )
+		for ( j = j0; j < j1; j++ )
 		{
 			for ( i = 0; i < n1; i++ )
 			{
@@ -4289,3 +4455,158 @@ void rdft3d_sub( int n1, int n2, int n3, int isgn, float** *a )
 		}
 	}
 }
+
+
+///////////// Multithreaded 2D/3D
+
+/*
+    The row and column passes are split between the clJobSystem workers.
+    Each column job has its own 't' buffer, the cos/sin tables are shared and never written.
+*/
+
+namespace
+{
+	struct sFFTPass
+	{
+		int        n1, n2, n3;
+		int        icr;
+		int        isgn;
+		float**    a2;
+		float***   a3;
+		int*       ip;
+		float*     w;
+	};
+
+	void cdft2d_rows_proc( void* Param, size_t Begin, size_t End )
+	{
+		sFFTPass* P = reinterpret_cast<sFFTPass*>( Param );
+
+		for ( size_t i = Begin; i != End; i++ )
+		{
+			cdft( P->n2, P->isgn, P->a2[i], P->ip, P->w );
+		}
+	}
+
+	void rdft2d_rows_proc( void* Param, size_t Begin, size_t End )
+	{
+		sFFTPass* P = reinterpret_cast<sFFTPass*>( Param );
+
+		for ( size_t i = Begin; i != End; i++ )
+		{
+			rdft( P->n2, P->isgn, P->a2[i], P->ip, P->w );
+		}
+	}
+
+	/// Blocks of 8 columns
+	void cdft2d_cols_proc( void* Param, size_t Begin, size_t End )
+	{
+		sFFTPass* P = reinterpret_cast<sFFTPass*>( Param );
+
+		std::vector<float> t( 8 * P->n1 );
+
+		cdft2d_cols( P->n1, static_cast<int>( Begin ) * 8, static_cast<int>( End ) * 8, P->isgn, P->a2, &t[0], P->ip, P->w );
+	}
+
+	void xdft3da_planes_proc( void* Param, size_t Begin, size_t End )
+	{
+		sFFTPass* P = reinterpret_cast<sFFTPass*>( Param );
+
+		std::vector<float> t( 8 * P->n2 );
+
+		xdft3da_planes( static_cast<int>( Begin ), static_cast<int>( End ), P->n2, P->n3, P->icr, P->isgn, P->a3, &t[0], P->ip, P->w );
+	}
+
+	void cdft3db_cols_proc( void* Param, size_t Begin, size_t End )
+	{
+		sFFTPass* P = reinterpret_cast<sFFTPass*>( Param );
+
+		std::vector<float> t( 8 * P->n1 );
+
+		cdft3db_cols( P->n1, static_cast<int>( Begin ), static_cast<int>( End ), P->n3, P->isgn, P->a3, &t[0], P->ip, P->w );
+	}
+
+	/// Number of items to keep in one job, each item is about Size floats of work
+	size_t GetGrain( int Size )
+	{
+		return static_cast<size_t>( MAX( FFT_THREADS_BEGIN_N / MAX( Size, 1 ), 1 ) );
+	}
+
+	void cdft2d_cols_mt( clJobSystem* Jobs, sFFTPass* P )
+	{
+		if ( P->n2 > 4 )
+		{
+			Jobs->ParallelFor( &cdft2d_cols_proc, P, 0, P->n2 >> 3, GetGrain( 8 * P->n1 ) );
+		}
+		else
+		{
+			std::vector<float> t( gettsize2( P->n1, P->n2 ) );
+
+			cdft2d_sub( P->n1, P->n2, P->isgn, P->a2, &t[0], P->ip, P->w );
+		}
+	}
+
+	void xdft3da_mt( clJobSystem* Jobs, sFFTPass* P )
+	{
+		Jobs->ParallelFor( &xdft3da_planes_proc, P, 0, P->n1, GetGrain( P->n2 * P->n3 ) );
+	}
+
+	void cdft3db_mt( clJobSystem* Jobs, sFFTPass* P )
+	{
+		Jobs->ParallelFor( &cdft3db_cols_proc, P, 0, P->n2, GetGrain( P->n1 * P->n3 ) );
+	}
+}
+
+void cdft2d_mt( clJobSystem* Jobs, int n1, int n2, int isgn, float** a, int* ip, float* w )
+{
+	sFFTPass P = { n1, n2, 0, 0, isgn, a, NULL, ip, w };
+
+	Jobs->ParallelFor( &cdft2d_rows_proc, &P, 0, n1, GetGrain( n2 ) );
+
+	cdft2d_cols_mt( Jobs, &P );
+}
+
+void rdft2d_mt( clJobSystem* Jobs, int n1, int n2, int isgn, float** a, int* ip, float* w )
+{
+	sFFTPass P = { n1, n2, 0, 1, isgn, a, NULL, ip, w };
+
+	if ( isgn < 0 )
+	{
+		rdft2d_sub( n1, n2, isgn, a );
+		cdft2d_cols_mt( Jobs, &P );
+	}
+
+	Jobs->ParallelFor( &rdft2d_rows_proc, &P, 0, n1, GetGrain( n2 ) );
+
+	if ( isgn >= 0 )
+	{
+		cdft2d_cols_mt( Jobs, &P );
+		rdft2d_sub( n1, n2, isgn, a );
+	}
+}
+
+void cdft3d_mt( clJobSystem* Jobs, int n1, int n2, int n3, int isgn, float** *a, int* ip, float* w )
+{
+	sFFTPass P = { n1, n2, n3, 0, isgn, NULL, a, ip, w };
+
+	xdft3da_mt( Jobs, &P );
+	cdft3db_mt( Jobs, &P );
+}
+
+void rdft3d_mt( clJobSystem* Jobs, int n1, int n2, int n3, int isgn, float** *a, int* ip, float* w )
+{
+	sFFTPass P = { n1, n2, n3, 1, isgn, NULL, a, ip, w };
+
+	if ( isgn < 0 )
+	{
+		rdft3d_sub( n1, n2, n3, isgn, a );
+		cdft3db_mt( Jobs, &P );
+	}
+
+	xdft3da_mt( Jobs, &P );
+
+	if ( isgn >= 0 )
+	{
+		cdft3db_mt( Jobs, &P );
+		rdft3d_sub( n1, n2, n3, isgn, a );
+	}
+}
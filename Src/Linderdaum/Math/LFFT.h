@@ -1,21 +1,27 @@
 #ifndef __lfft__h__included__
 #define __lfft__h__included__
 
+class clJobSystem;
+
 /**
    \brief Utility class to hold the required temporary buffers for the 1D/2D/3D DFFT using Takuya Ooura's implementation
 
    This is the reference CPU implementation, for real-time 2D transforms one must use GPU-based FFT.
 
+   The cos/sin and bit reversal tables are cached for each transform size and shared by all the instances,
+   so creating an LFFT every frame is cheap. With a job system assigned the row and column passes of 2D/3D
+   transforms are executed on the worker threads.
+
    The reason for this class is simple: it is an adapter for internal image (clBitmap) processing
 */
 class LFFT
 {
 public:
-	LFFT(): Dim( 0 ), OwnsData( false ) {}
+	LFFT(): OwnsData( false ), a1D( 0 ), a2D( 0 ), a3D( 0 ), Dim( 0 ), ip( 0 ), t( 0 ), w( 0 ), Jobs( 0 ) {}
 
 	~LFFT() { Free(); }
 
-	void Transform( bool Inverse, bool Complex );
+	void Transform( bool Inverse, bool IsComplex );
 
 	/// Make the forward or inverse Real DFT
 	inline void TransformReal( bool Inverse ) { Transform( Inverse, false ); }
@@ -23,11 +29,22 @@ public:
 	/// Make the forward or inverse Complex DFT
 	inline void TransformComplex( bool Inverse ) { Transform( Inverse, true ); }
 
+	/**
+	   \brief Make the forward or inverse Real DFT with the unpacked spectrum
+
+	   The last dimension holds n/2+1 complex values, so the arrays should have n+2 floats in the last dimension (AllocArray( true ) is enough).
+	   Twice as fast as TransformComplex() with zero imaginary parts
+	*/
+	void TransformRealToComplex( bool Inverse );
+
+	/// Run the 2D/3D passes on the worker threads, NULL to transform on the calling thread
+	inline void SetJobSystem( clJobSystem* JobSystem ) { Jobs = JobSystem; }
+
 #pragma region Utility constructors for fast initialization
 
-	LFFT( int an1 )                    { Prepare1D( an1 ); }
-	LFFT( int an1, int an2 )           { Prepare2D( an1, an2 ); }
-	LFFT( int an1, int an2, int an3 )  { Prepare3D( an1, an2, an3 ); }
+	LFFT( int an1 ): OwnsData( false ), a1D( 0 ), a2D( 0 ), a3D( 0 ), t( 0 ), Jobs( 0 )                    { Prepare1D( an1 ); }
+	LFFT( int an1, int an2 ): OwnsData( false ), a1D( 0 ), a2D( 0 ), a3D( 0 ), t( 0 ), Jobs( 0 )           { Prepare2D( an1, an2 ); }
+	LFFT( int an1, int an2, int an3 ): OwnsData( false ), a1D( 0 ), a2D( 0 ), a3D( 0 ), t( 0 ), Jobs( 0 )  { Prepare3D( an1, an2, an3 ); }
 
 #pragma endregion
 
@@ -42,7 +59,7 @@ public:
 	/// Prepare three-dimensional transform
 	void Prepare3D( int an1, int an2, int an3 );
 
-	/// Free all buffers
+	/// Free all buffers. The cached tables stay alive
 	void Free();
 
 #pragma endregion
@@ -50,7 +67,7 @@ public:
 	/// Assign bitmap and store internal pointers
 	void AssignPointersFromBitmap( void* Bmp, int W, int H, int D );
 
-	void AllocArray( bool Complex );
+	void AllocArray( bool IsComplex );
 
 	void FreeArray();
 
@@ -67,17 +84,23 @@ public:
 
 private:
 
+	/// Is the job system set and the transform of Size elements large enough for it
+	bool UseJobs( int Size ) const;
+
 	/// Number of dimensions
 	int Dim;
 
-	/// Temporary buffer
+	/// Bit reversal table, shared
 	int* ip;
 
-	/// Another temporary buffer
+	/// Temporary buffer
 	float* t;
 
-	/// And another buffer
+	/// Cos/sin table, shared
 	float* w;
+
+	/// Job system for the multithreaded passes
+	clJobSystem* Jobs;
 };
 
 #endif
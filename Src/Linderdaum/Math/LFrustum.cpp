@@ -10,6 +10,15 @@
 #include "LFrustum.h"
 
 #include "Math/LSphere.h"
+#include "Math/LBoundsArray.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#  define L_FRUSTUM_SSE
+#  include <xmmintrin.h>
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#  define L_FRUSTUM_NEON
+#  include <arm_neon.h>
+#endif
 
 LFrustum::LFrustum(): FPlanes()
 {
@@ -60,31 +69,16 @@ bool LFrustum::IsPointInFrustum( const LVector3& Point ) const
 
 bool LFrustum::IsSphereInFrustum( const LSphere& Sphere ) const
 {
-	if ( Sphere.GetOrigin().SqrLength() < Linderdaum::Math::EPSILON /*IsZeroVector()*/ )
-	{
-		return true;
-	}
-
 	LVector4 Point4 = LVector4( Sphere.GetOrigin(), 1.0f );
 
-//	int Planes = 0;
-
 	for ( int i = 0; i != CheckPlanes; ++i )
 	{
 		float Distance = FPlanes[i].Dot( Point4 );
 
 		// completely outside
 		if ( Distance < -Sphere.GetRadius() ) { return false; }
-
-		// partially inside
-		if ( fabs( Distance ) < Sphere.GetRadius() ) { return true; }
-
-//		if ( Distance > Sphere.GetRadius() ) Planes++;
 	}
 
-	// NOTE:  Planes == CheckPlanes  - full inside
-	//        Planes != CheckPlanes  - partial inside
-
 	return true;
 }
 
@@ -93,21 +87,21 @@ bool LFrustum::IsAABBInFrustum( const LAABoundingBox& Box ) const
 	LVector3 bMax = Box.FMax;
 	LVector3 bMin = Box.FMin;
 
-	LVector3 Near, N;
+	LVector3 Far, N;
 
 	const LVector4* Plane = &FPlanes[0];
 
-	/// Find extreme point for each plane
+	/// Find extreme point for each plane, the planes point inside of the frustum
 	for ( int i = 0 ; i < 6 ; i++ )
 	{
 		N = Plane->ToVector3();
 
-		Near.x = ( N.x > 0.0f ) ? bMin.x : bMax.x;
-		Near.y = ( N.y > 0.0f ) ? bMin.y : bMax.y;
-		Near.z = ( N.z > 0.0f ) ? bMin.z : bMax.z;
+		Far.x = ( N.x > 0.0f ) ? bMax.x : bMin.x;
+		Far.y = ( N.y > 0.0f ) ? bMax.y : bMin.y;
+		Far.z = ( N.z > 0.0f ) ? bMax.z : bMin.z;
 
-		/// If the near extreme point is outside, then the AABB is totally outside the frustum
-		if ( N.Dot( Near ) + Plane->W > 0.0f ) { return false; }
+		/// If the farthest point along the normal is outside, then the AABB is totally outside the frustum
+		if ( N.Dot( Far ) + Plane->W < 0.0f ) { return false; }
 
 		Plane++;
 	}
@@ -115,6 +109,150 @@ bool LFrustum::IsAABBInFrustum( const LAABoundingBox& Box ) const
 	return true;
 }
 
+bool LFrustum::IsAABBInFrustumMasked( const LAABoundingBox& Box, int* PlaneMask ) const
+{
+	for ( int i = 0 ; i < 6 ; i++ )
+	{
+		if ( !( *PlaneMask & ( 1 << i ) ) ) { continue; }
+
+		const LVector4& Plane = FPlanes[i];
+
+		LVector3 N = Plane.ToVector3();
+
+		LVector3 Far( ( N.X > 0.0f ) ? Box.FMax.X : Box.FMin.X,
+		              ( N.Y > 0.0f ) ? Box.FMax.Y : Box.FMin.Y,
+		              ( N.Z > 0.0f ) ? Box.FMax.Z : Box.FMin.Z );
+
+		if ( N.Dot( Far ) + Plane.W < 0.0f ) { return false; }
+
+		LVector3 Near( ( N.X > 0.0f ) ? Box.FMin.X : Box.FMax.X,
+		               ( N.Y > 0.0f ) ? Box.FMin.Y : Box.FMax.Y,
+		               ( N.Z > 0.0f ) ? Box.FMin.Z : Box.FMax.Z );
+
+		/// The near extreme point is inside too, so are the children of this box
+		if ( N.Dot( Near ) + Plane.W >= 0.0f ) { *PlaneMask &= ~( 1 << i ); }
+	}
+
+	return true;
+}
+
+void LFrustum::CullAABBs( const LAABBArray& Boxes, Lubyte* Visible, int PlaneMask ) const
+{
+	if ( !Boxes.size() ) { return; }
+
+	CullAABBs( Boxes.size(), &Boxes.FMinX[0], &Boxes.FMinY[0], &Boxes.FMinZ[0], &Boxes.FMaxX[0], &Boxes.FMaxY[0], &Boxes.FMaxZ[0], Visible, PlaneMask );
+}
+
+/**
+   The batched kernel evaluates the same expression in the same order as IsAABBInFrustumMasked(). The results are
+   identical unless the compiler contracts the scalar expression into fused multiply-adds (i.e. -ffp-contract=fast
+   on a target with FMA), then the boxes touching a plane within the rounding error may be classified differently.
+   The plane is the same for all the lanes, so the extreme point of the box is selected by picking the min or max
+   arrays once per plane.
+**/
+void LFrustum::CullAABBs( size_t Count,
+                          const float* MinX, const float* MinY, const float* MinZ,
+                          const float* MaxX, const float* MaxY, const float* MaxZ,
+                          Lubyte* Visible, int PlaneMask ) const
+{
+	// only the planes in the mask are tested
+	const LVector4* Planes[6];
+	const float*    FarX[6];
+	const float*    FarY[6];
+	const float*    FarZ[6];
+
+	int NumPlanes = 0;
+
+	for ( int p = 0; p != 6; p++ )
+	{
+		if ( !( PlaneMask & ( 1 << p ) ) ) { continue; }
+
+		Planes[ NumPlanes ] = &FPlanes[p];
+
+		FarX[ NumPlanes ] = ( FPlanes[p].X > 0.0f ) ? MaxX : MinX;
+		FarY[ NumPlanes ] = ( FPlanes[p].Y > 0.0f ) ? MaxY : MinY;
+		FarZ[ NumPlanes ] = ( FPlanes[p].Z > 0.0f ) ? MaxZ : MinZ;
+
+		NumPlanes++;
+	}
+
+	size_t i = 0;
+
+#if defined( L_FRUSTUM_SSE )
+	const __m128 Zero = _mm_setzero_ps();
+
+	for ( ; i + 4 <= Count; i += 4 )
+	{
+		__m128 Outside = _mm_setzero_ps();
+
+		for ( int p = 0; p != NumPlanes; p++ )
+		{
+			const LVector4& P = *Planes[p];
+
+			__m128 D = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( P.X ), _mm_loadu_ps( FarX[p] + i ) ),
+			                       _mm_mul_ps( _mm_set1_ps( P.Y ), _mm_loadu_ps( FarY[p] + i ) ) );
+
+			D = _mm_add_ps( D, _mm_mul_ps( _mm_set1_ps( P.Z ), _mm_loadu_ps( FarZ[p] + i ) ) );
+			D = _mm_add_ps( D, _mm_set1_ps( P.W ) );
+
+			Outside = _mm_or_ps( Outside, _mm_cmplt_ps( D, Zero ) );
+		}
+
+		int Mask = _mm_movemask_ps( Outside );
+
+		Visible[i + 0] = ( Mask & 1 ) ? 0 : 1;
+		Visible[i + 1] = ( Mask & 2 ) ? 0 : 1;
+		Visible[i + 2] = ( Mask & 4 ) ? 0 : 1;
+		Visible[i + 3] = ( Mask & 8 ) ? 0 : 1;
+	}
+
+#elif defined( L_FRUSTUM_NEON )
+	const float32x4_t Zero = vdupq_n_f32( 0.0f );
+
+	for ( ; i + 4 <= Count; i += 4 )
+	{
+		uint32x4_t Outside = vdupq_n_u32( 0 );
+
+		for ( int p = 0; p != NumPlanes; p++ )
+		{
+			const LVector4& P = *Planes[p];
+
+			// separate multiplies and adds, as in the scalar expression without the contraction
+			float32x4_t D = vaddq_f32( vmulq_f32( vdupq_n_f32( P.X ), vld1q_f32( FarX[p] + i ) ),
+			                           vmulq_f32( vdupq_n_f32( P.Y ), vld1q_f32( FarY[p] + i ) ) );
+
+			D = vaddq_f32( D, vmulq_f32( vdupq_n_f32( P.Z ), vld1q_f32( FarZ[p] + i ) ) );
+			D = vaddq_f32( D, vdupq_n_f32( P.W ) );
+
+			Outside = vorrq_u32( Outside, vcltq_f32( D, Zero ) );
+		}
+
+		Visible[i + 0] = vgetq_lane_u32( Outside, 0 ) ? 0 : 1;
+		Visible[i + 1] = vgetq_lane_u32( Outside, 1 ) ? 0 : 1;
+		Visible[i + 2] = vgetq_lane_u32( Outside, 2 ) ? 0 : 1;
+		Visible[i + 3] = vgetq_lane_u32( Outside, 3 ) ? 0 : 1;
+	}
+
+#endif
+
+	// scalar fallback and the remainder
+	for ( ; i < Count; i++ )
+	{
+		Lubyte Inside = 1;
+
+		for ( int p = 0; p != NumPlanes; p++ )
+		{
+			const LVector4& P = *Planes[p];
+
+			float D = P.X * FarX[p][i] + P.Y * FarY[p][i] + P.Z * FarZ[p][i] + P.W;
+
+			if ( D < 0.0f ) { Inside = 0; }
+		}
+
+		Visible[i] = Inside;
+	}
+}
+
 // indices of the plane-defining corner points
 LVector3 FrustumPlanePoints[] =
 {
@@ -190,6 +328,10 @@ void LFrustum::CalcPerspectiveFrustumPoints( float Angle, float Ratio, float Nea
 }
 
 /*
+ * 17/10/2026
+     Batched SSE/NEON CullAABBs() with the planes mask
+     IsAABBInFrustum() used the inverted plane orientation
+     IsAABBInFrustumMasked()
  * 16/02/2007
      Development...
  * 24/01/2007
@@ -38,6 +38,11 @@ enum LFrustumCorner
 	FRUSTUM_fbr = 7
 };
 
+class LAABBArray;
+
+/// All the six planes for IsAABBInFrustumMasked() and CullAABBs()
+const int L_FRUSTUM_ALL_PLANES = ( 1 << 6 ) - 1;
+
 /// Viewing frustum
 class LFrustum
 {
@@ -56,6 +61,15 @@ public:
 	bool    IsPointInFrustum( const LVector3& Point ) const;
 	bool    IsSphereInFrustum( const LSphere& Sphere ) const;
 	bool    IsAABBInFrustum( const LAABoundingBox& Box ) const;
+	/// Test the box against the planes in PlaneMask only and clear the bits of the planes the box is completely inside of
+	bool    IsAABBInFrustumMasked( const LAABoundingBox& Box, int* PlaneMask ) const;
+
+	/// Batched IsAABBInFrustumMasked() using SSE or NEON when available, Visible[i] is set to 1 or 0. The mask is not changed
+	void    CullAABBs( const LAABBArray& Boxes, Lubyte* Visible, int PlaneMask ) const;
+	void    CullAABBs( size_t Count,
+	                   const float* MinX, const float* MinY, const float* MinZ,
+	                   const float* MaxX, const float* MaxY, const float* MaxZ,
+	                   Lubyte* Visible, int PlaneMask ) const;
 
 	TODO( "split frustum to parts for multiple shadow maps" )
 
@@ -83,6 +97,9 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     CullAABBs()
+     IsAABBInFrustumMasked()
  * 29/03/2010
      Recalculation of frustum corner points
      Plane/Point constants
@@ -7,8 +7,8 @@
    http://www.linderdaum.com
 */
 
-#ifndef _LRandom_
-#define _LRandom_
+#ifndef _LHash_
+#define _LHash_
 
 #include "Platform.h"
 
@@ -26,12 +26,28 @@ namespace Linderdaum
 			Value = Value ^ ( Value >> 15 );
 			return Value;
 		}
+
+		// http://www.isthe.com/chongo/tech/comp/fnv/
+		inline Luint32 HashStringFNV1a( const char* Str )
+		{
+			Luint32 Hash = 2166136261u;
+
+			for ( ; *Str; ++Str )
+			{
+				Hash ^= static_cast<unsigned char>( *Str );
+				Hash *= 16777619u;
+			}
+
+			return Hash;
+		}
 	};
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     HashStringFNV1a()
  * 13/10/2010
      It's here
 */
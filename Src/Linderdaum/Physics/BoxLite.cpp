@@ -11,6 +11,8 @@
 
 #include "Physics/BoxLite.h"
 
+#include <algorithm>
+
 int Collide(Contact* contacts, Body* body1, Body* body2);
 
 Arbiter::Arbiter(Body* b1, Body* b2)
@@ -101,11 +103,17 @@ void Arbiter::PreStep(float inv_dt)
 			// Apply normal + friction impulse
 			Vec2 P = c->Pn * c->normal + c->Pt * tangent;
 
-			body1->velocity -= body1->invMass * P;
-			body1->angularVelocity -= body1->invI * Cross(r1, P);
+			if (body1->invMass != 0.0f)
+			{
+				body1->velocity -= body1->invMass * P;
+				body1->angularVelocity -= body1->invI * Cross(r1, P);
+			}
 
-			body2->velocity += body2->invMass * P;
-			body2->angularVelocity += body2->invI * Cross(r2, P);
+			if (body2->invMass != 0.0f)
+			{
+				body2->velocity += body2->invMass * P;
+				body2->angularVelocity += body2->invI * Cross(r2, P);
+			}
 		}
 	}
 }
@@ -143,11 +151,17 @@ void Arbiter::ApplyImpulse()
 		// Apply contact impulse
 		Vec2 Pn = dPn * c->normal;
 
-		b1->velocity -= b1->invMass * Pn;
-		b1->angularVelocity -= b1->invI * Cross(c->r1, Pn);
+		if (b1->invMass != 0.0f)
+		{
+			b1->velocity -= b1->invMass * Pn;
+			b1->angularVelocity -= b1->invI * Cross(c->r1, Pn);
+		}
 
-		b2->velocity += b2->invMass * Pn;
-		b2->angularVelocity += b2->invI * Cross(c->r2, Pn);
+		if (b2->invMass != 0.0f)
+		{
+			b2->velocity += b2->invMass * Pn;
+			b2->angularVelocity += b2->invI * Cross(c->r2, Pn);
+		}
 
 		// Relative velocity at contact
 		dv = b2->velocity + Cross(b2->angularVelocity, c->r2) - b1->velocity - Cross(b1->angularVelocity, c->r1);
@@ -175,11 +189,29 @@ void Arbiter::ApplyImpulse()
 		// Apply contact impulse
 		Vec2 Pt = dPt * tangent;
 
-		b1->velocity -= b1->invMass * Pt;
-		b1->angularVelocity -= b1->invI * Cross(c->r1, Pt);
+		if (b1->invMass != 0.0f)
+		{
+			b1->velocity -= b1->invMass * Pt;
+			b1->angularVelocity -= b1->invI * Cross(c->r1, Pt);
+		}
 
-		b2->velocity += b2->invMass * Pt;
-		b2->angularVelocity += b2->invI * Cross(c->r2, Pt);
+		if (b2->invMass != 0.0f)
+		{
+			b2->velocity += b2->invMass * Pt;
+			b2->angularVelocity += b2->invI * Cross(c->r2, Pt);
+		}
+	}
+}
+
+void Body::SetAwake(bool flag)
+{
+	awake = flag;
+	sleepTime = 0.0f;
+
+	if (!flag)
+	{
+		velocity.Set(0.0f, 0.0f);
+		angularVelocity = 0.0f;
 	}
 }
 
@@ -514,11 +546,17 @@ void Joint::PreStep(float inv_dt)
 	if (!World::warmStarting) { P.Set(0.0f, 0.0f); return; }
 
 	// Apply accumulated impulse.
-	body1->velocity -= body1->invMass * P;
-	body1->angularVelocity -= body1->invI * Cross(r1, P);
+	if (body1->invMass != 0.0f)
+	{
+		body1->velocity -= body1->invMass * P;
+		body1->angularVelocity -= body1->invI * Cross(r1, P);
+	}
 
-	body2->velocity += body2->invMass * P;
-	body2->angularVelocity += body2->invI * Cross(r2, P);
+	if (body2->invMass != 0.0f)
+	{
+		body2->velocity += body2->invMass * P;
+		body2->angularVelocity += body2->invI * Cross(r2, P);
+	}
 }
 
 void Joint::ApplyImpulse()
@@ -527,88 +565,490 @@ void Joint::ApplyImpulse()
 
 	Vec2 impulse = M * (bias - dv - softness * P);
 
-	body1->velocity -= body1->invMass * impulse;
-	body1->angularVelocity -= body1->invI * Cross(r1, impulse);
+	if (body1->invMass != 0.0f)
+	{
+		body1->velocity -= body1->invMass * impulse;
+		body1->angularVelocity -= body1->invI * Cross(r1, impulse);
+	}
 
-	body2->velocity += body2->invMass * impulse;
-	body2->angularVelocity += body2->invI * Cross(r2, impulse);
+	if (body2->invMass != 0.0f)
+	{
+		body2->velocity += body2->invMass * impulse;
+		body2->angularVelocity += body2->invI * Cross(r2, impulse);
+	}
 
 	P += impulse;
 }
 
-typedef std::map<ArbiterKey, Arbiter>::iterator ArbIter;
+unsigned int ArbiterTable::Home(const ArbiterKey& key) const
+{
+	size_t a = (size_t)key.body1 >> 3, b = (size_t)key.body2 >> 3;
+	size_t h = a * 2654435761u ^ b * 2246822519u;
+	return (unsigned int)(h ^ (h >> 15)) & mask;
+}
+
+int ArbiterTable::FindSlot(const ArbiterKey& key) const
+{
+	if (slots.empty()) { return -1; }
+
+	for (unsigned int i = Home(key); ; i = (i + 1) & mask)
+	{
+		int k = slots[i];
+
+		if (k < 0) { return -1; }
+
+		if (arbiters[k].body1 == key.body1 && arbiters[k].body2 == key.body2) { return (int)i; }
+	}
+}
+
+int ArbiterTable::Find(const ArbiterKey& key) const
+{
+	int slot = FindSlot(key);
+
+	return (slot < 0) ? -1 : slots[slot];
+}
+
+void ArbiterTable::Rehash(int capacity)
+{
+	slots.assign(capacity, -1);
+	mask = (unsigned int)capacity - 1;
+
+	for (int k = 0; k < (int)arbiters.size(); ++k)
+	{
+		unsigned int i = Home(ArbiterKey(arbiters[k].body1, arbiters[k].body2));
+		while (slots[i] >= 0) { i = (i + 1) & mask; }
+		slots[i] = k;
+	}
+}
+
+int ArbiterTable::Insert(const ArbiterKey& key, const Arbiter& arb)
+{
+	// keep the load factor below 1/2
+	if ((arbiters.size() + 1) * 2 > slots.size()) { Rehash(slots.empty() ? 64 : (int)slots.size() * 2); }
+
+	int k = (int)arbiters.size();
+
+	arbiters.push_back(arb);
+	stamps.push_back(0);
+
+	unsigned int i = Home(key);
+	while (slots[i] >= 0) { i = (i + 1) & mask; }
+	slots[i] = k;
+
+	return k;
+}
+
+void ArbiterTable::Remove(int k)
+{
+	unsigned int hole = (unsigned int)FindSlot(ArbiterKey(arbiters[k].body1, arbiters[k].body2));
+
+	// backward shift deletion: move the following entries of the cluster into the hole unless it precedes their home slot
+	for (unsigned int j = (hole + 1) & mask; slots[j] >= 0; j = (j + 1) & mask)
+	{
+		unsigned int home = Home(ArbiterKey(arbiters[slots[j]].body1, arbiters[slots[j]].body2));
+
+		if (((j - home) & mask) >= ((j - hole) & mask))
+		{
+			slots[hole] = slots[j];
+			hole = j;
+		}
+	}
+
+	slots[hole] = -1;
+
+	// fill the hole in the dense storage with the last arbiter
+	int last = (int)arbiters.size() - 1;
+
+	if (k != last)
+	{
+		int lastSlot = FindSlot(ArbiterKey(arbiters[last].body1, arbiters[last].body2));
+
+		arbiters[k] = arbiters[last];
+		stamps[k] = stamps[last];
+		slots[lastSlot] = k;
+	}
+
+	arbiters.pop_back();
+	stamps.pop_back();
+}
 
 bool World::accumulateImpulses = true;
 bool World::warmStarting = true;
 bool World::positionCorrection = true;
+bool World::allowSleep = false;
+
+// Islands slower than this for timeToSleep seconds are put to sleep
+static const float linearSleepTolerance = 0.01f;
+static const float angularSleepTolerance = 2.0f / 180.0f * 3.14159265f;
+static const float timeToSleep = 0.5f;
+
+static inline bool ProxyLess(const SapProxy& p1, const SapProxy& p2) { return p1.minX < p2.minX; }
+
+// Moving static bodies keep the touching islands awake
+static inline bool IsMovingStatic(const Body* b)
+{
+	return b->invMass == 0.0f && (b->velocity.x != 0.0f || b->velocity.y != 0.0f || b->angularVelocity != 0.0f);
+}
+
+// A moving static body pushes the sleeping bodies, so it is never resting
+static inline bool IsResting(const Body* b) { return !IsMovingStatic(b) && (b->invMass == 0.0f || !b->awake); }
+
+static void UpdateProxy(SapProxy& p, const Body* b)
+{
+	Vec2 h = Abs(Mat22(b->rotation)) * (0.5f * b->width);
+
+	p.minX = b->position.x - h.x;
+	p.maxX = b->position.x + h.x;
+	p.minY = b->position.y - h.y;
+	p.maxY = b->position.y + h.y;
+}
 
 void World::BroadPhase()
 {
 	int i, j, sz = (int)bodies.size();
-	// O(n^2) broad-phase
+
+	++stamp;
+
+	// new proxies when the bodies were added or removed
+	bool rebuild = (proxyBodies != bodies);
+
+	if (rebuild)
+	{
+		proxyBodies = bodies;
+		proxies.resize(sz);
+
+		for (i = 0; i < sz; ++i) { proxies[i].body = i; }
+	}
+
+	for (i = 0; i < sz; ++i) { UpdateProxy(proxies[i], bodies[proxies[i].body]); }
+
+	if (rebuild)
+	{
+		std::sort(proxies.begin(), proxies.end(), ProxyLess);
+	}
+	else
+	{
+		// insertion sort, the order barely changes between the steps. Fall back to std::sort after a teleport
+		int shifts = 0, maxShifts = 8 * sz + 64;
+
+		for (i = 1; i < sz && shifts <= maxShifts; ++i)
+		{
+			SapProxy p = proxies[i];
+
+			for (j = i - 1; j >= 0 && proxies[j].minX > p.minX; --j, ++shifts) { proxies[j + 1] = proxies[j]; }
+
+			proxies[j + 1] = p;
+		}
+
+		if (shifts > maxShifts) { std::sort(proxies.begin(), proxies.end(), ProxyLess); }
+	}
+
+	// sweep along X, check Y
 	for (i = 0; i < sz; ++i)
 	{
-		Body* bi = bodies[i];
+		const SapProxy& pi = proxies[i];
+		Body* bi = bodies[pi.body];
 
-		for (j = i + 1; j < sz; ++j)
+		for (j = i + 1; j < sz && proxies[j].minX <= pi.maxX; ++j)
 		{
-			Body* bj = bodies[j];
+			const SapProxy& pj = proxies[j];
+
+			if (pj.minY > pi.maxY || pj.maxY < pi.minY) { continue; }
+
+			Body* bj = bodies[pj.body];
 
 			if (bi->invMass == 0.0f && bj->invMass == 0.0f) { continue; }
 
-			Arbiter newArb(bi, bj);
 			ArbiterKey key(bi, bj);
 
-			if (newArb.numContacts > 0)
+			// nothing moves, keep the contacts for the warm starting after the wake up
+			if (IsResting(bi) && IsResting(bj))
+			{
+				int k = arbiters.Find(key);
+
+				if (k >= 0) { arbiters.stamps[k] = stamp; }
+
+				continue;
+			}
+
+			Arbiter newArb(bi, bj);
+
+			if (newArb.numContacts == 0) { continue; }
+
+			int k = arbiters.Find(key);
+
+			if (k < 0)
 			{
-				ArbIter iter = arbiters.find(key);
-				if (iter == arbiters.end())
-				{
-					arbiters.insert(std::pair<ArbiterKey, Arbiter>(key, newArb));
-				}
-				else
-				{
-					iter->second.Update(newArb.contacts, newArb.numContacts);
-				}
+				k = arbiters.Insert(key, newArb);
 			}
 			else
 			{
-				arbiters.erase(key);
+				arbiters[k].Update(newArb.contacts, newArb.numContacts);
 			}
+
+			arbiters.stamps[k] = stamp;
 		}
 	}
+
+	// the pairs which were not touching in this step, including the removed bodies
+	for (int k = arbiters.Size() - 1; k >= 0; --k)
+	{
+		if (arbiters.stamps[k] != stamp) { arbiters.Remove(k); }
+	}
 }
 
-void World::Step(float dt)
+static int FindRoot(std::vector<int>& parent, int i)
 {
-	float inv_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+	while (parent[i] != i)
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
 
-	BroadPhase();
+	return i;
+}
 
-	for (int i = 0; i < (int)bodies.size(); ++i) // forces
+static void Union(std::vector<int>& parent, const Body* b1, const Body* b2)
+{
+	if (b1->invMass == 0.0f || b2->invMass == 0.0f) { return; }
+
+	int r1 = FindRoot(parent, b1->index), r2 = FindRoot(parent, b2->index);
+
+	// the smaller index becomes the root, so the islands do not depend on the merge order
+	if (r1 < r2) { parent[r2] = r1; } else { parent[r1] = r2; }
+}
+
+// Island of the constraint, -1 if both bodies are static
+static inline int ConstraintIsland(const std::vector<int>& bodyIsland, const Body* b1, const Body* b2)
+{
+	return (b1->invMass != 0.0f) ? bodyIsland[b1->index] : ((b2->invMass != 0.0f) ? bodyIsland[b2->index] : -1);
+}
+
+void World::BuildIslands()
+{
+	int i, sz = (int)bodies.size(), numArbiters = arbiters.Size(), numJoints = (int)joints.size();
+
+	bodyIsland.resize(sz);
+
+	for (i = 0; i < sz; ++i) { bodies[i]->index = i; bodyIsland[i] = i; }
+
+	for (i = 0; i < numArbiters; ++i) { Union(bodyIsland, arbiters[i].body1, arbiters[i].body2); }
+	for (i = 0; i < numJoints; ++i) { Union(bodyIsland, joints[i]->body1, joints[i]->body2); }
+
+	for (i = 0; i < sz; ++i) { bodyIsland[i] = FindRoot(bodyIsland, i); }
+
+	// number the islands in the order of their first bodies
+	islands.clear();
+
+	for (i = 0; i < sz; ++i)
 	{
-		Body* b = bodies[i];
+		if (bodies[i]->invMass == 0.0f) { bodyIsland[i] = -1; continue; }
+
+		int root = bodyIsland[i];
+
+		if (root == i)
+		{
+			Island island = { 0, 0, 0, 0, 0, 0, false };
+			bodyIsland[i] = (int)islands.size();
+			islands.push_back(island);
+		}
+		else
+		{
+			// the root precedes i and is already numbered
+			bodyIsland[i] = bodyIsland[root];
+		}
+	}
+
+	int numIslands = (int)islands.size();
+
+	// count, offsets and fill, every list keeps the global order
+	for (i = 0; i < sz; ++i)
+	{
+		if (bodyIsland[i] < 0) { continue; }
+
+		Island& island = islands[bodyIsland[i]];
+
+		island.bodyEnd++;
+		island.awake |= bodies[i]->awake || !allowSleep;
+	}
+
+	for (i = 0; i < numArbiters; ++i)
+	{
+		const Arbiter& arb = arbiters[i];
+		Island& island = islands[ConstraintIsland(bodyIsland, arb.body1, arb.body2)];
+
+		island.arbiterEnd++;
+		island.awake |= IsMovingStatic(arb.body1) || IsMovingStatic(arb.body2);
+	}
+
+	for (i = 0; i < numJoints; ++i)
+	{
+		int k = ConstraintIsland(bodyIsland, joints[i]->body1, joints[i]->body2);
+
+		if (k < 0) { continue; }
+
+		islands[k].jointEnd++;
+		islands[k].awake |= IsMovingStatic(joints[i]->body1) || IsMovingStatic(joints[i]->body2);
+	}
+
+	int numBodies = 0, numIslandArbiters = 0, numIslandJoints = 0;
+
+	for (i = 0; i < numIslands; ++i)
+	{
+		Island& island = islands[i];
+
+		island.bodyBegin = numBodies;       numBodies += island.bodyEnd;                 island.bodyEnd = island.bodyBegin;
+		island.arbiterBegin = numIslandArbiters; numIslandArbiters += island.arbiterEnd; island.arbiterEnd = island.arbiterBegin;
+		island.jointBegin = numIslandJoints; numIslandJoints += island.jointEnd;         island.jointEnd = island.jointBegin;
+	}
+
+	islandBodies.resize(numBodies);
+	islandArbiters.resize(numIslandArbiters);
+	islandJoints.resize(numIslandJoints);
+
+	for (i = 0; i < sz; ++i)
+	{
+		if (bodyIsland[i] < 0) { continue; }
+
+		Island& island = islands[bodyIsland[i]];
+
+		islandBodies[island.bodyEnd++] = i;
+
+		// a single awake body wakes the whole island
+		if (island.awake && !bodies[i]->awake) { bodies[i]->SetAwake(true); }
+	}
+
+	for (i = 0; i < numArbiters; ++i)
+	{
+		Island& island = islands[ConstraintIsland(bodyIsland, arbiters[i].body1, arbiters[i].body2)];
+
+		islandArbiters[island.arbiterEnd++] = i;
+	}
+
+	for (i = 0; i < numJoints; ++i)
+	{
+		int k = ConstraintIsland(bodyIsland, joints[i]->body1, joints[i]->body2);
+
+		if (k >= 0) { islandJoints[islands[k].jointEnd++] = i; }
+	}
+}
+
+void World::SolveIsland(int n, float dt, float inv_dt)
+{
+	const Island& island = islands[n];
+
+	if (!island.awake) { return; }
 
-		if (b->invMass == 0.0f) { continue; }
+	int i, j;
+
+	for (i = island.bodyBegin; i < island.bodyEnd; ++i) // forces
+	{
+		Body* b = bodies[islandBodies[i]];
 
 		b->velocity += dt * (gravity + b->invMass * b->force);
 		b->angularVelocity += dt * b->invI * b->torque;
 	}
 
 	// pre-steps.
-	for (ArbIter arb = arbiters.begin(); arb != arbiters.end(); ++arb) { arb->second.PreStep(inv_dt); }
-	for (int i = 0; i < (int)joints.size(); ++i) { joints[i]->PreStep(inv_dt); }
+	for (i = island.arbiterBegin; i < island.arbiterEnd; ++i) { arbiters[islandArbiters[i]].PreStep(inv_dt); }
+	for (i = island.jointBegin; i < island.jointEnd; ++i) { joints[islandJoints[i]]->PreStep(inv_dt); }
 
-	for (int i = 0; i < iterations; ++i) // iterations
+	for (i = 0; i < iterations; ++i) // iterations
 	{
-		for (ArbIter arb = arbiters.begin(); arb != arbiters.end(); ++arb) { arb->second.ApplyImpulse(); }
-		for (int j = 0; j < (int)joints.size(); ++j) { joints[j]->ApplyImpulse(); }
+		for (j = island.arbiterBegin; j < island.arbiterEnd; ++j) { arbiters[islandArbiters[j]].ApplyImpulse(); }
+		for (j = island.jointBegin; j < island.jointEnd; ++j) { joints[islandJoints[j]]->ApplyImpulse(); }
 	}
 
-	for (int i = 0; i < (int)bodies.size(); ++i) // velocity step
+	float minSleepTime = FLT_MAX;
+
+	for (i = island.bodyBegin; i < island.bodyEnd; ++i) // velocity step
+	{
+		Body* b = bodies[islandBodies[i]];
+
+		b->position += dt * b->velocity;
+		b->rotation += dt * b->angularVelocity;
+
+		b->force.Set(0.0f, 0.0f);
+		b->torque = 0.0f;
+
+		if (Dot(b->velocity, b->velocity) > linearSleepTolerance * linearSleepTolerance ||
+		    b->angularVelocity * b->angularVelocity > angularSleepTolerance * angularSleepTolerance)
+		{
+			b->sleepTime = 0.0f;
+		}
+		else
+		{
+			b->sleepTime += dt;
+		}
+
+		minSleepTime = Min(minSleepTime, b->sleepTime);
+	}
+
+	if (allowSleep && minSleepTime >= timeToSleep)
+	{
+		for (i = island.bodyBegin; i < island.bodyEnd; ++i) { bodies[islandBodies[i]]->SetAwake(false); }
+	}
+}
+
+void World::WakeAll()
+{
+	for (size_t i = 0; i < bodies.size(); ++i)
+	{
+		if (bodies[i]->invMass != 0.0f) { bodies[i]->SetAwake(true); }
+	}
+}
+
+static inline void WakeOther(const Body* body, Body* b1, Body* b2)
+{
+	Body* other = (b1 == body) ? b2 : ((b2 == body) ? b1 : NULL);
+
+	if (other && other->invMass != 0.0f) { other->SetAwake(true); }
+}
+
+void World::WakeTouching(const Body* body)
+{
+	for (int i = 0; i < arbiters.Size(); ++i) { WakeOther(body, arbiters[i].body1, arbiters[i].body2); }
+
+	for (size_t i = 0; i < joints.size(); ++i) { WakeOther(body, joints[i]->body1, joints[i]->body2); }
+}
+
+struct IslandStepParams
+{
+	World* world;
+	float dt, inv_dt;
+};
+
+static void SolveIslandsProc(void* param, size_t begin, size_t end)
+{
+	IslandStepParams* p = (IslandStepParams*)param;
+
+	for (size_t i = begin; i != end; ++i) { p->world->SolveIsland((int)i, p->dt, p->inv_dt); }
+}
+
+void World::Step(float dt)
+{
+	float inv_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+	BroadPhase();
+	BuildIslands();
+
+	IslandStepParams params = { this, dt, inv_dt };
+
+	if (parallelFor && islands.size() > 1)
+	{
+		parallelFor(parallelContext, &SolveIslandsProc, &params, islands.size());
+	}
+	else
+	{
+		SolveIslandsProc(&params, 0, islands.size());
+	}
+
+	for (int i = 0; i < (int)bodies.size(); ++i) // static and sleeping bodies
 	{
 		Body* b = bodies[i];
 
+		if (b->invMass != 0.0f && b->awake) { continue; }
+
 		b->position += dt * b->velocity;
 		b->rotation += dt * b->angularVelocity;
 
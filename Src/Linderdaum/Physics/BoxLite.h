@@ -17,7 +17,6 @@
 #include <float.h>
 
 #include <vector>
-#include <map>
 
 struct Vec2
 {
@@ -81,18 +80,28 @@ inline float Max(float a, float b) { return a > b ? a : b; }
 
 inline float Clamp(float a, float low, float high) { return Max(low, Min(a, high)); }
 
+// Bodies with invMass == 0 are static. They can be shared by the islands solved in parallel, so the solver never writes them
 struct Body
 {
-	Body(): position(0,0), rotation(0), velocity(0,0), angularVelocity(0), force(0,0), torque(0) { Set(Vec2(1.0f, 1.0f), FLT_MAX); }
+	Body(): position(0,0), rotation(0), velocity(0,0), angularVelocity(0), force(0,0), torque(0), sleepTime(0), awake(true), index(0) { Set(Vec2(1.0f, 1.0f), FLT_MAX); }
 	void Set(const Vec2& w, float m);
 
-	void AddForce(const Vec2& f) { force += f; }
+	void AddForce(const Vec2& f) { force += f; SetAwake(true); }
+
+	// A sleeping body is not simulated until something touches it
+	void SetAwake(bool flag);
 
 	Vec2 width, position, velocity, force;
 	float rotation, angularVelocity, torque;
 
 	float friction;
 	float mass, invMass, I, invI;
+
+	// time spent below the sleep velocities
+	float sleepTime;
+	bool awake;
+	// position in World::bodies, updated every step
+	int index;
 };
 
 struct Joint
@@ -146,6 +155,8 @@ struct ArbiterKey
 	Body* body2;
 };
 
+inline bool operator == (const ArbiterKey& a1, const ArbiterKey& a2) { return a1.body1 == a2.body1 && a1.body2 == a2.body2; }
+
 struct Arbiter
 {
 	enum {MAX_POINTS = 2};
@@ -167,31 +178,105 @@ struct Arbiter
 	float friction;
 };
 
-// This is used by std::set
-inline bool operator < (const ArbiterKey& a1, const ArbiterKey& a2)
+// Arbiters stored densely for the solver loops, with an open addressing index (linear probing) on top.
+// The storage is kept between the steps, removal moves the last arbiter into the hole.
+struct ArbiterTable
+{
+	ArbiterTable() : mask(0) {}
+
+	inline int Size() const { return (int)arbiters.size(); }
+	inline Arbiter& operator [] (int i) { return arbiters[i]; }
+	inline const Arbiter& operator [] (int i) const { return arbiters[i]; }
+
+	// Index of the arbiter, -1 if the pair has none
+	int Find(const ArbiterKey& key) const;
+	int Insert(const ArbiterKey& key, const Arbiter& arb);
+	void Remove(int i);
+	void Clear() { arbiters.clear(); stamps.clear(); slots.clear(); mask = 0; }
+
+	std::vector<Arbiter> arbiters;
+	// step in which the pair was last seen by the broad-phase
+	std::vector<unsigned int> stamps;
+
+private:
+	int FindSlot(const ArbiterKey& key) const;
+	unsigned int Home(const ArbiterKey& key) const;
+	void Rehash(int capacity);
+
+	// indices into arbiters, -1 for the empty slots
+	std::vector<int> slots;
+	unsigned int mask;
+};
+
+// Bodies connected by the contacts and joints. Static bodies do not connect the islands.
+// Ranges in World::islandBodies, World::islandArbiters and World::islandJoints
+struct Island
+{
+	int bodyBegin, bodyEnd;
+	int arbiterBegin, arbiterEnd;
+	int jointBegin, jointEnd;
+	bool awake;
+};
+
+// Runs proc(param, begin, end) over the ranges of [0..count) and returns when all of them are done
+typedef void (*ParallelForFunc)(void* context, void (*proc)(void* param, size_t begin, size_t end), void* param, size_t count);
+
+// Broad-phase proxy, the AABB of a body
+struct SapProxy
 {
-	return ( (a1.body1 < a2.body1) || (a1.body1 == a2.body1 && a1.body2 < a2.body2) );
-}
+	float minX, maxX, minY, maxY;
+	int body;
+};
 
 struct World
 {
-	World(Vec2 _gravity, int _iterations) : gravity(_gravity), iterations(_iterations) {}
+	World(Vec2 _gravity, int _iterations) : gravity(_gravity), iterations(_iterations), stamp(0), parallelFor(0), parallelContext(0) {}
 
 	inline void Add(Body* body) { bodies.push_back(body); }
 	inline void Add(Joint* joint) { joints.push_back(joint); }
-	inline void Clear() { bodies.clear(); joints.clear(); arbiters.clear(); }
+	inline void Clear() { bodies.clear(); joints.clear(); arbiters.Clear(); proxies.clear(); proxyBodies.clear(); }
 
+	// Sweep-and-prune along X. The proxies stay sorted between the steps, so the sort is nearly linear for coherent motion
 	void BroadPhase();
 	void Step(float dt);
 
+	// Islands are independent and are solved with parallelFor when it is set. The result does not depend on the number of threads
+	void BuildIslands();
+	void SolveIsland(int i, float dt, float inv_dt);
+
+	// Wakes every dynamic body, the setters changing the whole world call it
+	void WakeAll();
+	// Wakes the bodies touching or jointed to the body, call it before removing the body. Their islands wake up on the next step
+	void WakeTouching(const Body* body);
+
 	std::vector<Body*> bodies;
 	std::vector<Joint*> joints;
-	std::map<ArbiterKey, Arbiter> arbiters;
+	ArbiterTable arbiters;
+
+	// sorted by minX
+	std::vector<SapProxy> proxies;
+	// bodies the proxies were built for
+	std::vector<Body*> proxyBodies;
+
 	Vec2 gravity;
 	int iterations;
+	unsigned int stamp;
+
+	std::vector<Island> islands;
+	std::vector<int> islandBodies;
+	std::vector<int> islandArbiters;
+	std::vector<int> islandJoints;
+	// union-find parents, then the island of every body (-1 for the static ones)
+	std::vector<int> bodyIsland;
+
+	ParallelForFunc parallelFor;
+	void* parallelContext;
+
 	static bool accumulateImpulses;
 	static bool warmStarting;
 	static bool positionCorrection;
+	// off by default: a sleeping island is skipped until something awake touches it
+	static bool allowSleep;
 };
 
 #endif // BoxLite
@@ -1,10 +1,28 @@
 #include "Physics/BoxScene.h"
 
 #include "Renderer/Canvas.h"
+#include "Utils/JobSystem.h"
+#include "Environment.h"
 
 // for debug render colors
 #include "LColors.h"
 
+/// Islands of the World are solved by the engine's job system
+static void Box2DParallelFor(void* Context, void (*Proc)(void* Param, size_t Begin, size_t End), void* Param, size_t Count)
+{
+	clJobSystem* Jobs = reinterpret_cast<sEnvironment*>(Context)->Jobs;
+
+	if(Jobs) { Jobs->ParallelFor(Proc, Param, 0, Count, 1); } else { Proc(Param, 0, Count); }
+}
+
+void Box2DScene::AfterConstruction()
+{
+	FWorld = new World(Vec2(0, 0), 10);
+
+	FWorld->parallelFor     = &Box2DParallelFor;
+	FWorld->parallelContext = Env;
+}
+
 Box2DBody* Box2DScene::AddGround(const vec2& Pos, float Angle, const vec2& Size, float Friction)
 {
 	Box2DBody* Ground = CreateBody( Size /*vec2(100.0f, 20.0f)*/, FLT_MAX, Friction /*0.2f*/);
@@ -144,9 +162,9 @@ void Box2DScene::RenderDebug(clCanvas* C)
 	for (size_t i = 0; i < FBodies.size(); ++i) { DrawBody(C, FBodies[i]->GetBody(), 0.0f, FBodies[i]->FColor); }
 	for (size_t i = 0; i < FJoints.size(); ++i) { DrawJoint(C, FJoints[i]->GetJoint(), FJoints[i]->FColor); }
 /*
-	for (std::map<ArbiterKey, Arbiter>::iterator i = FWorld->arbiters.begin() ; i != FWorld->arbiters.end() ; i++)
+	for (int i = 0; i < FWorld->arbiters.Size(); ++i)
 	{
-		DrawContact(C, &i->second, LC_White);
+		DrawContact(C, &FWorld->arbiters[i], LC_White);
 	}
 */
 }
@@ -33,32 +33,32 @@ public:
 	scriptmethod Body* GetBody() const { return FBody; }
 
 public:
-	scriptmethod void  SetPosition(const vec2& Pos) { FBody->position = Vec2(Pos.x, Pos.y); }
+	scriptmethod void  SetPosition(const vec2& Pos) { FBody->position = Vec2(Pos.x, Pos.y); FBody->SetAwake(true); }
 	scriptmethod vec2  GetPosition() const { return vec2(FBody->position.x, FBody->position.y); }
 
-	scriptmethod void  SetAngle(float A) { FBody->rotation = A; }
+	scriptmethod void  SetAngle(float A) { FBody->rotation = A; FBody->SetAwake(true); }
 	scriptmethod float GetAngle() const { return FBody->rotation; }
 
-	scriptmethod void  SetVelocity(const vec2& Vel) { FBody->velocity = Vec2(Vel.x, Vel.y); }
+	scriptmethod void  SetVelocity(const vec2& Vel) { FBody->SetAwake(true); FBody->velocity = Vec2(Vel.x, Vel.y); }
 	scriptmethod vec2  GetVelocity() const { return vec2(FBody->velocity.x, FBody->velocity.y); }
 
-	scriptmethod void  SetAngVelocity(float Vel) { FBody->angularVelocity = Vel; }
+	scriptmethod void  SetAngVelocity(float Vel) { FBody->SetAwake(true); FBody->angularVelocity = Vel; }
 	scriptmethod float GetAngVelocity() const { return FBody->angularVelocity; }
 
-	scriptmethod void  SetForce(const vec2& F) { FBody->force = Vec2(F.x, F.y); }
+	scriptmethod void  SetForce(const vec2& F) { FBody->force = Vec2(F.x, F.y); FBody->SetAwake(true); }
 	scriptmethod vec2  GetForce() const { return vec2(FBody->force.x, FBody->force.y); }
 
-	scriptmethod void  SetTorque(float T) { FBody->torque = T; }
+	scriptmethod void  SetTorque(float T) { FBody->torque = T; FBody->SetAwake(true); }
 	scriptmethod float GetTorque() const { return FBody->torque; }
 
 	scriptmethod float GetFriction() const { return FBody->friction; }
 	scriptmethod void  SetFriction(float f) { FBody->friction = f; }
 
 	scriptmethod float GetMass() const { return FBody->mass; }
-	scriptmethod void  SetMass(float m) { FBody->Set(FBody->width, m); }
+	scriptmethod void  SetMass(float m) { FBody->Set(FBody->width, m); FBody->SetAwake(true); }
 
 	scriptmethod vec2  GetSize() const { return vec2(FBody->width.x, FBody->width.y); }
-	scriptmethod void  SetSize(const vec2& Sz) { FBody->Set(Vec2(Sz.x, Sz.y), FBody->mass); }
+	scriptmethod void  SetSize(const vec2& Sz) { FBody->Set(Vec2(Sz.x, Sz.y), FBody->mass); FBody->SetAwake(true); }
 
 	scriptmethod float GetI() const { return FBody->I; }
 
@@ -196,7 +196,7 @@ public:
 		delete FWorld;
 	}
 
-	virtual void AfterConstruction() { FWorld = new World(Vec2(0, 0), 10); }
+	virtual void AfterConstruction();
 
 #pragma region State update
 
@@ -232,7 +232,7 @@ public:
 	scriptmethod void SetIterations(int Iters) { FWorld->iterations = Iters; }
 	scriptmethod int  GetIterations() const { return FWorld->iterations; }
 
-	scriptmethod void SetGravity(const vec2& G) { FWorld->gravity = Vec2(G.x, G.y); }
+	scriptmethod void SetGravity(const vec2& G) { FWorld->gravity = Vec2(G.x, G.y); FWorld->WakeAll(); }
 	scriptmethod vec2 GetGravity() const { return vec2(FWorld->gravity.x, FWorld->gravity.y); }
 
 	/** Property(Name=TimeStep, Type=float, Getter=GetTimeStep, Setter=SetTimeStep) */
@@ -246,15 +246,20 @@ public:
 	/** Property(Category="Box2D Properties", Name=AccumulateImpulses, Type=bool, Getter=GetAccumulateImpulses, Setter=SetAccumulateImpulses) */
 	/** Property(Category="Box2D Properties", Name=PositionCorrection, Type=bool, Getter=GetPositionCorrection, Setter=SetPositionCorrection) */
 	/** Property(Category="Box2D Properties", Name=WarmStarting,       Type=bool, Getter=GetWarmStarting,       Setter=SetWarmStarting) */
+	/** Property(Category="Box2D Properties", Name=AllowSleep,         Type=bool, Getter=GetAllowSleep,         Setter=SetAllowSleep) */
 
 	scriptmethod bool GetWarmStarting() const { return FWorld->warmStarting; }
 	scriptmethod bool GetAccumulateImpulses() const { return FWorld->accumulateImpulses; }
 	scriptmethod bool GetPositionCorrection() const { return FWorld->positionCorrection; }
+	scriptmethod bool GetAllowSleep() const { return FWorld->allowSleep; }
 
 	scriptmethod void SetAccumulateImpulses(bool _AccImp) { FWorld->accumulateImpulses = _AccImp; }
 	scriptmethod void SetPositionCorrection(bool _PosCorr) { FWorld->positionCorrection = _PosCorr; }
 	scriptmethod void SetWarmStarting(bool _WarmSt) { FWorld->warmStarting = _WarmSt; }
 
+	/// Resting islands are not simulated until touched, off by default. The flag is shared by all the scenes
+	scriptmethod void SetAllowSleep(bool _Sleep) { FWorld->allowSleep = _Sleep; if(!_Sleep) { FWorld->WakeAll(); } }
+
 #pragma endregion
 
 #pragma region Factory methods
@@ -377,6 +382,8 @@ public:
 
 	scriptmethod void RemoveBody(size_t idx)
 	{
+		FWorld->WakeTouching(FWorld->bodies[idx]);
+
 		if(FBodies.size() - 1 != idx)
 		{
 			FBodies[idx] = FBodies[FBodies.size() - 1];
@@ -392,6 +399,8 @@ public:
 		std::vector<Box2DBody*>::iterator _i1 = FBodies.begin() + idx;
 		std::vector<Body*>::iterator _i2 = FWorld->bodies.begin() + idx;
 
+		FWorld->WakeTouching(*_i2);
+
 		FBodies.erase(_i1);
 		FWorld->bodies.erase(_i2);
 	}
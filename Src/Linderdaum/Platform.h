@@ -14,6 +14,9 @@
 
 #define L_ENABLE_OPENGL_TRACING				0
 
+/// collect per-opcode usage frequency and timing in the LinderScript VM
+#define L_VM_PROFILING							0
+
 #define L_AUDIO_USE_OPENAL						1
 
 #define L_AUDIO_USE_FMOD						0
@@ -181,6 +184,8 @@ typedef void*            Lhandle;
 #endif
 
 /*
+ * 17/10/2026
+     L_VM_PROFILING
  * 15/11/2010
      Merged with LTypes.h
  * 14/04/2009
@@ -18,6 +18,7 @@
 #include "Core/Logger.h"
 #include "Core/VFS/FileSystem.h"
 #include "Core/VFS/iOStream.h"
+#include "Images/Image.h"
 #include "Renderer/iRenderTarget.h"
 #include "Renderer/iTexture.h"
 #include "Renderer/iShaderProgram.h"
@@ -295,6 +296,8 @@ bool clRenderState::EndLoad()
 		GetShaderProgram()->BindConsoleVariable( FUniforms[i], Env->Console->GetVar( FUniforms[i] ) );
 	}
 
+	std::vector<iResource*> Images;
+
 	// 4. Create textures
 	for ( size_t i = 0 ; i != FImages.size() ; i++ )
 	{
@@ -362,16 +365,23 @@ bool clRenderState::EndLoad()
 
 			SetTexture( static_cast<int>( i ), Image->GetTexture(), false );
 
+			Images.push_back( Image );
+
 			CheckRendererError( "" );
 
 			Env->Logger->Log( L_NOTICE, "Texture loaded from file: " + TextureName );
 		}
 	}
 
+	// WaitLoad() on this render state waits for (and prioritizes) the textures
+	Env->Resources->AddLoadDependencies( this, Images );
+
 	return true;
 }
 
 /*
+ * 17/10/2026
+     Render state depends on the loading of its textures
  * 23/03/2011
      UpdateRenderStateMask()
  * 04/11/2010
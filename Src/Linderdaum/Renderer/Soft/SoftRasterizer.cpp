@@ -0,0 +1,497 @@
+/**
+ * \file SoftRasterizer.cpp
+ * \brief Tile-binned triangle rasterizer for the software rendering pipeline
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "SoftRasterizer.h"
+
+#include "Images/Bitmap.h"
+#include "Utils/JobSystem.h"
+#include "Math/LMath.h"
+
+#include <math.h>
+#include <algorithm>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#  define L_SOFT_RASTERIZER_SSE
+#  include <xmmintrin.h>
+#elif defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#  define L_SOFT_RASTERIZER_NEON
+#  include <arm_neon.h>
+#endif
+
+/// Number of interpolated values: Z, 1/W, U/W, V/W, R/W, G/W, B/W, A/W
+const int SOFT_NUM_PLANES = 8;
+
+/// Smallest W kept after the near plane clipping
+const float SOFT_MIN_W = 1e-5f;
+
+namespace
+{
+	void RasterizeTilesProc( void* Param, size_t Begin, size_t End )
+	{
+		clSoftRasterizer* Rasterizer = reinterpret_cast<clSoftRasterizer*>( Param );
+
+		for ( size_t i = Begin; i != End; i++ ) { Rasterizer->RasterizeTile( static_cast<int>( i ) ); }
+	}
+}
+
+clSoftRasterizer::clSoftRasterizer()
+	: FTarget( NULL ),
+	  FTargetWidth( 0 ),
+	  FTargetHeight( 0 ),
+	  FDepthBuffer(),
+	  FViewportX( 0 ),
+	  FViewportY( 0 ),
+	  FViewportWidth( 0 ),
+	  FViewportHeight( 0 ),
+	  FTexture( NULL ),
+	  FDepthTest( true ),
+	  FDepthWrite( true ),
+	  FTilesX( 0 ),
+	  FTilesY( 0 ),
+	  FTriangles(),
+	  FBins(),
+	  FJobs( NULL )
+{
+}
+
+clSoftRasterizer::~clSoftRasterizer()
+{
+}
+
+void clSoftRasterizer::SetTarget( clBitmap* ColorTarget )
+{
+	Flush();
+
+	FTarget       = ColorTarget;
+	FTargetWidth  = ColorTarget ? ColorTarget->GetWidth()  : 0;
+	FTargetHeight = ColorTarget ? ColorTarget->GetHeight() : 0;
+
+	FDepthBuffer.assign( FTargetWidth * FTargetHeight + 4, 1.0f );
+
+	FTilesX = ( FTargetWidth  + L_SOFT_TILE_SIZE - 1 ) / L_SOFT_TILE_SIZE;
+	FTilesY = ( FTargetHeight + L_SOFT_TILE_SIZE - 1 ) / L_SOFT_TILE_SIZE;
+
+	FBins.clear();
+	FBins.resize( FTilesX * FTilesY );
+
+	SetViewport( 0, 0, FTargetWidth, FTargetHeight );
+}
+
+void clSoftRasterizer::SetViewport( int X, int Y, int Width, int Height )
+{
+	FViewportX      = X;
+	FViewportY      = Y;
+	FViewportWidth  = Width;
+	FViewportHeight = Height;
+}
+
+void clSoftRasterizer::SetTexture( const clBitmap* Texture )
+{
+	FTexture = Texture;
+}
+
+void clSoftRasterizer::ClearColor( const LVector4& Color )
+{
+	Flush();
+
+	if ( FTarget ) { FTarget->Clear( Color ); }
+}
+
+void clSoftRasterizer::ClearDepth( float Depth )
+{
+	Flush();
+
+	std::fill( FDepthBuffer.begin(), FDepthBuffer.end(), Depth );
+}
+
+namespace
+{
+	/// Distance to the near plane in the clip space, Z >= -W
+	inline float NearDistance( const sSoftVertex& V )
+	{
+		return V.FPosition.Z + V.FPosition.W;
+	}
+
+	inline sSoftVertex LerpVertex( const sSoftVertex& A, const sSoftVertex& B, float T )
+	{
+		sSoftVertex V;
+
+		V.FPosition = A.FPosition + ( B.FPosition - A.FPosition ) * T;
+		V.FTexCoord = A.FTexCoord + ( B.FTexCoord - A.FTexCoord ) * T;
+		V.FColor    = A.FColor    + ( B.FColor    - A.FColor    ) * T;
+
+		return V;
+	}
+}
+
+void clSoftRasterizer::AddTriangle( const sSoftVertex& V1, const sSoftVertex& V2, const sSoftVertex& V3 )
+{
+	if ( !FTarget ) { return; }
+
+	const sSoftVertex* In[3] = { &V1, &V2, &V3 };
+
+	bool AllInside = true;
+
+	for ( int i = 0; i != 3; i++ )
+	{
+		if ( NearDistance( *In[i] ) < 0.0f || In[i]->FPosition.W < SOFT_MIN_W ) { AllInside = false; }
+	}
+
+	if ( AllInside )
+	{
+		SetupTriangle( V1, V2, V3 );
+		return;
+	}
+
+	// clip against the near plane, a triangle becomes at most a quad
+	sSoftVertex Out[4];
+	int         NumOut = 0;
+
+	for ( int i = 0; i != 3; i++ )
+	{
+		const sSoftVertex& A = *In[i];
+		const sSoftVertex& B = *In[( i + 1 ) % 3];
+
+		float DA = NearDistance( A );
+		float DB = NearDistance( B );
+
+		if ( DA >= 0.0f ) { Out[ NumOut++ ] = A; }
+
+		if ( ( DA >= 0.0f ) != ( DB >= 0.0f ) ) { Out[ NumOut++ ] = LerpVertex( A, B, DA / ( DA - DB ) ); }
+	}
+
+	for ( int i = 0; i < NumOut; i++ )
+	{
+		if ( Out[i].FPosition.W < SOFT_MIN_W ) { return; }
+	}
+
+	for ( int i = 2; i < NumOut; i++ )
+	{
+		SetupTriangle( Out[0], Out[i - 1], Out[i] );
+	}
+}
+
+void clSoftRasterizer::SetupTriangle( const sSoftVertex& V1, const sSoftVertex& V2, const sSoftVertex& V3 )
+{
+	const sSoftVertex* V[3] = { &V1, &V2, &V3 };
+
+	float SX[3], SY[3];
+	float Values[ SOFT_NUM_PLANES ][3];
+
+	for ( int i = 0; i != 3; i++ )
+	{
+		const LVector4& P = V[i]->FPosition;
+
+		float InvW = 1.0f / P.W;
+
+		SX[i] = FViewportX + ( P.X * InvW + 1.0f ) * 0.5f * FViewportWidth;
+		SY[i] = FViewportY + ( P.Y * InvW + 1.0f ) * 0.5f * FViewportHeight;
+
+		Values[0][i] = ( P.Z * InvW ) * 0.5f + 0.5f;
+		Values[1][i] = InvW;
+		Values[2][i] = V[i]->FTexCoord.X * InvW;
+		Values[3][i] = V[i]->FTexCoord.Y * InvW;
+		Values[4][i] = V[i]->FColor.X * InvW;
+		Values[5][i] = V[i]->FColor.Y * InvW;
+		Values[6][i] = V[i]->FColor.Z * InvW;
+		Values[7][i] = V[i]->FColor.W * InvW;
+	}
+
+	sSoftTriangle Tri;
+
+	// edge k is opposite to the vertex k
+	for ( int k = 0; k != 3; k++ )
+	{
+		int a = ( k + 1 ) % 3;
+		int b = ( k + 2 ) % 3;
+
+		Tri.FEdgeA[k] = SY[a] - SY[b];
+		Tri.FEdgeB[k] = SX[b] - SX[a];
+		Tri.FEdgeC[k] = SX[a] * SY[b] - SY[a] * SX[b];
+	}
+
+	float Area = Tri.FEdgeA[0] * SX[0] + Tri.FEdgeB[0] * SY[0] + Tri.FEdgeC[0];
+
+	if ( Area == 0.0f ) { return; }
+
+	// no face culling, flip the clockwise triangles to keep the inside positive
+	if ( Area < 0.0f )
+	{
+		for ( int k = 0; k != 3; k++ )
+		{
+			Tri.FEdgeA[k] = -Tri.FEdgeA[k];
+			Tri.FEdgeB[k] = -Tri.FEdgeB[k];
+			Tri.FEdgeC[k] = -Tri.FEdgeC[k];
+		}
+
+		Area = -Area;
+	}
+
+	for ( int k = 0; k != 3; k++ )
+	{
+		// a shared edge has opposite normals in the two triangles, exactly one of them owns the pixels on it
+		Tri.FTopLeft[k] = ( Tri.FEdgeA[k] > 0.0f ) || ( Tri.FEdgeA[k] == 0.0f && Tri.FEdgeB[k] > 0.0f );
+	}
+
+	float InvArea = 1.0f / Area;
+
+	for ( int p = 0; p != SOFT_NUM_PLANES; p++ )
+	{
+		Tri.FPlaneDX[p] = ( Values[p][0] * Tri.FEdgeA[0] + Values[p][1] * Tri.FEdgeA[1] + Values[p][2] * Tri.FEdgeA[2] ) * InvArea;
+		Tri.FPlaneDY[p] = ( Values[p][0] * Tri.FEdgeB[0] + Values[p][1] * Tri.FEdgeB[1] + Values[p][2] * Tri.FEdgeB[2] ) * InvArea;
+		Tri.FPlaneC[p]  = ( Values[p][0] * Tri.FEdgeC[0] + Values[p][1] * Tri.FEdgeC[1] + Values[p][2] * Tri.FEdgeC[2] ) * InvArea;
+	}
+
+	float MinX = Linderdaum::Math::LMin( SX[0], Linderdaum::Math::LMin( SX[1], SX[2] ) );
+	float MinY = Linderdaum::Math::LMin( SY[0], Linderdaum::Math::LMin( SY[1], SY[2] ) );
+	float MaxX = Linderdaum::Math::LMax( SX[0], Linderdaum::Math::LMax( SX[1], SX[2] ) );
+	float MaxY = Linderdaum::Math::LMax( SY[0], Linderdaum::Math::LMax( SY[1], SY[2] ) );
+
+	int ClipX0 = std::max( FViewportX, 0 );
+	int ClipY0 = std::max( FViewportY, 0 );
+	int ClipX1 = std::min( FViewportX + FViewportWidth,  FTargetWidth  ) - 1;
+	int ClipY1 = std::min( FViewportY + FViewportHeight, FTargetHeight ) - 1;
+
+	// reject before the float to int conversion can overflow
+	if ( MaxX < ClipX0 || MaxY < ClipY0 || MinX > ClipX1 + 1 || MinY > ClipY1 + 1 ) { return; }
+
+	Tri.FMinX = std::max( static_cast<int>( floorf( Linderdaum::Math::LMax( MinX, static_cast<float>( ClipX0 ) ) ) ), ClipX0 );
+	Tri.FMinY = std::max( static_cast<int>( floorf( Linderdaum::Math::LMax( MinY, static_cast<float>( ClipY0 ) ) ) ), ClipY0 );
+	Tri.FMaxX = std::min( static_cast<int>( floorf( Linderdaum::Math::LMin( MaxX, static_cast<float>( ClipX1 ) ) ) ), ClipX1 );
+	Tri.FMaxY = std::min( static_cast<int>( floorf( Linderdaum::Math::LMin( MaxY, static_cast<float>( ClipY1 ) ) ) ), ClipY1 );
+
+	if ( Tri.FMinX > Tri.FMaxX || Tri.FMinY > Tri.FMaxY ) { return; }
+
+	Tri.FTexture    = FTexture;
+	Tri.FDepthTest  = FDepthTest;
+	Tri.FDepthWrite = FDepthWrite;
+
+	int Index = static_cast<int>( FTriangles.size() );
+
+	FTriangles.push_back( Tri );
+
+	// bin by the bounding rectangle
+	for ( int TY = Tri.FMinY / L_SOFT_TILE_SIZE; TY <= Tri.FMaxY / L_SOFT_TILE_SIZE; TY++ )
+	{
+		for ( int TX = Tri.FMinX / L_SOFT_TILE_SIZE; TX <= Tri.FMaxX / L_SOFT_TILE_SIZE; TX++ )
+		{
+			FBins[ TY * FTilesX + TX ].push_back( Index );
+		}
+	}
+}
+
+void clSoftRasterizer::Flush()
+{
+	if ( FTriangles.empty() ) { return; }
+
+	int NumTiles = FTilesX * FTilesY;
+
+	if ( FJobs )
+	{
+		FJobs->ParallelFor( &RasterizeTilesProc, this, 0, NumTiles, 1 );
+	}
+	else
+	{
+		RasterizeTilesProc( this, 0, NumTiles );
+	}
+
+	FTriangles.clear();
+
+	for ( size_t i = 0; i != FBins.size(); i++ ) { FBins[i].clear(); }
+}
+
+void clSoftRasterizer::RasterizeTile( int Tile )
+{
+	const std::vector<int>& Bin = FBins[ Tile ];
+
+	if ( Bin.empty() ) { return; }
+
+	int X0 = ( Tile % FTilesX ) * L_SOFT_TILE_SIZE;
+	int Y0 = ( Tile / FTilesX ) * L_SOFT_TILE_SIZE;
+	int X1 = std::min( X0 + L_SOFT_TILE_SIZE, FTargetWidth  ) - 1;
+	int Y1 = std::min( Y0 + L_SOFT_TILE_SIZE, FTargetHeight ) - 1;
+
+	for ( size_t i = 0; i != Bin.size(); i++ )
+	{
+		const sSoftTriangle& Tri = FTriangles[ Bin[i] ];
+
+		RasterizeTriangle( Tri,
+		                   std::max( X0, Tri.FMinX ), std::max( Y0, Tri.FMinY ),
+		                   std::min( X1, Tri.FMaxX ), std::min( Y1, Tri.FMaxY ) );
+	}
+}
+
+namespace
+{
+	/// Coverage of the 4 pixel centers X + 0.5 .. X + 3.5 in the row with the center CY, bit i is set for the covered pixel X + i
+	inline int CoverageMask4( const float* EdgeA, const float* EdgeB, const float* EdgeC, const bool* TopLeft, float X, float CY )
+	{
+#if defined( L_SOFT_RASTERIZER_SSE )
+		const __m128 PX   = _mm_add_ps( _mm_set1_ps( X ), _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f ) );
+		const __m128 Zero = _mm_setzero_ps();
+
+		__m128 Inside = _mm_cmpeq_ps( Zero, Zero );
+
+		for ( int k = 0; k != 3; k++ )
+		{
+			__m128 E = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( EdgeA[k] ), PX ), _mm_set1_ps( EdgeB[k] * CY + EdgeC[k] ) );
+
+			__m128 In = TopLeft[k] ? _mm_cmpge_ps( E, Zero ) : _mm_cmpgt_ps( E, Zero );
+
+			Inside = _mm_and_ps( Inside, In );
+		}
+
+		return _mm_movemask_ps( Inside );
+#elif defined( L_SOFT_RASTERIZER_NEON )
+		static const float Offsets[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+
+		const float32x4_t PX   = vaddq_f32( vdupq_n_f32( X ), vld1q_f32( Offsets ) );
+		const float32x4_t Zero = vdupq_n_f32( 0.0f );
+
+		uint32x4_t Inside = vdupq_n_u32( 0xFFFFFFFF );
+
+		for ( int k = 0; k != 3; k++ )
+		{
+			float32x4_t E = vaddq_f32( vmulq_f32( vdupq_n_f32( EdgeA[k] ), PX ), vdupq_n_f32( EdgeB[k] * CY + EdgeC[k] ) );
+
+			uint32x4_t In = TopLeft[k] ? vcgeq_f32( E, Zero ) : vcgtq_f32( E, Zero );
+
+			Inside = vandq_u32( Inside, In );
+		}
+
+		return ( vgetq_lane_u32( Inside, 0 ) ? 1 : 0 ) | ( vgetq_lane_u32( Inside, 1 ) ? 2 : 0 ) |
+		       ( vgetq_lane_u32( Inside, 2 ) ? 4 : 0 ) | ( vgetq_lane_u32( Inside, 3 ) ? 8 : 0 );
+#else
+		int Mask = 0;
+
+		for ( int i = 0; i != 4; i++ )
+		{
+			float PX = X + static_cast<float>( i ) + 0.5f;
+
+			bool In = true;
+
+			for ( int k = 0; k != 3; k++ )
+			{
+				float E = EdgeA[k] * PX + ( EdgeB[k] * CY + EdgeC[k] );
+
+				In = In && ( TopLeft[k] ? ( E >= 0.0f ) : ( E > 0.0f ) );
+			}
+
+			if ( In ) { Mask |= 1 << i; }
+		}
+
+		return Mask;
+#endif
+	}
+
+	/// Nearest sample with wrapping
+	inline LVector4 SampleTexture( const clBitmap* Texture, float U, float V )
+	{
+		int W = Texture->GetWidth();
+		int H = Texture->GetHeight();
+
+		int TX = static_cast<int>( ( U - floorf( U ) ) * W );
+		int TY = static_cast<int>( ( V - floorf( V ) ) * H );
+
+		TX = Linderdaum::Math::Clamp( TX, 0, W - 1 );
+		TY = Linderdaum::Math::Clamp( TY, 0, H - 1 );
+
+		LBitmapFormat Format = Texture->GetBitmapFormat();
+
+		if ( Format == L_BITMAP_BGR8 || Format == L_BITMAP_BGRA8 )
+		{
+			const Lubyte* Texel = Texture->FBitmapData + Texture->PixelOffset( TX, TY, 0 );
+
+			const float Scale = 1.0f / 255.0f;
+
+			return LVector4( Texel[2] * Scale, Texel[1] * Scale, Texel[0] * Scale, ( Format == L_BITMAP_BGRA8 ) ? Texel[3] * Scale : 1.0f );
+		}
+
+		return Texture->GetPixel( TX, TY, 0 );
+	}
+}
+
+void clSoftRasterizer::RasterizeTriangle( const sSoftTriangle& Tri, int X0, int Y0, int X1, int Y1 )
+{
+	for ( int Y = Y0; Y <= Y1; Y++ )
+	{
+		float CY = static_cast<float>( Y ) + 0.5f;
+
+		float* DepthRow = &FDepthBuffer[ Y * FTargetWidth ];
+
+		for ( int X = X0; X <= X1; X += 4 )
+		{
+			int Mask = CoverageMask4( Tri.FEdgeA, Tri.FEdgeB, Tri.FEdgeC, Tri.FTopLeft, static_cast<float>( X ), CY );
+
+			// drop the lanes past the right border
+			if ( X1 - X < 3 ) { Mask &= ( 1 << ( X1 - X + 1 ) ) - 1; }
+
+			if ( !Mask ) { continue; }
+
+			for ( int i = 0; i != 4; i++ )
+			{
+				if ( !( Mask & ( 1 << i ) ) ) { continue; }
+
+				float CX = static_cast<float>( X + i ) + 0.5f;
+
+				float Z = Tri.FPlaneDX[0] * CX + Tri.FPlaneDY[0] * CY + Tri.FPlaneC[0];
+
+				if ( Tri.FDepthTest && !( Z < DepthRow[ X + i ] ) ) { continue; }
+
+				if ( Tri.FDepthWrite ) { DepthRow[ X + i ] = Z; }
+
+				float Values[ SOFT_NUM_PLANES ];
+
+				for ( int p = 1; p != SOFT_NUM_PLANES; p++ )
+				{
+					Values[p] = Tri.FPlaneDX[p] * CX + Tri.FPlaneDY[p] * CY + Tri.FPlaneC[p];
+				}
+
+				// perspective correction
+				float W = 1.0f / Values[1];
+
+				LVector4 Color( Values[4] * W, Values[5] * W, Values[6] * W, Values[7] * W );
+
+				if ( Tri.FTexture )
+				{
+					LVector4 Texel = SampleTexture( Tri.FTexture, Values[2] * W, Values[3] * W );
+
+					Color = LVector4( Color.X * Texel.X, Color.Y * Texel.Y, Color.Z * Texel.Z, Color.W * Texel.W );
+				}
+
+				WritePixel( X + i, Y, Color );
+			}
+		}
+	}
+}
+
+void clSoftRasterizer::WritePixel( int X, int Y, const LVector4& Color )
+{
+	LBitmapFormat Format = FTarget->GetBitmapFormat();
+
+	if ( Format == L_BITMAP_BGR8 || Format == L_BITMAP_BGRA8 )
+	{
+		Lubyte* Pixel = FTarget->FBitmapData + FTarget->PixelOffset( X, Y, 0 );
+
+		Pixel[0] = static_cast<Lubyte>( Linderdaum::Math::Clamp( Color.Z, 0.0f, 1.0f ) * 255.0f );
+		Pixel[1] = static_cast<Lubyte>( Linderdaum::Math::Clamp( Color.Y, 0.0f, 1.0f ) * 255.0f );
+		Pixel[2] = static_cast<Lubyte>( Linderdaum::Math::Clamp( Color.X, 0.0f, 1.0f ) * 255.0f );
+
+		if ( Format == L_BITMAP_BGRA8 ) { Pixel[3] = static_cast<Lubyte>( Linderdaum::Math::Clamp( Color.W, 0.0f, 1.0f ) * 255.0f ); }
+
+		return;
+	}
+
+	FTarget->SetPixel( X, Y, 0, Color );
+}
+
+/*
+ * 17/10/2026
+     Tiles are distributed through clJobSystem instead of the own threads
+     It's here
+*/
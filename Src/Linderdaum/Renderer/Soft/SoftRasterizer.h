@@ -0,0 +1,132 @@
+/**
+ * \file SoftRasterizer.h
+ * \brief Tile-binned triangle rasterizer for the software rendering pipeline
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _clSoftRasterizer_
+#define _clSoftRasterizer_
+
+#include "Platform.h"
+#include "Math/LVector.h"
+
+#include <vector>
+
+class clBitmap;
+class clJobSystem;
+
+/// Size of the screen tiles in pixels
+const int L_SOFT_TILE_SIZE = 64;
+
+/// Vertex in the clip space
+struct sSoftVertex
+{
+	LVector4    FPosition;
+	LVector2    FTexCoord;
+	LVector4    FColor;
+};
+
+/**
+   \brief Software rasterizer
+
+   Triangles are clipped, set up and binned into screen tiles by AddTriangle(). Flush() rasterizes the tiles,
+   tiles are independent and are distributed among the job system workers. Every tile processes its triangles
+   in the submission order, so the result does not depend on the number of threads.
+
+   Attributes are interpolated with the perspective correction, the depth test is LESS. The color target
+   should be L_BITMAP_BGR8 or L_BITMAP_BGRA8 for the fast path, other formats go through clBitmap::SetPixel().
+**/
+class clSoftRasterizer
+{
+public:
+	clSoftRasterizer();
+	~clSoftRasterizer();
+
+	/// Rasterize the tiles in parallel using Jobs, NULL rasterizes on the calling thread only
+	void    SetJobSystem( clJobSystem* Jobs ) { FJobs = Jobs; }
+
+	/// Attach the color target and reallocate the depth buffer
+	void    SetTarget( clBitmap* ColorTarget );
+	void    SetViewport( int X, int Y, int Width, int Height );
+
+	/// Texture for the following triangles, NULL for untextured. The bitmap should stay alive until Flush()
+	void    SetTexture( const clBitmap* Texture );
+
+	/// Depth state for the following triangles, the triangles added before keep their own state
+	void    SetDepthTest( bool DepthTest ) { FDepthTest = DepthTest; }
+	void    SetDepthWrite( bool DepthWrite ) { FDepthWrite = DepthWrite; }
+
+	/// Rasterize the pending triangles before clearing
+	void    ClearColor( const LVector4& Color );
+	void    ClearDepth( float Depth );
+
+	/// Clip and bin the triangle
+	void    AddTriangle( const sSoftVertex& V1, const sSoftVertex& V2, const sSoftVertex& V3 );
+
+	/// Rasterize all the binned triangles into the target
+	void    Flush();
+
+	inline size_t GetNumPendingTriangles() const { return FTriangles.size(); }
+	inline float  GetDepth( int X, int Y ) const { return FDepthBuffer[ Y * FTargetWidth + X ]; }
+
+	/// Rasterize the triangles binned to the tile, tiles can be processed concurrently
+	void    RasterizeTile( int Tile );
+private:
+	/// Triangle ready for the rasterization: edge functions and interpolation planes in the screen space
+	struct sSoftTriangle
+	{
+		/// edge functions A*x + B*y + C, positive inside
+		float     FEdgeA[3];
+		float     FEdgeB[3];
+		float     FEdgeC[3];
+		/// edges which own the pixels exactly on them
+		bool      FTopLeft[3];
+		/// planes of Z, 1/W, U/W, V/W, R/W, G/W, B/W, A/W
+		float     FPlaneDX[8];
+		float     FPlaneDY[8];
+		float     FPlaneC[8];
+		/// bounding rectangle in pixels, inclusive
+		int       FMinX, FMinY, FMaxX, FMaxY;
+		/// state at the time of AddTriangle()
+		const clBitmap* FTexture;
+		bool      FDepthTest;
+		bool      FDepthWrite;
+	};
+
+	void    SetupTriangle( const sSoftVertex& V1, const sSoftVertex& V2, const sSoftVertex& V3 );
+	void    RasterizeTriangle( const sSoftTriangle& Tri, int X0, int Y0, int X1, int Y1 );
+	void    WritePixel( int X, int Y, const LVector4& Color );
+private:
+	clBitmap*                     FTarget;
+	int                           FTargetWidth;
+	int                           FTargetHeight;
+	/// row-major depth, padded for the 4-wide loads at the end of the last row
+	std::vector<float>            FDepthBuffer;
+
+	int                           FViewportX;
+	int                           FViewportY;
+	int                           FViewportWidth;
+	int                           FViewportHeight;
+
+	const clBitmap*               FTexture;
+	bool                          FDepthTest;
+	bool                          FDepthWrite;
+
+	int                           FTilesX;
+	int                           FTilesY;
+	std::vector<sSoftTriangle>    FTriangles;
+	/// indices of the triangles overlapping every tile
+	std::vector< std::vector<int> > FBins;
+
+	clJobSystem*                  FJobs;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     SetJobSystem() replaces SetNumThreads()
+     It's here
+*/
@@ -10,6 +10,8 @@
 #include "Environment.h"
 
 #include "SoftRenderContext.h"
+#include "SoftRasterizer.h"
+#include "SoftTexture.h"
 
 #include "Utils/Viewport.h"
 #include "Images/Bitmap.h"
@@ -22,7 +24,9 @@
 #include <string.h>
 
 
-clSoftRenderContext::clSoftRenderContext()//:FViewport(NULL),
+clSoftRenderContext::clSoftRenderContext(): FFrameBuffer( NULL ),
+	FRasterizer( NULL )
+	//:FViewport(NULL),
 //FInsideFrame(false)
 //                            ,
 //                                       FCurrentViewportWidth(0),
@@ -52,6 +56,10 @@ bool clSoftRenderContext::InitContext( clViewport* Viewport,
 
 	FFrameBuffer = clBitmap::CreateBitmap( Env, W, H, 1, L_BITMAP_BGR8, L_TEXTURE_2D );
 
+	FRasterizer = new clSoftRasterizer();
+	FRasterizer->SetTarget( FFrameBuffer );
+	FRasterizer->SetJobSystem( Env->Jobs );
+
 	FX = 0.0f;
 	FY = 0.0f;
 	FWidth = static_cast<float>( W );
@@ -70,6 +78,8 @@ bool clSoftRenderContext::InitContext( clViewport* Viewport,
 
 clSoftRenderContext::~clSoftRenderContext()
 {
+	delete( FRasterizer );
+	delete( FFrameBuffer );
 }
 
 void clSoftRenderContext::SetPolygonFillMode( bool Fill )
@@ -103,31 +113,37 @@ int clSoftRenderContext::GetScreenshotSize() const
 
 void clSoftRenderContext::GetScreenshot( void* Ptr ) const
 {
-//   int Width = FViewport->GetWidth();
-//   int Height = FViewport->GetHeight();
+	FRasterizer->Flush();
 
-//   glReadPixels( 0, 0, Width, Height, GL_BGR, GL_UNSIGNED_BYTE, Ptr );
+	memcpy( Ptr, FFrameBuffer->FBitmapData, GetScreenshotSize() );
 }
 
 Luint clSoftRenderContext::GetPixel( const LVector2& Pnt ) const
 {
-	TODO( "read from image" )
+	FRasterizer->Flush();
 
-//   Lint X = static_cast<Lint>( Pnt.X        * FCurrentViewportWidth );
-//   Lint Y = static_cast<Lint>( (1.0f-Pnt.Y) * FCurrentViewportHeight );
+	int W = FFrameBuffer->GetWidth();
+	int H = FFrameBuffer->GetHeight();
 
-	Luint C = 0;
+	int X = Math::Clamp( static_cast<int>( Pnt.X * W ), 0, W - 1 );
+	int Y = Math::Clamp( static_cast<int>( ( 1.0f - Pnt.Y ) * H ), 0, H - 1 );
 
-//   glReadPixels(X, Y, 1, 1, GL_RGB, GL_UNSIGNED_BYTE, &C);
+	// same layout as glReadPixels() with GL_RGB
+	const Lubyte* P = FFrameBuffer->FBitmapData + FFrameBuffer->PixelOffset( X, Y, 0 );
 
-	return C;
+	return static_cast<Luint>( P[2] ) | ( static_cast<Luint>( P[1] ) << 8 ) | ( static_cast<Luint>( P[0] ) << 16 );
 }
 
 void clSoftRenderContext::ClearRenderTarget( bool Color, bool Depth, bool Stencil )
 {
 	if ( Color )
 	{
-		FFrameBuffer->Clear( FClearColor );
+		FRasterizer->ClearColor( FClearColor );
+	}
+
+	if ( Depth )
+	{
+		FRasterizer->ClearDepth( 1.0f );
 	}
 }
 
@@ -157,9 +173,19 @@ void clSoftRenderContext::AddBuffer( iVertexArray* VertexArray,
 	LMatrix4 FProjection = Matrices->in_ProjectionMatrix;
 	LMatrix4 FTransform  = Matrices->in_ModelViewMatrix;
 
-	// we do not use any shaders yet - just render the wireframe
+	// we do not use any shaders yet - just render the wireframe or the textured triangles
 	clVertexAttribs* VB = VertexArray->GetVertexAttribs();
 
+	if ( !Wireframe )
+	{
+		AddTriangles( VB, Shader, FProjection * FTransform );
+
+		return;
+	}
+
+	// the lines are drawn immediately, finish the filled triangles first
+	FRasterizer->Flush();
+
 	LVector3 V[3], VV[3];
 	LVector4 V4[3], PV[3];
 
@@ -214,6 +240,37 @@ void clSoftRenderContext::AddBuffer( iVertexArray* VertexArray,
 	}
 }
 
+void clSoftRenderContext::AddTriangles( const clVertexAttribs* VB, clRenderState* Shader, const LMatrix4& MVP )
+{
+	clSoftTexture* Texture = dynamic_cast<clSoftTexture*>( Shader->GetTextureForTextureUnit( 0 ) );
+
+	FRasterizer->SetTexture( Texture ? Texture->GetBitmap() : NULL );
+	FRasterizer->SetDepthTest( true );
+	FRasterizer->SetDepthWrite( true );
+
+	int Mult = ( VB->FPrimitiveType == L_PT_TRIANGLE_STRIP ) ? 2 : 3;
+
+	const LVector3* Vertices  = VB->FVertices.GetPtr();
+	const LVector4* TexCoords = VB->FTexCoords.size() == VB->FVertices.size() ? VB->FTexCoords.GetPtr() : NULL;
+	const LVector4* Colors    = VB->FColors.size()    == VB->FVertices.size() ? VB->FColors.GetPtr()    : NULL;
+
+	sSoftVertex SV[3];
+
+	for ( int i = 0; i < VB->GetNumTriangles(); i++ )
+	{
+		for ( int j = 0 ; j < 3 ; j++ )
+		{
+			size_t Idx = i * Mult + j;
+
+			SV[j].FPosition = MVP * LVector4( Vertices[Idx], 1.0f );
+			SV[j].FTexCoord = TexCoords ? TexCoords[Idx].ToVector2() : LVector2( 0.0f );
+			SV[j].FColor    = Colors ? Colors[Idx] : LC_White;
+		}
+
+		FRasterizer->AddTriangle( SV[0], SV[1], SV[2] );
+	}
+}
+
 void clSoftRenderContext::SetClearColor4v( const LVector4& Color ) const
 {
 	FClearColor = Color;
@@ -239,10 +296,14 @@ void clSoftRenderContext::EndFrame( bool SwapBuffer )
 {
 	iRenderContext::EndFrame( false );
 
+	FRasterizer->Flush();
+
 	Env->Viewport->BlitBitmap( static_cast<int>( FX ), static_cast<int>( FY ), FFrameBuffer );
 }
 
 /*
+ * 17/10/2026
+     Filled triangles are rendered by clSoftRasterizer
  * 10/06/2010
      First version
 */
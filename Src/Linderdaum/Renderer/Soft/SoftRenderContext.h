@@ -20,6 +20,8 @@
 class iVertexArray;
 class clViewport;
 class clBitmap;
+class clVertexAttribs;
+class clSoftRasterizer;
 
 /// Abstract render context representation
 class scriptfinal clSoftRenderContext: public iRenderContext
@@ -65,6 +67,9 @@ public:
 private:
 	LVector3    ToViewport( const LVector3& Pt );
 
+	/// Transform the triangles and pass them to FRasterizer
+	void        AddTriangles( const clVertexAttribs* VB, clRenderState* Shader, const LMatrix4& MVP );
+
 	clViewport*        FViewport;
 
 	float    FX;
@@ -75,12 +80,17 @@ private:
 	TODO( "replace by SoftFrameBuffer instance" )
 	clBitmap*    FFrameBuffer;
 
+	/// Filled triangles go here, wireframe is drawn directly into FFrameBuffer
+	clSoftRasterizer*    FRasterizer;
+
 	mutable LVector4    FClearColor;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     clSoftRasterizer
  * 10/06/2010
      Initial version
 */
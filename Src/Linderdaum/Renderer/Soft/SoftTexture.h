@@ -13,32 +13,49 @@
 #include "Renderer/iTexture.h"
 #include "Core/VFS/iIStream.h"
 #include "Core/VFS/iOStream.h"
+#include "Images/Bitmap.h"
+#include "Images/Image.h"
 
+/// Software texture, keeps a copy of the bitmap for clSoftRasterizer
 class scriptfinal clSoftTexture: public iTexture
 {
 public:
-	clSoftTexture() {}
-	virtual ~clSoftTexture() {}
+	clSoftTexture(): FBitmap( NULL ) {}
+	virtual ~clSoftTexture() { delete( FBitmap ); }
 	//
 	// iTexture interface
 	//
-	virtual void    Bind( int TextureUnit ) const {}
-	virtual void    SaveToBitmap( clBitmap* Bitmap ) const {}
+	virtual void    Bind( int /*TextureUnit*/ ) const {}
+	virtual void    SaveToBitmap( clBitmap* /*Bitmap*/ ) const {}
 	virtual sBitmapParams GetBitmapFormat() const { return sBitmapParams( NULL ); };
-	virtual void    LoadFromBitmap( clBitmap* Bitmap ) {}
-	virtual void    UpdateSubImageFromBitmap( clBitmap* Bitmap, int X, int Y, int MIPLevel ) {};
-	virtual void    SetImage( clImage* TheImage ) {}
-	virtual void    CommitChanges() {}
-	virtual void    SetMipMapping( const LMipMapping MinFilter, const LMipMapping MagFilter ) {}
-	virtual void    SetClamping( const LClamping Clamping ) {}
+	virtual void    LoadFromBitmap( clBitmap* Bitmap )
+	{
+		delete( FBitmap );
+
+		FBitmap = Bitmap ? Bitmap->MakeCopy() : NULL;
+	}
+	virtual void    UpdateSubImageFromBitmap( clBitmap* /*Bitmap*/, int /*X*/, int /*Y*/, int /*MIPLevel*/ ) {};
+	virtual void    CommitChanges()
+	{
+		if ( GetImage() ) { LoadFromBitmap( GetImage()->GetCurrentBitmap() ); }
+	}
+	virtual void    SetMipMapping( const LMipMapping /*MinFilter*/, const LMipMapping /*MagFilter*/ ) {}
+	virtual void    SetClamping( const LClamping /*Clamping*/ ) {}
 	virtual void    UpdateMipmaps() {}
-	virtual void    SetFormat( Lenum Target, Lenum InternalFormat, Lenum Format, int Width, int Height, int Depth ) {}
-	virtual void    AttachToCurrentFB( Lenum Attachment, int ZSlice ) {}
+	virtual void    SetFormat( Lenum /*Target*/, Lenum /*InternalFormat*/, Lenum /*Format*/, int /*Width*/, int /*Height*/, int /*Depth*/ ) {}
+	virtual void    AttachToCurrentFB( Lenum /*Attachment*/, int /*ZSlice*/ ) {}
+
+	/// Texels for the rasterizer, NULL if nothing was loaded
+	const clBitmap* GetBitmap() const { return FBitmap; }
+private:
+	clBitmap*    FBitmap;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     Keeps a copy of the bitmap for clSoftRasterizer
  * 11/06/2010
      Initial version
 */
@@ -24,6 +24,9 @@
 #include "Renderer/iRenderContext.h"
 #include "Renderer/iShaderProgram.h"
 #include "Images/Image.h"
+#include "Images/Bitmap.h"
+#include "Images/RAW.h"
+#include "Images/VolumeLib.h"
 #include "Resources/ResourcesManager.h"
 
 #pragma region Recommended render target parameters
@@ -762,6 +765,120 @@ bool clLVLibVolume::AutoLoadVolumeAndGradients( const LString& FileName,
 	return true;
 }
 
+void* clLVLibVolume::CreateBrickedVolume( clBitmap** Bitmap )
+{
+	iTexture* Texture = FVolumeShader->GetTextureForTextureUnit( L_SLOT_VOLUME );
+
+	clImage* Image = Texture ? Texture->GetImage() : NULL;
+
+	if ( !Image ) { return NULL; }
+
+	clBitmap* Bmp = Image->GetCurrentBitmapLocked();
+
+	if ( Bmp->GetBitmapFormat() != L_BITMAP_GRAYSCALE8 && Bmp->GetBitmapFormat() != L_BITMAP_GRAYSCALE16 ) { return NULL; }
+
+	// bricks are processed by the job system
+	clRAWLoader::InstallParallelFor( Env );
+
+	void* Bricked = VL_CreateBrickedVolume( Bmp->GetWidth(), Bmp->GetHeight(), Bmp->GetDepth(), Bmp->GetBitsPerPixel() / 8, DEFAULT_BRICK_SIZE );
+
+	VL_LoadBrickedVolumeFromLinear( Bricked, Bmp->FBitmapData );
+
+	*Bitmap = Bmp;
+
+	return Bricked;
+}
+
+bool clLVLibVolume::SmoothVolume( int KernelSize, float Sigma )
+{
+	clBitmap* Bmp = NULL;
+
+	void* Bricked = CreateBrickedVolume( &Bmp );
+
+	if ( !Bricked ) { return false; }
+
+	// the separable filter keeps a line of voxels, so the volume is smoothed in place
+	if ( Bmp->GetBitmapFormat() == L_BITMAP_GRAYSCALE8 )
+	{
+		VL_MakeSeparableGaussian8_Single( Bricked, Bricked, KernelSize, Sigma );
+	}
+	else
+	{
+		VL_MakeSeparableGaussian16_Single( Bricked, Bricked, KernelSize, Sigma );
+	}
+
+	VL_StoreBrickedVolumeToLinear( Bricked, Bmp->FBitmapData );
+	VL_DeleteBrickedVolume( Bricked );
+
+	// upload the new voxels
+	GetVolume()->CommitChanges();
+
+	return true;
+}
+
+bool clLVLibVolume::CollectHistogram( std::vector<Luint>* Bins )
+{
+	clBitmap* Bmp = NULL;
+
+	void* Bricked = CreateBrickedVolume( &Bmp );
+
+	if ( !Bricked ) { return false; }
+
+	bool Is8Bit = ( Bmp->GetBitmapFormat() == L_BITMAP_GRAYSCALE8 );
+
+	Bins->assign( Is8Bit ? 256 : 65536, 0 );
+
+	if ( Is8Bit )
+	{
+		VL_CollectBrickedHistogram8( Bricked, static_cast<int>( Bins->size() ), &( *Bins )[0] );
+	}
+	else
+	{
+		VL_CollectBrickedHistogram16( Bricked, static_cast<int>( Bins->size() ), &( *Bins )[0] );
+	}
+
+	VL_DeleteBrickedVolume( Bricked );
+
+	return true;
+}
+
+clBitmap* clLVLibVolume::CreateHistogram2D( int W, int H )
+{
+	clBitmap* Bmp = NULL;
+
+	void* Bricked = CreateBrickedVolume( &Bmp );
+
+	if ( !Bricked ) { return NULL; }
+
+	bool Is8Bit = ( Bmp->GetBitmapFormat() == L_BITMAP_GRAYSCALE8 );
+
+	double MaxValue = Is8Bit ? 255.0 : 65535.0;
+
+	// the largest possible central differences gradient
+	double MaxGradient = 0.5 * sqrt( 3.0 ) * MaxValue;
+
+	std::vector<Luint> Bins( W * H, 0 );
+
+	if ( Is8Bit )
+	{
+		VL_CollectBrickedHistogram2D8( Bricked, W, H, MaxValue, MaxGradient, &Bins[0] );
+	}
+	else
+	{
+		VL_CollectBrickedHistogram2D16( Bricked, W, H, MaxValue, MaxGradient, &Bins[0] );
+	}
+
+	VL_DeleteBrickedVolume( Bricked );
+
+	clBitmap* Histogram = clBitmap::CreateBitmap( Env, W, H, 1, L_BITMAP_FLOAT32_R, L_TEXTURE_2D );
+
+	float* Dst = reinterpret_cast<float*>( Histogram->FBitmapData );
+
+	for ( size_t i = 0 ; i != Bins.size() ; i++ ) { Dst[i] = static_cast<float>( Bins[i] ); }
+
+	return Histogram;
+}
+
 clGeom* clLVLibVolume::CreateVolumeGeom() const
 {
 	clGeom* Geom = Env->Resources->CreateGeom();
@@ -787,6 +904,8 @@ int clLVLibVolume::AddToScene( clScene* Scene ) const
 }
 
 /*
+ * 17/10/2026
+     SmoothVolume(), CollectHistogram() and CreateHistogram2D() run VolumeLib bricked routines on the job system
  * 30/05/2010
      Initial support for depth blending
  * 29/05/2010
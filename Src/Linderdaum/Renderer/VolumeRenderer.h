@@ -15,8 +15,10 @@
 #include "Math/LMatrix.h"
 
 #include <map>
+#include <vector>
 
 class clImage;
+class clBitmap;
 class clGeom;
 class clScene;
 class iTexture;
@@ -102,6 +104,21 @@ public:
 	                                         bool PrecomputeGradient,
 	                                         bool CreateESLMap );
 
+	/**
+	   Smooth the 8 or 16-bit volume image with the separable KernelSize^3 gaussian exp(-r^2/Sigma^2).
+	   The volume is split into bricks which are filtered on the job system
+	**/
+	virtual bool SmoothVolume( int KernelSize, float Sigma );
+
+	/// Density histogram of the 8 or 16-bit volume image, one bin per voxel value
+	virtual bool CollectHistogram( std::vector<Luint>* Bins );
+
+	/**
+	   (density, gradient magnitude) histogram of the 8 or 16-bit volume image for 2D transfer functions.
+	   Returns the W x H L_BITMAP_FLOAT32_R bitmap of bin counts, density goes along X. NULL for other formats
+	**/
+	virtual clBitmap* CreateHistogram2D( int W, int H );
+
 	/** Property(Category="Rendering parameters", Description="Number of tracing steps", Name=Iterations, Type=int, Getter= GetIterations, Setter=SetIterations) */
 
 	/** Property(Category="Transformations", Description="ModelView matrix", Name=ModelView, Type=mtx4, Setter=SetModelView) */
@@ -178,6 +195,8 @@ private:
 	virtual LString         GetPropertiesString();
 	virtual void            RelinkShader();
 	virtual void            BindParameters( iShaderProgram* Prog );
+	/// Bricked copy of the 8 or 16-bit volume image (for the VL_*Bricked* routines), NULL for other formats
+	void*                   CreateBrickedVolume( clBitmap** Bitmap );
 private:
 	bool               FMVPChanged;
 	bool               FViewportNeedResize;
@@ -232,6 +251,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     Bricked smoothing and histograms
  * 23/03/2009
      It's here
 */
@@ -25,33 +25,34 @@
 #include "Geometry/GeomServ.h"
 #include "Geometry/Geom.h"
 #include "Geometry/Surfaces.h"
+#include "Math/LMath.h"
 #include "Math/LMathStrings.h"
 #include "Utils/LBlob.h"
 
+#include <algorithm>
+
 void clLoaderThread::Run()
 {
-	Env->Logger->SetCurrentThreadName( "Loader" );
+	Env->Logger->SetCurrentThreadName( "Loader " + LStr::ToStr( FIndex ) );
 
 	guard();
 
-	while ( !IsPendingExit() )
+	while ( clLoaderPool::iLoadOp* Op = FPool->ExtractLoadOp( this ) )
 	{
-		if ( FLoadOps.empty() )
+		if ( Op->IsCancelled() )
 		{
-			Env->ReleaseTimeslice( 10 );
+			Op->Cancel();
 
-			continue;
+			Env->Logger->Log( L_PARANOID, "Async loading cancelled: " + Op->GetResource()->GetFileName() );
 		}
+		else
+		{
+			Op->Load();
 
-		// 1. Extract loading command from dequeue
-		iLoadOp* Op = ExtractLoadOp();
-
-		// 2. Load file and switch default & current object in resource
-		Op->Load();
-
-		Env->Logger->Log( L_PARANOID, "Async loaded resource: " + Op->GetResource()->GetFileName() );
+			Env->Logger->Log( L_PARANOID, "Async loaded resource: " + Op->GetResource()->GetFileName() );
+		}
 
-		delete( Op );
+		FPool->CompleteLoadOp( Op );
 	}
 
 	Env->Logger->Log( L_NOTICE, "Loader thread exited" );
@@ -59,12 +60,33 @@ void clLoaderThread::Run()
 	unguard();
 }
 
-iResource* clLoaderThread::clLoadOp_Geom::GetResource() const
+void clLoaderPool::iLoadOp::Cancel()
+{
+	// the resource keeps its default content
+	GetResource()->SetAsyncLoadComplete( true );
+}
+
+bool clLoaderPool::iLoadOp::DependsOn( iResource* Resource ) const
+{
+	return std::find( FDependencies.begin(), FDependencies.end(), Resource ) != FDependencies.end();
+}
+
+bool clLoaderPool::iLoadOp::IsReady() const
+{
+	for ( std::vector<iResource*>::const_iterator i = FDependencies.begin(); i != FDependencies.end(); ++i )
+	{
+		if ( !( *i )->IsAsyncLoadComplete() ) { return false; }
+	}
+
+	return true;
+}
+
+iResource* clLoaderPool::clLoadOp_Geom::GetResource() const
 {
 	return FResource;
 }
 
-void clLoaderThread::clLoadOp_Geom::Load()
+void clLoaderPool::clLoadOp_Geom::Load()
 {
 	// this Env is used in guard()
 	sEnvironment* Env = this->FResource->Env;
@@ -82,12 +104,12 @@ void clLoaderThread::clLoadOp_Geom::Load()
 	unguard();
 }
 
-iResource* clLoaderThread::clLoadOp_Image::GetResource() const
+iResource* clLoaderPool::clLoadOp_Image::GetResource() const
 {
 	return FResource;
 }
 
-void clLoaderThread::clLoadOp_Image::Load()
+void clLoaderPool::clLoadOp_Image::Load()
 {
 	// this Env is used in guard()
 	sEnvironment* Env = this->FResource->Env;
@@ -139,56 +161,311 @@ void clLoaderThread::clLoadOp_Image::Load()
 	unguard();
 }
 
-void clLoaderThread::Event_STARTLOADING( LEvent Event, const LEventArgs& Args )
+iResource* clLoaderPool::clLoadOp_Join::GetResource() const
+{
+	return FResource;
+}
+
+void clLoaderPool::clLoadOp_Join::Load()
+{
+	this->FResource->SetAsyncLoadComplete( true );
+}
+
+clLoaderPool::clLoaderPool()
+	: Env( NULL ),
+	  FReadyOps(),
+	  FWaitingOps(),
+	  FNextSequence( 0 ),
+	  FThreads()
+{
+}
+
+clLoaderPool::~clLoaderPool()
+{
+	for ( std::vector<clLoaderThread*>::iterator i = FThreads.begin(); i != FThreads.end(); ++i )
+	{
+		delete( *i );
+	}
+
+	for ( std::vector<iLoadOp*>::iterator i = FReadyOps.begin(); i != FReadyOps.end(); ++i )
+	{
+		delete( *i );
+	}
+
+	for ( std::list<iLoadOp*>::iterator i = FWaitingOps.begin(); i != FWaitingOps.end(); ++i )
+	{
+		delete( *i );
+	}
+}
+
+void clLoaderPool::Start( sEnvironment* E, int NumThreads )
+{
+	Env = E;
+
+	for ( int i = 0; i != NumThreads; i++ )
+	{
+		clLoaderThread* Thread = new clLoaderThread( this, i );
+
+		FThreads.push_back( Thread );
+
+		Thread->Start( Env, iThread::Priority_Low );
+	}
+
+	Env->Logger->LogP( L_LOG, "Started %i loader threads", NumThreads );
+}
+
+void clLoaderPool::Stop( bool Wait )
+{
+	{
+		LMutex Lock( &FMutex );
+
+		for ( std::vector<clLoaderThread*>::iterator i = FThreads.begin(); i != FThreads.end(); ++i )
+		{
+			( *i )->Exit( false );
+		}
+
+		FOpsAvailable.Broadcast();
+	}
+
+	if ( !Wait ) { return; }
+
+	for ( std::vector<clLoaderThread*>::iterator i = FThreads.begin(); i != FThreads.end(); ++i )
+	{
+		( *i )->Exit( true );
+	}
+}
+
+void clLoaderPool::EnqueueLoading( iLoadOp* LoadOp )
+{
+	LMutex Lock( &FMutex );
+
+	LoadOp->FSequence = FNextSequence++;
+
+	if ( LoadOp->IsReady() )
+	{
+		PushReady_NoLock( LoadOp );
+
+		FOpsAvailable.Signal();
+	}
+	else
+	{
+		FWaitingOps.push_back( LoadOp );
+	}
+}
+
+void clLoaderPool::PrioritizeLoading( iResource* Resource, int Priority )
+{
+	LMutex Lock( &FMutex );
+
+	// the resource and everything it waits for (transitively) get the new priority
+	std::vector<iResource*> Targets( 1, Resource );
+
+	for ( size_t t = 0; t != Targets.size(); t++ )
+	{
+		for ( std::list<iLoadOp*>::iterator i = FWaitingOps.begin(); i != FWaitingOps.end(); ++i )
+		{
+			iLoadOp* Op = *i;
+
+			if ( Op->GetResource() != Targets[t] ) { continue; }
+
+			if ( Op->FPriority < Priority ) { Op->FPriority = Priority; }
+
+			for ( std::vector<iResource*>::const_iterator d = Op->FDependencies.begin(); d != Op->FDependencies.end(); ++d )
+			{
+				if ( std::find( Targets.begin(), Targets.end(), *d ) == Targets.end() ) { Targets.push_back( *d ); }
+			}
+		}
+	}
+
+	bool Changed = false;
+
+	for ( std::vector<iLoadOp*>::iterator i = FReadyOps.begin(); i != FReadyOps.end(); ++i )
+	{
+		iLoadOp* Op = *i;
+
+		if ( Op->FPriority >= Priority ) { continue; }
+
+		if ( std::find( Targets.begin(), Targets.end(), Op->GetResource() ) == Targets.end() ) { continue; }
+
+		Op->FPriority = Priority;
+
+		Changed = true;
+	}
+
+	if ( Changed ) { std::make_heap( FReadyOps.begin(), FReadyOps.end(), sLoadOpLess() ); }
+}
+
+size_t clLoaderPool::CancelLoading( iResource* Resource )
+{
+	std::vector<iLoadOp*> Cancelled;
+
+	bool Detached = false;
+
+	{
+		LMutex Lock( &FMutex );
+
+		std::vector<iLoadOp*> Ready;
+		Ready.reserve( FReadyOps.size() );
+
+		for ( std::vector<iLoadOp*>::iterator i = FReadyOps.begin(); i != FReadyOps.end(); ++i )
+		{
+			if ( ( *i )->GetResource() == Resource ) { Cancelled.push_back( *i ); }
+			else { Ready.push_back( *i ); }
+		}
+
+		if ( !Cancelled.empty() )
+		{
+			FReadyOps.swap( Ready );
+			std::make_heap( FReadyOps.begin(), FReadyOps.end(), sLoadOpLess() );
+		}
+
+		for ( std::list<iLoadOp*>::iterator i = FWaitingOps.begin(); i != FWaitingOps.end(); )
+		{
+			if ( ( *i )->GetResource() == Resource )
+			{
+				Cancelled.push_back( *i );
+				i = FWaitingOps.erase( i );
+				continue;
+			}
+
+			// nobody waits for a resource which will never be loaded (or is being deleted)
+			std::vector<iResource*>& Deps = ( *i )->FDependencies;
+
+			size_t NumDeps = Deps.size();
+
+			Deps.erase( std::remove( Deps.begin(), Deps.end(), Resource ), Deps.end() );
+
+			if ( Deps.size() != NumDeps ) { Detached = true; }
+
+			++i;
+		}
+	}
+
+	for ( std::vector<iLoadOp*>::iterator i = Cancelled.begin(); i != Cancelled.end(); ++i )
+	{
+		( *i )->Cancel();
+
+		delete( *i );
+	}
+
+	if ( Detached )
+	{
+		// dependants of the cancelled resource may start now
+		LMutex Lock( &FMutex );
+
+		PromoteWaitingOps_NoLock();
+	}
+
+	return Cancelled.size();
+}
+
+void clLoaderPool::ResourceLoaded()
 {
+	LMutex Lock( &FMutex );
+
+	PromoteWaitingOps_NoLock();
 }
 
-void clLoaderThread::Event_STOPLOADING( LEvent Event, const LEventArgs& Args )
+size_t clLoaderPool::GetQueueSize() const
 {
+	LMutex Lock( &FMutex );
+
+	return FReadyOps.size() + FWaitingOps.size();
 }
 
-clLoaderThread::iLoadOp* clLoaderThread::ExtractLoadOp()
+clLoaderPool::iLoadOp* clLoaderPool::ExtractLoadOp( clLoaderThread* Worker )
 {
 	LMutex Lock( &FMutex );
 
-	iLoadOp* Op = FLoadOps.front();
+	while ( FReadyOps.empty() && !Worker->IsPendingExit() )
+	{
+		FOpsAvailable.Wait( &FMutex );
+	}
+
+	if ( Worker->IsPendingExit() ) { return NULL; }
+
+	std::pop_heap( FReadyOps.begin(), FReadyOps.end(), sLoadOpLess() );
 
-	FLoadOps.pop_front();
+	iLoadOp* Op = FReadyOps.back();
 
-	Env->Logger->LogP( L_DEBUG, "Size of loading queue: %i", FLoadOps.size() );
+	FReadyOps.pop_back();
+
+	Env->Logger->LogP( L_DEBUG, "Size of loading queue: %i", static_cast<int>( FReadyOps.size() + FWaitingOps.size() ) );
 
 	return Op;
 }
 
-void clLoaderThread::EnqueueLoading( iLoadOp* LoadOp )
+void clLoaderPool::CompleteLoadOp( iLoadOp* LoadOp )
 {
+	delete( LoadOp );
+
 	LMutex Lock( &FMutex );
 
-	FLoadOps.push_back( LoadOp );
+	PromoteWaitingOps_NoLock();
+}
+
+void clLoaderPool::PromoteWaitingOps_NoLock()
+{
+	bool Promoted = false;
+
+	for ( std::list<iLoadOp*>::iterator i = FWaitingOps.begin(); i != FWaitingOps.end(); )
+	{
+		if ( ( *i )->IsReady() )
+		{
+			PushReady_NoLock( *i );
+
+			i = FWaitingOps.erase( i );
+
+			Promoted = true;
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if ( Promoted ) { FOpsAvailable.Broadcast(); }
+}
+
+void clLoaderPool::PushReady_NoLock( iLoadOp* LoadOp )
+{
+	FReadyOps.push_back( LoadOp );
+
+	std::push_heap( FReadyOps.begin(), FReadyOps.end(), sLoadOpLess() );
 }
 
 clResourcesManager::clResourcesManager():
-	FResourcesGraph( 0 ),
+	FRegistry(),
 	FTime_Waveforms( 0 ),
 	FTime_ShaderPrograms( 0 ),
 	FTime_Images( 0 ),
 	FTime_Materials( 0 ),
 	FTime_Meshes( 0 ),
 	FTime_RenderStates( 0 ),
-	FTime_Animations( 0 )
+	FTime_Animations( 0 ),
+	FLoaderPool( NULL ),
+	FLockedLoading( NULL ),
+	FMaxLoaded( NULL )
 {
 }
 
 void clResourcesManager::AfterConstruction()
 {
 	FLockedLoading = Env->Console->GetVarDefault( "Resources.LockedLoading", "false" );
+	// 0 - never evict loaded resources
+	FMaxLoaded     = Env->Console->GetVarDefault( "Resources.MaxLoaded", "0" );
 
 	Env->Console->RegisterCommand( "PreCache",         Utils::Bind( &clResourcesManager::PreCacheC,   this ) );
 	Env->Console->RegisterCommand( "ReCache",          Utils::Bind( &clResourcesManager::ReCacheC,    this ) );
 	Env->Console->RegisterCommand( "ReCacheNew",       Utils::Bind( &clResourcesManager::ReCacheNewC, this ) );
 
-	FLoaderThread = new clLoaderThread();
-	FLoaderThread->Start( Env, iThread::Priority_Low );
+	// 0 - one thread per core except the main one, at most 4
+	int NumThreads = Env->Console->GetVarDefault( "Resources.LoaderThreads", "0" )->GetInt();
+
+	if ( NumThreads <= 0 ) { NumThreads = Math::Clamp( iThread::GetNumberOfCores() - 1, 1, 4 ); }
+
+	FLoaderPool = new clLoaderPool();
+	FLoaderPool->Start( Env, NumThreads );
 }
 
 clBlob* clResourcesManager::CreateEmptyBlob() const
@@ -218,17 +495,20 @@ void clResourcesManager::StopLoaderThread()
 {
 	guard();
 
-	Env->Logger->Log( L_LOG, "Stopping loader thread" );
+	Env->Logger->Log( L_LOG, "Stopping loader threads" );
 
-	FLoaderThread->Exit( false );
+	FLoaderPool->Stop( false );
 
 	unguard();
 }
 
 clResourcesManager::~clResourcesManager()
 {
-	FLoaderThread->Exit( true );
-	delete( FLoaderThread );
+	FLoaderPool->Stop( true );
+	delete( FLoaderPool );
+
+	// resources deleted in PurgeAll() should not look for the pool
+	FLoaderPool = NULL;
 
 	Env->Logger->Log( L_LOG, "Resources total loading time:" );
 	Env->Logger->Log( L_LOG, "         Waveforms: " + LStr::ToStr( FTime_Waveforms, 1 ) );
@@ -258,6 +538,8 @@ iWaveform* clResourcesManager::LoadWaveform( const LString& FileName )
 		Resource->Load( FileName, false );
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_Waveforms += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -276,17 +558,16 @@ iShaderProgram* clResourcesManager::LoadSP( const LString& FileName, const LStri
 
 	iShaderProgram* Resource = NULL;
 
-	clResourcesGraph::const_iterator i;
+	// only the programs sharing the file name are checked
+	std::vector<iResource*> SameName;
 
-	// manual iteration
-	for ( i = FResourcesGraph.begin(); i != FResourcesGraph.end(); ++i )
+	if ( FRegistry.GetResourcesByName( FileName, &SameName ) )
 	{
-		if ( iShaderProgram* SP = dynamic_cast<iShaderProgram*>( *i ) )
+		for ( std::vector<iResource*>::const_iterator i = SameName.begin(); i != SameName.end(); ++i )
 		{
-			bool SameName =  SP->GetFileName() == FileName;
-			bool SameDefs =  SP->GetDefinesList() == DefinesList;
+			iShaderProgram* SP = dynamic_cast<iShaderProgram*>( *i );
 
-			if ( SameName && SameDefs )
+			if ( SP && SP->GetDefinesList() == DefinesList )
 			{
 				Resource = SP;
 				break;
@@ -294,7 +575,13 @@ iShaderProgram* clResourcesManager::LoadSP( const LString& FileName, const LStri
 		}
 	}
 
-	if ( !Resource )
+	if ( Resource )
+	{
+		FRegistry.Touch( Resource );
+
+		Resource->Reload();
+	}
+	else
 	{
 		bool CacheEnabled = Env->Console->GetVarDefault( "Cache.ShaderProgramsCacheEnabled", "false" )->GetBool();
 
@@ -304,6 +591,8 @@ iShaderProgram* clResourcesManager::LoadSP( const LString& FileName, const LStri
 		Resource->Load( FileName, CacheEnabled );
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_ShaderPrograms += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -371,14 +660,18 @@ clImage* clResourcesManager::LoadImgHints( const LString& FileName,
 
 		Resource->GetDefaultBitmap()->ReallocImageData( &Params );
 
-		EnqueueLoading( new clLoaderThread::clLoadOp_Image( Resource ) );
+		EnqueueLoading( new clLoaderPool::clLoadOp_Image( Resource ) );
 
 		if ( FLockedLoading->GetBool() )
 		{
 			Resource->WaitLoad();
 		}
+
+		EvictUnusedResources();
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_Images += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -415,6 +708,8 @@ clMaterial* clResourcesManager::LoadMaterial( const LString& FileName )
 		Resource->Load( FileName, false );
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_Materials += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -540,9 +835,44 @@ clGeom* clResourcesManager::CreatePlane( float X1, float Y1, float X2, float Y2,
 	unguard();
 }
 
-void clResourcesManager::EnqueueLoading( clLoaderThread::iLoadOp* LoadOp )
+void clResourcesManager::EnqueueLoading( clLoaderPool::iLoadOp* LoadOp )
 {
-	FLoaderThread->EnqueueLoading( LoadOp );
+	FLoaderPool->EnqueueLoading( LoadOp );
+}
+
+void clResourcesManager::PrioritizeLoading( iResource* Resource )
+{
+	FLoaderPool->PrioritizeLoading( Resource, clLoaderPool::Priority_Urgent );
+}
+
+void clResourcesManager::CancelLoading( iResource* Resource )
+{
+	if ( FLoaderPool ) { FLoaderPool->CancelLoading( Resource ); }
+}
+
+void clResourcesManager::ResourceLoaded()
+{
+	if ( FLoaderPool ) { FLoaderPool->ResourceLoaded(); }
+}
+
+void clResourcesManager::AddLoadDependencies( iResource* Resource, const std::vector<iResource*>& Dependencies )
+{
+	clLoaderPool::iLoadOp* Join = NULL;
+
+	for ( std::vector<iResource*>::const_iterator i = Dependencies.begin(); i != Dependencies.end(); ++i )
+	{
+		if ( !*i || ( *i )->IsAsyncLoadComplete() ) { continue; }
+
+		if ( !Join ) { Join = new clLoaderPool::clLoadOp_Join( Resource ); }
+
+		Join->AddDependency( *i );
+	}
+
+	if ( !Join ) { return; }
+
+	Resource->SetAsyncLoadComplete( false );
+
+	EnqueueLoading( Join );
 }
 
 clGeom* clResourcesManager::LoadGeom( const LString& FileName )
@@ -557,14 +887,18 @@ clGeom* clResourcesManager::LoadGeom( const LString& FileName )
 		Resource->SetAsyncLoadComplete( false );
 		Resource->SetFileName( FileName );
 
-		EnqueueLoading( new clLoaderThread::clLoadOp_Geom( Resource ) );
+		EnqueueLoading( new clLoaderPool::clLoadOp_Geom( Resource ) );
 
 		if ( FLockedLoading->GetBool() )
 		{
 			Resource->WaitLoad();
 		}
+
+		EvictUnusedResources();
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_Meshes += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -589,6 +923,8 @@ clAnimation* clResourcesManager::LoadAnimation( const LString& FileName )
 		Resource->Load( FileName, CacheEnabled );
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_Animations += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -626,6 +962,8 @@ clRenderState* clResourcesManager::LoadShader( const LString& FileName )
 		Resource->Load( FileName, CacheEnabled );
 	}
 
+	FRegistry.Pin( Resource );
+
 	FTime_RenderStates += Env->GetSeconds() - StartTime;
 
 	return Resource;
@@ -642,9 +980,11 @@ void clResourcesManager::PurgeAll()
 
 	//Env->Logger->Log( L_NOTICE, "Purging resources..." );
 
-	clResourcesGraph LocalGraph( FResourcesGraph );
+	std::vector<iResource*> LocalGraph;
 
-	for ( clResourcesGraph::iterator i = LocalGraph.begin(); i != LocalGraph.end(); ++i )
+	FRegistry.GetResources( &LocalGraph );
+
+	for ( std::vector<iResource*>::iterator i = LocalGraph.begin(); i != LocalGraph.end(); ++i )
 	{
 		iResource* Res = *i;
 
@@ -653,9 +993,9 @@ void clResourcesManager::PurgeAll()
 		delete( Res );
 	}
 
-	if ( !FResourcesGraph.empty() )
+	if ( !FRegistry.IsEmpty() )
 	{
-		Env->Logger->Log( L_WARNING, "Resources graph is not empty!" );
+		Env->Logger->Log( L_WARNING, "Resources registry is not empty!" );
 	}
 
 	/*
@@ -671,23 +1011,27 @@ void clResourcesManager::PurgeAll()
 	unguard();
 }
 
-iResource* clResourcesManager::FindResourceInGraph( clResourcesGraph& Graph,
-                                                    const LString& FileName )
+void clResourcesManager::EvictUnusedResources()
 {
-	LString ConvFileName = LStr::GetUpper( FileName );
+	int MaxLoaded = FMaxLoaded->GetInt();
 
-	for ( clResourcesGraph::iterator i = Graph.begin(); i != Graph.end(); ++i )
-	{
-		if ( LStr::GetUpper( ( *i )->GetFileName() ) == ConvFileName )
-		{
-			// simple LRU cache
-			std::swap( *Graph.begin(), *i );
+	if ( MaxLoaded <= 0 ) { return; }
 
-			return *Graph.begin();
-		}
+	size_t Evicted = FRegistry.EvictLRU( static_cast<size_t>( MaxLoaded ) );
+
+	if ( Evicted > 0 )
+	{
+		Env->Logger->LogP( L_DEBUG, "Evicted %i least recently used resources", static_cast<int>( Evicted ) );
 	}
+}
+
+void clResourcesManager::ReleaseResource( iResource* Resource )
+{
+	if ( !Resource ) { return; }
 
-	return NULL;
+	FRegistry.Unpin( Resource );
+
+	EvictUnusedResources();
 }
 
 /**
@@ -750,7 +1094,7 @@ void clResourcesManager::ReCacheC( const LString& Param )
 		return;
 	}
 
-	iResource* Resource = Env->Resources->FindResourceInGraph( FResourcesGraph, Param );
+	iResource* Resource = FindResourceFile<iResource>( Param );
 
 	if ( !Resource )
 	{
@@ -770,8 +1114,13 @@ void clResourcesManager::ReCacheNewC( const LString& Param )
 {
 	Env->Console->Display( "Recaching updated resources..." );
 
-	clResourcesGraph::const_iterator i   = FResourcesGraph.begin();
-	clResourcesGraph::const_iterator End = FResourcesGraph.end();
+	// snapshot: reloading may create new resources
+	std::vector<iResource*> Resources;
+
+	FRegistry.GetResources( &Resources );
+
+	std::vector<iResource*>::const_iterator i   = Resources.begin();
+	std::vector<iResource*>::const_iterator End = Resources.end();
 
 	for ( ; i != End; ++i )
 	{
@@ -798,6 +1147,12 @@ void clResourcesManager::ReCacheNewC( const LString& Param )
 }
 
 /*
+ * 17/10/2026
+     ReleaseResource(), resources returned by Load*() are pinned until released
+     clLoaderPool replaced the single loader thread
+     AddLoadDependencies()
+     Resources lookup via clResourcesRegistry
+     Resources.MaxLoaded LRU eviction
  * 30/09/2010
      CreateSphere() implemented
  * 10/07/2010
@@ -14,9 +14,9 @@
 #include "Core/iObject.h"
 #include "Images/Bitmap.h"
 #include "Utils/Thread.h"
+#include "Resources/ResourcesRegistry.h"
 
 #include <list>
-#include <deque>
 #include <map>
 
 class clCVar;
@@ -34,16 +34,83 @@ class clLVLibVolume;
 class clUVSurfaceGenerator;
 class clVertexAttribs;
 
+/// Cancellation flag shared by a group of load operations (e.g. all resources of a level)
+class clLoadCancelToken: public iIntrusiveCounter
+{
+public:
+	clLoadCancelToken(): FCancelled( false ) {};
+
+	void Cancel() { FCancelled = true; };
+	bool IsCancelled() const { return FCancelled; };
+private:
+	volatile bool FCancelled;
+};
+
+class clLoaderPool;
+
+/// Worker thread of the asynchronous resources loader
 class scriptfinal clLoaderThread: public iThread
 {
 public:
+	clLoaderThread( clLoaderPool* Pool, int Index ): FPool( Pool ), FIndex( Index ) {};
+	//
+	// iThread interface
+	//
+	virtual void Run();
+private:
+	clLoaderPool* FPool;
+	int           FIndex;
+};
+
+/**
+   Pool of loader threads.
+
+   Load operations are served in the order of priority (FIFO within the same priority).
+   An operation with dependencies is held back until all the resources it depends on are loaded.
+   Idle workers sleep on a condition variable.
+**/
+class scriptfinal clLoaderPool
+{
+public:
+	enum LLoadPriority
+	{
+		Priority_Low    = -100,
+		Priority_Normal = 0,
+		Priority_High   = 100,
+		/// somebody is blocked in WaitLoad() on this resource
+		Priority_Urgent = 1000
+	};
 	class iLoadOp
 	{
 	public:
+		iLoadOp(): FPriority( Priority_Normal ), FSequence( 0 ), FCancelToken(), FDependencies() {};
 		virtual ~iLoadOp() {};
 		/// invoke an appropiate loader to perform actual loading of the resource
 		virtual void Load() = 0;
+		/// the operation was cancelled before it started, leave the resource in a consistent state
+		virtual void Cancel();
 		virtual iResource* GetResource() const = 0;
+
+		void   SetPriority( int Priority ) { FPriority = Priority; };
+		int    GetPriority() const { return FPriority; };
+		size_t GetSequence() const { return FSequence; };
+
+		void SetCancelToken( const clPtr<clLoadCancelToken>& Token ) { FCancelToken = Token; };
+		bool IsCancelled() const { return FCancelToken.IsValid() && FCancelToken->IsCancelled(); };
+
+		/// do not start loading until Resource is loaded
+		void AddDependency( iResource* Resource ) { FDependencies.push_back( Resource ); };
+		bool DependsOn( iResource* Resource ) const;
+		/// true if all dependencies are loaded
+		bool IsReady() const;
+
+		friend class clLoaderPool;
+	private:
+		int                       FPriority;
+		/// order of enqueueing, keeps FIFO within the same priority
+		size_t                    FSequence;
+		clPtr<clLoadCancelToken>  FCancelToken;
+		std::vector<iResource*>   FDependencies;
 	};
 	class clLoadOp_Image: public iLoadOp
 	{
@@ -63,23 +130,64 @@ public:
 	private:
 		clGeom* FResource;
 	};
+	/// nothing to load by itself, marks the resource as loaded once all its dependencies are loaded
+	class clLoadOp_Join: public iLoadOp
+	{
+	public:
+		clLoadOp_Join( iResource* Resource ) : FResource( Resource ) {};
+		virtual void Load();
+		virtual iResource* GetResource() const;
+	private:
+		iResource* FResource;
+	};
 public:
-	//
-	// iThread interface
-	//
-	virtual void Run();
-	//
-	// clLoaderThread
-	//
-	virtual void EnqueueLoading( iLoadOp* LoadOp );
+	clLoaderPool();
+	~clLoaderPool();
+
+	/// start NumThreads workers
+	void    Start( sEnvironment* Env, int NumThreads );
+	/// ask all workers to exit, optionally wait for them
+	void    Stop( bool Wait );
+
+	void    EnqueueLoading( iLoadOp* LoadOp );
+	/// raise the priority of the pending operations for this resource
+	void    PrioritizeLoading( iResource* Resource, int Priority );
+	/// cancel the pending operations for this resource and stop others from waiting for it, returns the number of cancelled operations
+	size_t  CancelLoading( iResource* Resource );
+	/// a resource finished loading (possibly outside of the pool), start the operations waiting for it
+	void    ResourceLoaded();
+
+	size_t  GetNumThreads() const { return FThreads.size(); };
+	size_t  GetQueueSize() const;
+
+	friend class clLoaderThread;
+private:
+	/// block until an operation is ready or the worker is asked to exit
+	iLoadOp* ExtractLoadOp( clLoaderThread* Worker );
+	/// called by workers when an operation is finished
+	void     CompleteLoadOp( iLoadOp* LoadOp );
+	void     PromoteWaitingOps_NoLock();
+	void     PushReady_NoLock( iLoadOp* LoadOp );
 private:
-	iLoadOp* ExtractLoadOp();
+	struct sLoadOpLess
+	{
+		bool operator()( const iLoadOp* A, const iLoadOp* B ) const
+		{
+			if ( A->GetPriority() != B->GetPriority() ) { return A->GetPriority() < B->GetPriority(); }
 
-	FWD_EVENT_HANDLER( Event_STARTLOADING );
-	FWD_EVENT_HANDLER( Event_STOPLOADING );
+			return A->GetSequence() > B->GetSequence();
+		}
+	};
 private:
-	std::deque<iLoadOp*> FLoadOps;
-	clMutex              FMutex;
+	sEnvironment*                 Env;
+	/// binary heap of operations ready to be loaded
+	std::vector<iLoadOp*>         FReadyOps;
+	/// operations waiting for their dependencies
+	std::list<iLoadOp*>           FWaitingOps;
+	size_t                        FNextSequence;
+	std::vector<clLoaderThread*>  FThreads;
+	clMutex                       FMutex;
+	clCondition                   FOpsAvailable;
 };
 
 /// Resources manager
@@ -112,7 +220,7 @@ public:
 
 #pragma endregion
 
-	/// LV: WTF is this ? explain, please
+	/// Stop loader threads without waiting for them, used on environment shutdown
 	void    StopLoaderThread();
 
 #pragma region iWaveform
@@ -219,11 +327,26 @@ public:
 #pragma region Resources management
 	static LString        ConvertName( const LString& FileName );
 	void          PurgeAll();
+	/// find a resource of type T by its file name (case-insensitive, any path separators), evicted resources are loaded again
 	template <class T> T* FindResourceFile( const LString& FileName )
 	{
-		return dynamic_cast<T*>( FindResourceInGraph( FResourcesGraph, FileName ) );
+		T* Resource = FRegistry.Find<T>( FileName );
+
+		if ( Resource ) { Resource->Reload(); }
+
+		return Resource;
 	};
-	void EnqueueLoading( clLoaderThread::iLoadOp* LoadOp );
+	/// unload least recently used resources above the Resources.MaxLoaded limit
+	void          EvictUnusedResources();
+	/// every Load*() pins the returned resource, call this once per Load*() when the pointer is not used anymore so the resource can be evicted
+	void          ReleaseResource( iResource* Resource );
+	void EnqueueLoading( clLoaderPool::iLoadOp* LoadOp );
+	/// raise the priority of the pending loading of this resource
+	void PrioritizeLoading( iResource* Resource );
+	/// cancel the pending loading of this resource
+	void CancelLoading( iResource* Resource );
+	/// Resource stays incomplete until all of the Dependencies are loaded
+	void AddLoadDependencies( iResource* Resource, const std::vector<iResource*>& Dependencies );
 #pragma endregion
 
 	friend class iResource;
@@ -234,11 +357,10 @@ private:
 	void    PreCacheC( const LString& Param );
 	void    ReCacheC( const LString& Param );
 	void    ReCacheNewC( const LString& Param );
+	/// called by iResource::SetAsyncLoadComplete()
+	void    ResourceLoaded();
 private:
-	typedef std::list<iResource*>    clResourcesGraph;
-	iResource*    FindResourceInGraph( clResourcesGraph& Graph, const LString& FileName );
-private:
-	clResourcesGraph    FResourcesGraph;
+	clResourcesRegistry FRegistry;
 #pragma region Commulative loading time for performance analysis
 	double              FTime_Waveforms;
 	double              FTime_ShaderPrograms;
@@ -249,13 +371,18 @@ private:
 	double              FTime_Animations;
 #pragma endregion
 
-	clLoaderThread* FLoaderThread;
+	clLoaderPool*   FLoaderPool;
 	clCVar*         FLockedLoading;
+	clCVar*         FMaxLoaded;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     ReleaseResource()
+     clLoaderPool: prioritized multithreaded loading with dependencies and cancellation
+     Hashed resources registry instead of the linear resources graph
  * 22/09/2011
      Animations
  * 10/07/2010
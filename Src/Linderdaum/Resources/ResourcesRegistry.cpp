@@ -0,0 +1,348 @@
+/**
+ * \file ResourcesRegistry.cpp
+ * \brief Hashed registry of loaded resources
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "ResourcesRegistry.h"
+#include "iResource.h"
+#include "Math/LHash.h"
+
+#include <algorithm>
+
+namespace
+{
+	const size_t INITIAL_BUCKETS_COUNT = 256;
+
+	inline char FoldChar( char Ch )
+	{
+		if ( Ch == '\\' ) { return '/'; }
+
+		if ( Ch >= 'a' && Ch <= 'z' ) { return Ch - 'a' + 'A'; }
+
+		return Ch;
+	}
+
+	/// compare normalized name with an arbitrary one without allocating a converted copy
+	inline bool IsSameName( const LString& Normalized, const LString& FileName )
+	{
+		if ( Normalized.length() != FileName.length() ) { return false; }
+
+		const char* A = Normalized.c_str();
+		const char* B = FileName.c_str();
+
+		for ( ; *A; ++A, ++B )
+		{
+			if ( *A != FoldChar( *B ) ) { return false; }
+		}
+
+		return true;
+	}
+}
+
+clResourcesRegistry::clResourcesRegistry()
+	: FBuckets( INITIAL_BUCKETS_COUNT, NULL ),
+	  FNamesCount( 0 ),
+	  FCount( 0 ),
+	  FNextResourceID( 0 ),
+	  FHead( NULL ),
+	  FTail( NULL )
+{
+}
+
+clResourcesRegistry::~clResourcesRegistry()
+{
+	for ( size_t i = 0; i != FBuckets.size(); i++ )
+	{
+		sResourceNameEntry* Entry = FBuckets[i];
+
+		while ( Entry )
+		{
+			sResourceNameEntry* Next = Entry->FNext;
+
+			delete( Entry );
+
+			Entry = Next;
+		}
+	}
+}
+
+Luint32 clResourcesRegistry::HashName( const LString& FileName )
+{
+	const size_t MAX_STACK_NAME = 256;
+
+	// fold short names on the stack, so lookups do not allocate
+	if ( FileName.length() < MAX_STACK_NAME )
+	{
+		char Folded[ MAX_STACK_NAME ];
+
+		size_t i = 0;
+
+		for ( const char* Ch = FileName.c_str(); *Ch; ++Ch ) { Folded[i++] = FoldChar( *Ch ); }
+
+		Folded[i] = 0;
+
+		return Linderdaum::Math::HashStringFNV1a( Folded );
+	}
+
+	return Linderdaum::Math::HashStringFNV1a( NormalizeName( FileName ).c_str() );
+}
+
+LString clResourcesRegistry::NormalizeName( const LString& FileName )
+{
+	LString Result( FileName );
+
+	for ( size_t i = 0; i != Result.length(); i++ )
+	{
+		Result[i] = FoldChar( Result[i] );
+	}
+
+	return Result;
+}
+
+void clResourcesRegistry::Register( iResource* Res )
+{
+	LMutex Lock( &FMutex );
+
+	Res->FResourceID = FNextResourceID++;
+
+	// new resources are the most recently used ones
+	Res->FLRUPrev = NULL;
+	Res->FLRUNext = FHead;
+
+	if ( FHead ) { FHead->FLRUPrev = Res; }
+
+	FHead = Res;
+
+	if ( !FTail ) { FTail = Res; }
+
+	FCount++;
+}
+
+bool clResourcesRegistry::Unregister( iResource* Res )
+{
+	LMutex Lock( &FMutex );
+
+	RemoveFromEntry_NoLock( Res );
+
+	bool Linked = ( Res->FLRUPrev != NULL ) || ( FHead == Res );
+
+	if ( !Linked ) { return false; }
+
+	if ( Res->FLRUPrev ) { Res->FLRUPrev->FLRUNext = Res->FLRUNext; }
+	else { FHead = Res->FLRUNext; }
+
+	if ( Res->FLRUNext ) { Res->FLRUNext->FLRUPrev = Res->FLRUPrev; }
+	else { FTail = Res->FLRUPrev; }
+
+	Res->FLRUPrev = NULL;
+	Res->FLRUNext = NULL;
+
+	FCount--;
+
+	return true;
+}
+
+void clResourcesRegistry::Rename( iResource* Res, const LString& NewFileName )
+{
+	LMutex Lock( &FMutex );
+
+	RemoveFromEntry_NoLock( Res );
+
+	if ( NewFileName.empty() ) { return; }
+
+	sResourceNameEntry* Entry = InternName_NoLock( NewFileName );
+
+	Entry->FResources.push_back( Res );
+	Entry->FTypeIndex.clear();
+
+	Res->FNameEntry = Entry;
+}
+
+bool clResourcesRegistry::GetResourcesByName( const LString& FileName, std::vector<iResource*>* Resources ) const
+{
+	LMutex Lock( &FMutex );
+
+	Resources->clear();
+
+	const sResourceNameEntry* Entry = FindEntry_NoLock( FileName );
+
+	if ( !Entry ) { return false; }
+
+	// copy under the lock: Rename() and Unregister() modify the list from other threads
+	Resources->assign( Entry->FResources.begin(), Entry->FResources.end() );
+
+	return !Resources->empty();
+}
+
+void clResourcesRegistry::Touch( iResource* Res )
+{
+	LMutex Lock( &FMutex );
+
+	Touch_NoLock( Res );
+}
+
+void clResourcesRegistry::Pin( iResource* Res )
+{
+	LMutex Lock( &FMutex );
+
+	Res->FPinCount++;
+}
+
+void clResourcesRegistry::Unpin( iResource* Res )
+{
+	LMutex Lock( &FMutex );
+
+	if ( Res->FPinCount > 0 ) { Res->FPinCount--; }
+}
+
+void clResourcesRegistry::GetResources( std::vector<iResource*>* Resources ) const
+{
+	LMutex Lock( &FMutex );
+
+	Resources->clear();
+	Resources->reserve( FCount );
+
+	for ( iResource* Res = FHead; Res; Res = Res->FLRUNext )
+	{
+		Resources->push_back( Res );
+	}
+}
+
+size_t clResourcesRegistry::EvictLRU( size_t MaxLoaded )
+{
+	std::vector<iResource*> Victims;
+
+	{
+		LMutex Lock( &FMutex );
+
+		size_t Loaded = 0;
+
+		for ( iResource* Res = FHead; Res; Res = Res->FLRUNext )
+		{
+			if ( Res->FResourceState != L_RESOURCE_LOADED ) { continue; }
+
+			if ( ++Loaded <= MaxLoaded ) { continue; }
+
+			// pinned resources are still used through the raw pointers handed out by the manager
+			if ( Res->FPinCount > 0 ) { continue; }
+
+			// the registry holds no reference itself, so any reference means the resource is still in use
+			if ( Res->GetReferenceCounter() > 0 ) { continue; }
+
+			Victims.push_back( Res );
+		}
+	}
+
+	size_t Evicted = 0;
+
+	// unload outside the lock: UnloadResource() may release other resources
+	for ( std::vector<iResource*>::const_iterator i = Victims.begin(); i != Victims.end(); ++i )
+	{
+		( *i )->Unload();
+
+		if ( ( *i )->FResourceState == L_RESOURCE_UNLOADED ) { Evicted++; }
+	}
+
+	return Evicted;
+}
+
+sResourceNameEntry* clResourcesRegistry::FindEntry_NoLock( const LString& FileName ) const
+{
+	if ( FileName.empty() ) { return NULL; }
+
+	Luint32 Hash = HashName( FileName );
+
+	for ( sResourceNameEntry* Entry = FBuckets[ Hash & ( FBuckets.size() - 1 ) ]; Entry; Entry = Entry->FNext )
+	{
+		if ( Entry->FHash == Hash && IsSameName( Entry->FName, FileName ) ) { return Entry; }
+	}
+
+	return NULL;
+}
+
+sResourceNameEntry* clResourcesRegistry::InternName_NoLock( const LString& FileName )
+{
+	sResourceNameEntry* Entry = FindEntry_NoLock( FileName );
+
+	if ( Entry ) { return Entry; }
+
+	// keep the load factor below 3/4
+	if ( ( FNamesCount + 1 ) * 4 > FBuckets.size() * 3 ) { Rehash_NoLock( FBuckets.size() * 2 ); }
+
+	Entry = new sResourceNameEntry();
+	Entry->FName = NormalizeName( FileName );
+	Entry->FHash = HashName( FileName );
+
+	size_t Bucket = Entry->FHash & ( FBuckets.size() - 1 );
+
+	Entry->FNext = FBuckets[ Bucket ];
+	FBuckets[ Bucket ] = Entry;
+
+	FNamesCount++;
+
+	return Entry;
+}
+
+void clResourcesRegistry::RemoveFromEntry_NoLock( iResource* Res )
+{
+	sResourceNameEntry* Entry = Res->FNameEntry;
+
+	if ( !Entry ) { return; }
+
+	std::vector<iResource*>::iterator i = std::find( Entry->FResources.begin(), Entry->FResources.end(), Res );
+
+	if ( i != Entry->FResources.end() ) { Entry->FResources.erase( i ); }
+
+	Entry->FTypeIndex.clear();
+
+	Res->FNameEntry = NULL;
+}
+
+void clResourcesRegistry::Touch_NoLock( iResource* Res )
+{
+	if ( FHead == Res ) { return; }
+
+	// unlink
+	Res->FLRUPrev->FLRUNext = Res->FLRUNext;
+
+	if ( Res->FLRUNext ) { Res->FLRUNext->FLRUPrev = Res->FLRUPrev; }
+	else { FTail = Res->FLRUPrev; }
+
+	// link as head
+	Res->FLRUPrev = NULL;
+	Res->FLRUNext = FHead;
+	FHead->FLRUPrev = Res;
+	FHead = Res;
+}
+
+void clResourcesRegistry::Rehash_NoLock( size_t NewBucketsCount )
+{
+	std::vector<sResourceNameEntry*> NewBuckets( NewBucketsCount, NULL );
+
+	for ( size_t i = 0; i != FBuckets.size(); i++ )
+	{
+		sResourceNameEntry* Entry = FBuckets[i];
+
+		while ( Entry )
+		{
+			sResourceNameEntry* Next = Entry->FNext;
+
+			size_t Bucket = Entry->FHash & ( NewBucketsCount - 1 );
+
+			Entry->FNext = NewBuckets[ Bucket ];
+			NewBuckets[ Bucket ] = Entry;
+
+			Entry = Next;
+		}
+	}
+
+	FBuckets.swap( NewBuckets );
+}
+
+/*
+ * 17/10/2026
+     It's here
+*/
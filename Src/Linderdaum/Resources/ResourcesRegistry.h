@@ -0,0 +1,160 @@
+/**
+ * \file ResourcesRegistry.h
+ * \brief Hashed registry of loaded resources
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _clResourcesRegistry_
+#define _clResourcesRegistry_
+
+#include "Platform.h"
+#include "LString.h"
+#include "Utils/Mutex.h"
+
+#include <vector>
+
+class iResource;
+
+/// Unique key of the type T, compared by address
+template <class T> struct sResourceTypeKey
+{
+	static const char FKey;
+};
+
+template <class T> const char sResourceTypeKey<T>::FKey = 0;
+
+/// Cached result of a typed lookup, FTyped is NULL if there is no resource of this type under the name
+struct sResourceTypeSlot
+{
+	const void*             FType;
+	iResource*              FResource;
+	void*                   FTyped;
+};
+
+/// Interned normalized path and the resources registered under it
+struct sResourceNameEntry
+{
+	LString                        FName;
+	Luint32                        FHash;
+	std::vector<iResource*>        FResources;
+	/// per-type index, cleared whenever FResources changes
+	std::vector<sResourceTypeSlot> FTypeIndex;
+	sResourceNameEntry*            FNext;
+};
+
+/**
+   Registry of all live resources.
+
+   Every resource is linked into an intrusive LRU list and, once it has a file name,
+   into a chained hash index keyed on the normalized (case-insensitive, '/'-separated) path.
+   Each normalized path is interned once: all resources sharing the same name hang off the same
+   entry. Each entry caches the results of typed lookups, so repeated lookups of the same type
+   do not cast at all. Lookups neither allocate nor convert strings.
+
+   Resources handed out by clResourcesManager are pinned until released, only unpinned
+   and unreferenced resources are evicted.
+**/
+class clResourcesRegistry
+{
+public:
+	clResourcesRegistry();
+	~clResourcesRegistry();
+
+	/// add resource to the LRU list and assign a unique resource ID
+	void       Register( iResource* Res );
+	/// remove resource from the LRU list and from the name index
+	bool       Unregister( iResource* Res );
+	/// move the resource to another name entry, called by iResource::SetFileName()
+	void       Rename( iResource* Res, const LString& NewFileName );
+
+	/// copy resources registered under the given file name without touching them, returns false if there are none
+	bool       GetResourcesByName( const LString& FileName, std::vector<iResource*>* Resources ) const;
+
+	/// find the first resource of type T with the given name and mark it as most recently used
+	template <class T> T* Find( const LString& FileName )
+	{
+		LMutex Lock( &FMutex );
+
+		sResourceNameEntry* Entry = FindEntry_NoLock( FileName );
+
+		if ( !Entry ) { return NULL; }
+
+		const void* Type = &sResourceTypeKey<T>::FKey;
+
+		for ( std::vector<sResourceTypeSlot>::const_iterator i = Entry->FTypeIndex.begin(); i != Entry->FTypeIndex.end(); ++i )
+		{
+			if ( i->FType != Type ) { continue; }
+
+			if ( i->FResource ) { Touch_NoLock( i->FResource ); }
+
+			return static_cast<T*>( i->FTyped );
+		}
+
+		// first lookup of this type under this name
+		sResourceTypeSlot Slot = { Type, NULL, NULL };
+
+		for ( std::vector<iResource*>::const_iterator i = Entry->FResources.begin(); i != Entry->FResources.end(); ++i )
+		{
+			if ( T* Res = dynamic_cast<T*>( *i ) )
+			{
+				Slot.FResource = *i;
+				Slot.FTyped    = Res;
+
+				Touch_NoLock( *i );
+
+				break;
+			}
+		}
+
+		Entry->FTypeIndex.push_back( Slot );
+
+		return static_cast<T*>( Slot.FTyped );
+	}
+
+	/// mark the resource as most recently used
+	void       Touch( iResource* Res );
+
+	/// keep the resource loaded until the matching Unpin()
+	void       Pin( iResource* Res );
+	void       Unpin( iResource* Res );
+
+	/// snapshot of all resources, most recently used first
+	void       GetResources( std::vector<iResource*>* Resources ) const;
+
+	/// unload least recently used resources until at most MaxLoaded loaded ones are left, returns the number of unloaded resources.
+	/// Pinned resources and resources referenced by anyone besides the manager are never unloaded
+	size_t     EvictLRU( size_t MaxLoaded );
+
+	size_t     GetCount() const { return FCount; }
+	size_t     GetNamesCount() const { return FNamesCount; }
+	bool       IsEmpty() const { return FCount == 0; }
+
+	/// normalize resource path: upper case, all separators converted to '/'
+	static LString NormalizeName( const LString& FileName );
+	static Luint32 HashName( const LString& FileName );
+private:
+	sResourceNameEntry* FindEntry_NoLock( const LString& FileName ) const;
+	sResourceNameEntry* InternName_NoLock( const LString& FileName );
+	void                RemoveFromEntry_NoLock( iResource* Res );
+	void                Touch_NoLock( iResource* Res );
+	void                Rehash_NoLock( size_t NewBucketsCount );
+private:
+	/// interned names are kept until the registry is destroyed, so entry pointers stay valid
+	std::vector<sResourceNameEntry*> FBuckets;
+	size_t                           FNamesCount;
+	size_t                           FCount;
+	size_t                           FNextResourceID;
+	/// intrusive LRU list, FHead is the most recently used resource
+	iResource*                       FHead;
+	iResource*                       FTail;
+	clMutex                          FMutex;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
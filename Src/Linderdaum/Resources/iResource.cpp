@@ -27,34 +27,31 @@ iResource::iResource()
 	  FAsyncComplete( true ),
 	  FFileName(),
 	  FFileTimeAtLoad( 0 ),
-	  FResourcePtr( NULL ),
-	  FResourceID( 0 )
+	  FResourceID( 0 ),
+	  FLRUPrev( NULL ),
+	  FLRUNext( NULL ),
+	  FNameEntry( NULL ),
+	  FPinCount( 0 )
 {
 }
 
 void iResource::AfterConstruction()
 {
-	FResourcePtr = this;
+	Env->Resources->FRegistry.Register( this );
 
-	FResourceID = Env->Resources->FResourcesGraph.size();
-
-	Env->Resources->FResourcesGraph.push_back( this );
+	if ( !FFileName.empty() ) { Env->Resources->FRegistry.Rename( this, FFileName ); }
 }
 
 iResource::~iResource()
 {
 	//Env->Logger->LogP( L_DEBUG, "Deleting resource %s (%s)", this->ClassName().c_str(), this->GetObjectID().c_str() );
 
-	clResourcesManager::clResourcesGraph::iterator i = std::find( Env->Resources->FResourcesGraph.begin(),
-	                                                              Env->Resources->FResourcesGraph.end(), FResourcePtr );
+	// drop the queued loading of this resource and do not let anybody wait for it
+	Env->Resources->CancelLoading( this );
 
-	if ( i != Env->Resources->FResourcesGraph.end() )
-	{
-		Env->Resources->FResourcesGraph.erase( i );
-	}
-	else
+	if ( !Env->Resources->FRegistry.Unregister( this ) )
 	{
-		Env->Logger->Log( L_WARNING, "Cannot find the resource " + this->ClassName() + "(" + this->GetObjectID() + ") in FResourcesGraph on deallocation" );
+		Env->Logger->Log( L_WARNING, "Cannot find the resource " + this->ClassName() + "(" + this->GetObjectID() + ") in resources registry on deallocation" );
 	}
 }
 
@@ -62,6 +59,9 @@ void iResource::SetAsyncLoadComplete( bool Complete ) volatile
 {
 	FResourceState = Complete ? L_RESOURCE_LOADED : L_RESOURCE_LOADING;
 	FAsyncComplete = Complete;
+
+	// the resource could have been loaded outside of the loader pool
+	if ( Complete ) { Env->Resources->ResourceLoaded(); }
 }
 
 bool iResource::Load( const LString& FileName, bool CacheResource )
@@ -108,6 +108,9 @@ void iResource::WaitLoad()
 
 	if ( !IsAsyncLoadComplete() )
 	{
+		// move this resource and its dependencies to the front of the loading queue
+		Env->Resources->PrioritizeLoading( this );
+
 		double StartTime = Env->GetSeconds();
 
 		Env->Logger->Log( L_DEBUG, "Waiting for resource " + GetFileName() + " to load" );
@@ -253,12 +256,18 @@ void iResource::SetFileName( const LString& FileName )
 		this->Connect( L_EVENT_FILE_NOTIFICATION, Utils::Bind( &iResource::Event_FILE_NOTIFICATION, this ) );
 
 		Env->FileSystem->AddFileWatch( FileName, this );
+
+		Env->Resources->FRegistry.Rename( this, FileName );
 	}
 
 	FFileName = FileName;
 };
 
 /*
+ * 17/10/2026
+     WaitLoad() prioritizes loading of the resource
+     Loading of a deleted resource is cancelled
+     Resources are tracked by clResourcesRegistry
  * 28/10/2010
      LoadFromFile()
  * 08/03/2010
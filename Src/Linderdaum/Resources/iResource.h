@@ -28,6 +28,7 @@ enum LResourceState
 };
 
 class clFileWatchHandle;
+struct sResourceNameEntry;
 
 /**
    Generic resource base class.
@@ -79,7 +80,8 @@ public:
 	virtual bool       IsSameResource( iResource* Other );
 
 	friend class clResourcesManager;
-	friend class clLoaderThread;
+	friend class clResourcesRegistry;
+	friend class clLoaderPool;
 protected:
 	virtual bool       Load( const LString& FileName, bool CacheResource );
 	/// just do a simple deserialization by default
@@ -96,12 +98,20 @@ private:
 	LString                 FFileName;
 	Lint64                  FFileTimeAtLoad;
 	size_t                  FResourceID;
-	iResource*              FResourcePtr;
+#pragma region Linkage in clResourcesRegistry
+	iResource*              FLRUPrev;
+	iResource*              FLRUNext;
+	sResourceNameEntry*     FNameEntry;
+	/// number of handed out pointers that were not released yet, pinned resources are never evicted
+	size_t                  FPinCount;
+#pragma endregion
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     Linked into clResourcesRegistry
  * 08/03/2010
      Timestamps for files
  * 17/01/2010
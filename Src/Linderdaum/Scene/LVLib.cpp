@@ -322,6 +322,27 @@ namespace LVLib
 		END_MTD()
 	}
 
+	bool SmoothVolume( int VolID, int KernelSize, float Sigma )
+	{
+		START_MTD()
+		return Volumes[VolID]->SmoothVolume( KernelSize, Sigma );
+		unguard();
+	}
+
+	clBitmap* CreateHistogram2D( int VolID, int W, int H )
+	{
+		guard( "%i,%i,%i", VolID, W, H );
+
+		if ( !IsValidID( VolID ) )
+		{
+			return NULL;
+		}
+
+		return Volumes[VolID]->CreateHistogram2D( W, H );
+
+		unguard();
+	}
+
 	bool SetProjection( int VolID, const LMatrix4& Projection )
 	{
 		START_MTD()
@@ -457,6 +478,8 @@ namespace LVLib
 #undef END_MTD
 
 /*
+ * 17/10/2026
+     SmoothVolume() and CreateHistogram2D()
  * 17/05/2009
      SetTransferFunction() instead of group of small functions
  * 06/05/2009
@@ -21,6 +21,7 @@
 class sEnvironment;
 class iTexture;
 class clImage;
+class clBitmap;
 class LVector2;
 class LVector3;
 class LVector4;
@@ -182,6 +183,26 @@ namespace LVLib
 	bool    SetESLMap( int VolID, clImage* ESLMap );
 #pragma endregion
 
+#pragma region Volume processing
+
+	/**
+	   This method smoothes the loaded 8 or 16-bit volume with the gaussian filter.
+	   The volume is processed in bricks on the engine's job system
+
+	   \param VolID - volume ID
+	   \param KernelSize - odd size of the filter kernel
+	   \param Sigma - width of the kernel exp(-r^2/Sigma^2)
+	**/
+	bool    SmoothVolume( int VolID, int KernelSize, float Sigma );
+
+	/**
+	   This method returns (density, gradient magnitude) histogram of the loaded 8 or 16-bit volume
+	   as a W x H floating point bitmap. It can be used as a background for 2D transfer function editing.
+	   NULL is returned on failure
+	**/
+	clBitmap* CreateHistogram2D( int VolID, int W, int H );
+#pragma endregion
+
 #pragma region Rendering parameters
 
 	/**
@@ -334,6 +355,8 @@ namespace LVLib
 #endif
 
 /*
+ * 17/10/2026
+     SmoothVolume() and CreateHistogram2D() on bricked volumes
  * 06/05/2009
      GetVolume()
  * 01/05/2009
@@ -12,6 +12,7 @@
 #include "Core/Logger.h"
 #include "Core/Console.h"
 #include "Core/VFS/FileSystem.h"
+#include "Images/Image.h"
 #include "Renderer/iTexture.h"
 #include "Renderer/iGPUBuffer.h"
 #include "Renderer/RenderState.h"
@@ -53,7 +54,7 @@ LString GetCorrectMapName( sEnvironment* Env, const LString& Name )
 	return "";
 }
 
-LString LoadMaterialMap( sEnvironment* Env, const LString& FileName, clRenderState* Shader, LMatSysSlot Slot, iTexture* OverridenTex, const LString& Define, LTextureType Type )
+LString LoadMaterialMap( sEnvironment* Env, const LString& FileName, clRenderState* Shader, LMatSysSlot Slot, iTexture* OverridenTex, const LString& Define, LTextureType Type, std::vector<iResource*>* Images )
 {
 	if ( OverridenTex )
 	{
@@ -64,7 +65,11 @@ LString LoadMaterialMap( sEnvironment* Env, const LString& FileName, clRenderSta
 
 	if ( !FileName.empty() )
 	{
-		Shader->SetTexture( Slot, Env->Resources->LoadImg( FileName, Type )->GetTexture(), false );
+		clImage* Image = Env->Resources->LoadImg( FileName, Type );
+
+		Shader->SetTexture( Slot, Image->GetTexture(), false );
+
+		Images->push_back( Image );
 
 		return Define;
 	}
@@ -179,12 +184,17 @@ clRenderState* sMaterialDesc::GetRenderStateForPass( sEnvironment* Env, const sM
 	*/
 	EnabledMaps += "MATSYS_" + MaterialClass + "_MATERIAL ";
 
-	EnabledMaps += LoadMaterialMap( Env, AmbientName,    Shader, L_MAT_SLOT_AMBIENT,  FAmbientMapOverride, "MATSYS_USE_AMBIENT_MAP ",  L_TEXTURE_2D );
-	EnabledMaps += LoadMaterialMap( Env, DiffuseName,    Shader, L_MAT_SLOT_DIFFUSE,  FDiffuseMapOverride, "MATSYS_USE_DIFFUSE_MAP ",  L_TEXTURE_2D );
-	EnabledMaps += LoadMaterialMap( Env, SpecularName,   Shader, L_MAT_SLOT_SPECULAR, FSpecularMapOverride, "MATSYS_USE_SPECULAR_MAP ", L_TEXTURE_2D );
-	EnabledMaps += LoadMaterialMap( Env, BumpName,       Shader, L_MAT_SLOT_BUMP,     FBumpMapOverride,    "MATSYS_USE_BUMP_MAP ",     L_TEXTURE_2D );
-	EnabledMaps += LoadMaterialMap( Env, NoiseName,      Shader, L_MAT_SLOT_NOISE,    NULL,                "",                         L_TEXTURE_3D );
-	EnabledMaps += LoadMaterialMap( Env, ReflectionName, Shader, L_MAT_SLOT_REFLECT,  FReflectionMapOverride, "MATSYS_USE_REFLECTION_MAP ", L_TEXTURE_CUBE );
+	std::vector<iResource*> Images;
+
+	EnabledMaps += LoadMaterialMap( Env, AmbientName,    Shader, L_MAT_SLOT_AMBIENT,  FAmbientMapOverride, "MATSYS_USE_AMBIENT_MAP ",  L_TEXTURE_2D, &Images );
+	EnabledMaps += LoadMaterialMap( Env, DiffuseName,    Shader, L_MAT_SLOT_DIFFUSE,  FDiffuseMapOverride, "MATSYS_USE_DIFFUSE_MAP ",  L_TEXTURE_2D, &Images );
+	EnabledMaps += LoadMaterialMap( Env, SpecularName,   Shader, L_MAT_SLOT_SPECULAR, FSpecularMapOverride, "MATSYS_USE_SPECULAR_MAP ", L_TEXTURE_2D, &Images );
+	EnabledMaps += LoadMaterialMap( Env, BumpName,       Shader, L_MAT_SLOT_BUMP,     FBumpMapOverride,    "MATSYS_USE_BUMP_MAP ",     L_TEXTURE_2D, &Images );
+	EnabledMaps += LoadMaterialMap( Env, NoiseName,      Shader, L_MAT_SLOT_NOISE,    NULL,                "",                         L_TEXTURE_3D, &Images );
+	EnabledMaps += LoadMaterialMap( Env, ReflectionName, Shader, L_MAT_SLOT_REFLECT,  FReflectionMapOverride, "MATSYS_USE_REFLECTION_MAP ", L_TEXTURE_CUBE, &Images );
+
+	// WaitLoad() on the render state waits for (and prioritizes) the maps
+	Env->Resources->AddLoadDependencies( Shader, Images );
 
 	Env->Logger->Log( L_NOTICE, "Setting transparency" );
 
@@ -283,6 +293,8 @@ bool clMaterial::IsSameResource( iResource* Other )
 }
 
 /*
+ * 17/10/2026
+     Render states of a material depend on the loading of its maps
  * 28/10/2010
      LoadFromFile() pushed up
  * 15/03/2010
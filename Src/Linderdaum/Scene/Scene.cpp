@@ -25,11 +25,13 @@
 #include "Renderer/iShaderProgram.h"
 #include "Renderer/iVertexArray.h"
 #include "Resources/ResourcesManager.h"
+#include "Utils/JobSystem.h"
 #include "Utils/Viewport.h"
 
 #include "Math/LSort.h"
 #include "Math/LPlane.h"
 #include "Math/LProjection.h"
+#include "Math/LGeomUtils.h"
 
 #include "LColors.h"
 
@@ -160,6 +162,12 @@ clScene::clScene(): FGeomsCollection( 0 ),
 	FGeomInstances( 0 ),
 	FRigids( 0 ),
 	FGlobalTransformsDirtyFlag( true ),
+	FTransformOrderDirty( true ),
+	FTransformOrder(),
+	FTransformSubtreeEnds(),
+	FTransformPositions(),
+	FDirtyTransforms(),
+	FDirtyTransformFlags(),
 	FMaterials( 0 ),
 	FMaterialMasked( 0 ),
 	FShadersNormal( 0 ),
@@ -168,7 +176,13 @@ clScene::clScene(): FGeomsCollection( 0 ),
 	FRenderBuffer( NULL ),
 	FManualOffscreenBuffer( false ),
 	FUseOffscreenBuffer( true ),
-	FUseFrustumCulling( false ),
+	FUseFrustumCulling( true ),
+	FSceneTree(),
+	FRigidProxies(),
+	FSceneTreeDirty( true ),
+	FRigidVisible(),
+	FSceneTreeQuery(),
+	FSceneTreeRayHits(),
 	FRenderOperations( 0 ),
 	FSortedSceneDirty( true ),
 	FSceneNeedsRebuild( false ),
@@ -688,6 +702,8 @@ int clScene::PushRigid( int RigidIdx, int ParentRef, int MtlRef, int GeomHandle
 {
 	FSortedSceneDirty = true;
 
+	MarkHierarchyDirty();
+
 	FRigids.FStream.push_back( clRigidInstance( sRigidID( FGeomInstances[GeomHandle].FGeomInstance, RigidIdx ), ParentRef, MtlRef ) );
 
 	return static_cast<int>( FRigids.size() ) - 1;
@@ -729,6 +745,8 @@ void clScene::RemoveItem( int Idx )
 	FSortedSceneDirty = true;
 	FSceneNeedsRebuild = true;
 
+	MarkHierarchyDirty();
+
 	// deallocate updaters
 	RemoveUpdater( Idx, NULL );
 
@@ -784,6 +802,8 @@ void clScene::RebuildSceneRigids()
 
 	FSceneNeedsRebuild = false;
 
+	MarkHierarchyDirty();
+
 	FRigids.FStream.clear();
 	FRenderOperations.FStream.clear();
 
@@ -881,28 +901,293 @@ void clScene::RecalculateGlobalTransforms()
 		return;
 	}
 
-	for ( size_t Rigid = 0; Rigid != FRigids.size(); Rigid++ )
+	// independent subtrees as the [Begin..End) pairs of positions in FTransformOrder
+	std::vector<int> Ranges;
+
+	if ( FTransformOrderDirty )
 	{
-		clRigidInstance& R = FRigids[ Rigid ];
+		RebuildTransformOrder();
 
-		int Parent = R.FParentRef;
+		// the root subtrees follow each other
+		for ( int Pos = 0; Pos != static_cast<int>( FTransformOrder.size() ); Pos = FTransformSubtreeEnds[ Pos ] )
+		{
+			Ranges.push_back( Pos );
+			Ranges.push_back( FTransformSubtreeEnds[ Pos ] );
+		}
+	}
+	else
+	{
+		// update only the subtrees of the changed nodes
+		std::vector<int> Positions;
+		Positions.reserve( FDirtyTransforms.size() );
+
+		for ( size_t i = 0; i != FDirtyTransforms.size(); i++ )
+		{
+			int Pos = FTransformPositions[ FDirtyTransforms[i] ];
 
-		LMatrix4 ParentTransform = LMatrix4::Identity();
+			if ( Pos >= 0 ) { Positions.push_back( Pos ); }
+		}
+
+		std::sort( Positions.begin(), Positions.end() );
+
+		// the subtrees of dirty descendants are already covered by their dirty ancestors
+		int CoveredUpTo = 0;
 
-		// collect local transformations of all parents
-		// NOTE: parents are leftwards of the child inside the array, so maybe we can just use FGlobalTransforms[Parent] ?
-		while ( Parent != -1 )
+		for ( size_t i = 0; i != Positions.size(); i++ )
 		{
-			ParentTransform = ParentTransform * FRigids[ Parent ].FLocalTransform;
-			Parent = FRigids[Parent].FParentRef;
+			if ( Positions[i] < CoveredUpTo ) { continue; }
+
+			CoveredUpTo = FTransformSubtreeEnds[ Positions[i] ];
+
+			Ranges.push_back( Positions[i] );
+			Ranges.push_back( CoveredUpTo );
 		}
+	}
 
-		R.FGlobalTransform = R.FLocalTransform * ParentTransform;
+	UpdateGlobalTransformRanges( Ranges );
+
+	for ( size_t i = 0; i != FDirtyTransforms.size(); i++ )
+	{
+		FDirtyTransformFlags[ FDirtyTransforms[i] ] = 0;
 	}
 
+	FDirtyTransforms.clear();
+
 	FGlobalTransformsDirtyFlag = false;
 }
 
+void clScene::RebuildTransformOrder()
+{
+	FTransformOrderDirty = false;
+
+	int NumRigids = static_cast<int>( FRigids.size() );
+
+	// children lists in the compressed form: children of the rigid i are Children[ FirstChild[i] .. FirstChild[i+1] )
+	std::vector<int> FirstChild( NumRigids + 1, 0 );
+	std::vector<int> Children( NumRigids );
+
+	for ( int i = 0; i != NumRigids; i++ )
+	{
+		int Parent = FRigids[ i ].FParentRef;
+
+		if ( Parent >= 0 && Parent < NumRigids && Parent != i ) { FirstChild[ Parent + 1 ]++; }
+	}
+
+	for ( int i = 0; i != NumRigids; i++ ) { FirstChild[ i + 1 ] += FirstChild[ i ]; }
+
+	std::vector<int> Fill( FirstChild.begin(), FirstChild.end() - 1 );
+
+	for ( int i = 0; i != NumRigids; i++ )
+	{
+		int Parent = FRigids[ i ].FParentRef;
+
+		if ( Parent >= 0 && Parent < NumRigids && Parent != i ) { Children[ Fill[ Parent ]++ ] = i; }
+	}
+
+	FTransformOrder.clear();
+	FTransformOrder.reserve( NumRigids );
+	FTransformSubtreeEnds.assign( NumRigids, 0 );
+	FTransformPositions.assign( NumRigids, -1 );
+
+	// iterative depth-first traversal from every root, the stack holds positions of the open subtrees
+	std::vector<int> Stack;
+	std::vector<int> NextChild( NumRigids, 0 );
+
+	for ( int Root = 0; Root != NumRigids; Root++ )
+	{
+		int Parent = FRigids[ Root ].FParentRef;
+
+		if ( Parent >= 0 && Parent < NumRigids && Parent != Root ) { continue; }
+
+		FTransformPositions[ Root ] = static_cast<int>( FTransformOrder.size() );
+		FTransformOrder.push_back( Root );
+		NextChild[ Root ] = FirstChild[ Root ];
+		Stack.push_back( Root );
+
+		while ( !Stack.empty() )
+		{
+			int Node = Stack.back();
+
+			if ( NextChild[ Node ] == FirstChild[ Node + 1 ] )
+			{
+				FTransformSubtreeEnds[ FTransformPositions[ Node ] ] = static_cast<int>( FTransformOrder.size() );
+				Stack.pop_back();
+				continue;
+			}
+
+			int Child = Children[ NextChild[ Node ]++ ];
+
+			FTransformPositions[ Child ] = static_cast<int>( FTransformOrder.size() );
+			FTransformOrder.push_back( Child );
+			NextChild[ Child ] = FirstChild[ Child ];
+			Stack.push_back( Child );
+		}
+	}
+
+	// rigids caught in parent cycles are not reachable and keep their old global transforms
+	FTransformSubtreeEnds.resize( FTransformOrder.size() );
+
+	FDirtyTransformFlags.assign( NumRigids, 0 );
+	FDirtyTransforms.clear();
+}
+
+namespace
+{
+	/// Below this number of rigids the jobs cost more than they save
+	const int TRANSFORMS_PARALLEL_MIN_RIGIDS = 2048;
+
+	struct sTransformRangesJob
+	{
+		clScene*                FScene;
+		const std::vector<int>* FRanges;
+	};
+}
+
+void clScene::UpdateTransformRangesProc( void* Param, size_t Begin, size_t End )
+{
+	sTransformRangesJob* Job = reinterpret_cast<sTransformRangesJob*>( Param );
+
+	for ( size_t i = Begin; i != End; i++ )
+	{
+		Job->FScene->UpdateGlobalTransforms( ( *Job->FRanges )[ 2 * i ], ( *Job->FRanges )[ 2 * i + 1 ] );
+	}
+}
+
+void clScene::UpdateGlobalTransformRanges( const std::vector<int>& Ranges )
+{
+	size_t NumRanges = Ranges.size() / 2;
+
+	int NumRigids = 0;
+
+	for ( size_t i = 0; i != NumRanges; i++ ) { NumRigids += Ranges[ 2 * i + 1 ] - Ranges[ 2 * i ]; }
+
+	clJobSystem* Jobs = Env->Jobs;
+
+	// the subtrees are disjoint and their parents are not touched here, so they can be updated in any order
+	if ( Jobs && Jobs->GetNumWorkers() > 0 && NumRanges > 1 && NumRigids >= TRANSFORMS_PARALLEL_MIN_RIGIDS )
+	{
+		sTransformRangesJob Job;
+
+		Job.FScene  = this;
+		Job.FRanges = &Ranges;
+
+		// subtrees differ in size, so make a few chunks per thread to balance them
+		size_t NumChunks = 4 * static_cast<size_t>( Jobs->GetNumWorkers() + 1 );
+
+		Jobs->ParallelFor( &UpdateTransformRangesProc, &Job, 0, NumRanges, std::max( NumRanges / NumChunks, static_cast<size_t>( 1 ) ) );
+
+		return;
+	}
+
+	for ( size_t i = 0; i != NumRanges; i++ )
+	{
+		UpdateGlobalTransforms( Ranges[ 2 * i ], Ranges[ 2 * i + 1 ] );
+	}
+}
+
+void clScene::UpdateGlobalTransforms( int Begin, int End )
+{
+	for ( int Pos = Begin; Pos != End; Pos++ )
+	{
+		clRigidInstance& R = FRigids[ FTransformOrder[ Pos ] ];
+
+		int Parent = R.FParentRef;
+
+		// parents always go before children, so their global transforms are already updated
+		bool HasParent = Parent >= 0 && Parent < static_cast<int>( FRigids.size() ) && Parent != FTransformOrder[ Pos ];
+
+		R.FGlobalTransform = HasParent ? R.FLocalTransform * FRigids[ Parent ].FGlobalTransform : R.FLocalTransform;
+	}
+}
+
+void clScene::MarkLocalTransformDirty( size_t RigidIdx )
+{
+	FGlobalTransformsDirtyFlag = true;
+
+	// the whole hierarchy will be updated anyway
+	if ( FTransformOrderDirty || RigidIdx >= FDirtyTransformFlags.size() ) { return; }
+
+	if ( FDirtyTransformFlags[ RigidIdx ] ) { return; }
+
+	FDirtyTransformFlags[ RigidIdx ] = 1;
+	FDirtyTransforms.push_back( static_cast<int>( RigidIdx ) );
+}
+
+void clScene::MarkHierarchyDirty()
+{
+	FGlobalTransformsDirtyFlag = true;
+	FTransformOrderDirty       = true;
+	FSceneTreeDirty            = true;
+}
+
+LAABoundingBox clScene::GetRigidBoundingBoxInterpolated( int RigidIdx ) const
+{
+	const clRigidInstance& Rigid = FRigids[ RigidIdx ];
+
+	LAABoundingBox Box = GetRigid( Rigid )->GetBoundingBoxInterpolated( static_cast<size_t>( Rigid.FKeyframer.GetKeyframe() ),
+	                                                                    static_cast<size_t>( Rigid.FKeyframer.GetNextKeyframe() ),
+	                                                                    Rigid.FKeyframer.GetKeyframeLerp() );
+
+	if ( !Box.IsEmpty() ) { Box.Transform( Rigid.FGlobalTransform ); }
+
+	return Box;
+}
+
+void clScene::UpdateSceneTree()
+{
+	bool Rebuild = FSceneTreeDirty;
+
+	if ( Rebuild )
+	{
+		FSceneTree.Clear();
+		FRigidProxies.assign( FRigids.size(), L_AABB_TREE_NULL );
+
+		FSceneTreeDirty = false;
+	}
+
+	for ( int i = 0; i != static_cast<int>( FRigids.size() ); i++ )
+	{
+		const clRigidInstance& Rigid = FRigids[ i ];
+
+		int& Proxy = FRigidProxies[ i ];
+
+		// keep only the rigids which have render operations
+		LAABoundingBox Box = ( Rigid.FRigid.FRigidIdx != -1 && Rigid.FVisible ) ? GetRigidBoundingBoxInterpolated( i ) : LAABoundingBox();
+
+		if ( Box.IsEmpty() )
+		{
+			if ( Proxy != L_AABB_TREE_NULL ) { FSceneTree.DestroyProxy( Proxy ); }
+
+			Proxy = L_AABB_TREE_NULL;
+		}
+		else if ( Proxy == L_AABB_TREE_NULL )
+		{
+			Proxy = FSceneTree.CreateProxy( Box, i );
+		}
+		else
+		{
+			FSceneTree.MoveProxy( Proxy, Box );
+		}
+	}
+
+	// incremental insertions give a worse tree than the top-down build
+	if ( Rebuild ) { FSceneTree.Rebuild(); }
+}
+
+void clScene::CullSceneTree( const LFrustum& Frustum )
+{
+	if ( FSceneTreeDirty ) { UpdateSceneTree(); }
+
+	FRigidVisible.assign( FRigids.size(), 0 );
+
+	FSceneTree.QueryFrustum( Frustum, &FSceneTreeQuery );
+
+	for ( size_t i = 0; i != FSceneTreeQuery.size(); i++ )
+	{
+		FRigidVisible[ FSceneTree.GetUserData( FSceneTreeQuery[i] ) ] = 1;
+	}
+}
+
 int clScene::AddGeomToParent( clGeom* Geom, int Parent )
 {
 	guard( "%s, %i", Geom->GetFileName().c_str(), Parent );
@@ -1113,7 +1398,7 @@ void clScene::SetOwner( int Idx, iObject* Owner )
 
 void clScene::Attach( int Child, int Parent )
 {
-	FGlobalTransformsDirtyFlag = true;
+	MarkHierarchyDirty();
 
 	FGeomInstances[ Child ].FParent = Parent;
 
@@ -1143,7 +1428,7 @@ void clScene::SetLocalTransform( int Idx, const LMatrix4& Transform )
 
 	FRigids[ RigidIdx ].FLocalTransform  = Transform;
 
-	FGlobalTransformsDirtyFlag = true;
+	MarkLocalTransformDirty( RigidIdx );
 }
 
 const LMatrix4& clScene::GetLocalTransform( int Idx ) const
@@ -1159,7 +1444,7 @@ void clScene::SetScaleTransform( int Idx, const LMatrix4& Transform )
 
 	FRigids[ RigidIdx ].FLocalTransform  = Transform;
 
-	FGlobalTransformsDirtyFlag = true;
+	MarkLocalTransformDirty( RigidIdx );
 }
 
 clVertexAttribs* clScene::GetRigid( const clRigidInstance& Rigid ) const
@@ -1191,34 +1476,35 @@ clVertexAttribs* clScene::PickVA( const LVector2& Pnt )
 
 int clScene::PickPair( const LVector2& Pnt )
 {
-	if ( !FUseOffscreenBuffer )
-	{
-		return -1;
-	}
-
 	double StartTime = Env->GetSeconds();
 
-	// read from ATTACHMENT1 of the render buffer
-	FRenderBuffer->BindReadFrom( 1 );
+	RecalculateGlobalTransforms();
 
-	Luint C = Env->Renderer->GetPixel( Pnt );
+	UpdateSceneTree();
 
-	FRenderBuffer->UnBind();
+	LVector3 Origin, Dir;
 
-	// decode pixel
-	uColorHasher Color;
+	MouseCoordsToWorldPointAndRay( FMatrices.GetProjectionMatrix(), FMatrices.GetViewMatrix(), Pnt.X, Pnt.Y, Origin, Dir );
 
-	// mask 3 lower bytes
-	Luint NodeNum = Color.InvHashColor( C & 0xFFFFFF ) - 1;
+	// candidates are sorted by the distance to their boxes, so we can stop at the first box behind the closest hit
+	FSceneTree.RayCast( Origin, Dir, ::Linderdaum::Math::INFINITY, &FSceneTreeRayHits );
 
-	int Rigid = static_cast<int>( NodeNum ) - 1;
+	int   Rigid = -1;
+	float BestT = ::Linderdaum::Math::INFINITY;
 
-	// check for validity
-	//
-	// NOTE: seems that if NodeNum >= FNodes.size() we've got a logic error
-	if ( NodeNum >= FRigids.size() )
+	for ( size_t i = 0; i != FSceneTreeRayHits.size(); i++ )
 	{
-		Rigid = -1;
+		if ( FSceneTreeRayHits[i].FT >= BestT ) { break; }
+
+		int RigidIdx = FSceneTree.GetUserData( FSceneTreeRayHits[i].FProxy );
+
+		float T = 0.0f;
+
+		if ( IntersectRigidWithRay( RigidIdx, Origin, Dir, &T ) && T < BestT )
+		{
+			BestT = T;
+			Rigid = RigidIdx;
+		}
 	}
 
 	FPickingTime_T->SetDouble( FPickingTime_T->GetDouble() + Env->GetSeconds() - StartTime );
@@ -1226,6 +1512,62 @@ int clScene::PickPair( const LVector2& Pnt )
 	return Rigid;
 }
 
+bool clScene::IntersectRigidWithRay( int RigidIdx, const LVector3& Origin, const LVector3& Dir, float* T ) const
+{
+	const clRigidInstance& Rigid = FRigids[ RigidIdx ];
+
+	clVertexAttribs* VA = GetRigid( Rigid );
+
+	// skinned vertices are not available on the CPU and lines have no triangles, use the animated bounding box
+	if ( VA->GetSkeletonFramesCount() > 0 || VA->GetNumTriangles() == 0 )
+	{
+		LAABoundingBox Box = GetRigidBoundingBoxInterpolated( RigidIdx );
+
+		LVector3 P1, P2;
+
+		if ( !Box.IntersectRay( Origin, Dir, P1, P2 ) ) { return false; }
+
+		*T = ( P1 - Origin ).Dot( Dir ) / Dir.SqrLength();
+
+		return true;
+	}
+
+	// test the triangles in the local space of the rigid
+	LMatrix4 Inverse = Rigid.FGlobalTransform.GetInversed();
+
+	LVector3 LocalOrigin = Inverse * Origin;
+	LVector3 LocalDir    = Inverse * ( Origin + Dir ) - LocalOrigin;
+
+	LVector3 Point;
+	int      TriangleIdx;
+
+	// large static meshes are traversed using their triangle BVH
+	if ( !VA->IntersectWithRayAndFindTriangle( LocalOrigin, LocalDir, Point, TriangleIdx ) ) { return false; }
+
+	// affine transforms keep the ray parameter
+	*T = ( Point - LocalOrigin ).Dot( LocalDir ) / LocalDir.SqrLength();
+
+	return true;
+}
+
+void clScene::QueryObjectsInBox( const LAABoundingBox& Box, std::vector<iObject*>* Objects )
+{
+	RecalculateGlobalTransforms();
+
+	UpdateSceneTree();
+
+	FSceneTree.QueryAABB( Box, &FSceneTreeQuery );
+
+	Objects->clear();
+
+	for ( size_t i = 0; i != FSceneTreeQuery.size(); i++ )
+	{
+		iObject* Owner = FRigids[ FSceneTree.GetUserData( FSceneTreeQuery[i] ) ].FOwner;
+
+		if ( Owner && std::find( Objects->begin(), Objects->end(), Owner ) == Objects->end() ) { Objects->push_back( Owner ); }
+	}
+}
+
 void clScene::AddRenderOperation( const clRigidInstance* Rigid, int RigidIdx )
 {
 	int MtlIdx = Rigid->FMaterialRef;
@@ -1386,6 +1728,8 @@ void clScene::RenderForward_Internal( iRenderTarget* ToBuffer )
 {
 	RecalculateGlobalTransforms();
 
+	UpdateSceneTree();
+
 	SortScene();
 
 	UpdateLights();
@@ -1797,6 +2141,8 @@ void clScene::RenderSortedScene( sAttribStream<clRenderOperation>* RenderOps,
 	// construct viewing frustum
 	LFrustum Frustum( FMatrices.GetProjectionMatrix(), FMatrices.GetModelViewMatrix() );
 
+	if ( FUseFrustumCulling ) { CullSceneTree( Frustum ); }
+
 	// now let's process all renderops
 	clRenderOperation* RenderOp = &( *RenderOps )[0];
 
@@ -1812,13 +2158,7 @@ void clScene::RenderSortedScene( sAttribStream<clRenderOperation>* RenderOps,
 		if ( Masked1 || Masked2 ) { continue; }
 
 		// 1. Frustum culling
-		if ( FUseFrustumCulling )
-		{
-			LAABoundingBox Box = GetBoundingBoxInterpolated( Rigid.FRigid.FGeomIdx );
-
-			// cull against entire Geom bounding box and bypass all rigids contained in this Geom
-			if ( !Frustum.IsAABBInFrustum( Box ) ) { continue; }
-		}
+		if ( FUseFrustumCulling && !FRigidVisible[ RenderOp->FRigid ] ) { continue; }
 
 		clRenderState*  Shader = Shaders->at( MtlIdx );
 		iShaderProgram* SP     = Shader->GetShaderProgram();
@@ -1842,7 +2182,7 @@ void clScene::RenderSortedScene( sAttribStream<clRenderOperation>* RenderOps,
 			clVertexAttribs* VA = GetRigid( Rigid );
 			const clJointsSet& Frame1 = VA->GetSkeletonFrame( Rigid.FKeyframer.GetKeyframe() );
 			const clJointsSet& Frame2 = VA->GetSkeletonFrame( Rigid.FKeyframer.GetNextKeyframe() );
-			VA->CalcPoints( const_cast<clJointsSet*>( &Frame1 ), const_cast<clJointsSet*>( &Frame2 ), Rigid.FKeyframer.GetKeyframeLerp() );
+			VA->CalcPoints( const_cast<clJointsSet*>( &Frame1 ), const_cast<clJointsSet*>( &Frame2 ), Rigid.FKeyframer.GetKeyframeLerp(), Env->Jobs );
 			RenderOp->FVertexArray->CommitChanges();
 		}
 
@@ -2114,6 +2454,7 @@ void clScene::RenderDeferred()
 void clScene::RenderDeferred_Internal( iRenderTarget* ToBuffer )
 {
 	RecalculateGlobalTransforms();
+	UpdateSceneTree();
 	SortScene();
 
 //	UpdateLights();
@@ -2206,6 +2547,12 @@ void clScene::DeallocateDeferredBuffers()
 }
 
 /*
+ * 17/10/2026
+     Independent transform subtrees are updated in parallel on Env->Jobs
+     Software skinning uses the job system
+     IntersectRigidWithRay() goes through clVertexAttribs::IntersectWithRayAndFindTriangle()
+     Frustum culling and picking via the scene bounding volume hierarchy, culling is on by default
+     Dirty-flag hierarchical update of global transforms
  * 15/04/2011
      SetMtlFromShader() now accepts 3 shaders for every pass
      Added SetShader()
@@ -15,6 +15,7 @@
 #include "Math/LAABB.h"
 #include "Math/LPlane.h"
 #include "Math/LFrustum.h"
+#include "Math/LAABBTree.h"
 #include "Math/LKeyframer.h"
 #include "Geometry/VertexAttribs.h"
 #include "Renderer/iRenderContext.h"
@@ -365,6 +366,8 @@ public:
 	scriptmethod iRenderTarget*    GetRenderTarget() const { return FRenderBuffer;};
 	scriptmethod iObject*          PickObject( const LVector2& Pnt );
 	scriptmethod clVertexAttribs*  PickVA( const LVector2& Pnt );
+	/// collect owners of all the visible rigids overlapping the world-space box
+	void    QueryObjectsInBox( const LAABoundingBox& Box, std::vector<iObject*>* Objects );
 
 #pragma region Callbacks
 	scriptmethod void    SetPreAddBufferCallback( LPreAddBufferCallback PreAddBufferCallback );
@@ -405,6 +408,14 @@ private:
 	int     AddMaterial( const sMaterialDesc* Material );
 	int     PushNewMaterial( const sMaterialDesc* Material );
 	void    RecalculateGlobalTransforms();
+	void    RebuildTransformOrder();
+	/// Update global transforms for the range of FTransformOrder, the parent of the first node should be up to date
+	void    UpdateGlobalTransforms( int Begin, int End );
+	/// Update the independent subtrees given as [Begin..End) pairs, in parallel on Env->Jobs if there are enough rigids
+	void    UpdateGlobalTransformRanges( const std::vector<int>& Ranges );
+	static void UpdateTransformRangesProc( void* Param, size_t Begin, size_t End );
+	void    MarkLocalTransformDirty( size_t RigidIdx );
+	void    MarkHierarchyDirty();
 	void    SetScaleTransform( int Idx, const LMatrix4& Transform );
 	void    SortScene();
 	void    UpdateLights();
@@ -413,6 +424,13 @@ private:
 	void    UpdateShaders( const LVector4* ClipPlane, clStatesList* Shaders, bool ShowNormals );
 	int     AddReflectionPlane( const LPlane& Plane );
 	int     PickPair( const LVector2& Pnt );
+	/// Exact ray test for a single rigid, returns the ray parameter of the closest hit
+	bool    IntersectRigidWithRay( int RigidIdx, const LVector3& Origin, const LVector3& Dir, float* T ) const;
+	LAABoundingBox GetRigidBoundingBoxInterpolated( int RigidIdx ) const;
+	/// Refit the scene tree to the current global transforms and animation keyframes
+	void    UpdateSceneTree();
+	/// Fill FRigidVisible using the scene tree
+	void    CullSceneTree( const LFrustum& Frustum );
 	int     PushRigid( int RigidIdx, int ParentRef, int MtlRef, int GeomHandle );
 	void    PushRigidInstances( clGeom* Geom, int ThisGeomHandle, int MtlIdx );
 	clVertexAttribs* GetRigid( const clRigidInstance& Rigid ) const;
@@ -446,6 +464,17 @@ private:
 	sAttribStream<clRigidInstance>    FRigids;
 	/// set if any of local transforms was changed
 	bool                              FGlobalTransformsDirtyFlag;
+	/// set if the hierarchy was changed, FTransformOrder should be rebuilt
+	bool                              FTransformOrderDirty;
+	/// rigids in the depth-first order, parents go before children and every subtree is a contiguous range
+	std::vector<int>                  FTransformOrder;
+	/// end of the subtree for every position in FTransformOrder
+	std::vector<int>                  FTransformSubtreeEnds;
+	/// position of every rigid in FTransformOrder or -1 if it is not reachable from any root
+	std::vector<int>                  FTransformPositions;
+	/// rigids with changed local transforms since the last update
+	std::vector<int>                  FDirtyTransforms;
+	std::vector<Lubyte>               FDirtyTransformFlags;
 #pragma endregion
 
 #pragma region Properties indexed by a Material ID
@@ -495,6 +524,17 @@ private:
 	/// enable frustum culling
 	bool              FUseFrustumCulling;
 
+	/// bounding volume hierarchy over the world-space boxes of the visible rigids
+	LAABBTree                    FSceneTree;
+	/// tree proxy of every rigid or L_AABB_TREE_NULL
+	std::vector<int>             FRigidProxies;
+	/// set if the rigids were changed and the tree should be rebuilt from scratch
+	bool                         FSceneTreeDirty;
+	/// result of the last CullSceneTree()
+	std::vector<Lubyte>          FRigidVisible;
+	std::vector<int>             FSceneTreeQuery;
+	std::vector<sAABBTreeRayHit> FSceneTreeRayHits;
+
 	/// sorted scene with all empty items deleted
 	sAttribStream<clRenderOperation> FRenderOperations;
 	bool                             FSortedSceneDirty;
@@ -569,6 +609,10 @@ public:
 #endif
 
 /*
+ * 17/10/2026
+     UpdateGlobalTransformRanges()
+     FSceneTree
+     Topological order of rigids for the transforms update
  * 15/04/2011
      SetMtlFromShader() now accepts 3 shaders for every pass - one for each pass
      Added SetShader()
@@ -16,6 +16,17 @@
 #include "Tests/Test_4.h"
 #include "Tests/Test_10.h"
 #include "Tests/Test_11.h"
+#include "Tests/Test_13.h"
+#include "Tests/Test_14.h"
+#include "Tests/Test_15.h"
+#include "Tests/Test_16.h"
+#include "Tests/Test_17.h"
+#include "Tests/Test_18.h"
+#include "Tests/Test_19.h"
+#include "Tests/Test_20.h"
+#include "Tests/Test_21.h"
+#include "Tests/Test_22.h"
+#include "Tests/Test_23.h"
 
 
 void DoAllTests( sEnvironment* Env )
@@ -31,9 +42,32 @@ void DoAllTests( sEnvironment* Env )
 	Test_9( Env );
 	Test_10( Env );
 	Test_11( Env );
+	Test_13( Env );
+	Test_14( Env );
+	Test_15( Env );
+	Test_16( Env );
+	Test_17( Env );
+	Test_18( Env );
+	Test_19( Env );
+	Test_20( Env );
+	Test_21( Env );
+	Test_22( Env );
+	Test_23( Env );
 }
 
 /*
+ * 17/10/2026
+     Test_17: BoxLite sweep-and-prune pairs against the brute force
+     Test_18: BoxLite stacks stepped with and without parallelFor are bit-identical
+     Test_19: LFFT real-to-complex against complex transforms, threaded against sequential
+     Test_20: bricked volume filters and histograms against the slicer ones
+     Test_21: jump point search against A*, 4-directional search against BFS
+     Test_22: software rasterizer depth order, fill rule, perspective correction and tiles on the job system
+     Test_23: job system sums, nested loops, dependencies, main thread jobs and shutdown
+     Test_16: triangle BVH ray casts against the brute force, BVH caching
+     Test_15: batched frustum culling against the scalar tests
+     Test_14: loader pool dependencies and cancellation
+     Test_13: LinderScript VM benchmark
  * 22/03/2005
      Autogenerated via TestGen 0.1
 */
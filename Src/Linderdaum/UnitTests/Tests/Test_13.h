@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Engine.h"
+#include "Core/Linker.h"
+#include "Core/Logger.h"
+#include "Core/Script.h"
+
+/// Assemble and link the code patch, lines are "INSTRUCTION args" or "LABEL:"
+clCodePatch* Test_13_Assemble( sEnvironment* Env, const char** Lines, const LString& Iterations )
+{
+	clCodePatch* Code = Env->Linker->Instantiate( "clCodePatch" );
+
+	LString ErrorCode;
+
+	for ( const char** Line = Lines; *Line; ++Line )
+	{
+		LString Instr = LStr::GetToken( *Line, 1 );
+		LString Args  = LString( *Line ).substr( Instr.length() );
+
+		Args = LStr::ReplaceAllSubStr( Args, "#", Iterations );
+
+		TEST_ASSERT( !Code->AssembleLine( Instr, Args, ErrorCode ) );
+	}
+
+	TEST_ASSERT( !Code->Link( ErrorCode ) );
+
+	return Code;
+}
+
+/// Run the code patch Runs times, returns the average time per run in milliseconds
+double Test_13_Run( sEnvironment* Env, clCodePatch* Code, int Runs, int* IntResult, float* FloatResult )
+{
+	clParametersList NoParams;
+
+	double StartTime = Env->GetSeconds();
+
+	for ( int i = 0; i != Runs; i++ )
+	{
+		clExecutionThread Thread;
+		Thread.Env = Env;
+
+		Thread.Execute( NULL, Code, NULL, NoParams );
+
+		*FloatResult = Thread.GetStack()->Pop<float>();
+		*IntResult   = Thread.GetStack()->Pop<int>();
+	}
+
+	return ( Env->GetSeconds() - StartTime ) * 1000.0 / Runs;
+}
+
+void Test_13( sEnvironment* Env )
+{
+	// LinderScript VM benchmark: counting loop with local variables
+	{
+		const int Iterations = 100000;
+
+		const char* Loop[] =
+		{
+			"PUSH_INT 4",
+			"DECLARE I",
+			"PUSH_INT 4",
+			"DECLARE F",
+			"PUSH_INT 0",
+			"LOAD_LOCAL_VAR_ADDRESS 0",
+			"SLOAD_INT",
+			"PUSH_FLOAT 0.0",
+			"LOAD_LOCAL_VAR_ADDRESS 1",
+			"SLOAD_FLOAT",
+			"LOOP:",
+			// I += 1
+			"PUSH_INT 1",
+			"LOAD_LOCAL_VAR_ADDRESS 0",
+			"ADD_INT_TO_INT",
+			"POP_BYTES 4",
+			// F += 0.5
+			"PUSH_FLOAT 0.5",
+			"LOAD_LOCAL_VAR_ADDRESS 1",
+			"ADD_FLT_TO_FLT",
+			"POP_BYTES 4",
+			// if ( I < Iterations ) goto LOOP
+			"PUSH_INT #",
+			"LOAD_LOCAL_VAR 0 4",
+			"LESSER_INT_INT",
+			"JMP_IF LOOP:",
+			// leave the results on the stack
+			"LOAD_LOCAL_VAR 0 4",
+			"LOAD_LOCAL_VAR 1 4",
+			"UNDECLARE",
+			"UNDECLARE",
+			NULL
+		};
+
+		clCodePatch* Code = Test_13_Assemble( Env, Loop, LStr::ToStr( Iterations ) );
+
+		int   IntResult   = 0;
+		float FloatResult = 0.0f;
+
+		double Time = Test_13_Run( Env, Code, 10, &IntResult, &FloatResult );
+
+		TEST_ASSERT( IntResult != Iterations );
+		TEST_ASSERT( FloatResult != 0.5f * Iterations );
+
+		int NumInstructions = static_cast<int>( Code->GetInstructions().size() );
+
+		Env->Logger->LogP( L_NOTICE, "VM benchmark: loop of %i iterations in %i instructions, %f ms per run", Iterations, NumInstructions, Time );
+
+		delete( Code );
+	}
+
+	// LinderScript VM benchmark: stack arithmetic without loops, the cost of entering Execute()
+	{
+		const char* Arithmetic[] =
+		{
+			"PUSH_INT 1",
+			"PUSH_INT 2",
+			"ADD_INT_INT",
+			"PUSH_INT 3",
+			"MUL_INT_INT",
+			"PUSH_FLOAT 1.5",
+			"PUSH_FLOAT 2.0",
+			"MUL_FLT_FLT",
+			NULL
+		};
+
+		clCodePatch* Code = Test_13_Assemble( Env, Arithmetic, "" );
+
+		int   IntResult   = 0;
+		float FloatResult = 0.0f;
+
+		double Time = Test_13_Run( Env, Code, 100000, &IntResult, &FloatResult );
+
+		TEST_ASSERT( IntResult != 9 );
+		TEST_ASSERT( FloatResult != 3.0f );
+
+		Env->Logger->LogP( L_NOTICE, "VM benchmark: short arithmetic patch, %f ms per run", Time );
+
+		delete( Code );
+	}
+}
+
+/*
+ * 17/10/2026
+     It's here
+*/
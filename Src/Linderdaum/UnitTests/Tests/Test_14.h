@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Engine.h"
+#include "Core/Logger.h"
+#include "Images/Image.h"
+#include "Resources/ResourcesManager.h"
+#include "Utils/Mutex.h"
+
+#include <algorithm>
+
+/// Load operation which only records the order of loading
+class Test_14_Op: public clLoaderPool::iLoadOp
+{
+public:
+	Test_14_Op( iResource* Resource, int Index, std::vector<int>* Order, clMutex* Mutex )
+		: FResource( Resource ), FIndex( Index ), FOrder( Order ), FMutex( Mutex ) {};
+
+	virtual void Load()
+	{
+		{
+			LMutex Lock( FMutex );
+
+			FOrder->push_back( FIndex );
+		}
+
+		FResource->SetAsyncLoadComplete( true );
+	}
+	virtual iResource* GetResource() const { return FResource; };
+private:
+	iResource*        FResource;
+	int               FIndex;
+	std::vector<int>* FOrder;
+	clMutex*          FMutex;
+};
+
+/// Wait (with a timeout) until the loader threads complete the resource
+bool Test_14_WaitFor( sEnvironment* Env, iResource* Resource )
+{
+	double StartTime = Env->GetSeconds();
+
+	while ( !Resource->IsAsyncLoadComplete() )
+	{
+		if ( Env->GetSeconds() - StartTime > 10.0 ) { return false; }
+
+		Env->ReleaseTimeslice( 1 );
+	}
+
+	return true;
+}
+
+bool Test_14_WasLoaded( std::vector<int>* Order, clMutex* Mutex, int Index )
+{
+	LMutex Lock( Mutex );
+
+	return std::find( Order->begin(), Order->end(), Index ) != Order->end();
+}
+
+void Test_14( sEnvironment* Env )
+{
+	std::vector<int> Order;
+	clMutex          Mutex;
+
+	clImage* R[9];
+
+	for ( int i = 0; i != 9; i++ )
+	{
+		R[i] = Env->Resources->CreateImage();
+		R[i]->SetAsyncLoadComplete( false );
+	}
+
+	// dependencies are loaded first, whatever the order of enqueueing: 0 <- 1 <- 2
+	{
+		Test_14_Op* Op2 = new Test_14_Op( R[2], 2, &Order, &Mutex );
+		Op2->AddDependency( R[1] );
+		Env->Resources->EnqueueLoading( Op2 );
+
+		Test_14_Op* Op1 = new Test_14_Op( R[1], 1, &Order, &Mutex );
+		Op1->AddDependency( R[0] );
+		Env->Resources->EnqueueLoading( Op1 );
+
+		Env->Resources->EnqueueLoading( new Test_14_Op( R[0], 0, &Order, &Mutex ) );
+
+		TEST_ASSERT( !Test_14_WaitFor( Env, R[2] ) );
+
+		LMutex Lock( &Mutex );
+
+		TEST_ASSERT( Order.size() != 3 );
+		TEST_ASSERT( Order[0] != 0 || Order[1] != 1 || Order[2] != 2 );
+	}
+
+	// the dependency is loaded outside of the pool: 4 <- 3
+	{
+		Test_14_Op* Op3 = new Test_14_Op( R[3], 3, &Order, &Mutex );
+		Op3->AddDependency( R[4] );
+		Env->Resources->EnqueueLoading( Op3 );
+
+		Env->ReleaseTimeslice( 50 );
+
+		TEST_ASSERT( R[3]->IsAsyncLoadComplete() );
+
+		R[4]->SetAsyncLoadComplete( true );
+
+		TEST_ASSERT( !Test_14_WaitFor( Env, R[3] ) );
+	}
+
+	// cancelled operation leaves the resource with its default content: 6 <- 5
+	{
+		Test_14_Op* Op5 = new Test_14_Op( R[5], 5, &Order, &Mutex );
+		Op5->AddDependency( R[6] );
+		Env->Resources->EnqueueLoading( Op5 );
+
+		Env->Resources->CancelLoading( R[5] );
+
+		TEST_ASSERT( !R[5]->IsAsyncLoadComplete() );
+		TEST_ASSERT( Test_14_WasLoaded( &Order, &Mutex, 5 ) );
+	}
+
+	// deleting an unloaded resource releases its dependants: 6 <- 7
+	{
+		Test_14_Op* Op7 = new Test_14_Op( R[7], 7, &Order, &Mutex );
+		Op7->AddDependency( R[6] );
+		Env->Resources->EnqueueLoading( Op7 );
+
+		R[6]->DisposeObject();
+		R[6] = NULL;
+
+		TEST_ASSERT( !Test_14_WaitFor( Env, R[7] ) );
+		TEST_ASSERT( !Test_14_WasLoaded( &Order, &Mutex, 7 ) );
+	}
+
+	// cancellation token
+	{
+		clPtr<clLoadCancelToken> Token( new clLoadCancelToken() );
+		Token->Cancel();
+
+		Test_14_Op* Op8 = new Test_14_Op( R[8], 8, &Order, &Mutex );
+		Op8->SetCancelToken( Token );
+		Env->Resources->EnqueueLoading( Op8 );
+
+		TEST_ASSERT( !Test_14_WaitFor( Env, R[8] ) );
+		TEST_ASSERT( Test_14_WasLoaded( &Order, &Mutex, 8 ) );
+	}
+
+	for ( int i = 0; i != 9; i++ )
+	{
+		if ( R[i] ) { R[i]->DisposeObject(); }
+	}
+}
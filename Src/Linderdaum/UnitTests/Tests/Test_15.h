@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Engine.h"
+#include "Math/LAABBTree.h"
+#include "Math/LBoundsArray.h"
+#include "Math/LFrustum.h"
+#include "Math/LProjection.h"
+#include "Math/LRandom.h"
+
+#include <algorithm>
+
+/// Distance from the box to the closest of the masked planes, the batched and scalar tests may legitimately differ near zero
+float Test_15_MinPlaneDistance( const LFrustum& Frustum, const LAABoundingBox& Box, int PlaneMask )
+{
+	float MinDistance = 1e30f;
+
+	for ( int p = 0; p != 6; p++ )
+	{
+		if ( !( PlaneMask & ( 1 << p ) ) ) { continue; }
+
+		LVector4 P = Frustum.GetPlane( p );
+
+		double D = static_cast<double>( P.X ) * ( ( P.X > 0.0f ) ? Box.FMax.X : Box.FMin.X ) +
+		           static_cast<double>( P.Y ) * ( ( P.Y > 0.0f ) ? Box.FMax.Y : Box.FMin.Y ) +
+		           static_cast<double>( P.Z ) * ( ( P.Z > 0.0f ) ? Box.FMax.Z : Box.FMin.Z ) + P.W;
+
+		MinDistance = std::min( MinDistance, static_cast<float>( fabs( D ) ) );
+	}
+
+	return MinDistance;
+}
+
+LAABoundingBox Test_15_RandomBox( float Range, float MaxSize )
+{
+	LVector3 Center( Math::RandomInRange( -Range, Range ), Math::RandomInRange( -Range, Range ), Math::RandomInRange( -Range, Range ) );
+	LVector3 Size( Math::RandomInRange( 0.0f, MaxSize ), Math::RandomInRange( 0.0f, MaxSize ), Math::RandomInRange( 0.0f, MaxSize ) );
+
+	LAABoundingBox Box;
+
+	Box.FMin = Center - Size;
+	Box.FMax = Center + Size;
+
+	return Box;
+}
+
+void Test_15( sEnvironment* Env )
+{
+	Math::Randomize( 15 );
+
+	LFrustum Frustum( Math::Perspective( 60.0f, 1.3f, 0.5f, 100.0f ),
+	                  Math::LookAt( LVector3( 3.0f, -2.0f, 1.0f ), LVector3( 0.0f, 10.0f, 2.0f ), LVector3( 0.0f, 0.0f, 1.0f ) ) );
+
+	// batched SIMD culling against the scalar test, the counts are not multiples of 4 to cover the scalar remainder
+	for ( int Run = 0; Run != 64; Run++ )
+	{
+		size_t Count = 1 + Math::Random( 1000 );
+
+		int PlaneMask = ( Run == 0 ) ? L_FRUSTUM_ALL_PLANES : Math::Random( L_FRUSTUM_ALL_PLANES + 1 );
+
+		LAABBArray Boxes;
+
+		for ( size_t i = 0; i != Count; i++ ) { Boxes.Add( Test_15_RandomBox( 50.0f, 5.0f ) ); }
+
+		std::vector<Lubyte> Visible( Count );
+
+		Frustum.CullAABBs( Boxes, &Visible[0], PlaneMask );
+
+		for ( size_t i = 0; i != Count; i++ )
+		{
+			LAABoundingBox Box = Boxes.Get( i );
+
+			int Mask = PlaneMask;
+
+			bool Expected = Frustum.IsAABBInFrustumMasked( Box, &Mask );
+
+			if ( PlaneMask == L_FRUSTUM_ALL_PLANES ) { TEST_ASSERT( Expected != Frustum.IsAABBInFrustum( Box ) ); }
+
+			// fused multiply-adds in the scalar code may flip the boxes touching a plane
+			if ( Test_15_MinPlaneDistance( Frustum, Box, PlaneMask ) < 1e-3f ) { continue; }
+
+			TEST_ASSERT( Expected != ( Visible[i] != 0 ) );
+		}
+	}
+
+	// the tree query returns the same proxies as the brute force test
+	{
+		LAABBTree Tree;
+
+		std::vector<int> Proxies;
+
+		for ( int i = 0; i != 3000; i++ ) { Proxies.push_back( Tree.CreateProxy( Test_15_RandomBox( 80.0f, 3.0f ), i ) ); }
+
+		std::vector<int> Found;
+
+		Tree.QueryFrustum( Frustum, &Found );
+
+		std::sort( Found.begin(), Found.end() );
+
+		for ( size_t i = 0; i != Proxies.size(); i++ )
+		{
+			const LAABoundingBox& Box = Tree.GetFatAABB( Proxies[i] );
+
+			if ( Test_15_MinPlaneDistance( Frustum, Box, L_FRUSTUM_ALL_PLANES ) < 1e-3f ) { continue; }
+
+			bool IsFound = std::binary_search( Found.begin(), Found.end(), Proxies[i] );
+
+			TEST_ASSERT( IsFound != Frustum.IsAABBInFrustum( Box ) );
+		}
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Engine.h"
+#include "Core/VFS/FileSystem.h"
+#include "Core/VFS/Files.h"
+#include "Geometry/TriangleBVH.h"
+#include "Geometry/VertexAttribs.h"
+#include "Math/LRandom.h"
+#include "Utils/LBlob.h"
+
+/// Closest hit by testing every triangle, returns the triangle index or -1
+int Test_16_BruteForceRayCast( const clVertexAttribs* VA, const LVector3& P, const LVector3& A, float* T )
+{
+	int Closest = -1;
+
+	*T = Linderdaum::Math::INFINITY;
+
+	LVector3 V1, V2, V3;
+
+	for ( int i = 0; i != VA->GetNumTriangles(); i++ )
+	{
+		VA->GetTriangle( i, V1, V2, V3 );
+
+		float TriT;
+
+		if ( clTriangleBVH::IntersectTriangle( P, A, V1, V2, V3, *T, &TriT ) )
+		{
+			*T = TriT;
+
+			Closest = i;
+		}
+	}
+
+	return Closest;
+}
+
+/// Ray casts through the BVH against the brute force, returns the number of mismatches
+int Test_16_CompareRayCasts( const clVertexAttribs* VA, int NumRays )
+{
+	int Mismatches = 0;
+
+	for ( int r = 0; r != NumRays; r++ )
+	{
+		LVector3 P( Math::RandomInRange( -15.0f, 15.0f ), Math::RandomInRange( -15.0f, 15.0f ), Math::RandomInRange( -15.0f, 15.0f ) );
+		LVector3 A( Math::RandomInRange( -1.0f, 1.0f ), Math::RandomInRange( -1.0f, 1.0f ), Math::RandomInRange( -1.0f, 1.0f ) );
+
+		// axis-aligned rays hit the zero components of the inverse direction
+		if ( r % 10 == 0 ) { A = LVector3( 0.0f, 0.0f, 1.0f ); }
+
+		float ExpectedT;
+		int   Expected = Test_16_BruteForceRayCast( VA, P, A, &ExpectedT );
+
+		LVector3 Hit;
+		int      Triangle = -1;
+
+		bool IsHit = VA->IntersectWithRayAndFindTriangle( P, A, Hit, Triangle );
+
+		if ( IsHit != ( Expected >= 0 ) ) { Mismatches++; continue; }
+
+		// two triangles may be hit at the same distance
+		if ( IsHit && Triangle != Expected && ( Hit - ( P + A * ExpectedT ) ).Length() > 1e-4f ) { Mismatches++; }
+
+		if ( VA->RayCastAny( P, A, Linderdaum::Math::INFINITY ) != ( Expected >= 0 ) ) { Mismatches++; }
+	}
+
+	return Mismatches;
+}
+
+void Test_16( sEnvironment* Env )
+{
+	Math::Randomize( 16 );
+
+	const int NumTriangles = 3000;
+
+	std::vector<LVector3> Vertices;
+	std::vector<int>      Indices;
+
+	for ( int i = 0; i != NumTriangles; i++ )
+	{
+		LVector3 Center( Math::RandomInRange( -10.0f, 10.0f ), Math::RandomInRange( -10.0f, 10.0f ), Math::RandomInRange( -10.0f, 10.0f ) );
+
+		for ( int k = 0; k != 3; k++ )
+		{
+			Indices.push_back( static_cast<int>( Vertices.size() ) );
+			Vertices.push_back( Center + LVector3( Math::RandomInRange( -1.0f, 1.0f ), Math::RandomInRange( -1.0f, 1.0f ), Math::RandomInRange( -1.0f, 1.0f ) ) );
+		}
+	}
+
+	clVertexAttribs* VA = clVertexAttribs::CreateFromTriangles( Indices, Vertices, 0 );
+
+	TEST_ASSERT( !VA->IsTriangleBVHWorthBuilding() );
+
+	// the BVH is built on the first query
+	TEST_ASSERT( Test_16_CompareRayCasts( VA, 1000 ) != 0 );
+	TEST_ASSERT( !VA->HasTriangleBVH() );
+
+	// the BVH is saved even if nothing was ray cast before saving, and is loaded back
+	VA->InvalidateTriangleBVH();
+
+	// large enough to never resize the blob
+	clMemFileWriter* Writer = Env->FileSystem->CreateMemFileWriter( "Test_16", 8 * 1024 * 1024 );
+
+	VA->SaveToStream( Writer );
+
+	TEST_ASSERT( !VA->HasTriangleBVH() );
+
+	clBlob* Blob = Writer->GetContainer();
+
+	iIStream* Reader = Env->FileSystem->CreateFileReaderFromMemory( "Test_16", "Test_16", Blob->GetDataConst(), Writer->GetFilePos() );
+
+	clVertexAttribs* Loaded = clVertexAttribs::CreateEmpty();
+
+	Loaded->LoadFromStream( Reader );
+
+	TEST_ASSERT( !Loaded->HasTriangleBVH() );
+	TEST_ASSERT( Test_16_CompareRayCasts( Loaded, 1000 ) != 0 );
+
+	delete( Loaded );
+	delete( VA );
+
+	Reader->DisposeObject();
+	Writer->DisposeObject();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Engine.h"
+#include "Math/LRandom.h"
+#include "Physics/BoxLite.h"
+
+#include <algorithm>
+
+typedef std::pair<Body*, Body*> Test_17_Pair;
+
+inline Test_17_Pair Test_17_MakePair( Body* B1, Body* B2 )
+{
+	return ( B1 < B2 ) ? Test_17_Pair( B1, B2 ) : Test_17_Pair( B2, B1 );
+}
+
+/// Touching pairs found by the sweep-and-prune broadphase
+void Test_17_CollectArbiters( const World& W, std::vector<Test_17_Pair>* Pairs )
+{
+	Pairs->clear();
+
+	for ( int i = 0; i != W.arbiters.Size(); i++ )
+	{
+		Pairs->push_back( Test_17_MakePair( W.arbiters[i].body1, W.arbiters[i].body2 ) );
+	}
+
+	std::sort( Pairs->begin(), Pairs->end() );
+}
+
+/// Touching pairs found by colliding every pair of bodies
+void Test_17_CollectBruteForce( const World& W, std::vector<Test_17_Pair>* Pairs )
+{
+	Pairs->clear();
+
+	for ( size_t i = 0; i != W.bodies.size(); i++ )
+	{
+		for ( size_t j = i + 1; j != W.bodies.size(); j++ )
+		{
+			Body* B1 = W.bodies[i];
+			Body* B2 = W.bodies[j];
+
+			if ( B1->invMass == 0.0f && B2->invMass == 0.0f ) { continue; }
+
+			Arbiter Arb( B1, B2 );
+
+			if ( Arb.numContacts > 0 ) { Pairs->push_back( Test_17_MakePair( B1, B2 ) ); }
+		}
+	}
+
+	std::sort( Pairs->begin(), Pairs->end() );
+}
+
+void Test_17( sEnvironment* Env )
+{
+	Math::Randomize( 17 );
+
+	// sleeping bodies keep their old contacts without colliding them again
+	bool AllowSleep = World::allowSleep;
+
+	World::allowSleep = false;
+
+	World W( Vec2( 0.0f, -10.0f ), 10 );
+
+	std::vector<Body> Bodies( 401 );
+
+	// ground
+	Bodies[0].Set( Vec2( 100.0f, 1.0f ), FLT_MAX );
+	Bodies[0].position.Set( 0.0f, -0.5f );
+
+	W.Add( &Bodies[0] );
+
+	// random boxes dropped onto the ground and onto each other
+	for ( size_t i = 1; i != Bodies.size(); i++ )
+	{
+		Bodies[i].Set( Vec2( Math::RandomInRange( 0.3f, 2.0f ), Math::RandomInRange( 0.3f, 2.0f ) ), 1.0f );
+		Bodies[i].position.Set( Math::RandomInRange( -40.0f, 40.0f ), Math::RandomInRange( 0.5f, 30.0f ) );
+		Bodies[i].rotation = Math::RandomInRange( -1.0f, 1.0f );
+
+		W.Add( &Bodies[i] );
+	}
+
+	std::vector<Test_17_Pair> SAP;
+	std::vector<Test_17_Pair> BruteForce;
+
+	for ( int Step = 0; Step != 200; Step++ )
+	{
+		// the broadphase is called once more before the step to look at its pairs, Step() repeats it for the same positions
+		W.BroadPhase();
+
+		Test_17_CollectArbiters( W, &SAP );
+		Test_17_CollectBruteForce( W, &BruteForce );
+
+		TEST_ASSERT( SAP != BruteForce );
+
+		// a teleport makes the insertion sort fall back to the full sort
+		if ( Step == 100 )
+		{
+			for ( size_t i = 1; i < Bodies.size(); i += 2 ) { Bodies[i].position.x = -Bodies[i].position.x; }
+		}
+
+		W.Step( 1.0f / 60.0f );
+	}
+
+	// removed bodies lose their contacts
+	W.bodies.resize( W.bodies.size() / 2 );
+
+	W.BroadPhase();
+
+	Test_17_CollectArbiters( W, &SAP );
+	Test_17_CollectBruteForce( W, &BruteForce );
+
+	TEST_ASSERT( SAP != BruteForce );
+
+	World::allowSleep = AllowSleep;
+}
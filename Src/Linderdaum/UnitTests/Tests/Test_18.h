@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Physics/BoxLite.h"
+#include "Utils/JobSystem.h"
+
+#include <string.h>
+
+/// Islands solved by the engine's job system
+void Test_18_JobsParallelFor( void* Context, void ( *Proc )( void* Param, size_t Begin, size_t End ), void* Param, size_t Count )
+{
+	reinterpret_cast<clJobSystem*>( Context )->ParallelFor( Proc, Param, 0, Count, 1 );
+}
+
+/// Islands solved one at a time from the last one, the result must not depend on the order
+void Test_18_ReverseParallelFor( void* /*Context*/, void ( *Proc )( void* Param, size_t Begin, size_t End ), void* Param, size_t Count )
+{
+	for ( size_t i = Count; i != 0; i-- ) { Proc( Param, i - 1, i ); }
+}
+
+/// Steps the stacks of boxes and returns the positions and rotations of all the bodies
+void Test_18_StepStacks( ParallelForFunc ParallelFor, void* Context, std::vector<float>* State )
+{
+	World W( Vec2( 0.0f, -10.0f ), 10 );
+
+	W.parallelFor     = ParallelFor;
+	W.parallelContext = Context;
+
+	const int NumStacks = 16;
+	const int StackHeight = 10;
+
+	std::vector<Body> Bodies( 1 + NumStacks * StackHeight );
+
+	// ground
+	Bodies[0].Set( Vec2( 200.0f, 1.0f ), FLT_MAX );
+	Bodies[0].position.Set( 0.0f, -0.5f );
+
+	W.Add( &Bodies[0] );
+
+	// separate stacks are separate islands
+	for ( int s = 0; s != NumStacks; s++ )
+	{
+		for ( int i = 0; i != StackHeight; i++ )
+		{
+			Body& B = Bodies[1 + s * StackHeight + i];
+
+			B.Set( Vec2( 1.0f, 1.0f ), 1.0f );
+			B.friction = 0.2f;
+			B.position.Set( -80.0f + 10.0f * s + 0.05f * ( i % 3 ), 0.51f + 1.05f * i );
+
+			W.Add( &B );
+		}
+	}
+
+	for ( int Step = 0; Step != 300; Step++ ) { W.Step( 1.0f / 60.0f ); }
+
+	State->clear();
+
+	for ( size_t i = 0; i != Bodies.size(); i++ )
+	{
+		State->push_back( Bodies[i].position.x );
+		State->push_back( Bodies[i].position.y );
+		State->push_back( Bodies[i].rotation );
+	}
+}
+
+void Test_18( sEnvironment* Env )
+{
+	bool AllowSleep = World::allowSleep;
+
+	for ( int Sleep = 0; Sleep != 2; Sleep++ )
+	{
+		World::allowSleep = ( Sleep != 0 );
+
+		std::vector<float> Sequential;
+		std::vector<float> Reversed;
+		std::vector<float> Threaded;
+
+		Test_18_StepStacks( NULL, NULL, &Sequential );
+		Test_18_StepStacks( &Test_18_ReverseParallelFor, NULL, &Reversed );
+
+		TEST_ASSERT( memcmp( &Sequential[0], &Reversed[0], Sequential.size() * sizeof( float ) ) != 0 );
+
+		if ( Env->Jobs )
+		{
+			Test_18_StepStacks( &Test_18_JobsParallelFor, Env->Jobs, &Threaded );
+
+			TEST_ASSERT( memcmp( &Sequential[0], &Threaded[0], Sequential.size() * sizeof( float ) ) != 0 );
+		}
+	}
+
+	// a moving static body pushes a sleeping box instead of passing through it
+	{
+		World::allowSleep = true;
+
+		World W( Vec2( 0.0f, -10.0f ), 10 );
+
+		Body Ground;
+		Body Box;
+		Body Pusher;
+
+		Ground.Set( Vec2( 200.0f, 1.0f ), FLT_MAX );
+		Ground.position.Set( 0.0f, -0.5f );
+
+		Box.Set( Vec2( 1.0f, 1.0f ), 1.0f );
+		Box.position.Set( 0.0f, 0.5f );
+
+		Pusher.Set( Vec2( 1.0f, 1.0f ), FLT_MAX );
+		Pusher.position.Set( -5.0f, 0.5f );
+
+		W.Add( &Ground );
+		W.Add( &Box );
+		W.Add( &Pusher );
+
+		for ( int Step = 0; Step != 120; Step++ ) { W.Step( 1.0f / 60.0f ); }
+
+		TEST_ASSERT( Box.awake );
+
+		Pusher.velocity.Set( 2.0f, 0.0f );
+
+		// the pusher moves 6 units, through the place where the box sleeps
+		for ( int Step = 0; Step != 180; Step++ ) { W.Step( 1.0f / 60.0f ); }
+
+		TEST_ASSERT( Box.position.x < Pusher.position.x + 0.9f );
+	}
+
+	World::allowSleep = AllowSleep;
+}
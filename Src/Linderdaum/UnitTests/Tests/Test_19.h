@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Images/Bitmap.h"
+#include "Math/LFFT.h"
+#include "Math/LRandom.h"
+
+#include <string.h>
+
+/// Fills the transform of Size real values, the complex one gets zero imaginary parts
+void Test_19_Fill( float* Real, float* Cplx, int Size )
+{
+	for ( int i = 0; i != Size; i++ )
+	{
+		float V = Math::RandomInRange( -1.0f, 1.0f );
+
+		Real[i] = V;
+
+		Cplx[2 * i + 0] = V;
+		Cplx[2 * i + 1] = 0.0f;
+	}
+}
+
+/// Largest difference of the unpacked real spectrum row from the first N/2+1 values of the complex row of N values
+float Test_19_MaxRowError( const float* Real, const float* Cplx, int N )
+{
+	float MaxError = 0.0f;
+
+	for ( int k = 0; k != N + 2; k++ ) { MaxError = std::max( MaxError, fabsf( Real[k] - Cplx[k] ) ); }
+
+	return MaxError;
+}
+
+/// Forward and inverse transforms with and without the job system, returns true if the results are bit-identical
+bool Test_19_IsThreadedEqual( sEnvironment* Env, LFFT* Sequential, LFFT* Threaded, float* SeqData, float* ThrData, int Size, bool IsComplex )
+{
+	for ( int i = 0; i != Size; i++ ) { SeqData[i] = ThrData[i] = Math::RandomInRange( -1.0f, 1.0f ); }
+
+	Threaded->SetJobSystem( Env->Jobs );
+
+	Sequential->Transform( false, IsComplex );
+	Threaded->Transform( false, IsComplex );
+
+	bool Forward = memcmp( SeqData, ThrData, Size * sizeof( float ) ) == 0;
+
+	Sequential->Transform( true, IsComplex );
+	Threaded->Transform( true, IsComplex );
+
+	return Forward && memcmp( SeqData, ThrData, Size * sizeof( float ) ) == 0;
+}
+
+void Test_19( sEnvironment* Env )
+{
+	Math::Randomize( 19 );
+
+	// the real transform with the unpacked spectrum against the complex one with zero imaginary parts
+	{
+		LFFT RealFFT( 256 ), ComplexFFT( 256 );
+
+		RealFFT.AllocArray( true );
+		ComplexFFT.AllocArray( true );
+
+		Test_19_Fill( RealFFT.a1D, ComplexFFT.a1D, 256 );
+
+		RealFFT.TransformRealToComplex( false );
+		ComplexFFT.TransformComplex( false );
+
+		TEST_ASSERT( Test_19_MaxRowError( RealFFT.a1D, ComplexFFT.a1D, 256 ) > 1e-4f );
+	}
+
+	{
+		LFFT RealFFT( 64, 32 ), ComplexFFT( 64, 32 );
+
+		RealFFT.AllocArray( true );
+		ComplexFFT.AllocArray( true );
+
+		for ( int i = 0; i != 64; i++ ) { Test_19_Fill( RealFFT.a2D[i], ComplexFFT.a2D[i], 32 ); }
+
+		RealFFT.TransformRealToComplex( false );
+		ComplexFFT.TransformComplex( false );
+
+		float MaxError = 0.0f;
+
+		for ( int i = 0; i != 64; i++ ) { MaxError = std::max( MaxError, Test_19_MaxRowError( RealFFT.a2D[i], ComplexFFT.a2D[i], 32 ) ); }
+
+		TEST_ASSERT( MaxError > 1e-3f );
+
+		// and back
+		RealFFT.TransformRealToComplex( true );
+		ComplexFFT.TransformComplex( true );
+
+		MaxError = 0.0f;
+
+		for ( int i = 0; i != 64; i++ )
+		{
+			for ( int j = 0; j != 32; j++ ) { MaxError = std::max( MaxError, fabsf( RealFFT.a2D[i][j] - ComplexFFT.a2D[i][2 * j] ) ); }
+		}
+
+		TEST_ASSERT( MaxError > 1e-5f );
+	}
+
+	{
+		LFFT RealFFT( 8, 16, 32 ), ComplexFFT( 8, 16, 32 );
+
+		RealFFT.AllocArray( true );
+		ComplexFFT.AllocArray( true );
+
+		for ( int i = 0; i != 8 * 16; i++ ) { Test_19_Fill( RealFFT.a3D[0][i], ComplexFFT.a3D[0][i], 32 ); }
+
+		RealFFT.TransformRealToComplex( false );
+		ComplexFFT.TransformComplex( false );
+
+		float MaxError = 0.0f;
+
+		for ( int i = 0; i != 8 * 16; i++ ) { MaxError = std::max( MaxError, Test_19_MaxRowError( RealFFT.a3D[0][i], ComplexFFT.a3D[0][i], 32 ) ); }
+
+		TEST_ASSERT( MaxError > 1e-3f );
+	}
+
+	// the row and column passes on the worker threads give the same bits as on the calling thread
+	if ( Env->Jobs )
+	{
+		LFFT Seq2D( 128, 256 ), Thr2D( 128, 256 );
+
+		Seq2D.AllocArray( true );
+		Thr2D.AllocArray( true );
+
+		TEST_ASSERT( !Test_19_IsThreadedEqual( Env, &Seq2D, &Thr2D, Seq2D.a2D[0], Thr2D.a2D[0], 128 * 256, false ) );
+		TEST_ASSERT( !Test_19_IsThreadedEqual( Env, &Seq2D, &Thr2D, Seq2D.a2D[0], Thr2D.a2D[0], 128 * 256 * 2, true ) );
+
+		LFFT Seq3D( 32, 16, 64 ), Thr3D( 32, 16, 64 );
+
+		Seq3D.AllocArray( true );
+		Thr3D.AllocArray( true );
+
+		TEST_ASSERT( !Test_19_IsThreadedEqual( Env, &Seq3D, &Thr3D, Seq3D.a3D[0][0], Thr3D.a3D[0][0], 32 * 16 * 64, false ) );
+		TEST_ASSERT( !Test_19_IsThreadedEqual( Env, &Seq3D, &Thr3D, Seq3D.a3D[0][0], Thr3D.a3D[0][0], 32 * 16 * 64 * 2, true ) );
+	}
+
+	// the untangled bitmap spectrum is the complex spectrum, including the conjugate half
+	{
+		const int W = 32;
+		const int H = 16;
+
+		clBitmap* Bmp = clBitmap::CreateBitmap( Env, W, H, 1, L_BITMAP_FLOAT32_RGBA, L_TEXTURE_2D );
+
+		LFFT ComplexFFT( W, H );
+
+		ComplexFFT.AllocArray( true );
+
+		for ( int x = 0; x != W; x++ )
+		{
+			for ( int y = 0; y != H; y++ )
+			{
+				float V = Math::RandomInRange( -1.0f, 1.0f );
+
+				Bmp->SetPixel( x, y, 0, LVector4( V, 0.0f, 0.0f, 0.0f ) );
+
+				ComplexFFT.a2D[x][2 * y + 0] = V;
+				ComplexFFT.a2D[x][2 * y + 1] = 0.0f;
+			}
+		}
+
+		ComplexFFT.TransformComplex( false );
+
+		clBitmap* Spectrum = Bmp->FFT2DAlloc();
+
+		float MaxError = 0.0f;
+
+		for ( int x = 0; x != W; x++ )
+		{
+			for ( int y = 0; y != H; y++ )
+			{
+				LVector4 V = Spectrum->GetPixel( x, y, 0 );
+
+				MaxError = std::max( MaxError, fabsf( V.X - ComplexFFT.a2D[x][2 * y + 0] ) );
+				MaxError = std::max( MaxError, fabsf( V.Y - ComplexFFT.a2D[x][2 * y + 1] ) );
+			}
+		}
+
+		TEST_ASSERT( MaxError > 1e-4f );
+
+		delete( Spectrum );
+		delete( Bmp );
+	}
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Images/RAW.h"
+#include "Images/VolumeLib.h"
+#include "Math/LRandom.h"
+
+#include <math.h>
+
+/// Runs the slicer convolution over the linear volume In, the result goes to Out
+void Test_20_SlicerConvolution( VOLUME_PTR In, VOLUME_PTR Out, int W, int H, int D, int BPP, int Size, float* Filter )
+{
+	void* InStream = VL_CreateMemoryInputStream( W * H * D * BPP, In, 0 );
+	void* Slicer = VL_CreateVolumeSlicer( W, H, D, BPP );
+
+	VL_SetInputStreamForSlicer( Slicer, InStream );
+
+	void* Writer = VL_CreateLinearVolumeWriter();
+
+	VL_SetOutputStreamForWriter( Writer, VL_CreateMemoryOutputStream( W * H * D * BPP, Out, 0 ), 1 );
+
+	int CurrentSlice = 0;
+
+	if ( BPP == 1 )
+	{
+		VL_MakeConvolution8_Single( Slicer, W, H, D, BPP, Writer, 0, D, Size, Filter, &CurrentSlice );
+	}
+	else
+	{
+		VL_MakeConvolution16_Single( Slicer, W, H, D, BPP, Writer, 0, D, Size, Filter, &CurrentSlice );
+	}
+
+	VL_DeleteVolumeWriter( Writer );
+	VL_DeleteVolumeSlicer( Slicer );
+	VL_DeleteStream( InStream );
+}
+
+/// Density histogram collected slice by slice
+void Test_20_SlicerHistogram( VOLUME_PTR In, int W, int H, int D, int BPP, std::vector<unsigned int>* Bins )
+{
+	void* InStream = VL_CreateMemoryInputStream( W * H * D * BPP, In, 0 );
+	void* Slicer = VL_CreateVolumeSlicer( W, H, D, BPP );
+
+	VL_SetInputStreamForSlicer( Slicer, InStream );
+
+	VolumeHistogram1D Hist( static_cast<int>( Bins->size() ), sizeof( unsigned int ), &( *Bins )[0], false );
+
+	int CurrentSlice = 0;
+
+	if ( BPP == 1 )
+	{
+		Hist.CollectSamples<unsigned int, unsigned char>( reinterpret_cast<VolumeSlicer*>( Slicer ), 0, D, &CurrentSlice );
+	}
+	else
+	{
+		Hist.CollectSamples<unsigned int, unsigned short>( reinterpret_cast<VolumeSlicer*>( Slicer ), 0, D, &CurrentSlice );
+	}
+
+	VL_DeleteVolumeSlicer( Slicer );
+	VL_DeleteStream( InStream );
+}
+
+/// Voxel of the linear 8-bit volume, zero outside
+inline double Test_20_Voxel( const std::vector<unsigned char>& V, int W, int H, int D, int X, int Y, int Z )
+{
+	if ( X < 0 || Y < 0 || Z < 0 || X >= W || Y >= H || Z >= D ) { return 0.0; }
+
+	return static_cast<double>( V[( Z * H + Y ) * W + X] );
+}
+
+/// Largest difference between two linear 8-bit volumes
+int Test_20_MaxError( const std::vector<unsigned char>& A, const std::vector<unsigned char>& B )
+{
+	int MaxError = 0;
+
+	for ( size_t i = 0; i != A.size(); i++ ) { MaxError = std::max( MaxError, abs( static_cast<int>( A[i] ) - static_cast<int>( B[i] ) ) ); }
+
+	return MaxError;
+}
+
+void Test_20( sEnvironment* Env )
+{
+	Math::Randomize( 20 );
+
+	// the bricks are filtered on the job system
+	clRAWLoader::InstallParallelFor( Env );
+
+	// the sizes are not multiples of the brick size, so the edge bricks are partial
+	const int W = 45;
+	const int H = 38;
+	const int D = 21;
+	const int N = W * H * D;
+	const int BrickSize = 16;
+
+	const int Size = 5;
+	const float Sigma = 1.5f;
+
+	std::vector<unsigned char> Volume8( N );
+	std::vector<unsigned short> Volume16( N );
+
+	for ( int i = 0; i != N; i++ )
+	{
+		Volume8[i] = static_cast<unsigned char>( Math::Random( 256 ) );
+		Volume16[i] = static_cast<unsigned short>( Math::Random( 65536 ) );
+	}
+
+	// the gaussian the separable filter is built from
+	std::vector<float> Filter( Size * Size * Size );
+
+	VL_PrepareGaussianFilter_Single( Size, Sigma * Sigma, &Filter[0] );
+
+	void* Bricked = VL_CreateBrickedVolume( W, H, D, 1, BrickSize );
+	void* BrickedOut = VL_CreateBrickedVolume( W, H, D, 1, BrickSize );
+
+	VL_LoadBrickedVolumeFromLinear( Bricked, &Volume8[0] );
+
+	// the layout conversion keeps every voxel
+	{
+		std::vector<unsigned char> Back( N );
+
+		VL_StoreBrickedVolumeToLinear( Bricked, &Back[0] );
+
+		TEST_ASSERT( Back != Volume8 );
+	}
+
+	// full kernel : the bricked convolution sums the same taps in the same order as the slicer one
+	std::vector<unsigned char> SlicerOut( N );
+	std::vector<unsigned char> BrickedResult( N );
+
+	Test_20_SlicerConvolution( &Volume8[0], &SlicerOut[0], W, H, D, 1, Size, &Filter[0] );
+
+	VL_MakeBrickedConvolution8_Single( Bricked, BrickedOut, Size, &Filter[0] );
+	VL_StoreBrickedVolumeToLinear( BrickedOut, &BrickedResult[0] );
+
+	TEST_ASSERT( Test_20_MaxError( SlicerOut, BrickedResult ) > 0 );
+
+	// separable kernel : the same filter up to the rounding of the intermediate passes
+	VL_MakeSeparableGaussian8_Single( Bricked, BrickedOut, Size, Sigma );
+	VL_StoreBrickedVolumeToLinear( BrickedOut, &BrickedResult[0] );
+
+	TEST_ASSERT( Test_20_MaxError( SlicerOut, BrickedResult ) > 1 );
+
+	// 8-bit density histograms
+	{
+		std::vector<unsigned int> SlicerBins( 256, 0 );
+		std::vector<unsigned int> BrickedBins( 256, 0 );
+
+		Test_20_SlicerHistogram( &Volume8[0], W, H, D, 1, &SlicerBins );
+
+		VL_CollectBrickedHistogram8( Bricked, 256, &BrickedBins[0] );
+
+		TEST_ASSERT( SlicerBins != BrickedBins );
+	}
+
+	// (density, gradient magnitude) histogram against the direct central differences
+	{
+		const int HW = 32;
+		const int HH = 24;
+
+		const double MaxValue = 255.0;
+		const double MaxGradient = 100.0;
+
+		std::vector<unsigned int> Bins( HW * HH, 0 );
+		std::vector<unsigned int> Reference( HW * HH, 0 );
+
+		VL_CollectBrickedHistogram2D8( Bricked, HW, HH, MaxValue, MaxGradient, &Bins[0] );
+
+		for ( int Z = 0; Z != D; Z++ )
+		{
+			for ( int Y = 0; Y != H; Y++ )
+			{
+				for ( int X = 0; X != W; X++ )
+				{
+					double Gx = Test_20_Voxel( Volume8, W, H, D, X + 1, Y, Z ) - Test_20_Voxel( Volume8, W, H, D, X - 1, Y, Z );
+					double Gy = Test_20_Voxel( Volume8, W, H, D, X, Y + 1, Z ) - Test_20_Voxel( Volume8, W, H, D, X, Y - 1, Z );
+					double Gz = Test_20_Voxel( Volume8, W, H, D, X, Y, Z + 1 ) - Test_20_Voxel( Volume8, W, H, D, X, Y, Z - 1 );
+
+					double G = 0.5 * sqrt( Gx * Gx + Gy * Gy + Gz * Gz );
+
+					int i = std::min( static_cast<int>( Test_20_Voxel( Volume8, W, H, D, X, Y, Z ) * ( HW - 1 ) / MaxValue ), HW - 1 );
+					int j = std::min( static_cast<int>( G * ( HH - 1 ) / MaxGradient ), HH - 1 );
+
+					Reference[j * HW + i]++;
+				}
+			}
+		}
+
+		TEST_ASSERT( Bins != Reference );
+
+		// zero ranges put every voxel into the first bins instead of dividing by zero
+		std::vector<unsigned int> Degenerate( HW * HH, 0 );
+
+		VL_CollectBrickedHistogram2D8( Bricked, HW, HH, 0.0, 0.0, &Degenerate[0] );
+
+		TEST_ASSERT( Degenerate[0] != static_cast<unsigned int>( N ) );
+	}
+
+	VL_DeleteBrickedVolume( BrickedOut );
+	VL_DeleteBrickedVolume( Bricked );
+
+	// 16-bit volumes
+	{
+		void* Bricked16 = VL_CreateBrickedVolume( W, H, D, 2, BrickSize );
+		void* BrickedOut16 = VL_CreateBrickedVolume( W, H, D, 2, BrickSize );
+
+		VL_LoadBrickedVolumeFromLinear( Bricked16, &Volume16[0] );
+
+		std::vector<unsigned short> SlicerOut16( N );
+		std::vector<unsigned short> BrickedResult16( N );
+
+		Test_20_SlicerConvolution( &Volume16[0], &SlicerOut16[0], W, H, D, 2, Size, &Filter[0] );
+
+		VL_MakeBrickedConvolution16_Single( Bricked16, BrickedOut16, Size, &Filter[0] );
+		VL_StoreBrickedVolumeToLinear( BrickedOut16, &BrickedResult16[0] );
+
+		TEST_ASSERT( SlicerOut16 != BrickedResult16 );
+
+		std::vector<unsigned int> SlicerBins( 65536, 0 );
+		std::vector<unsigned int> BrickedBins( 65536, 0 );
+
+		Test_20_SlicerHistogram( &Volume16[0], W, H, D, 2, &SlicerBins );
+
+		VL_CollectBrickedHistogram16( Bricked16, 65536, &BrickedBins[0] );
+
+		TEST_ASSERT( SlicerBins != BrickedBins );
+
+		VL_DeleteBrickedVolume( BrickedOut16 );
+		VL_DeleteBrickedVolume( Bricked16 );
+	}
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Math/LRandom.h"
+#include "World/AI/Pathfinder.h"
+
+#include <queue>
+#include <stdlib.h>
+
+/// Random passability grid
+class Test_21_Grid: public cl2DPassabilityMap
+{
+public:
+	virtual bool IsPassable( int X, int Y ) const { return FCells[Y * FWidth + X] != 0; }
+public:
+	int                  FWidth;
+	int                  FHeight;
+	std::vector<char>    FCells;
+};
+
+/// Length of the shortest 4-directional path found by the breadth-first search, -1 if there is none
+int Test_21_BFS( const Test_21_Grid& G, int XSrc, int YSrc, int XDest, int YDest )
+{
+	const int HeadingX[4] = {  0, -1, +1,  0 };
+	const int HeadingY[4] = { -1,  0,  0, +1 };
+
+	std::vector<int> Dist( G.FWidth * G.FHeight, -1 );
+	std::queue<int> Queue;
+
+	Dist[YSrc * G.FWidth + XSrc] = 0;
+	Queue.push( YSrc * G.FWidth + XSrc );
+
+	while ( !Queue.empty() )
+	{
+		int Cell = Queue.front();
+		Queue.pop();
+
+		for ( int i = 0; i != 4; i++ )
+		{
+			int X = Cell % G.FWidth + HeadingX[i];
+			int Y = Cell / G.FWidth + HeadingY[i];
+
+			if ( X < 0 || Y < 0 || X >= G.FWidth || Y >= G.FHeight ) { continue; }
+
+			int Next = Y * G.FWidth + X;
+
+			if ( !G.FCells[Next] || Dist[Next] >= 0 ) { continue; }
+
+			Dist[Next] = Dist[Cell] + 1;
+			Queue.push( Next );
+		}
+	}
+
+	return Dist[YDest * G.FWidth + XDest];
+}
+
+/// Cost of the path in the pathfinder's units (10 straight, 14 diagonal), -1 if the path is broken, cuts a corner or has unexpected diagonals, -2 if it is empty
+int Test_21_PathCost( const Test_21_Grid& G, const clPath& Path, int XSrc, int YSrc, int XDest, int YDest, bool Diagonal )
+{
+	int Num = Path.GetTotalWaypoints();
+
+	if ( Num == 0 ) { return -2; }
+
+	// waypoints go from the destination to the source
+	if ( Path.GetWaypoint( 0 ).FX != XDest || Path.GetWaypoint( 0 ).FY != YDest ) { return -1; }
+
+	if ( Path.GetWaypoint( Num - 1 ).FX != XSrc || Path.GetWaypoint( Num - 1 ).FY != YSrc ) { return -1; }
+
+	int Cost = 0;
+
+	for ( int i = 0; i != Num; i++ )
+	{
+		s2DWaypoint W = Path.GetWaypoint( i );
+
+		if ( !G.IsPassable( W.FX, W.FY ) ) { return -1; }
+
+		if ( i == 0 ) { continue; }
+
+		s2DWaypoint V = Path.GetWaypoint( i - 1 );
+
+		int AX = abs( W.FX - V.FX );
+		int AY = abs( W.FY - V.FY );
+
+		if ( AX > 1 || AY > 1 || AX + AY == 0 ) { return -1; }
+
+		if ( AX && AY )
+		{
+			if ( !Diagonal ) { return -1; }
+
+			// no corner cutting
+			if ( !G.IsPassable( W.FX, V.FY ) || !G.IsPassable( V.FX, W.FY ) ) { return -1; }
+
+			Cost += 14;
+		}
+		else
+		{
+			Cost += 10;
+		}
+	}
+
+	return Cost;
+}
+
+void Test_21( sEnvironment* Env )
+{
+	Math::Randomize( 21 );
+
+	s2DPathfinderParams AStarParams;
+	AStarParams.FDiagonalMoves = true;
+	AStarParams.FJumpPointSearch = false;
+
+	s2DPathfinderParams JPSParams;
+	JPSParams.FDiagonalMoves = true;
+	JPSParams.FJumpPointSearch = true;
+
+	clPathfinder AStar;
+	clPathfinder JPS;
+	clPathfinder Default;
+
+	AStar.SetParams( AStarParams );
+	JPS.SetParams( JPSParams );
+
+	// the default is the 4-directional search
+	TEST_ASSERT( Default.GetParams().FDiagonalMoves );
+
+	cl2DPathSearchBuffer Buffer;
+
+	for ( int t = 0; t != 3000; t++ )
+	{
+		Test_21_Grid G;
+
+		G.FWidth  = 5 + Math::Random( 39 );
+		G.FHeight = 5 + Math::Random( 39 );
+		G.FCells.resize( G.FWidth * G.FHeight );
+
+		int Density = Math::Random( 45 );
+
+		for ( size_t i = 0; i != G.FCells.size(); i++ ) { G.FCells[i] = Math::Random( 99 ) >= Density; }
+
+		int XSrc  = Math::Random( G.FWidth - 1 );
+		int YSrc  = Math::Random( G.FHeight - 1 );
+		int XDest = Math::Random( G.FWidth - 1 );
+		int YDest = Math::Random( G.FHeight - 1 );
+
+		G.FCells[YSrc * G.FWidth + XSrc] = 1;
+		G.FCells[YDest * G.FWidth + XDest] = 1;
+
+		clPath AStarPath;
+		clPath JPSPath;
+
+		bool AStarFound = AStar.FindPath2DGrid( G.FWidth, G.FHeight, XSrc, YSrc, XDest, YDest, &G, &AStarPath, &Buffer );
+		bool JPSFound = JPS.FindPath2DGrid( G.FWidth, G.FHeight, XSrc, YSrc, XDest, YDest, &G, &JPSPath, &Buffer );
+
+		// the legacy overload with the default parameters
+		clPath* Path4 = Default.FindPath2DGrid( G.FWidth, G.FHeight, XSrc, YSrc, XDest, YDest, &G );
+
+		int Steps = Test_21_BFS( G, XSrc, YSrc, XDest, YDest );
+
+		// diagonal moves never reach what the orthogonal ones can not
+		TEST_ASSERT( AStarFound != JPSFound );
+		TEST_ASSERT( AStarFound != ( Steps >= 0 ) );
+
+		// the jump point search gives a path as short as A*
+		if ( AStarFound )
+		{
+			int AStarCost = Test_21_PathCost( G, AStarPath, XSrc, YSrc, XDest, YDest, true );
+
+			TEST_ASSERT( AStarCost < 0 );
+			TEST_ASSERT( Test_21_PathCost( G, JPSPath, XSrc, YSrc, XDest, YDest, true ) != AStarCost );
+		}
+
+		// the 4-directional path is as short as the breadth-first one
+		TEST_ASSERT( Test_21_PathCost( G, *Path4, XSrc, YSrc, XDest, YDest, false ) != ( ( Steps >= 0 ) ? Steps * 10 : -2 ) );
+	}
+
+	// batched queries on the job system give the same paths as the sequential ones
+	if ( Env->Jobs )
+	{
+		Test_21_Grid G;
+
+		G.FWidth  = 128;
+		G.FHeight = 128;
+		G.FCells.resize( G.FWidth * G.FHeight );
+
+		for ( size_t i = 0; i != G.FCells.size(); i++ ) { G.FCells[i] = Math::Random( 99 ) >= 25; }
+
+		std::vector<s2DPathRequest> Sequential( 64 );
+
+		for ( size_t i = 0; i != Sequential.size(); i++ )
+		{
+			Sequential[i].FXSrc  = Math::Random( G.FWidth - 1 );
+			Sequential[i].FYSrc  = Math::Random( G.FHeight - 1 );
+			Sequential[i].FXDest = Math::Random( G.FWidth - 1 );
+			Sequential[i].FYDest = Math::Random( G.FHeight - 1 );
+		}
+
+		std::vector<s2DPathRequest> Threaded( Sequential );
+
+		JPS.FindPaths2DGrid( G.FWidth, G.FHeight, &G, &Sequential[0], Sequential.size(), NULL );
+		JPS.FindPaths2DGrid( G.FWidth, G.FHeight, &G, &Threaded[0], Threaded.size(), Env->Jobs );
+
+		for ( size_t i = 0; i != Sequential.size(); i++ )
+		{
+			TEST_ASSERT( Sequential[i].FFound != Threaded[i].FFound );
+			TEST_ASSERT( Sequential[i].FPath.GetTotalWaypoints() != Threaded[i].FPath.GetTotalWaypoints() );
+		}
+	}
+}
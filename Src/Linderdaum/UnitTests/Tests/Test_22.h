@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Images/Bitmap.h"
+#include "Math/LRandom.h"
+#include "Renderer/Soft/SoftRasterizer.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Vertex at the screen position SX, SY with the normalized depth Z, W scales the clip space position
+sSoftVertex Test_22_Vertex( int Width, int Height, float SX, float SY, float Z, float W, float U, const LVector4& Color )
+{
+	sSoftVertex V;
+
+	V.FPosition = LVector4( ( 2.0f * SX / Width - 1.0f ) * W, ( 2.0f * SY / Height - 1.0f ) * W, Z * W, W );
+	V.FTexCoord = LVector2( U, 0.0f );
+	V.FColor    = Color;
+
+	return V;
+}
+
+/// Red byte of the BGR8 pixel
+inline int Test_22_Red( const clBitmap* Bitmap, int X, int Y )
+{
+	return Bitmap->FBitmapData[ Bitmap->PixelOffset( X, Y, 0 ) + 2 ];
+}
+
+void Test_22( sEnvironment* Env )
+{
+	Math::Randomize( 22 );
+
+	// a few tiles, the last ones are partial
+	const int W = 150;
+	const int H = 100;
+
+	const LVector4 Black( 0.0f, 0.0f, 0.0f, 1.0f );
+	const LVector4 White( 1.0f, 1.0f, 1.0f, 1.0f );
+	const LVector4 Red( 1.0f, 0.0f, 0.0f, 1.0f );
+	const LVector4 Green( 0.0f, 1.0f, 0.0f, 1.0f );
+
+	clBitmap* Target = clBitmap::CreateBitmap( Env, W, H, 1, L_BITMAP_BGR8, L_TEXTURE_2D );
+
+	clSoftRasterizer Rasterizer;
+
+	Rasterizer.SetTarget( Target );
+
+	// depth ordering, in both submission orders
+	for ( int NearFirst = 0; NearFirst != 2; NearFirst++ )
+	{
+		Rasterizer.ClearColor( Black );
+		Rasterizer.ClearDepth( 1.0f );
+
+		sSoftVertex Near[3] = { Test_22_Vertex( W, H, 10, 10, -0.5f, 1.0f, 0.0f, Green ), Test_22_Vertex( W, H, 140, 20, -0.5f, 1.0f, 0.0f, Green ), Test_22_Vertex( W, H, 70, 90, -0.5f, 1.0f, 0.0f, Green ) };
+		sSoftVertex Far[3]  = { Test_22_Vertex( W, H, 5, 5, 0.5f, 2.0f, 0.0f, Red ), Test_22_Vertex( W, H, 145, 5, 0.5f, 2.0f, 0.0f, Red ), Test_22_Vertex( W, H, 75, 95, 0.5f, 2.0f, 0.0f, Red ) };
+
+		if ( NearFirst ) { Rasterizer.AddTriangle( Near[0], Near[1], Near[2] ); }
+
+		Rasterizer.AddTriangle( Far[0], Far[1], Far[2] );
+
+		if ( !NearFirst ) { Rasterizer.AddTriangle( Near[0], Near[1], Near[2] ); }
+
+		// the depth state is captured by AddTriangle(), changing it does not affect the queued triangles
+		Rasterizer.SetDepthTest( false );
+		Rasterizer.Flush();
+		Rasterizer.SetDepthTest( true );
+
+		LVector4 Center = Target->GetPixel( 70, 40, 0 );
+
+		TEST_ASSERT( Center.Y < 0.9f || Center.X > 0.1f );
+
+		// only the far triangle covers the corners
+		TEST_ASSERT( Target->GetPixel( 8, 6, 0 ).X < 0.9f );
+
+		TEST_ASSERT( fabsf( Rasterizer.GetDepth( 70, 40 ) - 0.25f ) > 1e-4f );
+	}
+
+	// top-left fill rule: a fan of triangles covers every pixel inside the rectangle exactly once.
+	// The shared edges go through the pixel centers, the outer edges do not
+	{
+		const float X0 = 8.25f;
+		const float Y0 = 6.75f;
+		const float X1 = 72.75f;
+		const float Y1 = 54.25f;
+
+		// the center and the midpoints lie on the pixel centers
+		const float CX = 40.5f;
+		const float CY = 30.5f;
+
+		const float Rim[8][2] = { { X0, Y0 }, { CX, Y0 }, { X1, Y0 }, { X1, CY }, { X1, Y1 }, { CX, Y1 }, { X0, Y1 }, { X0, CY } };
+
+		std::vector<int> Coverage( W * H, 0 );
+
+		Rasterizer.SetDepthTest( false );
+		Rasterizer.SetDepthWrite( false );
+
+		for ( int i = 0; i != 8; i++ )
+		{
+			Rasterizer.ClearColor( Black );
+
+			sSoftVertex A = Test_22_Vertex( W, H, CX, CY, 0.0f, 1.0f, 0.0f, White );
+			sSoftVertex B = Test_22_Vertex( W, H, Rim[i][0], Rim[i][1], 0.0f, 1.0f, 0.0f, White );
+			sSoftVertex C = Test_22_Vertex( W, H, Rim[( i + 1 ) % 8][0], Rim[( i + 1 ) % 8][1], 0.0f, 1.0f, 0.0f, White );
+
+			// both windings
+			if ( i & 1 ) { Rasterizer.AddTriangle( A, C, B ); }
+			else { Rasterizer.AddTriangle( A, B, C ); }
+
+			Rasterizer.Flush();
+
+			for ( int Y = 0; Y != H; Y++ )
+			{
+				for ( int X = 0; X != W; X++ )
+				{
+					if ( Test_22_Red( Target, X, Y ) ) { Coverage[ Y * W + X ]++; }
+				}
+			}
+		}
+
+		Rasterizer.SetDepthTest( true );
+		Rasterizer.SetDepthWrite( true );
+
+		int Errors = 0;
+
+		for ( int Y = 0; Y != H; Y++ )
+		{
+			for ( int X = 0; X != W; X++ )
+			{
+				float PX = X + 0.5f;
+				float PY = Y + 0.5f;
+
+				int Expected = ( PX > X0 && PX < X1 && PY > Y0 && PY < Y1 ) ? 1 : 0;
+
+				if ( Coverage[ Y * W + X ] != Expected ) { Errors++; }
+			}
+		}
+
+		TEST_ASSERT( Errors > 0 );
+	}
+
+	// perspective-correct texture coordinates: the texel index is stored in the red channel
+	clBitmap* Texture = clBitmap::CreateBitmap( Env, 256, 1, 1, L_BITMAP_BGR8, L_TEXTURE_2D );
+
+	for ( int i = 0; i != 256; i++ )
+	{
+		Lubyte* Texel = Texture->FBitmapData + Texture->PixelOffset( i, 0, 0 );
+
+		Texel[0] = 0;
+		Texel[1] = 0;
+		Texel[2] = static_cast<Lubyte>( i );
+	}
+
+	{
+		const double SX[3] = { 12.0, 140.0, 30.0 };
+		const double SY[3] = { 8.0, 30.0, 92.0 };
+		const double VW[3] = { 1.0, 6.0, 2.5 };
+		const double VU[3] = { 0.02, 0.97, 0.5 };
+
+		Rasterizer.ClearColor( Black );
+		Rasterizer.ClearDepth( 1.0f );
+		Rasterizer.SetTexture( Texture );
+
+		Rasterizer.AddTriangle( Test_22_Vertex( W, H, static_cast<float>( SX[0] ), static_cast<float>( SY[0] ), 0.0f, static_cast<float>( VW[0] ), static_cast<float>( VU[0] ), White ),
+		                        Test_22_Vertex( W, H, static_cast<float>( SX[1] ), static_cast<float>( SY[1] ), 0.0f, static_cast<float>( VW[1] ), static_cast<float>( VU[1] ), White ),
+		                        Test_22_Vertex( W, H, static_cast<float>( SX[2] ), static_cast<float>( SY[2] ), 0.0f, static_cast<float>( VW[2] ), static_cast<float>( VU[2] ), White ) );
+
+		Rasterizer.Flush();
+		Rasterizer.SetTexture( NULL );
+
+		double Area = ( SX[1] - SX[0] ) * ( SY[2] - SY[0] ) - ( SX[2] - SX[0] ) * ( SY[1] - SY[0] );
+
+		int Errors = 0;
+		int AffineErrors = 0;
+		int Inside = 0;
+
+		for ( int Y = 0; Y != H; Y++ )
+		{
+			for ( int X = 0; X != W; X++ )
+			{
+				double PX = X + 0.5;
+				double PY = Y + 0.5;
+
+				// barycentric coordinates of the pixel center
+				double B0 = ( ( SX[1] - PX ) * ( SY[2] - PY ) - ( SX[2] - PX ) * ( SY[1] - PY ) ) / Area;
+				double B1 = ( ( SX[2] - PX ) * ( SY[0] - PY ) - ( SX[0] - PX ) * ( SY[2] - PY ) ) / Area;
+				double B2 = 1.0 - B0 - B1;
+
+				// stay away from the edges, the fill rule is tested above
+				if ( B0 < 0.01 || B1 < 0.01 || B2 < 0.01 ) { continue; }
+
+				Inside++;
+
+				double U = ( B0 * VU[0] / VW[0] + B1 * VU[1] / VW[1] + B2 * VU[2] / VW[2] ) / ( B0 / VW[0] + B1 / VW[1] + B2 / VW[2] );
+				double AffineU = B0 * VU[0] + B1 * VU[1] + B2 * VU[2];
+
+				int Red = Test_22_Red( Target, X, Y );
+
+				if ( abs( Red - static_cast<int>( U * 256.0 ) ) > 1 ) { Errors++; }
+
+				if ( abs( Red - static_cast<int>( AffineU * 256.0 ) ) > 1 ) { AffineErrors++; }
+			}
+		}
+
+		TEST_ASSERT( Inside < 1000 );
+		TEST_ASSERT( Errors > 0 );
+
+		// the affine interpolation is far off, so the test does check the correction
+		TEST_ASSERT( AffineErrors < Inside / 2 );
+	}
+
+	// the job system gives exactly the same image
+	if ( Env->Jobs )
+	{
+		std::vector<sSoftVertex> Vertices;
+
+		for ( int i = 0; i != 3 * 300; i++ )
+		{
+			LVector4 Color( Math::RandomInRange( 0.0f, 1.0f ), Math::RandomInRange( 0.0f, 1.0f ), Math::RandomInRange( 0.0f, 1.0f ), 1.0f );
+
+			Vertices.push_back( Test_22_Vertex( W, H,
+			                                    Math::RandomInRange( -20.0f, W + 20.0f ), Math::RandomInRange( -20.0f, H + 20.0f ),
+			                                    Math::RandomInRange( -1.0f, 1.0f ), Math::RandomInRange( 0.5f, 4.0f ),
+			                                    Math::RandomInRange( 0.0f, 1.0f ), Color ) );
+		}
+
+		clBitmap* Images[2] = { NULL, NULL };
+
+		for ( int Pass = 0; Pass != 2; Pass++ )
+		{
+			Rasterizer.SetJobSystem( Pass ? Env->Jobs : NULL );
+
+			Rasterizer.ClearColor( Black );
+			Rasterizer.ClearDepth( 1.0f );
+
+			for ( size_t i = 0; i != Vertices.size(); i += 3 )
+			{
+				Rasterizer.SetTexture( ( i & 1 ) ? Texture : NULL );
+				Rasterizer.SetDepthWrite( ( i % 7 ) != 0 );
+
+				Rasterizer.AddTriangle( Vertices[i], Vertices[i + 1], Vertices[i + 2] );
+			}
+
+			Rasterizer.Flush();
+
+			Images[ Pass ] = Target->MakeCopy();
+		}
+
+		Rasterizer.SetJobSystem( NULL );
+		Rasterizer.SetTexture( NULL );
+		Rasterizer.SetDepthWrite( true );
+
+		TEST_ASSERT( memcmp( Images[0]->FBitmapData, Images[1]->FBitmapData, W * H * 3 ) != 0 );
+
+		delete( Images[0] );
+		delete( Images[1] );
+	}
+
+	Rasterizer.SetTarget( NULL );
+
+	delete( Texture );
+	delete( Target );
+}
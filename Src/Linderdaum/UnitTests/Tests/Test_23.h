@@ -0,0 +1,296 @@
+#pragma once
+
+#include "Engine.h"
+#include "Environment.h"
+#include "Utils/JobSystem.h"
+#include "Utils/Mutex.h"
+
+/// Sum shared by all the jobs
+struct sTest_23_Sum
+{
+	clMutex  FMutex;
+	Lint64   FSum;
+	int      FCount;
+	/// number of jobs executed on the main thread
+	int      FOnMainThread;
+	clJobSystem* FJobs;
+};
+
+struct sTest_23_Item
+{
+	sTest_23_Sum* FSum;
+	Lint64        FValue;
+};
+
+void Test_23_AddProc( void* Param )
+{
+	sTest_23_Item* Item = reinterpret_cast<sTest_23_Item*>( Param );
+
+	LMutex Lock( &Item->FSum->FMutex );
+
+	Item->FSum->FSum += Item->FValue;
+	Item->FSum->FCount++;
+
+	if ( Item->FSum->FJobs->IsMainThread() ) { Item->FSum->FOnMainThread++; }
+}
+
+/// Nested parallel loops: every row runs its own ParallelFor over the columns
+struct sTest_23_Rows
+{
+	clJobSystem*      FJobs;
+	size_t            FWidth;
+	std::vector<int>* FCells;
+};
+
+struct sTest_23_Row
+{
+	const sTest_23_Rows* FRows;
+	size_t               FRow;
+};
+
+void Test_23_RowCellsProc( void* Param, size_t Begin, size_t End )
+{
+	const sTest_23_Row* Row = reinterpret_cast<const sTest_23_Row*>( Param );
+
+	for ( size_t i = Begin; i != End; i++ ) { ( *Row->FRows->FCells )[ Row->FRow * Row->FRows->FWidth + i ]++; }
+}
+
+void Test_23_NestedRowsProc( void* Param, size_t Begin, size_t End )
+{
+	const sTest_23_Rows* Rows = reinterpret_cast<const sTest_23_Rows*>( Param );
+
+	for ( size_t j = Begin; j != End; j++ )
+	{
+		sTest_23_Row Row = { Rows, j };
+
+		Rows->FJobs->ParallelFor( &Test_23_RowCellsProc, &Row, 0, Rows->FWidth, 8 );
+	}
+}
+
+/// Keeps the job busy for a while, so the jobs started too early overlap with it
+void Test_23_Spin()
+{
+	volatile int Counter = 0;
+
+	for ( int i = 0; i != 100000; i++ ) { Counter++; }
+}
+
+/// Link of a dependency chain, appends its index to the shared order
+struct sTest_23_Link
+{
+	clMutex*          FMutex;
+	std::vector<int>* FOrder;
+	int               FIndex;
+};
+
+void Test_23_LinkProc( void* Param )
+{
+	sTest_23_Link* Link = reinterpret_cast<sTest_23_Link*>( Param );
+
+	Test_23_Spin();
+
+	LMutex Lock( Link->FMutex );
+
+	Link->FOrder->push_back( Link->FIndex );
+}
+
+/// Second stage job: sums what the first stage has written
+struct sTest_23_Stage
+{
+	const std::vector<Lint64>* FFirst;
+	Lint64                     FResult;
+};
+
+void Test_23_FirstStageProc( void* Param )
+{
+	Lint64* Value = reinterpret_cast<Lint64*>( Param );
+
+	Test_23_Spin();
+
+	*Value = 1;
+}
+
+void Test_23_SecondStageProc( void* Param )
+{
+	sTest_23_Stage* Stage = reinterpret_cast<sTest_23_Stage*>( Param );
+
+	Stage->FResult = 0;
+
+	for ( size_t i = 0; i != Stage->FFirst->size(); i++ ) { Stage->FResult += ( *Stage->FFirst )[i]; }
+}
+
+void Test_23( sEnvironment* Env )
+{
+	const int NumJobs = 20000;
+
+	std::vector<sTest_23_Item> Items( NumJobs );
+
+	Lint64 ExpectedSum = 0;
+
+	for ( int i = 0; i != NumJobs; i++ )
+	{
+		Items[i].FValue = i;
+		ExpectedSum += i;
+	}
+
+	// without the workers the jobs run on the main thread while it waits
+	const int WorkerCounts[2] = { 0, 3 };
+
+	for ( int Pass = 0; Pass != 2; Pass++ )
+	{
+		const int NumWorkers = WorkerCounts[ Pass ];
+
+		clJobSystem Jobs;
+
+		Jobs.Start( Env, NumWorkers );
+
+		TEST_ASSERT( Jobs.GetNumWorkers() != NumWorkers );
+
+		// many jobs adding to a shared sum
+		{
+			sTest_23_Sum Sum;
+
+			Sum.FSum = 0;
+			Sum.FCount = 0;
+			Sum.FOnMainThread = 0;
+			Sum.FJobs = &Jobs;
+
+			clJobCounter Counter;
+
+			for ( int i = 0; i != NumJobs; i++ )
+			{
+				Items[i].FSum = &Sum;
+
+				Jobs.AddJob( &Test_23_AddProc, &Items[i], &Counter, NULL );
+			}
+
+			Jobs.Wait( &Counter );
+
+			TEST_ASSERT( !Jobs.IsDone( &Counter ) );
+			TEST_ASSERT( Sum.FCount != NumJobs );
+			TEST_ASSERT( Sum.FSum != ExpectedSum );
+		}
+
+		// nested parallel loops
+		{
+			const size_t Width = 300;
+			const size_t Height = 70;
+
+			std::vector<int> Cells( Width * Height, 0 );
+
+			sTest_23_Rows Rows = { &Jobs, Width, &Cells };
+
+			Jobs.ParallelFor( &Test_23_NestedRowsProc, &Rows, 0, Height, 1 );
+
+			int Errors = 0;
+
+			for ( size_t i = 0; i != Cells.size(); i++ ) { if ( Cells[i] != 1 ) { Errors++; } }
+
+			TEST_ASSERT( Errors > 0 );
+		}
+
+		// dependency counters: the second stage sees everything the first stage has written
+		{
+			const int NumFirst = 64;
+			const int NumSecond = 50;
+
+			std::vector<Lint64> First( NumFirst, 0 );
+			std::vector<sTest_23_Stage> Second( NumSecond );
+
+			clJobCounter FirstDone;
+			clJobCounter SecondDone;
+
+			for ( int i = 0; i != NumFirst; i++ ) { Jobs.AddJob( &Test_23_FirstStageProc, &First[i], &FirstDone, NULL ); }
+
+			for ( int i = 0; i != NumSecond; i++ )
+			{
+				Second[i].FFirst = &First;
+				Second[i].FResult = -1;
+
+				Jobs.AddJob( &Test_23_SecondStageProc, &Second[i], &SecondDone, &FirstDone );
+			}
+
+			Jobs.Wait( &SecondDone );
+
+			TEST_ASSERT( !Jobs.IsDone( &FirstDone ) );
+
+			for ( int i = 0; i != NumSecond; i++ ) { TEST_ASSERT( Second[i].FResult != NumFirst ); }
+
+			// a chain: every link waits for the previous one
+			const int NumLinks = 100;
+
+			clMutex OrderMutex;
+			std::vector<int> Order;
+			std::vector<sTest_23_Link> Links( NumLinks );
+			std::vector<clJobCounter> LinkDone( NumLinks );
+
+			for ( int i = 0; i != NumLinks; i++ )
+			{
+				Links[i].FMutex = &OrderMutex;
+				Links[i].FOrder = &Order;
+				Links[i].FIndex = i;
+
+				Jobs.AddJob( &Test_23_LinkProc, &Links[i], &LinkDone[i], i ? &LinkDone[i - 1] : NULL );
+			}
+
+			Jobs.Wait( &LinkDone[ NumLinks - 1 ] );
+
+			TEST_ASSERT( static_cast<int>( Order.size() ) != NumLinks );
+
+			for ( size_t i = 0; i != Order.size(); i++ ) { TEST_ASSERT( Order[i] != static_cast<int>( i ) ); }
+		}
+
+		// main thread jobs wait for RunMainThreadJobs()
+		{
+			const int NumMainJobs = 100;
+
+			sTest_23_Sum Sum;
+
+			Sum.FSum = 0;
+			Sum.FCount = 0;
+			Sum.FOnMainThread = 0;
+			Sum.FJobs = &Jobs;
+
+			for ( int i = 0; i != NumMainJobs; i++ )
+			{
+				Items[i].FSum = &Sum;
+
+				Jobs.AddMainThreadJob( &Test_23_AddProc, &Items[i], NULL, NULL );
+			}
+
+			TEST_ASSERT( Sum.FCount != 0 );
+
+			Jobs.RunMainThreadJobs();
+
+			TEST_ASSERT( Sum.FCount != NumMainJobs );
+			TEST_ASSERT( Sum.FOnMainThread != NumMainJobs );
+		}
+
+		// the jobs still queued are executed by Shutdown()
+		{
+			sTest_23_Sum Sum;
+
+			Sum.FSum = 0;
+			Sum.FCount = 0;
+			Sum.FOnMainThread = 0;
+			Sum.FJobs = &Jobs;
+
+			const int NumMainJobs = 10;
+
+			for ( int i = 0; i != NumJobs; i++ )
+			{
+				Items[i].FSum = &Sum;
+
+				if ( i < NumMainJobs ) { Jobs.AddMainThreadJob( &Test_23_AddProc, &Items[i], NULL, NULL ); }
+				else { Jobs.AddJob( &Test_23_AddProc, &Items[i], NULL, NULL ); }
+			}
+
+			Jobs.Shutdown();
+
+			TEST_ASSERT( Jobs.GetNumWorkers() != 0 );
+			TEST_ASSERT( Sum.FCount != NumJobs );
+			TEST_ASSERT( Sum.FSum != ExpectedSum );
+			TEST_ASSERT( Sum.FOnMainThread < NumMainJobs );
+		}
+	}
+}
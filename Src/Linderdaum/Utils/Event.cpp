@@ -15,19 +15,102 @@
 #include "Utils/Utils.h"
 #include "Generated/AsyncCapsule.h"
 
+namespace
+{
+	inline void EventsMemoryBarrier()
+	{
+#if defined( OS_WINDOWS )
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	/// Counts the sends in progress, so the replaced handler lists are not deleted under them
+	class clSendScope
+	{
+	public:
+		explicit clSendScope( volatile long* Counter ): FCounter( Counter )
+		{
+#if defined( OS_WINDOWS )
+			InterlockedIncrement( FCounter );
+#else
+			__sync_fetch_and_add( FCounter, 1 );
+#endif
+		}
+		~clSendScope()
+		{
+#if defined( OS_WINDOWS )
+			InterlockedDecrement( FCounter );
+#else
+			__sync_fetch_and_sub( FCounter, 1 );
+#endif
+		}
+	private:
+		volatile long* FCounter;
+	};
+
+	inline long EventsAtomicIncrement( volatile long* Value )
+	{
+#if defined( OS_WINDOWS )
+		return InterlockedIncrement( Value );
+#else
+		return __sync_add_and_fetch( Value, 1 );
+#endif
+	}
+
+	inline bool EventsCompareAndSwap( void* volatile* Ptr, void* Expected, void* NewValue )
+	{
+#if defined( OS_WINDOWS )
+		return InterlockedCompareExchangePointer( Ptr, NewValue, Expected ) == Expected;
+#else
+		return __sync_bool_compare_and_swap( Ptr, Expected, NewValue );
+#endif
+	}
+}
+
 LEventSubscriber::sHandler::sHandler( LEvent Event, const LEventHandler& Handler, int Priority )
 	: FEvent( Event ),
 	  FHandler( Handler ),
 	  FObject( reinterpret_cast<iObject*>( Handler.GetObjectPtr() ) ),
-	  FPriority( Priority ), FTag( -1 )
+	  FPriority( Priority ), FTag( -1 ), FSerial( 0 )
+{
+}
+
+LEventSubscriber::LEventSubscriber()
+	: FRetired(),
+	  FActiveSends( 0 ),
+	  FNextSerial( 0 ),
+	  FPendingClear( false )
+{
+	for ( int i = 0; i <= L_EVENT_INVALID; i++ ) { FBuckets[i] = NULL; }
+}
+
+LEventSubscriber::LEventSubscriber( LEvent /*Event*/ )
+	: FRetired(),
+	  FActiveSends( 0 ),
+	  FNextSerial( 0 ),
+	  FPendingClear( false )
+{
+	for ( int i = 0; i <= L_EVENT_INVALID; i++ ) { FBuckets[i] = NULL; }
+}
+
+LEventSubscriber::~LEventSubscriber()
 {
+	for ( int i = 0; i <= L_EVENT_INVALID; i++ ) { delete( FBuckets[i] ); }
+
+	for ( std::vector<clHandlersList*>::iterator i = FRetired.begin(); i != FRetired.end(); ++i ) { delete( *i ); }
 }
 
 bool LEventSubscriber::IsConnected( LEvent Event, const LEventHandler& Handler ) const
 {
 	LMutex Lock( &FMutex );
 
-	for ( std::vector<sHandler>::const_iterator i = FHandlers.begin(); i != FHandlers.end(); ++i )
+	const clHandlersList* Handlers = FBuckets[ GetBucket( Event ) ];
+
+	if ( !Handlers ) { return false; }
+
+	for ( clHandlersList::const_iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 	{
 		if ( ( *i ).FEvent == Event && ( *i ).FHandler.IsEqual( Handler ) )
 		{
@@ -40,19 +123,20 @@ bool LEventSubscriber::IsConnected( LEvent Event, const LEventHandler& Handler )
 
 void LEventSubscriber::Connect( LEvent Event, const LEventHandler& Handler )
 {
-	ConnectWithPriority( Event, Handler, 0 );
+	Insert( Event, Handler, 0, -1 );
 }
 
 void LEventSubscriber::ConnectWithTag( LEvent Event, const LEventHandler& Handler, int Tag )
 {
-	Lint64 i = ConnectWithPriority( Event, Handler, 0 );
-
-	LMutex Lock( &FMutex );
-
-	if ( i >= 0 ) { FHandlers[ static_cast<Luint>( i ) ].FTag = Tag; }
+	Insert( Event, Handler, 0, Tag );
 }
 
 Lint64 LEventSubscriber::ConnectWithPriority( LEvent Event, const LEventHandler& Handler, int Priority )
+{
+	return Insert( Event, Handler, Priority, -1 );
+}
+
+Lint64 LEventSubscriber::Insert( LEvent Event, const LEventHandler& Handler, int Priority, int Tag )
 {
 	if ( IsConnected( Event, Handler ) )
 	{
@@ -61,10 +145,16 @@ Lint64 LEventSubscriber::ConnectWithPriority( LEvent Event, const LEventHandler&
 
 	LMutex Lock( &FMutex );
 
+	int Bucket = GetBucket( Event );
+
+	const clHandlersList* Handlers = FBuckets[ Bucket ];
+
+	clHandlersList* NewList = Handlers ? new clHandlersList( *Handlers ) : new clHandlersList();
+
 	// insert according to priority class
-	std::vector<sHandler>::iterator InsertPos = FHandlers.begin();
+	clHandlersList::iterator InsertPos = NewList->begin();
 
-	for ( ; InsertPos != FHandlers.end(); ++InsertPos )
+	for ( ; InsertPos != NewList->end(); ++InsertPos )
 	{
 		if ( ( *InsertPos ).FPriority > Priority )
 		{
@@ -72,20 +162,39 @@ Lint64 LEventSubscriber::ConnectWithPriority( LEvent Event, const LEventHandler&
 		}
 	}
 
-	InsertPos = FHandlers.insert( InsertPos, sHandler( Event, Handler, Priority ) );
+	sHandler NewHandler( Event, Handler, Priority );
+
+	NewHandler.FTag    = Tag;
+	NewHandler.FSerial = FNextSerial++;
 
-	return ( InsertPos - FHandlers.begin() );
+	InsertPos = NewList->insert( InsertPos, NewHandler );
+
+	Lint64 Index = InsertPos - NewList->begin();
+
+	ReplaceList_NoLock( Bucket, NewList );
+
+	return Index;
 }
 
 void LEventSubscriber::Disconnect( LEvent Event, const LEventHandler& Handler )
 {
 	LMutex Lock( &FMutex );
 
-	for ( std::vector<sHandler>::iterator i = FHandlers.begin(); i != FHandlers.end(); ++i )
+	int Bucket = GetBucket( Event );
+
+	const clHandlersList* Handlers = FBuckets[ Bucket ];
+
+	if ( !Handlers ) { return; }
+
+	for ( clHandlersList::const_iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 	{
 		if ( ( *i ).FEvent == Event && ( *i ).FHandler.IsEqual( Handler ) )
 		{
-			FHandlers.erase( i );
+			clHandlersList* NewList = new clHandlersList( *Handlers );
+
+			NewList->erase( NewList->begin() + ( i - Handlers->begin() ) );
+
+			ReplaceList_NoLock( Bucket, NewList );
 
 			return;
 		}
@@ -96,15 +205,45 @@ void LEventSubscriber::DisconnectObject( iObject* Object )
 {
 	LMutex Lock( &FMutex );
 
-	for ( std::vector<sHandler>::iterator i = FHandlers.begin(); i != FHandlers.end(); ++i )
+	// only the first handler of the object in the sending order is removed
+	int    FoundBucket = -1;
+	size_t FoundIndex  = 0;
+
+	for ( int b = 0; b <= L_EVENT_INVALID; b++ )
 	{
-		if ( ( *i ).FHandler.IsObject( Object ) )
+		const clHandlersList* Handlers = FBuckets[ b ];
+
+		if ( !Handlers ) { continue; }
+
+		for ( size_t i = 0; i != Handlers->size(); i++ )
 		{
-			FHandlers.erase( i );
+			const sHandler& H = ( *Handlers )[i];
 
-			return;
+			if ( !H.FHandler.IsObject( Object ) ) { continue; }
+
+			if ( FoundBucket >= 0 )
+			{
+				const sHandler& Found = ( *FBuckets[ FoundBucket ] )[ FoundIndex ];
+
+				bool Earlier = ( H.FPriority < Found.FPriority ) || ( H.FPriority == Found.FPriority && H.FSerial < Found.FSerial );
+
+				if ( !Earlier ) { break; }
+			}
+
+			FoundBucket = b;
+			FoundIndex  = i;
+
+			break;
 		}
 	}
+
+	if ( FoundBucket < 0 ) { return; }
+
+	clHandlersList* NewList = new clHandlersList( *FBuckets[ FoundBucket ] );
+
+	NewList->erase( NewList->begin() + FoundIndex );
+
+	ReplaceList_NoLock( FoundBucket, NewList );
 }
 
 void LEventSubscriber::DisconnectAll()
@@ -112,33 +251,75 @@ void LEventSubscriber::DisconnectAll()
 	FPendingClear = true;
 }
 
-void LEventSubscriber::SendSync( LEvent Event, const LEventArgs& Args, bool UseTag )
+void LEventSubscriber::ApplyPendingClear()
 {
-	std::vector<sHandler> Handlers;
+	LMutex Lock( &FMutex );
 
+	if ( !FPendingClear ) { return; }
+
+	FPendingClear = false;
+
+	for ( int b = 0; b <= L_EVENT_INVALID; b++ )
 	{
-		LMutex Lock( &FMutex );
+		if ( FBuckets[b] ) { ReplaceList_NoLock( b, NULL ); }
+	}
+}
 
-		if ( FPendingClear )
-		{
-			FPendingClear = false;
-			FHandlers.clear();
-		}
+void LEventSubscriber::ReplaceList_NoLock( int Bucket, clHandlersList* NewList )
+{
+	if ( NewList && NewList->empty() )
+	{
+		delete( NewList );
 
-		// make a clean copy to prevent deadlock (FMutex should be unlocked)
-		Handlers = FHandlers;
+		NewList = NULL;
 	}
 
+	clHandlersList* OldList = FBuckets[ Bucket ];
+
+	// the new list should be completely constructed before it is published
+	EventsMemoryBarrier();
+
+	FBuckets[ Bucket ] = NewList;
+
+	if ( OldList ) { FRetired.push_back( OldList ); }
+
+	DeleteRetired_NoLock();
+}
+
+void LEventSubscriber::DeleteRetired_NoLock()
+{
+	// a sender increments FActiveSends before it reads a bucket: if there are no active sends now,
+	// any future sender will see only the new lists
+	EventsMemoryBarrier();
+
+	if ( FActiveSends != 0 ) { return; }
+
+	for ( std::vector<clHandlersList*>::iterator i = FRetired.begin(); i != FRetired.end(); ++i ) { delete( *i ); }
+
+	FRetired.clear();
+}
+
+void LEventSubscriber::SendSync( LEvent Event, const LEventArgs& Args, bool UseTag )
+{
+	if ( FPendingClear ) { ApplyPendingClear(); }
+
+	clSendScope Scope( &FActiveSends );
+
+	// the list is never modified, changes made by the handlers will take effect on the next send
+	clHandlersList* Handlers = FBuckets[ GetBucket( Event ) ];
+
+	if ( !Handlers ) { return; }
+
 	if ( UseTag )
 	{
-		for ( std::vector<sHandler>::iterator i = Handlers.begin(); i != Handlers.end(); ++i )
+		for ( clHandlersList::iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 		{
 			if ( Args.FTag == ( *i ).FTag && ( *i ).FEvent == Event ) { ( *i ).FHandler( Event, Args ); }
 		}
 	}
 	else
 	{
-		for ( std::vector<sHandler>::iterator i = Handlers.begin(); i != Handlers.end(); ++i )
+		for ( clHandlersList::iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 		{
 			if ( ( *i ).FEvent == Event ) { ( *i ).FHandler( Event, Args ); }
 		}
@@ -147,17 +328,17 @@ void LEventSubscriber::SendSync( LEvent Event, const LEventArgs& Args, bool UseT
 
 void LEventSubscriber::SendAsync( sEnvironment* Env, LEvent Event, const LEventArgs& Args, bool UseTag )
 {
-	LMutex Lock( &FMutex );
+	if ( FPendingClear ) { ApplyPendingClear(); }
 
-	if ( FPendingClear )
-	{
-		FPendingClear = false;
-		FHandlers.clear();
-	}
+	clSendScope Scope( &FActiveSends );
+
+	clHandlersList* Handlers = FBuckets[ GetBucket( Event ) ];
+
+	if ( !Handlers ) { return; }
 
 	if ( UseTag )
 	{
-		for ( std::vector<sHandler>::iterator i = FHandlers.begin(); i != FHandlers.end(); ++i )
+		for ( clHandlersList::iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 		{
 			if ( Args.FTag == ( *i ).FTag && ( *i ).FEvent == Event )
 			{
@@ -167,7 +348,7 @@ void LEventSubscriber::SendAsync( sEnvironment* Env, LEvent Event, const LEventA
 	}
 	else
 	{
-		for ( std::vector<sHandler>::iterator i = FHandlers.begin(); i != FHandlers.end(); ++i )
+		for ( clHandlersList::iterator i = Handlers->begin(); i != Handlers->end(); ++i )
 		{
 			if ( ( *i ).FEvent == Event )
 			{
@@ -199,74 +380,297 @@ void LEventSubscriber::sAsyncCall::Invoke()
 	}
 }
 
+void LEventSubscriber::sAsyncCall::Discard()
+{
+	delete( FCapsule );
+
+	FCapsule = NULL;
+}
+
 iAsyncQueue::iAsyncQueue()
-	: FDemultiplexerMutex(),
-	  FAsyncQueue( 0 )
+	: FAsyncQueueHead( NULL ),
+	  FNextSerial( 0 ),
+	  FTimerHeap(),
+	  FTimerSlots(),
+	  FFreeTimerSlots(),
+	  FTimersMutex()
+{
+}
+
+iAsyncQueue::~iAsyncQueue()
+{
+	for ( sQueueNode* Node = TakeNodes(); Node; )
+	{
+		sQueueNode* Next = Node->FNext;
+
+		Node->FCall.FCall.Discard();
+
+		delete( Node );
+
+		Node = Next;
+	}
+
+	for ( std::vector<sTimerSlot>::iterator i = FTimerSlots.begin(); i != FTimerSlots.end(); ++i )
+	{
+		if ( ( *i ).FActive ) { ( *i ).FCall.FCall.Discard(); }
+	}
+}
+
+LAsyncHandle iAsyncQueue::EnqueueEvent( LEvent Event, const LEventArgs& Args, const LEventSubscriber::LEventHandler& Handler )
+{
+	return Enqueue( LEventSubscriber::sAsyncCall( Event, Args, Handler ) );
+}
+
+LAsyncHandle iAsyncQueue::EnqueueCapsule( iAsyncCapsule* Capsule, double TimeStamp, double TimeToHandle )
 {
+	return Enqueue( LEventSubscriber::sAsyncCall( Capsule, TimeStamp, TimeToHandle ) );
 }
 
-void iAsyncQueue::EnqueueEvent( LEvent Event, const LEventArgs& Args, const LEventSubscriber::LEventHandler& Handler )
+void iAsyncQueue::PushNodes( sQueueNode* First, sQueueNode* Last )
 {
-	LMutex Mutex( &FDemultiplexerMutex );
+	sQueueNode* Head = NULL;
+
+	do
+	{
+		Head = FAsyncQueueHead;
+
+		Last->FNext = Head;
+	}
+	while ( !EventsCompareAndSwap( reinterpret_cast<void* volatile*>( &FAsyncQueueHead ), Head, First ) );
+}
+
+iAsyncQueue::sQueueNode* iAsyncQueue::TakeNodes()
+{
+	sQueueNode* Head = NULL;
+
+	do
+	{
+		Head = FAsyncQueueHead;
+
+		if ( !Head ) { return NULL; }
+	}
+	while ( !EventsCompareAndSwap( reinterpret_cast<void* volatile*>( &FAsyncQueueHead ), Head, NULL ) );
+
+	// the list is pushed as a stack, reverse it to get the order of pushing
+	sQueueNode* Reversed = NULL;
+
+	while ( Head )
+	{
+		sQueueNode* Next = Head->FNext;
+
+		Head->FNext = Reversed;
+		Reversed    = Head;
+
+		Head = Next;
+	}
 
-	FAsyncQueue.push_back( LEventSubscriber::sAsyncCall( Event, Args, Handler ) );
+	return Reversed;
 }
 
-void iAsyncQueue::EnqueueCapsule( iAsyncCapsule* Capsule, double TimeStamp, double TimeToHandle )
+LAsyncHandle iAsyncQueue::Enqueue( const LEventSubscriber::sAsyncCall& Call )
 {
-	LMutex Mutex( &FDemultiplexerMutex );
+	Luint32 Serial = static_cast<Luint32>( EventsAtomicIncrement( &FNextSerial ) );
+
+	// calls without a delay do not need the heap
+	if ( Call.FArgs.FTimeToHandle <= Call.FArgs.FTimeStamp )
+	{
+		sQueueNode* Node = new sQueueNode();
+
+		Node->FCall = sQueuedCall( Call, Serial );
+		Node->FNext = NULL;
+
+		PushNodes( Node, Node );
+
+		return L_INVALID_ASYNC_HANDLE;
+	}
+
+	LMutex Mutex( &FTimersMutex );
+
+	Luint32 Slot = 0;
+
+	if ( FFreeTimerSlots.empty() )
+	{
+		Slot = static_cast<Luint32>( FTimerSlots.size() );
+
+		FTimerSlots.push_back( sTimerSlot() );
+	}
+	else
+	{
+		Slot = FFreeTimerSlots.back();
+
+		FFreeTimerSlots.pop_back();
+	}
 
-	FAsyncQueue.push_back( LEventSubscriber::sAsyncCall( Capsule, TimeStamp, TimeToHandle ) );
+	sTimerSlot& TimerSlot = FTimerSlots[ Slot ];
+
+	TimerSlot.FCall   = sQueuedCall( Call, Serial );
+	TimerSlot.FActive = true;
+
+	sTimerEntry Entry;
+	Entry.FTimeToHandle = Call.FArgs.FTimeToHandle;
+	Entry.FSerial       = Serial;
+	Entry.FSlot         = Slot;
+	Entry.FGeneration   = TimerSlot.FGeneration;
+
+	FTimerHeap.push_back( Entry );
+	std::push_heap( FTimerHeap.begin(), FTimerHeap.end() );
+
+	return ( static_cast<LAsyncHandle>( TimerSlot.FGeneration ) << 32 ) | Slot;
 }
 
-void iAsyncQueue::DemultiplexEvents( double CurrentSeconds )
+void iAsyncQueue::ReleaseTimerSlot_NoLock( Luint32 Slot )
 {
-	FDemultiplexerMutex.Lock();
+	sTimerSlot& TimerSlot = FTimerSlots[ Slot ];
+
+	TimerSlot.FCall   = sQueuedCall();
+	TimerSlot.FActive = false;
 
-	clAsyncQueue LocalQueue( FAsyncQueue );
+	// zero generation is reserved for L_INVALID_ASYNC_HANDLE
+	if ( ++TimerSlot.FGeneration == 0 ) { TimerSlot.FGeneration = 1; }
 
-	FAsyncQueue.clear();
+	FFreeTimerSlots.push_back( Slot );
+}
+
+void iAsyncQueue::CompactTimerHeap_NoLock()
+{
+	size_t NumActive = FTimerSlots.size() - FFreeTimerSlots.size();
+
+	// the cancelled entries are normally dropped when they become due, rebuild only if they dominate
+	if ( FTimerHeap.size() < 64 || FTimerHeap.size() < 2 * NumActive ) { return; }
 
-	clAsyncQueue::iterator End( LocalQueue.end() );
+	std::vector<sTimerEntry> Heap;
+	Heap.reserve( NumActive );
 
-	for ( clAsyncQueue::iterator i = LocalQueue.begin(); i != End; ++i )
+	for ( std::vector<sTimerEntry>::const_iterator i = FTimerHeap.begin(); i != FTimerHeap.end(); ++i )
 	{
-		if ( ( *i ).FArgs.FTimeToHandle > CurrentSeconds ) { FAsyncQueue.push_back( ( *i ) ); }
+		if ( FTimerSlots[ ( *i ).FSlot ].FGeneration == ( *i ).FGeneration ) { Heap.push_back( *i ); }
 	}
 
-	FDemultiplexerMutex.Unlock();
+	std::make_heap( Heap.begin(), Heap.end() );
+
+	FTimerHeap.swap( Heap );
+}
+
+void iAsyncQueue::DemultiplexEvents( double CurrentSeconds )
+{
+	clAsyncQueue LocalQueue;
+
+	for ( sQueueNode* Node = TakeNodes(); Node; )
+	{
+		sQueueNode* Next = Node->FNext;
+
+		LocalQueue.push_back( Node->FCall );
+
+		delete( Node );
+
+		Node = Next;
+	}
 
-	for ( clAsyncQueue::iterator i = LocalQueue.begin(); i != End; ++i )
 	{
-		LEventSubscriber::sAsyncCall& Call = ( *i );
+		LMutex Mutex( &FTimersMutex );
+
+		// the cancelled calls are left in the heap and skipped here
+		while ( !FTimerHeap.empty() && FTimerHeap.front().FTimeToHandle <= CurrentSeconds )
+		{
+			sTimerEntry Entry = FTimerHeap.front();
+
+			std::pop_heap( FTimerHeap.begin(), FTimerHeap.end() );
+			FTimerHeap.pop_back();
+
+			sTimerSlot& TimerSlot = FTimerSlots[ Entry.FSlot ];
+
+			if ( TimerSlot.FGeneration != Entry.FGeneration ) { continue; }
 
-		if ( Call.FArgs.FTimeToHandle <= CurrentSeconds ) { Call.Invoke(); }
+			LocalQueue.push_back( TimerSlot.FCall );
+
+			ReleaseTimerSlot_NoLock( Entry.FSlot );
+		}
+	}
+
+	// the due delayed calls are interleaved with the immediate ones in the order of enqueueing,
+	// the immediate calls of the racing producers may also be pushed slightly out of order
+	if ( LocalQueue.size() > 1 ) { std::stable_sort( LocalQueue.begin(), LocalQueue.end() ); }
+
+	// the calls are invoked without locks, new calls will be dispatched next time
+	for ( clAsyncQueue::iterator i = LocalQueue.begin(); i != LocalQueue.end(); ++i )
+	{
+		( *i ).FCall.Invoke();
 	}
 }
 
 void iAsyncQueue::CancelEvent( LEvent Event, iObject* Receiver )
 {
-	LMutex Mutex( &FDemultiplexerMutex );
+	{
+		// take the immediate calls out and push the remaining ones back, the serials keep their order
+		sQueueNode* First = NULL;
+		sQueueNode* Last  = NULL;
+
+		for ( sQueueNode* Node = TakeNodes(); Node; )
+		{
+			sQueueNode* Next = Node->FNext;
+
+			const LEventSubscriber::sAsyncCall& Call = Node->FCall.FCall;
+
+			if ( Call.FEvent == Event && Call.FHandler.IsObject( Receiver ) )
+			{
+				delete( Node );
+			}
+			else
+			{
+				Node->FNext = First;
+				First       = Node;
+
+				if ( !Last ) { Last = Node; }
+			}
+
+			Node = Next;
+		}
+
+		if ( First ) { PushNodes( First, Last ); }
+	}
 
-	clAsyncQueue::iterator End( FAsyncQueue.end() );
+	LMutex Mutex( &FTimersMutex );
 
-	for ( size_t i = 0; i != FAsyncQueue.size(); )
+	for ( size_t i = 0; i != FTimerSlots.size(); i++ )
 	{
-		const LEventSubscriber::sAsyncCall& Call = FAsyncQueue[i];
+		const sTimerSlot& TimerSlot = FTimerSlots[i];
 
-		if ( Call.FEvent == Event && Call.FHandler.IsObject( Receiver ) )
+		if ( TimerSlot.FActive && TimerSlot.FCall.FCall.FEvent == Event && TimerSlot.FCall.FCall.FHandler.IsObject( Receiver ) )
 		{
-			FAsyncQueue[i] = FAsyncQueue.back();
-			FAsyncQueue.pop_back();
-			continue;
+			ReleaseTimerSlot_NoLock( static_cast<Luint32>( i ) );
 		}
-
-		i++;
 	}
+
+	CompactTimerHeap_NoLock();
 }
 
+bool iAsyncQueue::CancelAsyncCall( LAsyncHandle Handle )
+{
+	Luint32 Slot       = static_cast<Luint32>( Handle & 0xFFFFFFFF );
+	Luint32 Generation = static_cast<Luint32>( Handle >> 32 );
+
+	LMutex Mutex( &FTimersMutex );
+
+	if ( Slot >= FTimerSlots.size() ) { return false; }
+
+	sTimerSlot& TimerSlot = FTimerSlots[ Slot ];
+
+	if ( !TimerSlot.FActive || TimerSlot.FGeneration != Generation ) { return false; }
+
+	TimerSlot.FCall.FCall.Discard();
+
+	ReleaseTimerSlot_NoLock( Slot );
+
+	CompactTimerHeap_NoLock();
+
+	return true;
+}
 
 /*
+ * 17/10/2026
+     Lock-free list of immediate calls, calls are dispatched in the order of enqueueing
+     Copy-on-write handler lists indexed by event, lock-free sends
+     Timer heap and handle-based cancellation in iAsyncQueue
  * 09/12/2010
      SendSync()
  * 28/07/2010
@@ -243,6 +243,8 @@ public:
 		sAsyncCall( iAsyncCapsule* Capsule, double TimeStamp, double TimeToHandle );
 		sAsyncCall( LEvent Event, const LEventArgs& Args, const LEventHandler& Handler ) : FEvent( Event ), FArgs( Args ), FHandler( Handler ), FCapsule( NULL ) {};
 		void Invoke();
+		/// Destroy the capsule without invoking it
+		void Discard();
 		LEvent        FEvent;
 		LEventArgs    FArgs;
 		LEventHandler FHandler;
@@ -250,12 +252,9 @@ public:
 		iAsyncCapsule* FCapsule;
 	};
 public:
-	LEventSubscriber():
-		FHandlers( 0 ),
-		FPendingClear( false ) {};
-	explicit LEventSubscriber( LEvent Event ):
-		FHandlers( 0 ),
-		FPendingClear( false ) {};
+	LEventSubscriber();
+	explicit LEventSubscriber( LEvent Event );
+	~LEventSubscriber();
 	//
 	// LEvent
 	//
@@ -271,45 +270,146 @@ public:
 private:
 	struct sHandler
 	{
-		sHandler(): FEvent( L_EVENT_INVALID ), FHandler(), FObject( NULL ), FPriority( 0 ), FTag( -1 ) {};
+		sHandler(): FEvent( L_EVENT_INVALID ), FHandler(), FObject( NULL ), FPriority( 0 ), FTag( -1 ), FSerial( 0 ) {};
 		sHandler( LEvent Event, const LEventHandler& Handler, int Priority );
 		LEvent        FEvent;
 		LEventHandler FHandler;
 		iObject*      FObject;
 		int           FPriority;
 		int           FTag;
+		/// Connection order, handlers with the same priority are called in this order
+		Lint64        FSerial;
 	};
+	typedef std::vector<sHandler> clHandlersList;
 private:
-	std::vector<sHandler>    FHandlers;
-	clMutex                  FMutex;
-	bool                     FPendingClear;
+	/// Bucket for the event, all the events outside of the LEvent range share the last bucket
+	static inline int GetBucket( LEvent Event ) { return ( Event >= 0 && Event < L_EVENT_INVALID ) ? static_cast<int>( Event ) : L_EVENT_INVALID; };
+
+	Lint64  Insert( LEvent Event, const LEventHandler& Handler, int Priority, int Tag );
+	void    ApplyPendingClear();
+	/// Publish the new handlers list, the old one is retired until no sends are active. FMutex should be locked
+	void    ReplaceList_NoLock( int Bucket, clHandlersList* NewList );
+	void    DeleteRetired_NoLock();
+private:
+	/**
+	   Copy-on-write handler lists, one per event. Senders read them without any locks,
+	   every change makes a new copy and replaces the pointer, so a send in progress
+	   always completes on the list it has started with
+	**/
+	clHandlersList* volatile     FBuckets[ L_EVENT_INVALID + 1 ];
+	/// Replaced lists which may still be used by the active senders
+	std::vector<clHandlersList*> FRetired;
+	/// Number of SendSync() and SendAsync() calls in progress
+	volatile long                FActiveSends;
+	Lint64                       FNextSerial;
+	/// Serializes the changes, senders never take it
+	clMutex                      FMutex;
+	volatile bool                FPendingClear;
 };
 
+/// Handle of a delayed call in iAsyncQueue, stays unique after the call is dispatched or cancelled
+typedef Luint64 LAsyncHandle;
+
+const LAsyncHandle L_INVALID_ASYNC_HANDLE = 0;
+
+/**
+   \brief Queue of asynchronous calls
+
+   Immediate calls go into a lock-free multiple-producer single-consumer list, delayed calls are kept
+   in a binary min-heap ordered by the time to handle, so a tick only touches the calls which are due.
+
+   Every call gets a serial number when it is enqueued. The calls due in a tick are dispatched
+   in the order of enqueueing, whether they were delayed or not, just like the single queue did.
+**/
 class scriptfinal iAsyncQueue
 {
 public:
 	iAsyncQueue();
+	virtual ~iAsyncQueue();
 
-	/// Put the event into the events queue
-	virtual void    EnqueueEvent( LEvent Event, const LEventArgs& Args, const LEventSubscriber::LEventHandler& Handler );
+	/// Put the event into the events queue, returns a handle for delayed events
+	virtual LAsyncHandle EnqueueEvent( LEvent Event, const LEventArgs& Args, const LEventSubscriber::LEventHandler& Handler );
 
-	/// Put the event into the events queue
-	virtual void    EnqueueCapsule( iAsyncCapsule* Capsule, double TimeStamp, double TimeToHandle );
+	/// Put the event into the events queue, returns a handle for delayed events
+	virtual LAsyncHandle EnqueueCapsule( iAsyncCapsule* Capsule, double TimeStamp, double TimeToHandle );
 
 	/// Events demultiplexer as described in Reactor pattern
 	virtual void    DemultiplexEvents( double CurrentSeconds );
 
 	/// Remove all the events from queue
 	virtual void    CancelEvent( LEvent Event, iObject* Receiver );
+
+	/// Remove the delayed call, returns false if it was already dispatched or cancelled
+	virtual bool    CancelAsyncCall( LAsyncHandle Handle );
 private:
-	typedef std::vector<LEventSubscriber::sAsyncCall> clAsyncQueue;
-	clAsyncQueue    FAsyncQueue;
-	clMutex         FDemultiplexerMutex;
+	struct sQueuedCall
+	{
+		sQueuedCall(): FCall(), FSerial( 0 ) {};
+		sQueuedCall( const LEventSubscriber::sAsyncCall& Call, Luint32 Serial ): FCall( Call ), FSerial( Serial ) {};
+		LEventSubscriber::sAsyncCall FCall;
+		/// Enqueueing order, wraps around
+		Luint32                      FSerial;
+		inline bool operator < ( const sQueuedCall& Other ) const { return IsSerialBefore( FSerial, Other.FSerial ); }
+	};
+	/// Node of the immediate calls list
+	struct sQueueNode
+	{
+		sQueuedCall FCall;
+		sQueueNode* FNext;
+	};
+	struct sTimerSlot
+	{
+		sTimerSlot(): FCall(), FGeneration( 1 ), FActive( false ) {};
+		sQueuedCall                  FCall;
+		/// Incremented whenever the slot is released, so the stale handles and heap entries are ignored
+		Luint32                      FGeneration;
+		bool                         FActive;
+	};
+	struct sTimerEntry
+	{
+		double  FTimeToHandle;
+		/// Enqueueing order, calls due at the same time are dispatched in this order
+		Luint32 FSerial;
+		Luint32 FSlot;
+		Luint32 FGeneration;
+		/// Inverted, so std::push_heap() keeps the earliest call on top
+		inline bool operator < ( const sTimerEntry& Other ) const
+		{
+			return ( FTimeToHandle > Other.FTimeToHandle ) || ( FTimeToHandle == Other.FTimeToHandle && IsSerialBefore( Other.FSerial, FSerial ) );
+		}
+	};
+	typedef std::vector<sQueuedCall> clAsyncQueue;
+private:
+	/// Serials are compared modulo 2^32, so a wrap-around does not reorder the calls pending at the moment
+	static inline bool IsSerialBefore( Luint32 A, Luint32 B ) { return static_cast<Lint32>( A - B ) < 0; };
+
+	LAsyncHandle    Enqueue( const LEventSubscriber::sAsyncCall& Call );
+	/// Atomically push the chain of nodes from First to Last
+	void            PushNodes( sQueueNode* First, sQueueNode* Last );
+	/// Atomically take all the immediate calls, returns them in the order of pushing
+	sQueueNode*     TakeNodes();
+	void            ReleaseTimerSlot_NoLock( Luint32 Slot );
+	/// Drop the heap entries of the cancelled calls
+	void            CompactTimerHeap_NoLock();
+private:
+	/// Immediate calls, pushed by the producers with a CAS, the consumer takes the whole list at once
+	sQueueNode* volatile     FAsyncQueueHead;
+	volatile long            FNextSerial;
+
+	/// Delayed calls
+	std::vector<sTimerEntry> FTimerHeap;
+	std::vector<sTimerSlot>  FTimerSlots;
+	std::vector<Luint32>     FFreeTimerSlots;
+	clMutex                  FTimersMutex;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     Lock-free list of immediate calls, calls are dispatched in the order of enqueueing
+     Copy-on-write handler lists indexed by event, lock-free sends
+     Timer heap and handle-based cancellation in iAsyncQueue
  * 03/06/2011
      Removed text argument from event (use void* if needed)
  * 25/04/2011
@@ -8,6 +8,7 @@
  */
 
 #include <stdarg.h>
+#include <string.h>
 
 #include "Exceptions.h"
 #include "Engine.h"
@@ -22,37 +23,357 @@ static const char NameNoParams[] = "%s->\0";
 static const char NameNoParams[] = "%s()->\0";
 #endif
 
-clGuardian::clGuardian( clLogger* Logger, const char* FuncName, const char* Pattern, ... ): FLogger( Logger )
+namespace
 {
-	va_list p;
-	va_start( p, Pattern );
+	const int MAX_GUARD_DEPTH    = 64;
+	const int MAX_GUARD_ARGS     = 8;
+	/// Storage for the copies of '%s' arguments, they may point to temporaries
+	const int GUARD_STRINGS_SIZE = 128;
 
-	char buf1[GUARD_BUFFER];
-	char buf2[GUARD_BUFFER];
+	enum LGuardArgType
+	{
+		L_GUARD_ARG_INT,
+		L_GUARD_ARG_LONG,
+		L_GUARD_ARG_INT64,
+		L_GUARD_ARG_DOUBLE,
+		L_GUARD_ARG_POINTER,
+		L_GUARD_ARG_STRING
+	};
 
-	Lvsnprintf( buf1, GUARD_BUFFER - 1, Pattern, p );
-	Lsnprintf( buf2, GUARD_BUFFER - 1, NameParams, FuncName, buf1 );
+	struct sGuardArg
+	{
+		LGuardArgType FType;
+		union
+		{
+			int         FInt;
+			long        FLong;
+			Lint64      FInt64;
+			double      FDouble;
+			const void* FPointer;
+			/// offset in sGuardFrame::FStrings
+			int         FString;
+		};
+	};
 
-	FLogger->PushProc( buf2 );
+	struct sGuardFrame
+	{
+		const ::Linderdaum::sGuardSite* FSite;
+		const char*  FPattern;
+		int          FNumArgs;
+		sGuardArg    FArgs[ MAX_GUARD_ARGS ];
+		char         FStrings[ GUARD_STRINGS_SIZE ];
+		/// Logged something in this frame
+		bool         FLogged;
+		bool         FFormatted;
+		char         FText[ GUARD_BUFFER ];
+	};
 
-	va_end( p );
+	/// Zero-initialized for every thread, frames above MAX_GUARD_DEPTH are counted but not stored
+	struct sGuardStack
+	{
+		int          FDepth;
+		sGuardFrame  FFrames[ MAX_GUARD_DEPTH ];
+	};
+
+	L_THREAD_LOCAL sGuardStack GGuardStack;
+
+	inline bool IsFormatFlag( char Ch )
+	{
+		return Ch == '-' || Ch == '+' || Ch == ' ' || Ch == '#' || Ch == '0';
+	}
+
+	/// Skip flags, width, precision and length of a conversion specification starting after '%'. Returns false for '*' widths
+	bool ParseFormatSpec( const char** Ptr, int* LongCount, bool* Int64 )
+	{
+		const char* P = *Ptr;
+
+		*LongCount = 0;
+		*Int64     = false;
+
+		while ( IsFormatFlag( *P ) ) { P++; }
+
+		if ( *P == '*' ) { return false; }
+
+		while ( *P >= '0' && *P <= '9' ) { P++; }
+
+		if ( *P == '.' )
+		{
+			P++;
+
+			if ( *P == '*' ) { return false; }
+
+			while ( *P >= '0' && *P <= '9' ) { P++; }
+		}
+
+		for ( ;; P++ )
+		{
+			if ( *P == 'l' ) { ( *LongCount )++; }
+			else if ( *P == 'I' && P[1] == '6' && P[2] == '4' ) { *Int64 = true; P += 2; }
+			else if ( *P != 'h' && *P != 'z' && *P != 't' && *P != 'j' && *P != 'L' ) { break; }
+		}
+
+		*Ptr = P;
+
+		return true;
+	}
+
+	/// Copy the arguments, returns false if they can not be stored and the frame should be formatted right away
+	bool CaptureArgs( sGuardFrame* Frame, va_list p )
+	{
+		int StringsUsed = 0;
+
+		for ( const char* P = Frame->FPattern; *P; P++ )
+		{
+			if ( *P != '%' ) { continue; }
+
+			P++;
+
+			if ( *P == '%' ) { continue; }
+
+			int  LongCount = 0;
+			bool Int64     = false;
+
+			if ( !ParseFormatSpec( &P, &LongCount, &Int64 ) ) { return false; }
+
+			if ( Frame->FNumArgs == MAX_GUARD_ARGS ) { return false; }
+
+			sGuardArg& Arg = Frame->FArgs[ Frame->FNumArgs++ ];
+
+			switch ( *P )
+			{
+				case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+					if ( Int64 || LongCount > 1 ) { Arg.FType = L_GUARD_ARG_INT64; Arg.FInt64 = va_arg( p, Lint64 ); }
+					else if ( LongCount == 1 )    { Arg.FType = L_GUARD_ARG_LONG;  Arg.FLong  = va_arg( p, long ); }
+					else                          { Arg.FType = L_GUARD_ARG_INT;   Arg.FInt   = va_arg( p, int ); }
+					break;
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+					Arg.FType   = L_GUARD_ARG_DOUBLE;
+					Arg.FDouble = va_arg( p, double );
+					break;
+				case 'p':
+					Arg.FType    = L_GUARD_ARG_POINTER;
+					Arg.FPointer = va_arg( p, const void* );
+					break;
+				case 's':
+				{
+					const char* Str = va_arg( p, const char* );
+
+					if ( !Str ) { Str = "(null)"; }
+
+					int Length = static_cast<int>( strlen( Str ) );
+
+					// truncate the long strings, the frame text is limited anyway
+					if ( Length > GUARD_STRINGS_SIZE - 1 - StringsUsed ) { Length = GUARD_STRINGS_SIZE - 1 - StringsUsed; }
+
+					memcpy( Frame->FStrings + StringsUsed, Str, Length );
+
+					Frame->FStrings[ StringsUsed + Length ] = 0;
+
+					Arg.FType   = L_GUARD_ARG_STRING;
+					Arg.FString = StringsUsed;
+
+					StringsUsed += Length + 1;
+
+					if ( StringsUsed >= GUARD_STRINGS_SIZE ) { StringsUsed = GUARD_STRINGS_SIZE - 1; }
+
+					break;
+				}
+				default:
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// Expand the pattern using the captured arguments, one conversion at a time
+	void FormatArgs( const sGuardFrame* Frame, char* Out, int OutSize )
+	{
+		int Pos = 0;
+		int ArgIdx = 0;
+
+		for ( const char* P = Frame->FPattern; *P && Pos < OutSize - 1; P++ )
+		{
+			if ( *P != '%' )
+			{
+				Out[ Pos++ ] = *P;
+				continue;
+			}
+
+			if ( P[1] == '%' )
+			{
+				Out[ Pos++ ] = '%';
+				P++;
+				continue;
+			}
+
+			const char* SpecStart = P;
+
+			P++;
+
+			int  LongCount = 0;
+			bool Int64     = false;
+
+			ParseFormatSpec( &P, &LongCount, &Int64 );
+
+			char Spec[ 32 ];
+
+			int SpecLength = static_cast<int>( P - SpecStart ) + 1;
+
+			if ( SpecLength >= static_cast<int>( sizeof( Spec ) ) || ArgIdx == Frame->FNumArgs ) { break; }
+
+			memcpy( Spec, SpecStart, SpecLength );
+
+			Spec[ SpecLength ] = 0;
+
+			const sGuardArg& Arg = Frame->FArgs[ ArgIdx++ ];
+
+			int Written = 0;
+
+			switch ( Arg.FType )
+			{
+				case L_GUARD_ARG_INT:     Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Arg.FInt );     break;
+				case L_GUARD_ARG_LONG:    Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Arg.FLong );    break;
+				case L_GUARD_ARG_INT64:   Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Arg.FInt64 );   break;
+				case L_GUARD_ARG_DOUBLE:  Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Arg.FDouble );  break;
+				case L_GUARD_ARG_POINTER: Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Arg.FPointer ); break;
+				case L_GUARD_ARG_STRING:  Written = Lsnprintf( Out + Pos, OutSize - Pos - 1, Spec, Frame->FStrings + Arg.FString ); break;
+			}
+
+			// snprintf() flavours disagree on the return value when the output is truncated
+			if ( Written < 0 || Written > OutSize - Pos - 1 ) { Pos = OutSize - 1; break; }
+
+			Pos += Written;
+		}
+
+		Out[ Pos ] = 0;
+	}
+
+	inline sGuardFrame* PushFrame( const ::Linderdaum::sGuardSite* Site, const char* Pattern )
+	{
+		int Depth = GGuardStack.FDepth++;
+
+		if ( Depth >= MAX_GUARD_DEPTH ) { return NULL; }
+
+		sGuardFrame* Frame = &GGuardStack.FFrames[ Depth ];
+
+		Frame->FSite      = Site;
+		Frame->FPattern   = Pattern;
+		Frame->FNumArgs   = 0;
+		Frame->FLogged    = false;
+		Frame->FFormatted = false;
+
+		return Frame;
+	}
+
+	inline sGuardFrame* GetTopFrame()
+	{
+		int Depth = GGuardStack.FDepth;
+
+		return ( Depth > 0 && Depth <= MAX_GUARD_DEPTH ) ? &GGuardStack.FFrames[ Depth - 1 ] : NULL;
+	}
 }
 
-::Linderdaum::clGuardian::clGuardian( clLogger* Logger, const char* FuncName ): FLogger( Logger )
+clGuardian::clGuardian( clLogger* Logger, const ::Linderdaum::sGuardSite* Site, const char* Pattern, ... ): FLogger( Logger )
 {
+	sGuardFrame* Frame = PushFrame( Site, Pattern );
+
+	if ( !Frame ) { return; }
+
+	va_list p;
+	va_start( p, Pattern );
+
+	bool Captured = CaptureArgs( Frame, p );
+
+	va_end( p );
+
+	if ( Captured ) { return; }
+
+	// unusual patterns are formatted right away
 	char buf[GUARD_BUFFER];
 
-	Lsnprintf( buf, GUARD_BUFFER - 1, NameNoParams, FuncName, buf );
+	va_start( p, Pattern );
 
-	FLogger->PushProc( buf );
-};
+	Lvsnprintf( buf, GUARD_BUFFER - 1, Pattern, p );
 
+	va_end( p );
+
+	Lsnprintf( Frame->FText, GUARD_BUFFER - 1, NameParams, Site->FFuncName, buf );
+
+	Frame->FFormatted = true;
+}
+
+::Linderdaum::clGuardian::clGuardian( clLogger* Logger, const ::Linderdaum::sGuardSite* Site ): FLogger( Logger )
+{
+	PushFrame( Site, NULL );
+};
 
 ::Linderdaum::clGuardian::~clGuardian()
 {
-	FLogger->PopProc();
+	PopFrame( FLogger );
 };
 
+int ::Linderdaum::clGuardian::GetDepth()
+{
+	return ( GGuardStack.FDepth < MAX_GUARD_DEPTH ) ? GGuardStack.FDepth : MAX_GUARD_DEPTH;
+}
+
+const char* ::Linderdaum::clGuardian::GetFrameText( int i )
+{
+	sGuardFrame* Frame = &GGuardStack.FFrames[i];
+
+	if ( Frame->FFormatted ) { return Frame->FText; }
+
+	if ( Frame->FPattern )
+	{
+		char buf[GUARD_BUFFER];
+
+		FormatArgs( Frame, buf, GUARD_BUFFER );
+
+		Lsnprintf( Frame->FText, GUARD_BUFFER - 1, NameParams, Frame->FSite->FFuncName, buf );
+	}
+	else
+	{
+		Lsnprintf( Frame->FText, GUARD_BUFFER - 1, NameNoParams, Frame->FSite->FFuncName );
+	}
+
+	Frame->FText[ GUARD_BUFFER - 1 ] = 0;
+
+	Frame->FFormatted = true;
+
+	return Frame->FText;
+}
+
+void ::Linderdaum::clGuardian::MarkLogged()
+{
+	sGuardFrame* Frame = GetTopFrame();
+
+	if ( Frame ) { Frame->FLogged = true; }
+}
+
+void ::Linderdaum::clGuardian::PushText( const char* Text )
+{
+	sGuardFrame* Frame = PushFrame( NULL, NULL );
+
+	if ( !Frame ) { return; }
+
+	Lsnprintf( Frame->FText, GUARD_BUFFER - 1, "%s", Text );
+
+	Frame->FText[ GUARD_BUFFER - 1 ] = 0;
+
+	Frame->FFormatted = true;
+}
+
+void ::Linderdaum::clGuardian::PopFrame( clLogger* Logger )
+{
+	if ( GGuardStack.FDepth <= 0 ) { return; }
+
+	sGuardFrame* Frame = GetTopFrame();
+
+	if ( Frame && Frame->FLogged && Logger ) { Logger->Log( L_DEBUG, "<-" ); }
+
+	GGuardStack.FDepth--;
+}
 
 ::Linderdaum::clException::clException( clLogger* Logger )
 	: FLogger( Logger ),
@@ -78,6 +399,8 @@ void ::Linderdaum::clException::FatalException()
 }
 
 /*
+ * 17/10/2026
+     Lazily formatted thread-local guard() frames
  * 10/01/2011
      Fixed NameNoParams[] for GCC
  * 27/12/2010
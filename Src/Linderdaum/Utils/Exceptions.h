@@ -62,13 +62,36 @@ public:
 
 namespace Linderdaum
 {
-	/// Handles guard() macro
+	/// Static description of a guard() call site
+	struct sGuardSite
+	{
+		const char* FFuncName;
+	};
+
+	/**
+	   \brief Handles guard() macro
+
+	   Every thread has a fixed-capacity stack of guarded frames. Entering a frame only stores the call site
+	   and the raw arguments, the text like "Func(Args)->" is formatted on demand: when an exception is raised
+	   or when something is logged inside of the frame.
+	**/
 	class clGuardian
 	{
 	public:
-		clGuardian( clLogger* Logger, const char* FuncName );
-		clGuardian( clLogger* Logger, const char* FuncName, const char* Pattern, ... );
+		clGuardian( clLogger* Logger, const sGuardSite* Site );
+		clGuardian( clLogger* Logger, const sGuardSite* Site, const char* Pattern, ... );
 		~clGuardian();
+
+		/// Number of guarded frames of the current thread
+		static int         GetDepth();
+		/// Text of the i-th frame of the current thread, formatted on the first request
+		static const char* GetFrameText( int i );
+		/// Mark the innermost frame of the current thread as having some log messages
+		static void        MarkLogged();
+		/// Push a preformatted frame, used by clLogger::PushProc()
+		static void        PushText( const char* Text );
+		/// Leave the innermost frame, writes "<-" to the log if anything was logged inside of it
+		static void        PopFrame( clLogger* Logger );
 	private:
 		clLogger* FLogger;
 	};
@@ -93,6 +116,8 @@ namespace Linderdaum
 #endif
 
 /*
+ * 17/10/2026
+     Lazily formatted thread-local guard() frames
  * 27/12/2010
      Significant speed boost in guard()/unguard() mechanism
  * 01/11/2010
@@ -0,0 +1,495 @@
+/**
+ * \file JobSystem.cpp
+ * \brief Work-stealing job scheduler
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#include "JobSystem.h"
+
+#include "Utils/Thread.h"
+
+#include <algorithm>
+
+/// Queued job
+struct sJob
+{
+	LJobProc         FProc;
+	void*            FParam;
+	clJobCounter*    FCounter;
+	bool             FMainThread;
+};
+
+class clJobWorker: public iThread
+{
+public:
+	clJobWorker( clJobSystem* System, int Index ): FSystem( System ), FIndex( Index ) {}
+
+	virtual void Run()
+	{
+		FSystem->WorkerLoop( FIndex );
+	}
+public:
+	clJobSystem*       FSystem;
+	int                FIndex;
+};
+
+namespace
+{
+	/// Job system and worker index of the calling thread, NULL for the non-worker threads
+	L_THREAD_LOCAL const clJobSystem* GWorkerSystem = NULL;
+	L_THREAD_LOCAL int                GWorkerIndex  = -1;
+
+	/// Chunk of a parallel-for
+	struct sRangeJob
+	{
+		LRangeProc    FProc;
+		void*         FParam;
+		size_t        FBegin;
+		size_t        FEnd;
+	};
+
+	void RangeJobProc( void* Param )
+	{
+		sRangeJob* Range = reinterpret_cast<sRangeJob*>( Param );
+
+		Range->FProc( Range->FParam, Range->FBegin, Range->FEnd );
+	}
+}
+
+clJobSystem::clJobSystem()
+	: FMainThreadID( iThread::GetCurrentThread() ),
+	  FNumQueued( 0 ),
+	  FNumMainQueued( 0 ),
+	  FNumWaiting( 0 ),
+	  FScheduleCount( 0 ),
+	  FRunningWorkers( 0 ),
+	  FShutdown( false )
+{
+}
+
+clJobSystem::~clJobSystem()
+{
+	Shutdown();
+
+	for ( size_t i = 0; i != FFreeJobs.size(); i++ ) { delete( FFreeJobs[i] ); }
+}
+
+sJob* clJobSystem::AllocateJob()
+{
+	{
+		LMutex Lock( &FFreeJobsMutex );
+
+		if ( !FFreeJobs.empty() )
+		{
+			sJob* Job = FFreeJobs.back();
+
+			FFreeJobs.pop_back();
+
+			return Job;
+		}
+	}
+
+	return new sJob();
+}
+
+void clJobSystem::FreeJob( sJob* Job )
+{
+	LMutex Lock( &FFreeJobsMutex );
+
+	FFreeJobs.push_back( Job );
+}
+
+void clJobSystem::Start( sEnvironment* Env, int NumWorkers )
+{
+	Shutdown();
+
+	FMainThreadID = iThread::GetCurrentThread();
+	FShutdown     = false;
+
+	for ( int i = 0; i < NumWorkers; i++ ) { FQueues.push_back( new sJobQueue() ); }
+
+	for ( int i = 0; i < NumWorkers; i++ )
+	{
+		clJobWorker* Worker = new clJobWorker( this, i );
+
+		{
+			LMutex Lock( &FMutex );
+
+			FRunningWorkers++;
+		}
+
+		FWorkers.push_back( Worker );
+	}
+
+	for ( size_t i = 0; i != FWorkers.size(); i++ ) { FWorkers[i]->Start( Env, iThread::Priority_Normal ); }
+}
+
+void clJobSystem::Shutdown()
+{
+	if ( !FWorkers.empty() )
+	{
+		LMutex Lock( &FMutex );
+
+		FShutdown = true;
+
+		FWorkAvailable.Broadcast();
+
+		while ( FRunningWorkers > 0 ) { FCounterChanged.Wait( &FMutex ); }
+	}
+
+	for ( size_t i = 0; i != FWorkers.size(); i++ ) { delete( FWorkers[i] ); }
+
+	FWorkers.clear();
+
+	// nobody else is running, finish the remaining jobs here
+	while ( sJob* Job = FindJob( -1, true ) ) { Execute( Job ); }
+
+	for ( size_t i = 0; i != FQueues.size(); i++ ) { delete( FQueues[i] ); }
+
+	FQueues.clear();
+}
+
+void clJobSystem::AddJob( LJobProc Proc, void* Param, clJobCounter* Counter, clJobCounter* Dependency )
+{
+	sJob* Job = AllocateJob();
+
+	Job->FProc       = Proc;
+	Job->FParam      = Param;
+	Job->FCounter    = Counter;
+	Job->FMainThread = false;
+
+	{
+		LMutex Lock( &FMutex );
+
+		if ( Counter ) { Counter->FValue++; }
+
+		if ( Dependency && Dependency->FValue > 0 )
+		{
+			Dependency->FDependents.push_back( Job );
+			return;
+		}
+	}
+
+	Schedule( Job );
+}
+
+void clJobSystem::AddMainThreadJob( LJobProc Proc, void* Param, clJobCounter* Counter, clJobCounter* Dependency )
+{
+	sJob* Job = AllocateJob();
+
+	Job->FProc       = Proc;
+	Job->FParam      = Param;
+	Job->FCounter    = Counter;
+	Job->FMainThread = true;
+
+	{
+		LMutex Lock( &FMutex );
+
+		if ( Counter ) { Counter->FValue++; }
+
+		if ( Dependency && Dependency->FValue > 0 )
+		{
+			Dependency->FDependents.push_back( Job );
+			return;
+		}
+	}
+
+	Schedule( Job );
+}
+
+void clJobSystem::Schedule( sJob* Job )
+{
+	if ( Job->FMainThread )
+	{
+		{
+			LMutex Lock( &FMainQueue.FMutex );
+
+			FMainQueue.FJobs.push_back( Job );
+		}
+
+		LMutex Lock( &FMutex );
+
+		FNumMainQueued++;
+		FScheduleCount++;
+
+		// the main thread can be waiting for a counter
+		FCounterChanged.Broadcast();
+
+		return;
+	}
+
+	int Index = GetWorkerIndex();
+
+	sJobQueue* Queue = ( Index >= 0 ) ? FQueues[ Index ] : &FSharedQueue;
+
+	{
+		LMutex Lock( &Queue->FMutex );
+
+		Queue->FJobs.push_back( Job );
+	}
+
+	LMutex Lock( &FMutex );
+
+	FNumQueued++;
+	FScheduleCount++;
+
+	FWorkAvailable.Signal();
+
+	if ( FNumWaiting > 0 ) { FCounterChanged.Broadcast(); }
+}
+
+void clJobSystem::Execute( sJob* Job )
+{
+	Job->FProc( Job->FParam );
+
+	clJobCounter* Counter = Job->FCounter;
+
+	FreeJob( Job );
+
+	if ( Counter ) { Finish( Counter ); }
+}
+
+void clJobSystem::Finish( clJobCounter* Counter )
+{
+	std::vector<sJob*> Ready;
+
+	{
+		LMutex Lock( &FMutex );
+
+		if ( --Counter->FValue > 0 ) { return; }
+
+		Ready.swap( Counter->FDependents );
+
+		FCounterChanged.Broadcast();
+	}
+
+	// the counter can be destroyed by its owner at this point
+	for ( size_t i = 0; i != Ready.size(); i++ ) { Schedule( Ready[i] ); }
+}
+
+void clJobSystem::Wait( clJobCounter* Counter )
+{
+	if ( !Counter ) { return; }
+
+	bool MainThread = IsMainThread();
+	int  Index      = GetWorkerIndex();
+
+	for ( ;; )
+	{
+		Luint64 ScheduleCount = 0;
+
+		{
+			LMutex Lock( &FMutex );
+
+			if ( Counter->FValue <= 0 ) { return; }
+
+			ScheduleCount = FScheduleCount;
+		}
+
+		if ( sJob* Job = FindJob( Index, MainThread ) )
+		{
+			Execute( Job );
+			continue;
+		}
+
+		LMutex Lock( &FMutex );
+
+		if ( Counter->FValue <= 0 ) { return; }
+
+		// a job scheduled after we have looked into the queues may be ours to take
+		if ( FScheduleCount != ScheduleCount ) { continue; }
+
+		/**
+		   Everything queued before was taken by other threads, even if they have not updated FNumQueued yet.
+		   Sleep until a job is scheduled or a counter is finished
+		**/
+		FNumWaiting++;
+		FCounterChanged.Wait( &FMutex );
+		FNumWaiting--;
+	}
+}
+
+bool clJobSystem::IsDone( clJobCounter* Counter ) const
+{
+	LMutex Lock( &FMutex );
+
+	return Counter->FValue <= 0;
+}
+
+void clJobSystem::ParallelFor( LRangeProc Proc, void* Param, size_t Begin, size_t End, size_t Grain )
+{
+	if ( End <= Begin ) { return; }
+
+	size_t Count      = End - Begin;
+	size_t NumThreads = FWorkers.size() + 1;
+
+	// a few chunks per thread to balance the uneven items
+	size_t ChunkSize = std::max( std::max( Grain, static_cast<size_t>( 1 ) ), ( Count + NumThreads * 4 - 1 ) / ( NumThreads * 4 ) );
+	size_t NumChunks = ( Count + ChunkSize - 1 ) / ChunkSize;
+
+	if ( NumChunks < 2 || FWorkers.empty() )
+	{
+		Proc( Param, Begin, End );
+		return;
+	}
+
+	std::vector<sRangeJob> Chunks( NumChunks );
+
+	clJobCounter Counter;
+
+	for ( size_t i = 0; i != NumChunks; i++ )
+	{
+		Chunks[i].FProc  = Proc;
+		Chunks[i].FParam = Param;
+		Chunks[i].FBegin = Begin + i * ChunkSize;
+		Chunks[i].FEnd   = std::min( End, Chunks[i].FBegin + ChunkSize );
+
+		if ( i > 0 ) { AddJob( &RangeJobProc, &Chunks[i], &Counter, NULL ); }
+	}
+
+	// the first chunk is ours
+	RangeJobProc( &Chunks[0] );
+
+	Wait( &Counter );
+}
+
+void clJobSystem::RunMainThreadJobs()
+{
+	if ( !IsMainThread() ) { return; }
+
+	int Count = 0;
+
+	{
+		LMutex Lock( &FMutex );
+
+		Count = FNumMainQueued;
+	}
+
+	// the jobs added by these jobs wait for the next call
+	for ( int i = 0; i != Count; i++ )
+	{
+		sJob* Job = PopFront( &FMainQueue );
+
+		if ( !Job ) { break; }
+
+		{
+			LMutex Lock( &FMutex );
+
+			FNumMainQueued--;
+		}
+
+		Execute( Job );
+	}
+
+	if ( FWorkers.empty() )
+	{
+		while ( sJob* Job = FindJob( -1, false ) ) { Execute( Job ); }
+	}
+}
+
+bool clJobSystem::IsMainThread() const
+{
+	return iThread::GetCurrentThread() == FMainThreadID;
+}
+
+void clJobSystem::WorkerLoop( int WorkerIndex )
+{
+	GWorkerSystem = this;
+	GWorkerIndex  = WorkerIndex;
+
+	for ( ;; )
+	{
+		if ( sJob* Job = FindJob( WorkerIndex, false ) )
+		{
+			Execute( Job );
+			continue;
+		}
+
+		LMutex Lock( &FMutex );
+
+		while ( FNumQueued <= 0 && !FShutdown ) { FWorkAvailable.Wait( &FMutex ); }
+
+		if ( FShutdown )
+		{
+			FRunningWorkers--;
+			FCounterChanged.Broadcast();
+			return;
+		}
+	}
+}
+
+sJob* clJobSystem::FindJob( int WorkerIndex, bool MainThread )
+{
+	if ( MainThread )
+	{
+		if ( sJob* Job = PopFront( &FMainQueue ) )
+		{
+			LMutex Lock( &FMutex );
+
+			FNumMainQueued--;
+
+			return Job;
+		}
+	}
+
+	sJob* Job = ( WorkerIndex >= 0 ) ? PopBack( FQueues[ WorkerIndex ] ) : NULL;
+
+	if ( !Job ) { Job = PopFront( &FSharedQueue ); }
+
+	// steal the oldest job of another worker
+	int NumQueues = static_cast<int>( FQueues.size() );
+
+	for ( int i = 1; !Job && i <= NumQueues; i++ )
+	{
+		int Victim = ( std::max( WorkerIndex, 0 ) + i ) % NumQueues;
+
+		if ( Victim != WorkerIndex ) { Job = PopFront( FQueues[ Victim ] ); }
+	}
+
+	if ( Job )
+	{
+		LMutex Lock( &FMutex );
+
+		FNumQueued--;
+	}
+
+	return Job;
+}
+
+sJob* clJobSystem::PopBack( sJobQueue* Queue )
+{
+	LMutex Lock( &Queue->FMutex );
+
+	if ( Queue->FJobs.empty() ) { return NULL; }
+
+	sJob* Job = Queue->FJobs.back();
+
+	Queue->FJobs.pop_back();
+
+	return Job;
+}
+
+sJob* clJobSystem::PopFront( sJobQueue* Queue )
+{
+	LMutex Lock( &Queue->FMutex );
+
+	if ( Queue->FJobs.empty() ) { return NULL; }
+
+	sJob* Job = Queue->FJobs.front();
+
+	Queue->FJobs.pop_front();
+
+	return Job;
+}
+
+int clJobSystem::GetWorkerIndex() const
+{
+	return ( GWorkerSystem == this ) ? GWorkerIndex : -1;
+}
+
+/*
+ * 17/10/2026
+     It's here
+*/
@@ -0,0 +1,151 @@
+/**
+ * \file JobSystem.h
+ * \brief Work-stealing job scheduler
+ * \version 0.6.02
+ * \date 17/10/2026
+ * \author support@linderdaum.com http://www.linderdaum.com
+ */
+
+#ifndef _clJobSystem_
+#define _clJobSystem_
+
+#include "Platform.h"
+#include "Utils/Mutex.h"
+
+#include <deque>
+#include <vector>
+
+class sEnvironment;
+class clJobWorker;
+struct sJob;
+
+/// Job entry point
+typedef void ( *LJobProc )( void* Param );
+
+/// Parallel-for body, processes the items [Begin..End)
+typedef void ( *LRangeProc )( void* Param, size_t Begin, size_t End );
+
+/**
+   \brief Number of unfinished jobs
+
+   A counter is incremented when a job referencing it is added and decremented when the job is done.
+   Jobs added with the counter as a dependency are started only after it reaches zero. Counters should
+   outlive the jobs referencing them.
+**/
+class clJobCounter
+{
+public:
+	clJobCounter(): FValue( 0 ) {}
+	~clJobCounter() {}
+private:
+	friend class clJobSystem;
+
+	int                  FValue;
+	/// jobs waiting for this counter to reach zero
+	std::vector<sJob*>   FDependents;
+};
+
+/**
+   \brief Work-stealing job scheduler
+
+   Every worker owns a deque: it pushes and pops its own jobs at the back and steals from the front of
+   the other deques when idle. Jobs added from the threads which are not workers go to a shared queue.
+   Jobs with the main thread affinity are executed only by the thread that created the job system,
+   in RunMainThreadJobs() or while it waits for a counter.
+
+   All the methods are thread-safe.
+**/
+class clJobSystem
+{
+public:
+	clJobSystem();
+	~clJobSystem();
+
+	/// Start NumWorkers threads. The calling thread becomes the main thread
+	void    Start( sEnvironment* Env, int NumWorkers );
+
+	/// Wait for the workers to exit. The queued jobs are executed on the calling thread
+	void    Shutdown();
+
+	inline int GetNumWorkers() const { return static_cast<int>( FWorkers.size() ); }
+
+	/// Queue the job. Counter (can be NULL) is decremented once the job is done, the job starts after Dependency (can be NULL) reaches zero
+	void    AddJob( LJobProc Proc, void* Param, clJobCounter* Counter, clJobCounter* Dependency );
+
+	/// Queue the job for the main thread
+	void    AddMainThreadJob( LJobProc Proc, void* Param, clJobCounter* Counter, clJobCounter* Dependency );
+
+	/// Execute other jobs until the counter reaches zero
+	void    Wait( clJobCounter* Counter );
+
+	bool    IsDone( clJobCounter* Counter ) const;
+
+	/// Split [Begin..End) into chunks of at least Grain items, run them in parallel and wait for all of them
+	void    ParallelFor( LRangeProc Proc, void* Param, size_t Begin, size_t End, size_t Grain );
+
+	/// Execute the queued main thread jobs, called once per frame by sEnvironment. Without the workers all queued jobs are executed here
+	void    RunMainThreadJobs();
+
+	bool    IsMainThread() const;
+
+	/// Worker thread entry, returns after the shutdown
+	void    WorkerLoop( int WorkerIndex );
+private:
+	/// Job deque guarded by its own mutex
+	struct sJobQueue
+	{
+		clMutex             FMutex;
+		std::deque<sJob*>   FJobs;
+	};
+
+	/// Jobs are recycled through FFreeJobs
+	sJob*   AllocateJob();
+	void    FreeJob( sJob* Job );
+
+	void    Schedule( sJob* Job );
+	void    Execute( sJob* Job );
+	void    Finish( clJobCounter* Counter );
+
+	/// Take a job from the own queue, the shared queue or another worker. WorkerIndex is -1 for the non-worker threads
+	sJob*   FindJob( int WorkerIndex, bool MainThread );
+	sJob*   PopBack( sJobQueue* Queue );
+	sJob*   PopFront( sJobQueue* Queue );
+
+	/// Index of the calling worker (kept in a thread-local variable), -1 if the calling thread is not a worker
+	int     GetWorkerIndex() const;
+private:
+	std::vector<clJobWorker*>   FWorkers;
+	/// one deque per worker
+	std::vector<sJobQueue*>     FQueues;
+	/// jobs added by the non-worker threads
+	sJobQueue                   FSharedQueue;
+	/// jobs with the main thread affinity
+	sJobQueue                   FMainQueue;
+
+	size_t                      FMainThreadID;
+
+	/// guards the counters, the sleeping threads and the numbers below
+	clMutex                     FMutex;
+	clCondition                 FWorkAvailable;
+	clCondition                 FCounterChanged;
+	/// number of jobs in FQueues and FSharedQueue
+	int                         FNumQueued;
+	/// number of jobs in FMainQueue
+	int                         FNumMainQueued;
+	int                         FNumWaiting;
+	/// incremented by every Schedule(), so Wait() knows whether new jobs appeared since it looked into the queues
+	Luint64                     FScheduleCount;
+	int                         FRunningWorkers;
+	bool                        FShutdown;
+
+	/// finished jobs ready for reuse
+	std::vector<sJob*>          FFreeJobs;
+	clMutex                     FFreeJobsMutex;
+};
+
+#endif
+
+/*
+ * 17/10/2026
+     It's here
+*/
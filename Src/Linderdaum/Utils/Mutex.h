@@ -88,6 +88,68 @@ public:
 #endif
 };
 
+/// Condition variable to be used together with clMutex
+class clCondition
+{
+public:
+	clCondition()
+	{
+#ifdef OS_POSIX
+		pthread_cond_init( &TheCondition, NULL );
+#endif
+#ifdef OS_WINDOWS
+		InitializeConditionVariable( &TheCondition );
+#endif
+	}
+
+	/// Atomically release the locked Mutex and block until signaled. The Mutex is locked again on return
+	void Wait( const clMutex* Mutex ) const
+	{
+#ifdef OS_POSIX
+		pthread_cond_wait( &TheCondition, &Mutex->TheMutex );
+#endif
+#ifdef OS_WINDOWS
+		SleepConditionVariableCS( &TheCondition, &Mutex->TheCS, INFINITE );
+#endif
+	}
+
+	/// Wake up one waiting thread
+	void Signal() const
+	{
+#ifdef OS_POSIX
+		pthread_cond_signal( &TheCondition );
+#endif
+#ifdef OS_WINDOWS
+		WakeConditionVariable( &TheCondition );
+#endif
+	}
+
+	/// Wake up all waiting threads
+	void Broadcast() const
+	{
+#ifdef OS_POSIX
+		pthread_cond_broadcast( &TheCondition );
+#endif
+#ifdef OS_WINDOWS
+		WakeAllConditionVariable( &TheCondition );
+#endif
+	}
+
+	~clCondition()
+	{
+#ifdef OS_POSIX
+		pthread_cond_destroy( &TheCondition );
+#endif
+	}
+
+#ifdef OS_POSIX
+	mutable pthread_cond_t TheCondition;
+#endif
+#ifdef OS_WINDOWS
+	mutable CONDITION_VARIABLE TheCondition;
+#endif
+};
+
 class LMutex
 {
 public:
@@ -100,6 +162,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     clCondition
  * 24/06/2010
      Log section added
 */
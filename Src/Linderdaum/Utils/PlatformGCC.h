@@ -63,6 +63,9 @@
 
 #define FUNC_NAME __PRETTY_FUNCTION__
 
+/// POD variables only
+#define L_THREAD_LOCAL __thread
+
 #include <typeinfo>
 #include <stdint.h>
 typedef int64_t       Lint64;
@@ -76,6 +79,8 @@ const uint32_t Endianness = 0xDEADBEEF;
 #endif
 
 /*
+ * 17/10/2026
+     L_THREAD_LOCAL
  * 01/04/2011
      Special APPLICATION_ENTRY_POINT for Android
  * 10/09/2010
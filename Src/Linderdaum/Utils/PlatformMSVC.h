@@ -34,6 +34,9 @@
 
 #define FUNC_NAME __FUNCTION__
 
+/// POD variables only
+#define L_THREAD_LOCAL __declspec(thread)
+
 // C++ exception handling must be enabled
 #ifndef _CPPUNWIND
 #error "Bad MSVC option: C++ exception handling must be enabled"
@@ -71,6 +74,8 @@ const unsigned __int32 Endianness = 0xDEADBEEF;
 #endif
 
 /*
+ * 17/10/2026
+     L_THREAD_LOCAL
  * 02/01/2012
      Disabled warnings 6011, 6211 and 6308
  * 09/11/2007
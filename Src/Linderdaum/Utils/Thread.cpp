@@ -21,6 +21,7 @@
 
 #ifdef OS_POSIX
 #	include <sched.h>
+#	include <unistd.h>
 #endif
 
 iThread::iThread()
@@ -130,7 +131,25 @@ size_t iThread::GetCurrentThread()
 #endif
 }
 
+int iThread::GetNumberOfCores()
+{
+#if defined( OS_WINDOWS )
+	SYSTEM_INFO SysInfo;
+	GetSystemInfo( &SysInfo );
+
+	int Cores = static_cast<int>( SysInfo.dwNumberOfProcessors );
+#elif defined( OS_POSIX ) || defined( OS_ANDROID )
+	int Cores = static_cast<int>( sysconf( _SC_NPROCESSORS_ONLN ) );
+#else
+	int Cores = 1;
+#endif
+
+	return ( Cores > 0 ) ? Cores : 1;
+}
+
 /*
+ * 17/10/2026
+     GetNumberOfCores()
  * 06/04/2009
      Initial implementation
 */
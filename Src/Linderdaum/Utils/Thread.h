@@ -46,6 +46,9 @@ public:
 
 	static size_t GetCurrentThread();
 
+	/// number of logical processors available to the process
+	static int    GetNumberOfCores();
+
 	/// Worker routine
 	virtual void Run() = 0;
 
@@ -68,6 +71,8 @@ private:
 #endif
 
 /*
+ * 17/10/2026
+     GetNumberOfCores()
  * 16/06/2010
      Linux port
  * 06/04/2009
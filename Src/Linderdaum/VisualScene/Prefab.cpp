@@ -5,6 +5,7 @@
 
 #include "Core/Logger.h"
 #include "Core/VFS/FileSystem.h"
+#include "Core/VFS/iIStream.h"
 #include "Core/VFS/ML.h"
 
 #include "Geometry/Mesh.h"
@@ -48,9 +49,16 @@ void clPrefab::ImportASE( const LString& fname )
 	Env->Logger->LogP( L_NOTICE, "Parsing prefab: %s", fname.c_str() );
 
 	/// Parse ASE file and determine collision/static/dynamic geoms
-	mlNode* SrcASE = Env->FileSystem->LoadXLML_ASE( fname );
+	iIStream* Stream = Env->FileSystem->CreateFileReader( fname );
 
-	std::vector<mlNode*> CollisionNodes;
+	FATAL( !Stream, "Unable to open prefab: " + fname );
+
+	// only the node names are needed, the arena tree points right into the mapped file
+	mlDocument SrcASE;
+
+	bool Parsed = SrcASE.build( reinterpret_cast<const char*>( Stream->MapStream() ), static_cast<size_t>( Stream->GetFileSize() ), false, true );
+
+	FATAL( !Parsed, "Unable to parse prefab: " + fname );
 
 	std::vector<LString> CollisionPrefixes;
 	CollisionPrefixes.push_back( "P_" );
@@ -60,13 +68,16 @@ void clPrefab::ImportASE( const LString& fname )
 
 	std::vector<LString> CollisionPartNames;
 
-	std::vector<mlNode*> Nodes;
-	FindAllNodesWithName( SrcASE, "*GEOMOBJECT", Nodes );
-
 	// filter all collision geometry
-	for ( size_t i = 0 ; i < Nodes.size() ; i++ )
+	for ( mlViewNode* Node = SrcASE.getRoot()->firstChild; Node; Node = Node->nextSibling )
 	{
-		LString ID = FindSubNode( Nodes[i], "*NODE_NAME" )->getValue();
+		if ( !Node->getID().equals( "*GEOMOBJECT" ) ) { continue; }
+
+		mlViewNode* NameNode = Node->findChild( "*NODE_NAME" );
+
+		if ( !NameNode ) { continue; }
+
+		LString ID = NameNode->getValue().str();
 
 		for ( size_t j = 0 ; j < CollisionPrefixes.size() ; j++ )
 			if ( LStr::StartsWith( ID, CollisionPrefixes[j] ) )
@@ -108,7 +119,9 @@ void clPrefab::ImportASE( const LString& fname )
 	}
 
 	/// cleanup
-	delete SrcASE;
+	SrcASE.clear();
+
+	delete( Stream );
 
 	// save caches
 	FMesh->CacheTo( GetCachedMeshName() );
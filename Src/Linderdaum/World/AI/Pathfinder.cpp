@@ -8,6 +8,10 @@
  */
 
 #include "Pathfinder.h"
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+#include <stdlib.h>
 
 struct sIntVec2
 {
@@ -36,131 +40,488 @@ s2DWaypoint clPath::GetWaypoint( int Index ) const
 	return FWaypoints[Index];
 }
 
-/*
 const int MAX_HEADING = 8;
 
-sIntVec2 sHeading[MAX_HEADING] = {
-                                  sIntVec2(-1,-1),
-                                  sIntVec2( 0,-1),
-                                  sIntVec2(+1,-1),
-                                  sIntVec2(-1, 0),
-                                  sIntVec2(+1, 0),
-                                  sIntVec2(-1,+1),
-                                  sIntVec2( 0,+1),
-                                  sIntVec2(+1,+1),
-                                 };
-*/
-const int MAX_HEADING = 4;
+/// The first 4 headings are orthogonal
+const int sHeadingX[MAX_HEADING] = {  0, -1, +1,  0, -1, +1, -1, +1 };
+const int sHeadingY[MAX_HEADING] = { -1,  0,  0, +1, -1, -1, +1, +1 };
+
+/// Integer move costs, diagonal ~ sqrt(2)
+const int STRAIGHT_COST = 10;
+const int DIAGONAL_COST = 14;
+
+void cl2DPathSearchBuffer::BeginSearch( int NumCells )
+{
+	if ( static_cast<int>( FStamp.size() ) < NumCells )
+	{
+		size_t OldSize = FStamp.size();
+
+		FStamp.resize( NumCells );
+		FCost.resize( NumCells );
+		FParent.resize( NumCells );
+		FClosed.resize( NumCells );
+
+		for ( size_t i = OldSize; i != FStamp.size(); ++i ) { FStamp[i] = 0; }
+	}
+
+	FOpen.clear();
 
-const int sHeadingX[MAX_HEADING] = {  0, -1, +1,  0 };
-const int sHeadingY[MAX_HEADING] = { -1,  0,  0, +1 };
+	if ( ++FSearchID == 0 )
+	{
+		// the stamps wrapped around
+		for ( size_t i = 0; i != FStamp.size(); ++i ) { FStamp[i] = 0; }
 
+		FSearchID = 1;
+	}
+}
 
-void clPathfinder::MarkPoint( int X, int Y, int Step )
+/// Everything about the current query the helpers below need
+struct s2DGridQuery
 {
-	if ( X < 0 || Y < 0 || X >= FSizeX || Y >= FSizeY )
+	int                    FSizeX;
+	int                    FSizeY;
+	int                    FDstX;
+	int                    FDstY;
+	cl2DPassabilityMap*    FMap;
+
+	inline bool IsFree( int X, int Y ) const
+	{
+		return X >= 0 && Y >= 0 && X < FSizeX && Y < FSizeY && FMap->IsPassable( X, Y );
+	}
+	inline bool IsDest( int X, int Y ) const
 	{
-		return;
+		return X == FDstX && Y == FDstY;
 	}
+	/// Octile distance, exact cost of the unobstructed path
+	inline int Distance( int X1, int Y1, int X2, int Y2, bool Diagonal ) const
+	{
+		int DX = abs( X2 - X1 );
+		int DY = abs( Y2 - Y1 );
+
+		if ( !Diagonal ) { return STRAIGHT_COST * ( DX + DY ); }
+
+		return ( DX < DY ) ? DIAGONAL_COST * DX + STRAIGHT_COST * ( DY - DX ) : DIAGONAL_COST * DY + STRAIGHT_COST * ( DX - DY );
+	}
+};
 
-	if ( FAccessMap.GetPoint( X, Y ) <= Step )
+static inline int Sign( int V )
+{
+	return ( V > 0 ) - ( V < 0 );
+}
+
+/// Move along (DX,DY) starting at (X,Y) until a cell with a forced neighbour or the destination is found
+static bool JumpStraight( const s2DGridQuery& Q, int& X, int& Y, int DX, int DY )
+{
+	for ( ;; X += DX, Y += DY )
 	{
-		return;
+		if ( !Q.IsFree( X, Y ) ) { return false; }
+
+		if ( Q.IsDest( X, Y ) ) { return true; }
+
+		if ( DX != 0 )
+		{
+			if ( ( Q.IsFree( X, Y - 1 ) && !Q.IsFree( X - DX, Y - 1 ) ) ||
+			     ( Q.IsFree( X, Y + 1 ) && !Q.IsFree( X - DX, Y + 1 ) ) ) { return true; }
+		}
+		else
+		{
+			if ( ( Q.IsFree( X - 1, Y ) && !Q.IsFree( X - 1, Y - DY ) ) ||
+			     ( Q.IsFree( X + 1, Y ) && !Q.IsFree( X + 1, Y - DY ) ) ) { return true; }
+		}
 	}
+}
 
-	FAccessMap.SetPoint( X, Y, Step );
+/// Jump from (X,Y) in the direction (DX,DY). On success (X,Y) is the jump point
+static bool Jump( const s2DGridQuery& Q, int& X, int& Y, int DX, int DY )
+{
+	int CX = X + DX;
+	int CY = Y + DY;
 
-	if ( X == FDstX && Y == FDstY )
+	if ( DX == 0 || DY == 0 )
 	{
-		return;
+		if ( !JumpStraight( Q, CX, CY, DX, DY ) ) { return false; }
+
+		X = CX;
+		Y = CY;
+
+		return true;
 	}
 
-	for ( int i = 0; i != MAX_HEADING; ++i )
+	// diagonal : stop where any of the straight scans finds something
+	for ( ;; CX += DX, CY += DY )
 	{
-		MarkPoint( X + sHeadingX[i],
-		           Y + sHeadingY[i],
-		           Step + 1 );
+		if ( !Q.IsFree( CX, CY ) ) { return false; }
+
+		if ( Q.IsDest( CX, CY ) ) { break; }
+
+		int SX = CX + DX;
+		int SY = CY;
+
+		if ( JumpStraight( Q, SX, SY, DX, 0 ) ) { break; }
+
+		SX = CX;
+		SY = CY + DY;
+
+		if ( JumpStraight( Q, SX, SY, 0, DY ) ) { break; }
+
+		// no corner cutting
+		if ( !Q.IsFree( CX + DX, CY ) || !Q.IsFree( CX, CY + DY ) ) { return false; }
 	}
+
+	X = CX;
+	Y = CY;
+
+	return true;
 }
 
-clPath* clPathfinder::FindPath2DGrid( int SizeX, int SizeY,
-                                      int XSrc , int YSrc,
-                                      int XDest, int YDest,
-                                      cl2DPassabilityMap* Map )
+/// Append the direction to the successor lists
+static inline void AddSuccessorDir( int DX, int DY, int* DirX, int* DirY, int* Num )
 {
-	FPath.Clear();
+	DirX[*Num] = DX;
+	DirY[*Num] = DY;
+
+	( *Num )++;
+}
+
+/// Directions worth searching from (X,Y) reached by moving in (DX,DY), all directions for the start node
+static int GetSuccessorDirs( const s2DGridQuery& Q, int X, int Y, int DX, int DY, int* DirX, int* DirY )
+{
+	int Num = 0;
+
+	if ( DX == 0 && DY == 0 )
+	{
+		for ( int i = 0; i != MAX_HEADING; ++i )
+		{
+			bool Diagonal = sHeadingX[i] != 0 && sHeadingY[i] != 0;
 
-	FSizeX = SizeX;
-	FSizeY = SizeY;
+			if ( Diagonal && ( !Q.IsFree( X + sHeadingX[i], Y ) || !Q.IsFree( X, Y + sHeadingY[i] ) ) ) { continue; }
 
-	FDstX = XDest;
-	FDstY = YDest;
+			AddSuccessorDir( sHeadingX[i], sHeadingY[i], DirX, DirY, &Num );
+		}
+	}
+	else if ( DX != 0 && DY != 0 )
+	{
+		bool FreeX = Q.IsFree( X + DX, Y );
+		bool FreeY = Q.IsFree( X, Y + DY );
 
-	const int UNREACHABLE = 0xFFFFFF;
-	const int UNPASSABLE  = -1;
+		if ( FreeY ) { AddSuccessorDir( 0, DY, DirX, DirY, &Num ); }
 
-	// run the wave
-	FAccessMap.SetSize( SizeX, SizeY );
-	FAccessMap.Fill( UNREACHABLE );
+		if ( FreeX ) { AddSuccessorDir( DX, 0, DirX, DirY, &Num ); }
 
-	for ( int i = 0; i != SizeX; ++i )
+		if ( FreeX && FreeY ) { AddSuccessorDir( DX, DY, DirX, DirY, &Num ); }
+	}
+	else if ( DX != 0 )
 	{
-		for ( int j = 0; j != SizeY; ++j )
+		bool FreeUp   = Q.IsFree( X, Y - 1 );
+		bool FreeDown = Q.IsFree( X, Y + 1 );
+
+		if ( Q.IsFree( X + DX, Y ) )
 		{
-			if ( !Map->IsPassable( i, j ) )
-			{
-				FAccessMap.SetPoint( i, j, UNPASSABLE );
-			}
+			AddSuccessorDir( DX, 0, DirX, DirY, &Num );
+
+			if ( FreeUp ) { AddSuccessorDir( DX, -1, DirX, DirY, &Num ); }
+
+			if ( FreeDown ) { AddSuccessorDir( DX, +1, DirX, DirY, &Num ); }
 		}
+
+		if ( FreeUp ) { AddSuccessorDir( 0, -1, DirX, DirY, &Num ); }
+
+		if ( FreeDown ) { AddSuccessorDir( 0, +1, DirX, DirY, &Num ); }
 	}
+	else
+	{
+		bool FreeLeft  = Q.IsFree( X - 1, Y );
+		bool FreeRight = Q.IsFree( X + 1, Y );
+
+		if ( Q.IsFree( X, Y + DY ) )
+		{
+			AddSuccessorDir( 0, DY, DirX, DirY, &Num );
+
+			if ( FreeLeft ) { AddSuccessorDir( -1, DY, DirX, DirY, &Num ); }
 
-	if ( FAccessMap.GetPoint( XDest, YDest ) == UNPASSABLE )
+			if ( FreeRight ) { AddSuccessorDir( +1, DY, DirX, DirY, &Num ); }
+		}
+
+		if ( FreeLeft ) { AddSuccessorDir( -1, 0, DirX, DirY, &Num ); }
+
+		if ( FreeRight ) { AddSuccessorDir( +1, 0, DirX, DirY, &Num ); }
+	}
+
+	return Num;
+}
+
+clPathfinder::~clPathfinder()
+{
+	for ( size_t i = 0; i != FBuffers.size(); ++i )
 	{
-		return &FPath;
+		delete( FBuffers[i] );
 	}
+}
 
-	MarkPoint( XSrc, YSrc, 0 );
+clPath* clPathfinder::FindPath2DGrid( int SizeX, int SizeY,
+                                      int XSrc , int YSrc,
+                                      int XDest, int YDest,
+                                      cl2DPassabilityMap* Map )
+{
+	// keep the old behaviour : nothing but the complete path
+	if ( !FindPath2DGrid( SizeX, SizeY, XSrc, YSrc, XDest, YDest, Map, &FPath, &FBuffer ) )
+	{
+		FPath.Clear();
+	}
 
-	// create path
-	int X = XDest;
-	int Y = YDest;
-	int Step = FAccessMap.GetPoint( XDest, YDest );
+	return &FPath;
+}
+
+bool clPathfinder::FindPath2DGrid( int SizeX, int SizeY,
+                                   int XSrc , int YSrc,
+                                   int XDest, int YDest,
+                                   cl2DPassabilityMap* Map,
+                                   clPath* Path,
+                                   cl2DPathSearchBuffer* Buffer ) const
+{
+	Path->Clear();
+
+	s2DGridQuery Q;
+	Q.FSizeX = SizeX;
+	Q.FSizeY = SizeY;
+	Q.FDstX  = XDest;
+	Q.FDstY  = YDest;
+	Q.FMap   = Map;
 
-	if ( Step == UNREACHABLE  )
+	if ( !Q.IsFree( XSrc, YSrc ) || !Q.IsFree( XDest, YDest ) )
 	{
-		return &FPath;
+		return false;
 	}
 
-	for ( int i = Step; i >= 0; --i )
+	const bool Diagonal = FParams.FDiagonalMoves;
+	const bool JPS      = Diagonal && FParams.FJumpPointSearch;
+
+	Buffer->BeginSearch( SizeX * SizeY );
+
+	const Luint ID = Buffer->FSearchID;
+
+	const int Start = YSrc * SizeX + XSrc;
+	const int Dest  = YDest * SizeX + XDest;
+
+	Buffer->FStamp[Start]  = ID;
+	Buffer->FCost[Start]   = 0;
+	Buffer->FParent[Start] = -1;
+	Buffer->FClosed[Start] = false;
+
+	cl2DPathSearchBuffer::sOpenNode StartNode;
+	StartNode.FEstimate = Q.Distance( XSrc, YSrc, XDest, YDest, Diagonal );
+	StartNode.FCell     = Start;
+
+	Buffer->FOpen.push_back( StartNode );
+
+	// the fallback target if the budget runs out
+	int Closest         = Start;
+	int ClosestDistance = StartNode.FEstimate;
+
+	int  Expanded = 0;
+	bool Found    = false;
+
+	int DirX[MAX_HEADING];
+	int DirY[MAX_HEADING];
+
+	while ( !Buffer->FOpen.empty() )
 	{
-		FPath.AddWaypoint( s2DWaypoint( X, Y ) );
+		std::pop_heap( Buffer->FOpen.begin(), Buffer->FOpen.end() );
+
+		const int Cell = Buffer->FOpen.back().FCell;
+
+		Buffer->FOpen.pop_back();
 
-		for ( int j = 0; j != MAX_HEADING; ++j )
+		// stale entry, the cell was reached cheaper before
+		if ( Buffer->FClosed[Cell] ) { continue; }
+
+		Buffer->FClosed[Cell] = true;
+
+		if ( Cell == Dest )
 		{
-			int aX = X + sHeadingX[j];
-			int aY = Y + sHeadingY[j];
+			Found = true;
+			break;
+		}
+
+		if ( FParams.FMaxExpandedNodes > 0 && Expanded++ >= FParams.FMaxExpandedNodes ) { break; }
+
+		const int X = Cell % SizeX;
+		const int Y = Cell / SizeX;
 
-			if ( aX < 0 || aY < 0 || aX >= FSizeX || aY >= FSizeY )
+		int Distance = Q.Distance( X, Y, XDest, YDest, Diagonal );
+
+		if ( Distance < ClosestDistance )
+		{
+			Closest         = Cell;
+			ClosestDistance = Distance;
+		}
+
+		int NumDirs = 0;
+
+		if ( JPS )
+		{
+			int Parent = Buffer->FParent[Cell];
+
+			int PX = ( Parent < 0 ) ? X : Parent % SizeX;
+			int PY = ( Parent < 0 ) ? Y : Parent / SizeX;
+
+			NumDirs = GetSuccessorDirs( Q, X, Y, Sign( X - PX ), Sign( Y - PY ), DirX, DirY );
+		}
+		else
+		{
+			for ( int i = 0; i != ( Diagonal ? MAX_HEADING : 4 ); ++i )
 			{
-				continue;
+				DirX[NumDirs] = sHeadingX[i];
+				DirY[NumDirs] = sHeadingY[i];
+				NumDirs++;
 			}
+		}
+
+		for ( int i = 0; i != NumDirs; ++i )
+		{
+			int NX = X;
+			int NY = Y;
 
-			if ( FAccessMap.GetPoint( aX, aY ) == Step - 1 )
+			if ( JPS )
+			{
+				if ( !Jump( Q, NX, NY, DirX[i], DirY[i] ) ) { continue; }
+			}
+			else
 			{
-				X = aX;
-				Y = aY;
+				NX += DirX[i];
+				NY += DirY[i];
 
-				Step--;
+				if ( !Q.IsFree( NX, NY ) ) { continue; }
 
-				break;
+				// no corner cutting
+				if ( DirX[i] != 0 && DirY[i] != 0 && ( !Q.IsFree( NX, Y ) || !Q.IsFree( X, NY ) ) ) { continue; }
 			}
+
+			const int Next = NY * SizeX + NX;
+			const int Cost = Buffer->FCost[Cell] + Q.Distance( X, Y, NX, NY, Diagonal );
+
+			if ( Buffer->FStamp[Next] != ID )
+			{
+				Buffer->FStamp[Next]  = ID;
+				Buffer->FClosed[Next] = false;
+			}
+			else if ( Buffer->FClosed[Next] || Buffer->FCost[Next] <= Cost )
+			{
+				continue;
+			}
+
+			Buffer->FCost[Next]   = Cost;
+			Buffer->FParent[Next] = Cell;
+
+			cl2DPathSearchBuffer::sOpenNode Node;
+			Node.FEstimate = Cost + Q.Distance( NX, NY, XDest, YDest, Diagonal );
+			Node.FCell     = Next;
+
+			Buffer->FOpen.push_back( Node );
+			std::push_heap( Buffer->FOpen.begin(), Buffer->FOpen.end() );
 		}
 	}
 
-	return &FPath;
+	// create path, the jump points are connected with straight or diagonal lines
+	for ( int Cell = Found ? Dest : Closest; Cell >= 0; Cell = Buffer->FParent[Cell] )
+	{
+		int X = Cell % SizeX;
+		int Y = Cell / SizeX;
+
+		int Parent = Buffer->FParent[Cell];
+
+		int PX = ( Parent < 0 ) ? X : Parent % SizeX;
+		int PY = ( Parent < 0 ) ? Y : Parent / SizeX;
+
+		int DX = Sign( PX - X );
+		int DY = Sign( PY - Y );
+
+		do
+		{
+			Path->AddWaypoint( s2DWaypoint( X, Y ) );
+
+			X += DX;
+			Y += DY;
+		}
+		while ( X != PX || Y != PY );
+	}
+
+	return Found;
+}
+
+/// Batch of queries split into chunks, each chunk has its own search buffer
+struct s2DPathBatch
+{
+	const clPathfinder*              FPathfinder;
+	int                              FSizeX;
+	int                              FSizeY;
+	cl2DPassabilityMap*              FMap;
+	s2DPathRequest*                  FRequests;
+	size_t                           FNumRequests;
+	size_t                           FNumChunks;
+	cl2DPathSearchBuffer* const*     FBuffers;
+};
+
+static void FindPathsProc( void* Param, size_t Begin, size_t End )
+{
+	s2DPathBatch* Batch = reinterpret_cast<s2DPathBatch*>( Param );
+
+	for ( size_t c = Begin; c != End; ++c )
+	{
+		size_t First = c * Batch->FNumRequests / Batch->FNumChunks;
+		size_t Last  = ( c + 1 ) * Batch->FNumRequests / Batch->FNumChunks;
+
+		for ( size_t i = First; i != Last; ++i )
+		{
+			s2DPathRequest& R = Batch->FRequests[i];
+
+			R.FFound = Batch->FPathfinder->FindPath2DGrid( Batch->FSizeX, Batch->FSizeY,
+			                                               R.FXSrc, R.FYSrc, R.FXDest, R.FYDest,
+			                                               Batch->FMap, &R.FPath, Batch->FBuffers[c] );
+		}
+	}
+}
+
+void clPathfinder::FindPaths2DGrid( int SizeX, int SizeY,
+                                    cl2DPassabilityMap* Map,
+                                    s2DPathRequest* Requests,
+                                    size_t NumRequests,
+                                    clJobSystem* Jobs )
+{
+	if ( NumRequests == 0 ) { return; }
+
+	size_t NumChunks = Jobs ? static_cast<size_t>( Jobs->GetNumWorkers() ) + 1 : 1;
+
+	if ( NumChunks > NumRequests ) { NumChunks = NumRequests; }
+
+	while ( FBuffers.size() < NumChunks )
+	{
+		FBuffers.push_back( new cl2DPathSearchBuffer() );
+	}
+
+	s2DPathBatch Batch;
+	Batch.FPathfinder  = this;
+	Batch.FSizeX       = SizeX;
+	Batch.FSizeY       = SizeY;
+	Batch.FMap         = Map;
+	Batch.FRequests    = Requests;
+	Batch.FNumRequests = NumRequests;
+	Batch.FNumChunks   = NumChunks;
+	Batch.FBuffers     = FBuffers.begin();
+
+	if ( Jobs && NumChunks > 1 )
+	{
+		Jobs->ParallelFor( &FindPathsProc, &Batch, 0, NumChunks, 1 );
+	}
+	else
+	{
+		FindPathsProc( &Batch, 0, NumChunks );
+	}
 }
 
 /*
+ * 17/10/2026
+     Recursive flood fill replaced with A* and jump point search
  * 03/08/2007
      It's here
 */
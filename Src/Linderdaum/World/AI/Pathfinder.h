@@ -78,32 +78,102 @@ private:
 	int            FSizeY;
 };
 
+/// Settings of the 2D grid search
+struct s2DPathfinderParams
+{
+	s2DPathfinderParams(): FDiagonalMoves( false ), FJumpPointSearch( true ), FMaxExpandedNodes( 0 ) {};
+	/// Allow 8-directional movement (off by default, as the original 4-directional pathfinder). Diagonal moves never cut the corners of unpassable cells
+	bool    FDiagonalMoves;
+	/// Skip the symmetric paths with the jump point search (only used with FDiagonalMoves)
+	bool    FJumpPointSearch;
+	/// Stop the search after so many nodes are taken from the open list, 0 - unlimited
+	int     FMaxExpandedNodes;
+};
+
+/// Per-thread memory of the search, reused between the queries without clearing
+class cl2DPathSearchBuffer
+{
+public:
+	cl2DPathSearchBuffer(): FSearchID( 0 ) {};
+	//
+	// cl2DPathSearchBuffer
+	//
+	/// Grow the arrays for the grid and start a new search generation
+	void    BeginSearch( int NumCells );
+public:
+	struct sOpenNode
+	{
+		int    FEstimate;
+		int    FCell;
+		/// Inverted, so std::push_heap() keeps the cheapest node on top
+		inline bool operator < ( const sOpenNode& Other ) const { return FEstimate > Other.FEstimate; }
+	};
+	/// Cell data is valid only if FStamp equals FSearchID, so nothing is cleared between the searches
+	LArray<Luint>        FStamp;
+	LArray<int>          FCost;
+	LArray<int>          FParent;
+	LArray<bool>         FClosed;
+	LArray<sOpenNode>    FOpen;
+	Luint                FSearchID;
+};
+
+/// Single query of the batched search
+struct s2DPathRequest
+{
+	int       FXSrc;
+	int       FYSrc;
+	int       FXDest;
+	int       FYDest;
+	/// Result, waypoints go from the destination to the source
+	clPath    FPath;
+	bool      FFound;
+};
+
+class clJobSystem;
+
 /// 2D pathfinder implementation
 class clPathfinder
 {
 public:
-	clPathfinder(): FAccessMap() {};
+	clPathfinder(): FParams(), FBuffers(), FBuffer(), FPath() {};
+	virtual ~clPathfinder();
 	//
 	// clPathFinder
 	//
+	virtual void       SetParams( const s2DPathfinderParams& Params ) { FParams = Params; };
+	virtual s2DPathfinderParams GetParams() const { return FParams; };
+	/// Find the path with the pathfinder's own search buffer. Returns an empty path if the destination is not reachable
 	virtual clPath*    FindPath2DGrid( int SizeX, int SizeY,
 	                                   int XSrc , int YSrc,
 	                                   int XDest, int YDest,
 	                                   cl2DPassabilityMap* Map );
+	/// Thread-safe A* search, the waypoints go from the destination to the source cell by cell. Returns false and the path to the closest explored cell if the budget is exhausted
+	virtual bool       FindPath2DGrid( int SizeX, int SizeY,
+	                                   int XSrc , int YSrc,
+	                                   int XDest, int YDest,
+	                                   cl2DPassabilityMap* Map,
+	                                   clPath* Path,
+	                                   cl2DPathSearchBuffer* Buffer ) const;
+	/// Run the queries in parallel on Jobs (can be NULL). Map->IsPassable() should be safe to call from many threads
+	virtual void       FindPaths2DGrid( int SizeX, int SizeY,
+	                                    cl2DPassabilityMap* Map,
+	                                    s2DPathRequest* Requests,
+	                                    size_t NumRequests,
+	                                    clJobSystem* Jobs );
 private:
-	void    MarkPoint( int X, int Y, int Step );
-private:
-	cl2DAccessMap          FAccessMap;
-	int                    FDstX;
-	int                    FDstY;
-	int                    FSizeX;
-	int                    FSizeY;
-	clPath                 FPath;
+	s2DPathfinderParams              FParams;
+	/// Reused search buffers, one per batch chunk
+	LArray<cl2DPathSearchBuffer*>    FBuffers;
+	cl2DPathSearchBuffer             FBuffer;
+	clPath                           FPath;
 };
 
 #endif
 
 /*
+ * 17/10/2026
+     4-directional search by default
+     A* with jump point search, search buffers and batched queries
  * 03/08/2007
      It's here
 */